@@ -32,6 +32,14 @@ public:
   std::vector<Function *> queuePushes;
   std::vector<Function *> queuePops;
   std::vector<Type *> queueTypes;
+
+  /*
+   * Queues of fixed-size records, which pack several values (or values that
+   * do not fit in the scalar queues above) in a single slot.
+   */
+  Function *recordQueuePush = nullptr;
+  Function *recordQueuePop = nullptr;
+  Type *recordQueueType = nullptr;
 };
 
 } // namespace llvm
@@ -34,6 +34,8 @@
 #include <list>
 #include <deque>
 #include <thread>
+#include <mutex>
+#include <atomic>
 #include <sstream>
 #include <math.h>
 #include <optional>
@@ -70,6 +72,8 @@
 #include "llvm/Analysis/ScalarEvolutionExpressions.h"
 #include "llvm/Analysis/CallGraph.h"
 #include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/CFG.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/IR/Mangler.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/CFG.h"
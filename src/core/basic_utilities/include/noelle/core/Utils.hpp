@@ -38,6 +38,13 @@ public:
   static Value *getAllocatedObject(CallBase *call);
 
   static Value *getFreedObject(CallBase *call);
+
+  /*
+   * Return the lock to hold while running code that can add entries to the
+   * LLVM context (e.g., constants, types, metadata kinds, scalar evolutions)
+   * from more than one thread.
+   */
+  static std::mutex &getLLVMContextLock(void);
 };
 
 } // namespace llvm::noelle
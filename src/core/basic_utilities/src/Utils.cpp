@@ -64,7 +64,8 @@ bool Utils::isAllocator(CallBase *callInst) {
    */
   auto calleeName = callee->getName();
   if (false || (calleeName == "malloc") || (calleeName == "calloc")
-      || (calleeName == "realloc")) {
+      || (calleeName == "realloc") || (calleeName == "_Znwm")
+      || (calleeName == "_Znam")) {
     return true;
   }
 
@@ -134,7 +135,8 @@ bool Utils::isDeallocator(CallBase *callInst) {
    * Check if it is a call to a known library function.
    */
   auto calleeName = callee->getName();
-  if (false || (calleeName == "free")) {
+  if (false || (calleeName == "free") || (calleeName == "_ZdlPv")
+      || (calleeName == "_ZdaPv")) {
     return true;
   }
 
@@ -151,7 +153,8 @@ Value *Utils::getAllocatedObject(CallBase *call) {
   }
   auto calleeName = callee->getName();
   if (false || (calleeName == "malloc") || (calleeName == "calloc")
-      || (calleeName == "realloc")) {
+      || (calleeName == "realloc") || (calleeName == "_Znwm")
+      || (calleeName == "_Znam")) {
     return call;
   }
 
@@ -170,7 +173,8 @@ Value *Utils::getFreedObject(CallBase *call) {
     return nullptr;
   }
   auto calleeName = callee->getName();
-  if (false || (calleeName == "free")) {
+  if (false || (calleeName == "free") || (calleeName == "_ZdlPv")
+      || (calleeName == "_ZdaPv")) {
     return call->getArgOperand(0);
   }
 
@@ -180,4 +184,10 @@ Value *Utils::getFreedObject(CallBase *call) {
   abort();
 }
 
+std::mutex &Utils::getLLVMContextLock(void) {
+  static std::mutex contextLock;
+
+  return contextLock;
+}
+
 } // namespace llvm::noelle
@@ -43,6 +43,8 @@ public:
 
   bool isAnSCC(void) const override;
 
+  std::unordered_set<CallGraphNode *> getNodes(void) const;
+
   virtual ~SCCCAGNode_SCC();
 
 private:
@@ -71,8 +73,15 @@ public:
 
   SCCCAGNode *getNode(CallGraphNode *n) const;
 
+  /*
+   * Return the nodes of the SCCCAG ordered such that callees come before their
+   * callers (i.e., in reverse topological order).
+   */
+  std::vector<SCCCAGNode *> getNodesInBottomUpOrder(void) const;
+
 private:
   std::unordered_map<CallGraphNode *, SCCCAGNode *> nodes;
+  std::vector<SCCCAGNode *> bottomUpNodes;
 };
 
 } // namespace llvm::noelle
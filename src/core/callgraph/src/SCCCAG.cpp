@@ -29,6 +29,11 @@ SCCCAG::SCCCAG(CallGraph *cg) {
   /*
    * Iterate over all function nodes.
    *
+   * The scc_iterator visits SCCs in reverse topological order. Since every
+   * traversal visits all SCCs reachable from its entry, SCCs found by a later
+   * traversal can only call SCCs found before. Hence, the order in which SCCs
+   * are found is a bottom-up order of the SCCCAG.
+   *
    * NOTE: The use of a call graph wrapper is because additional APIs are needed
    * that don't belong on CallGraph for the use of GraphTraits and scc_iterator
    */
@@ -101,12 +106,14 @@ SCCCAG::SCCCAG(CallGraph *cg) {
       if (!thisIsAnSCC) {
         auto sccNode = new SCCCAGNode_Function(singleCGNode);
         this->nodes[singleCGNode] = sccNode;
+        this->bottomUpNodes.push_back(sccNode);
         continue;
       }
       auto sccNode = new SCCCAGNode_SCC(cgNodes);
       for (auto node : cgNodes) {
         this->nodes[node] = sccNode;
       }
+      this->bottomUpNodes.push_back(sccNode);
     }
   }
 
@@ -122,4 +129,8 @@ SCCCAGNode *SCCCAG::getNode(CallGraphNode *n) const {
   return node;
 }
 
+std::vector<SCCCAGNode *> SCCCAG::getNodesInBottomUpOrder(void) const {
+  return this->bottomUpNodes;
+}
+
 } // namespace llvm::noelle
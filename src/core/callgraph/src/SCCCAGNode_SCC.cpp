@@ -33,6 +33,10 @@ bool SCCCAGNode_SCC::isAnSCC(void) const {
   return true;
 }
 
+std::unordered_set<CallGraphNode *> SCCCAGNode_SCC::getNodes(void) const {
+  return this->nodes;
+}
+
 SCCCAGNode_SCC::~SCCCAGNode_SCC() {
   return;
 }
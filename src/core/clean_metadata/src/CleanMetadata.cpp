@@ -86,10 +86,33 @@ void CleanMetadata::cleanProfMetadata(Module &M) {
         if (I.getMetadata("prof")) {
           I.setMetadata("prof", nullptr);
         }
+        if (I.getMetadata("noelle.prof.loop.iterations")) {
+          I.setMetadata("noelle.prof.loop.iterations", nullptr);
+        }
+        if (I.getMetadata("noelle.prof.loop.instructions")) {
+          I.setMetadata("noelle.prof.loop.instructions", nullptr);
+        }
+
+        /*
+         * Memory dependence profile.
+         */
+        for (auto name : { "noelle.deps.prof.id",
+                           "noelle.deps.prof.executed",
+                           "noelle.deps.prof.complete",
+                           "noelle.deps.prof.deps",
+                           "noelle.deps.prof.loop.id" }) {
+          if (I.getMetadata(name)) {
+            I.setMetadata(name, nullptr);
+          }
+        }
       }
     }
   }
 
+  if (auto n = M.getNamedMetadata("noelle.deps.prof")) {
+    M.eraseNamedMetadata(n);
+  }
+
   return;
 }
 
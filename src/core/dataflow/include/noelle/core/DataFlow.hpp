@@ -26,3 +26,4 @@
 #include "noelle/core/DataFlowResult.hpp"
 #include "noelle/core/DataFlowEngine.hpp"
 #include "noelle/core/DataFlowAnalysis.hpp"
+#include "noelle/core/InstructionReachability.hpp"
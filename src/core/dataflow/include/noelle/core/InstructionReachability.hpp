@@ -0,0 +1,89 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+
+namespace llvm::noelle {
+
+/*
+ * Which instructions of a function can execute after a given one.
+ *
+ * Only instructions selected by a filter (e.g., memory instructions) are
+ * tracked. Reachability is computed between strongly connected components of
+ * the CFG with one bitset per component, and answers about instructions are
+ * derived from the order of instructions within their basic block. This is
+ * equivalent to the data-flow based reachable analysis, but it needs linear
+ * memory in the number of instructions of the function.
+ */
+class InstructionReachability {
+public:
+  /*
+   * If @assumeEverythingIsReachable is true, every instruction selected by
+   * @filter is considered reachable from every instruction of @f.
+   */
+  InstructionReachability(Function *f,
+                          std::function<bool(Instruction *i)> filter,
+                          bool assumeEverythingIsReachable);
+
+  Function *getFunction(void) const;
+
+  /*
+   * Return the instructions selected by the filter that can execute after @i
+   * (@i itself is included if it belongs to a cycle of the CFG).
+   */
+  std::vector<Instruction *> getReachableInstructions(Instruction *i) const;
+
+  bool canReach(Instruction *from, Instruction *to) const;
+
+private:
+  Function *f;
+  bool assumeEverythingIsReachable;
+
+  /*
+   * Instructions selected by the filter.
+   */
+  std::vector<Instruction *> allInstructions;
+  std::unordered_map<BasicBlock *, std::vector<Instruction *>>
+      blockInstructions;
+
+  /*
+   * Position of every instruction within its basic block.
+   */
+  std::unordered_map<Instruction *, uint32_t> positions;
+
+  /*
+   * Strongly connected components of the CFG.
+   * The successors of a component have smaller IDs than the component.
+   * reachableSCCs[s] contains the components that can be reached from @s by
+   * following at least one CFG edge (so it contains @s iff @s has a cycle).
+   */
+  std::unordered_map<BasicBlock *, uint32_t> blockSCC;
+  std::vector<std::vector<BasicBlock *>> sccBlocks;
+  std::vector<BitVector> reachableSCCs;
+
+  void computeSCCs(void);
+
+  void computeReachableSCCs(void);
+};
+
+} // namespace llvm::noelle
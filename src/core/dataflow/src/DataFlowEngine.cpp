@@ -20,6 +20,7 @@
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "noelle/core/DataFlowEngine.hpp"
+#include "noelle/core/CompileTimeProfiler.hpp"
 
 namespace llvm::noelle {
 
@@ -140,6 +141,7 @@ DataFlowResult *DataFlowEngine::applyBackward(
     std::function<void(std::set<Value *> &OUT,
                        Instruction *successor,
                        DataFlowResult *df)> computeOUT) {
+  CompileTimePhase phase("Data-flow analysis");
 
   /*
    * Compute the GENs and KILLs
@@ -299,6 +301,7 @@ DataFlowResult *DataFlowEngine::applyCustomizableForwardAnalysis(
         appendBB,
     std::function<Instruction *(BasicBlock *bb)> getFirstInstruction,
     std::function<Instruction *(BasicBlock *bb)> getLastInstruction) {
+  CompileTimePhase phase("Data-flow analysis");
 
   /*
    * Initialize IN and OUT sets.
@@ -0,0 +1,199 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/InstructionReachability.hpp"
+
+namespace llvm::noelle {
+
+InstructionReachability::InstructionReachability(
+    Function *f,
+    std::function<bool(Instruction *i)> filter,
+    bool assumeEverythingIsReachable)
+  : f{ f },
+    assumeEverythingIsReachable{ assumeEverythingIsReachable } {
+
+  /*
+   * Collect the instructions selected by the filter.
+   */
+  for (auto &bb : *f) {
+    uint32_t position = 0;
+    for (auto &inst : bb) {
+      this->positions[&inst] = position++;
+      if (!filter(&inst)) {
+        continue;
+      }
+      this->allInstructions.push_back(&inst);
+      this->blockInstructions[&bb].push_back(&inst);
+    }
+  }
+
+  /*
+   * Check if we need to compute the reachability.
+   */
+  if (this->assumeEverythingIsReachable) {
+    return;
+  }
+
+  /*
+   * Compute the reachability between basic blocks.
+   */
+  this->computeSCCs();
+  this->computeReachableSCCs();
+
+  return;
+}
+
+Function *InstructionReachability::getFunction(void) const {
+  return this->f;
+}
+
+std::vector<Instruction *> InstructionReachability::getReachableInstructions(
+    Instruction *i) const {
+  if (this->assumeEverythingIsReachable) {
+    return this->allInstructions;
+  }
+  std::vector<Instruction *> reachableInstructions;
+
+  /*
+   * Fetch the basic blocks that can execute after the one of @i.
+   */
+  auto bb = i->getParent();
+  auto scc = this->blockSCC.at(bb);
+  auto &reachable = this->reachableSCCs[scc];
+
+  /*
+   * If the basic block of @i is not in a cycle, then only the instructions
+   * that follow @i within its basic block can be reached.
+   * Otherwise, all its instructions are added together with the rest of the
+   * cycle.
+   */
+  if (!reachable.test(scc)) {
+    auto blockIt = this->blockInstructions.find(bb);
+    if (blockIt != this->blockInstructions.end()) {
+      auto position = this->positions.at(i);
+      for (auto inst : blockIt->second) {
+        if (this->positions.at(inst) > position) {
+          reachableInstructions.push_back(inst);
+        }
+      }
+    }
+  }
+
+  /*
+   * Add the instructions of the basic blocks reachable through at least one
+   * CFG edge.
+   */
+  for (auto reachableSCC : reachable.set_bits()) {
+    for (auto reachableBB : this->sccBlocks[reachableSCC]) {
+      auto blockIt = this->blockInstructions.find(reachableBB);
+      if (blockIt == this->blockInstructions.end()) {
+        continue;
+      }
+      reachableInstructions.insert(reachableInstructions.end(),
+                                   blockIt->second.begin(),
+                                   blockIt->second.end());
+    }
+  }
+
+  return reachableInstructions;
+}
+
+bool InstructionReachability::canReach(Instruction *from,
+                                       Instruction *to) const {
+  if (this->assumeEverythingIsReachable) {
+    return true;
+  }
+
+  auto fromSCC = this->blockSCC.at(from->getParent());
+  auto toSCC = this->blockSCC.at(to->getParent());
+  auto &reachable = this->reachableSCCs[fromSCC];
+  if ((from->getParent() == to->getParent()) && (!reachable.test(fromSCC))) {
+    return this->positions.at(to) > this->positions.at(from);
+  }
+
+  return reachable.test(toSCC);
+}
+
+void InstructionReachability::computeSCCs(void) {
+
+  /*
+   * Identify the SCCs of the CFG.
+   *
+   * scc_iterator only visits the basic blocks reachable from where it starts,
+   * so we start from every basic block not visited yet (e.g., unreachable
+   * ones). SCCs are generated in post-order (successors first), which is the
+   * order of their IDs.
+   */
+  for (auto &bb : *this->f) {
+    if (this->blockSCC.find(&bb) != this->blockSCC.end()) {
+      continue;
+    }
+    for (auto sccIt = scc_begin(&bb); !sccIt.isAtEnd(); ++sccIt) {
+      auto &blocks = *sccIt;
+
+      /*
+       * Check if the SCC has been identified by a previous traversal.
+       */
+      if (this->blockSCC.find(blocks.front()) != this->blockSCC.end()) {
+        continue;
+      }
+
+      /*
+       * Add the new SCC.
+       */
+      uint32_t sccID = this->sccBlocks.size();
+      for (auto block : blocks) {
+        this->blockSCC[block] = sccID;
+      }
+      this->sccBlocks.push_back(blocks);
+    }
+  }
+
+  return;
+}
+
+void InstructionReachability::computeReachableSCCs(void) {
+  auto numberOfSCCs = this->sccBlocks.size();
+
+  /*
+   * Successors of an SCC have smaller IDs, so their reachable sets are
+   * complete by the time they are needed.
+   */
+  for (auto sccID = 0u; sccID < numberOfSCCs; sccID++) {
+    BitVector reachable(numberOfSCCs);
+    for (auto bb : this->sccBlocks[sccID]) {
+      for (auto succBB : successors(bb)) {
+        auto succSCC = this->blockSCC.at(succBB);
+        reachable.set(succSCC);
+        if (succSCC == sccID) {
+          continue;
+        }
+        assert(succSCC < sccID);
+        reachable |= this->reachableSCCs[succSCC];
+      }
+    }
+    this->reachableSCCs.push_back(std::move(reachable));
+  }
+
+  return;
+}
+
+} // namespace llvm::noelle
@@ -0,0 +1,110 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/DGBase.hpp"
+#include "noelle/core/LoopStructure.hpp"
+
+namespace llvm::noelle {
+
+/*
+ * Remedy of a memory dependence that the dependence profiler never observed.
+ *
+ * A remedy with neverObserved set to true covers a dependence that never
+ * manifested in the profiled runs. Otherwise, the dependence manifested, but
+ * only within single iterations of the loop the remedy has been computed for.
+ */
+class DependenceProfileRemedy : public Remedy {
+public:
+  static const unsigned long PROFILE_REMEDY_COST = 100;
+
+  DependenceProfileRemedy(DGEdge<Value> *edge, bool neverObserved);
+
+  bool compare(const Remedy_ptr rhs) const override;
+
+  StringRef getRemedyName() const override;
+
+  bool wasNeverObserved(void) const;
+
+private:
+  bool neverObserved;
+};
+
+/*
+ * Query interface to the memory dependence profile embedded into the IR by
+ * noelle-meta-deps-prof-embed.
+ */
+class DependenceProfile {
+public:
+  /*
+   * Return true if a dependence profile has been embedded into @M.
+   */
+  static bool isAvailable(Module &M);
+
+  /*
+   * Return true if the profile of @inst can be trusted.
+   *
+   * This is the case when @inst executed during the profiled runs and all
+   * memory it can access (including the one accessed by its callees) was
+   * instrumented.
+   */
+  static bool canBeTrusted(Instruction *inst);
+
+  /*
+   * Return true if a dependence of type @type from @from to @to manifested
+   * during the profiled runs.
+   */
+  static bool wasObserved(Instruction *from,
+                          Instruction *to,
+                          DataDependenceType type);
+
+  /*
+   * Return true if a dependence of type @type from @from to @to manifested
+   * across iterations of @loop during the profiled runs.
+   */
+  static bool wasObservedAsLoopCarried(Instruction *from,
+                                       Instruction *to,
+                                       DataDependenceType type,
+                                       LoopStructure *loop);
+
+  /*
+   * Metadata used to embed the profile.
+   */
+  static const std::string MODULE_METADATA;
+  static const std::string INSTRUCTION_ID_METADATA;
+  static const std::string EXECUTED_METADATA;
+  static const std::string COMPLETE_METADATA;
+  static const std::string DEPENDENCES_METADATA;
+  static const std::string LOOP_ID_METADATA;
+
+  static std::string getDependenceTypeName(DataDependenceType type);
+
+private:
+  static MDNode *fetchObservedDependence(Instruction *from,
+                                         Instruction *to,
+                                         DataDependenceType type);
+
+  static uint64_t fetchID(Instruction *inst, const std::string &metadataName);
+};
+
+} // namespace llvm::noelle
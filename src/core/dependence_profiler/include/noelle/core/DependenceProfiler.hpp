@@ -0,0 +1,125 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/DependenceProfile.hpp"
+#include "noelle/core/LoopProfiler.hpp"
+
+namespace llvm::noelle {
+
+/*
+ * Instructions and loops of a module numbered in the same way by the
+ * instrumenter and by the embedder of the memory dependence profile.
+ * Loops are numbered as done by the loop profiler.
+ *
+ * IDs start from 1 as 0 is reserved to mean "none".
+ */
+class DependenceProfilerNumbering {
+public:
+  DependenceProfilerNumbering(
+      Module &M,
+      std::function<LoopInfo &(Function &F)> getLoopInfo);
+
+  /*
+   * Return true if @inst can access memory and therefore must be profiled.
+   */
+  static bool isProfiled(Instruction *inst);
+
+  std::vector<Instruction *> instructions;
+
+  std::unordered_map<Instruction *, uint64_t> instructionIDs;
+
+  /*
+   * ID of the innermost loop that includes each instruction (indexed by
+   * instruction ID).
+   */
+  std::vector<uint64_t> innermostLoopOfInstruction;
+
+  LoopProfilerNumbering loops;
+};
+
+/*
+ * Inject the calls to the memory dependence profiler runtime.
+ */
+class DependenceProfilerInstrumenter : public ModulePass {
+public:
+  static char ID;
+
+  DependenceProfilerInstrumenter();
+
+  bool doInitialization(Module &M) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+  bool runOnModule(Module &M) override;
+
+private:
+  void instrumentInstruction(Instruction *inst,
+                             uint64_t instID,
+                             const DataLayout &DL);
+
+  void instrumentLoop(BasicBlock *header,
+                      const std::vector<BasicBlock *> &entries,
+                      uint64_t loopID);
+
+  void instrumentFunction(Function &F);
+
+  void instrumentEntryPoint(Function &mainF,
+                            DependenceProfilerNumbering &numbering);
+
+  Constant *createTable(Module &M,
+                        const std::vector<uint64_t> &values,
+                        const std::string &name);
+
+  FunctionCallee loadFunction;
+  FunctionCallee storeFunction;
+  FunctionCallee callFunction;
+  FunctionCallee functionEntryFunction;
+  FunctionCallee functionExitFunction;
+  FunctionCallee loopEntryFunction;
+  FunctionCallee loopIterationFunction;
+  FunctionCallee initializeFunction;
+};
+
+/*
+ * Embed the memory dependence profile generated by an instrumented binary.
+ */
+class DependenceProfilerEmbedder : public ModulePass {
+public:
+  static char ID;
+
+  DependenceProfilerEmbedder();
+
+  bool doInitialization(Module &M) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+  bool runOnModule(Module &M) override;
+
+private:
+  std::string profileFileName;
+
+  std::unordered_set<Function *> computeFullyInstrumentedFunctions(Module &M);
+};
+
+} // namespace llvm::noelle
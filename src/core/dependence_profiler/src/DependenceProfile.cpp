@@ -0,0 +1,188 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/DependenceProfile.hpp"
+
+namespace llvm::noelle {
+
+const std::string DependenceProfile::MODULE_METADATA = "noelle.deps.prof";
+const std::string DependenceProfile::INSTRUCTION_ID_METADATA =
+    "noelle.deps.prof.id";
+const std::string DependenceProfile::EXECUTED_METADATA =
+    "noelle.deps.prof.executed";
+const std::string DependenceProfile::COMPLETE_METADATA =
+    "noelle.deps.prof.complete";
+const std::string DependenceProfile::DEPENDENCES_METADATA =
+    "noelle.deps.prof.deps";
+const std::string DependenceProfile::LOOP_ID_METADATA =
+    "noelle.deps.prof.loop.id";
+
+bool DependenceProfile::isAvailable(Module &M) {
+  return M.getNamedMetadata(DependenceProfile::MODULE_METADATA) != nullptr;
+}
+
+bool DependenceProfile::canBeTrusted(Instruction *inst) {
+  if (inst->getMetadata(DependenceProfile::EXECUTED_METADATA) == nullptr) {
+    return false;
+  }
+  if (inst->getMetadata(DependenceProfile::COMPLETE_METADATA) == nullptr) {
+    return false;
+  }
+
+  return true;
+}
+
+bool DependenceProfile::wasObserved(Instruction *from,
+                                    Instruction *to,
+                                    DataDependenceType type) {
+  return DependenceProfile::fetchObservedDependence(from, to, type) != nullptr;
+}
+
+bool DependenceProfile::wasObservedAsLoopCarried(Instruction *from,
+                                                 Instruction *to,
+                                                 DataDependenceType type,
+                                                 LoopStructure *loop) {
+
+  /*
+   * Fetch the dependence.
+   */
+  auto dep = DependenceProfile::fetchObservedDependence(from, to, type);
+  if (dep == nullptr) {
+    return false;
+  }
+
+  /*
+   * Fetch the ID the profiler gave to the loop.
+   * Loops without ID have not been profiled and therefore nothing can be said
+   * about them.
+   */
+  auto loopID = DependenceProfile::fetchID(loop->getHeader()->getTerminator(),
+                                           DependenceProfile::LOOP_ID_METADATA);
+  if (loopID == 0) {
+    return true;
+  }
+
+  /*
+   * Check whether the dependence crossed iterations of the loop.
+   */
+  for (auto i = 2u; i < dep->getNumOperands(); i++) {
+    auto c = cast<ConstantAsMetadata>(dep->getOperand(i))->getValue();
+    if (cast<ConstantInt>(c)->getZExtValue() == loopID) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+std::string DependenceProfile::getDependenceTypeName(DataDependenceType type) {
+  switch (type) {
+    case DG_DATA_RAW:
+      return "RAW";
+    case DG_DATA_WAR:
+      return "WAR";
+    case DG_DATA_WAW:
+      return "WAW";
+    default:
+      return "NONE";
+  }
+}
+
+MDNode *DependenceProfile::fetchObservedDependence(Instruction *from,
+                                                   Instruction *to,
+                                                   DataDependenceType type) {
+
+  /*
+   * Fetch the ID of the source.
+   */
+  auto fromID = DependenceProfile::fetchID(
+      from,
+      DependenceProfile::INSTRUCTION_ID_METADATA);
+  if (fromID == 0) {
+    return nullptr;
+  }
+
+  /*
+   * Fetch the dependences that reached the destination.
+   */
+  auto deps = to->getMetadata(DependenceProfile::DEPENDENCES_METADATA);
+  if (deps == nullptr) {
+    return nullptr;
+  }
+
+  /*
+   * Look for the dependence.
+   *
+   * Each dependence is a tuple (source ID, type, loops carrying it).
+   */
+  auto typeName = DependenceProfile::getDependenceTypeName(type);
+  for (auto &op : deps->operands()) {
+    auto dep = cast<MDNode>(op);
+    auto c = cast<ConstantAsMetadata>(dep->getOperand(0))->getValue();
+    if (cast<ConstantInt>(c)->getZExtValue() != fromID) {
+      continue;
+    }
+    auto depType = cast<MDString>(dep->getOperand(1))->getString();
+    if (depType != typeName) {
+      continue;
+    }
+
+    return dep;
+  }
+
+  return nullptr;
+}
+
+uint64_t DependenceProfile::fetchID(Instruction *inst,
+                                    const std::string &metadataName) {
+  auto md = inst->getMetadata(metadataName);
+  if (md == nullptr) {
+    return 0;
+  }
+  auto c = cast<ConstantAsMetadata>(md->getOperand(0))->getValue();
+
+  return cast<ConstantInt>(c)->getZExtValue();
+}
+
+DependenceProfileRemedy::DependenceProfileRemedy(DGEdge<Value> *edge,
+                                                 bool neverObserved)
+  : neverObserved{ neverObserved } {
+  this->resolvedC.insert(edge);
+  this->cost = DependenceProfileRemedy::PROFILE_REMEDY_COST;
+
+  return;
+}
+
+bool DependenceProfileRemedy::compare(const Remedy_ptr rhs) const {
+  auto otherRemedy = std::static_pointer_cast<DependenceProfileRemedy>(rhs);
+
+  return this->neverObserved < otherRemedy->neverObserved;
+}
+
+StringRef DependenceProfileRemedy::getRemedyName() const {
+  return "dependence-profile-remedy";
+}
+
+bool DependenceProfileRemedy::wasNeverObserved(void) const {
+  return this->neverObserved;
+}
+
+} // namespace llvm::noelle
@@ -0,0 +1,253 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <fstream>
+
+#include "noelle/core/DependenceProfiler.hpp"
+
+namespace llvm::noelle {
+
+DependenceProfilerEmbedder::DependenceProfilerEmbedder() : ModulePass{ ID } {
+  return;
+}
+
+bool DependenceProfilerEmbedder::runOnModule(Module &M) {
+  errs() << "DependenceProfiler: Embed the profile "
+         << this->profileFileName << "\n";
+
+  /*
+   * Number the instructions and loops in the same way the instrumenter did.
+   */
+  auto getLoopInfo = [this](Function &F) -> LoopInfo & {
+    return this->getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo();
+  };
+  DependenceProfilerNumbering numbering(M, getLoopInfo);
+  auto numberOfInstructions = numbering.instructions.size() - 1;
+  auto numberOfLoops = numbering.loops.getNumberOfLoops();
+
+  /*
+   * Open the profile.
+   */
+  std::ifstream profile(this->profileFileName);
+  if (!profile.is_open()) {
+    errs() << "DependenceProfiler: ERROR: cannot open "
+           << this->profileFileName << "\n";
+    return false;
+  }
+
+  /*
+   * Check that the profile has been generated from this module.
+   */
+  std::string tag;
+  uint64_t profiledInstructions = 0;
+  uint64_t profiledLoops = 0;
+  profile >> tag >> profiledInstructions >> profiledLoops;
+  if ((tag != "NOELLE_DEPS_PROF")
+      || (profiledInstructions != numberOfInstructions)
+      || (profiledLoops != numberOfLoops)) {
+    errs() << "DependenceProfiler: ERROR: the profile does not match the "
+              "module\n";
+    return false;
+  }
+
+  /*
+   * Parse the profile.
+   *
+   * "E ID" means the instruction ID executed.
+   * "D SRC DST TYPE N LOOP_1 ... LOOP_N" means the dependence SRC -> DST of
+   * type TYPE manifested and crossed iterations of the N loops listed.
+   */
+  auto &context = M.getContext();
+  auto int64Type = Type::getInt64Ty(context);
+  auto trueMD = MDNode::get(context, MDString::get(context, "true"));
+  std::unordered_map<Instruction *, std::vector<Metadata *>> dependences;
+  uint64_t numberOfDependences = 0;
+  std::string kind;
+  while (profile >> kind) {
+    if (kind == "E") {
+      uint64_t instID;
+      profile >> instID;
+      assert(instID > 0 && instID <= numberOfInstructions);
+      auto inst = numbering.instructions[instID];
+      inst->setMetadata(DependenceProfile::EXECUTED_METADATA, trueMD);
+      continue;
+    }
+    assert(kind == "D");
+
+    uint64_t srcID, dstID, carryingLoops;
+    std::string type;
+    profile >> srcID >> dstID >> type >> carryingLoops;
+    assert(srcID > 0 && srcID <= numberOfInstructions);
+    assert(dstID > 0 && dstID <= numberOfInstructions);
+    std::vector<Metadata *> dep;
+    dep.push_back(ConstantAsMetadata::get(ConstantInt::get(int64Type, srcID)));
+    dep.push_back(MDString::get(context, type));
+    for (auto i = 0u; i < carryingLoops; i++) {
+      uint64_t loopID;
+      profile >> loopID;
+      dep.push_back(
+          ConstantAsMetadata::get(ConstantInt::get(int64Type, loopID)));
+    }
+    auto dst = numbering.instructions[dstID];
+    dependences[dst].push_back(MDNode::get(context, dep));
+    numberOfDependences++;
+  }
+  errs() << "DependenceProfiler:   Dependences observed = "
+         << numberOfDependences << "\n";
+
+  /*
+   * Embed the dependences.
+   */
+  for (auto &pair : dependences) {
+    pair.first->setMetadata(DependenceProfile::DEPENDENCES_METADATA,
+                            MDNode::get(context, pair.second));
+  }
+
+  /*
+   * Embed the IDs of the instructions and tag the ones whose profile is
+   * complete.
+   */
+  auto fullyInstrumented = this->computeFullyInstrumentedFunctions(M);
+  for (auto instID = 1u; instID <= numberOfInstructions; instID++) {
+    auto inst = numbering.instructions[instID];
+    auto idMD = MDNode::get(
+        context,
+        ConstantAsMetadata::get(ConstantInt::get(int64Type, instID)));
+    inst->setMetadata(DependenceProfile::INSTRUCTION_ID_METADATA, idMD);
+
+    /*
+     * Memory accesses are always profiled.
+     * Calls are profiled only if their callee (and everything it invokes) has
+     * been instrumented.
+     */
+    auto call = dyn_cast<CallBase>(inst);
+    if ((call != nullptr) && !isa<MemIntrinsic>(call)) {
+      auto callee = call->getCalledFunction();
+      if (callee == nullptr) {
+        continue;
+      }
+      if (callee->isDeclaration() && !callee->doesNotAccessMemory()) {
+        continue;
+      }
+      if (!callee->isDeclaration()
+          && (fullyInstrumented.find(callee) == fullyInstrumented.end())) {
+        continue;
+      }
+    }
+    inst->setMetadata(DependenceProfile::COMPLETE_METADATA, trueMD);
+  }
+
+  /*
+   * Embed the IDs of the loops.
+   */
+  for (auto loopID = 1u; loopID <= numberOfLoops; loopID++) {
+    auto header = numbering.loops.loopHeaders[loopID];
+    auto headerTerminator = header->getTerminator();
+    auto idMD = MDNode::get(
+        context,
+        ConstantAsMetadata::get(ConstantInt::get(int64Type, loopID)));
+    headerTerminator->setMetadata(DependenceProfile::LOOP_ID_METADATA, idMD);
+  }
+
+  /*
+   * Tag the module.
+   */
+  auto moduleMD = M.getOrInsertNamedMetadata(DependenceProfile::MODULE_METADATA);
+  moduleMD->clearOperands();
+  moduleMD->addOperand(trueMD);
+
+  return true;
+}
+
+std::unordered_set<Function *> DependenceProfilerEmbedder::
+    computeFullyInstrumentedFunctions(Module &M) {
+
+  /*
+   * Start from the functions with a body that only access memory through
+   * instructions that have been instrumented.
+   */
+  std::unordered_set<Function *> fullyInstrumented;
+  for (auto &F : M) {
+    if (F.isDeclaration()) {
+      continue;
+    }
+    auto isComplete = true;
+    for (auto &I : instructions(F)) {
+      if (DependenceProfilerNumbering::isProfiled(&I)) {
+        continue;
+      }
+      if (!I.mayReadOrWriteMemory() || isa<FenceInst>(&I)
+          || isa<DbgInfoIntrinsic>(&I)) {
+        continue;
+      }
+      if (auto intrinsic = dyn_cast<IntrinsicInst>(&I)) {
+        auto intrinsicID = intrinsic->getIntrinsicID();
+        if ((intrinsicID == Intrinsic::lifetime_start)
+            || (intrinsicID == Intrinsic::lifetime_end)) {
+          continue;
+        }
+      }
+      isComplete = false;
+      break;
+    }
+    if (isComplete) {
+      fullyInstrumented.insert(&F);
+    }
+  }
+
+  /*
+   * Remove the functions that invoke code that has not been instrumented until
+   * a fixed point is reached.
+   */
+  auto modified = true;
+  while (modified) {
+    modified = false;
+    for (auto &F : M) {
+      if (fullyInstrumented.find(&F) == fullyInstrumented.end()) {
+        continue;
+      }
+      for (auto &I : instructions(F)) {
+        auto call = dyn_cast<CallBase>(&I);
+        if ((call == nullptr) || isa<IntrinsicInst>(call)) {
+          continue;
+        }
+        auto callee = call->getCalledFunction();
+        auto isComplete = true;
+        if (callee == nullptr) {
+          isComplete = false;
+        } else if (callee->isDeclaration()) {
+          isComplete = callee->doesNotAccessMemory();
+        } else {
+          isComplete = fullyInstrumented.find(callee) != fullyInstrumented.end();
+        }
+        if (!isComplete) {
+          fullyInstrumented.erase(&F);
+          modified = true;
+          break;
+        }
+      }
+    }
+  }
+
+  return fullyInstrumented;
+}
+
+} // namespace llvm::noelle
@@ -0,0 +1,294 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/DependenceProfiler.hpp"
+
+namespace llvm::noelle {
+
+DependenceProfilerInstrumenter::DependenceProfilerInstrumenter()
+  : ModulePass{ ID } {
+  return;
+}
+
+bool DependenceProfilerInstrumenter::runOnModule(Module &M) {
+  errs() << "DependenceProfiler: Instrument the module\n";
+
+  /*
+   * Number the instructions and loops of the module.
+   */
+  auto getLoopInfo = [this](Function &F) -> LoopInfo & {
+    return this->getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo();
+  };
+  DependenceProfilerNumbering numbering(M, getLoopInfo);
+  errs() << "DependenceProfiler:   Instructions to profile = "
+         << (numbering.instructions.size() - 1) << "\n";
+  errs() << "DependenceProfiler:   Loops to profile = "
+         << numbering.loops.getNumberOfLoops() << "\n";
+
+  /*
+   * Declare the runtime.
+   */
+  auto &context = M.getContext();
+  auto voidType = Type::getVoidTy(context);
+  auto int64Type = Type::getInt64Ty(context);
+  auto int8PtrType = Type::getInt8PtrTy(context);
+  auto int64PtrType = Type::getInt64PtrTy(context);
+  this->initializeFunction = M.getOrInsertFunction("noelle_depprof_initialize",
+                                                   voidType,
+                                                   int64Type,
+                                                   int64Type,
+                                                   int64PtrType,
+                                                   int64PtrType);
+  this->loadFunction = M.getOrInsertFunction("noelle_depprof_load",
+                                             voidType,
+                                             int64Type,
+                                             int8PtrType,
+                                             int64Type);
+  this->storeFunction = M.getOrInsertFunction("noelle_depprof_store",
+                                              voidType,
+                                              int64Type,
+                                              int8PtrType,
+                                              int64Type);
+  this->callFunction =
+      M.getOrInsertFunction("noelle_depprof_call", voidType, int64Type);
+  this->functionEntryFunction =
+      M.getOrInsertFunction("noelle_depprof_function_entry", voidType);
+  this->functionExitFunction =
+      M.getOrInsertFunction("noelle_depprof_function_exit", voidType);
+  this->loopEntryFunction =
+      M.getOrInsertFunction("noelle_depprof_loop_entry", voidType, int64Type);
+  this->loopIterationFunction =
+      M.getOrInsertFunction("noelle_depprof_loop_iteration",
+                            voidType,
+                            int64Type);
+
+  /*
+   * Instrument the memory accesses and the calls.
+   */
+  auto &DL = M.getDataLayout();
+  for (auto instID = 1u; instID < numbering.instructions.size(); instID++) {
+    this->instrumentInstruction(numbering.instructions[instID], instID, DL);
+  }
+
+  /*
+   * Instrument the loops.
+   */
+  auto &loops = numbering.loops;
+  for (auto loopID = 1u; loopID <= loops.getNumberOfLoops(); loopID++) {
+    this->instrumentLoop(loops.loopHeaders[loopID],
+                         loops.loopEntries[loopID],
+                         loopID);
+  }
+
+  /*
+   * Instrument the entries and exits of the functions.
+   */
+  for (auto &F : M) {
+    if (F.isDeclaration()) {
+      continue;
+    }
+    this->instrumentFunction(F);
+  }
+
+  /*
+   * Initialize the runtime at the entry point of the program.
+   */
+  auto mainF = M.getFunction("main");
+  if (mainF == nullptr || mainF->isDeclaration()) {
+    errs() << "DependenceProfiler: WARNING: the module has no entry point. "
+              "The runtime will not be initialized\n";
+    return true;
+  }
+  this->instrumentEntryPoint(*mainF, numbering);
+
+  return true;
+}
+
+void DependenceProfilerInstrumenter::instrumentInstruction(
+    Instruction *inst,
+    uint64_t instID,
+    const DataLayout &DL) {
+  IRBuilder<> builder(inst);
+  auto int64Type = builder.getInt64Ty();
+  auto int8PtrType = builder.getInt8PtrTy();
+  auto instIDValue = ConstantInt::get(int64Type, instID);
+
+  /*
+   * Memory accesses.
+   */
+  auto profileAccess = [&](FunctionCallee f, Value *ptr, Value *size) {
+    auto ptrCast = builder.CreatePointerCast(ptr, int8PtrType);
+    auto size64 = builder.CreateZExtOrTrunc(size, int64Type);
+    builder.CreateCall(f, { instIDValue, ptrCast, size64 });
+  };
+  auto sizeOf = [&](Type *t) -> Value * {
+    return ConstantInt::get(int64Type, DL.getTypeStoreSize(t));
+  };
+  if (auto load = dyn_cast<LoadInst>(inst)) {
+    profileAccess(this->loadFunction,
+                  load->getPointerOperand(),
+                  sizeOf(load->getType()));
+    return;
+  }
+  if (auto store = dyn_cast<StoreInst>(inst)) {
+    profileAccess(this->storeFunction,
+                  store->getPointerOperand(),
+                  sizeOf(store->getValueOperand()->getType()));
+    return;
+  }
+  if (auto rmw = dyn_cast<AtomicRMWInst>(inst)) {
+    auto size = sizeOf(rmw->getValOperand()->getType());
+    profileAccess(this->loadFunction, rmw->getPointerOperand(), size);
+    profileAccess(this->storeFunction, rmw->getPointerOperand(), size);
+    return;
+  }
+  if (auto cmpXchg = dyn_cast<AtomicCmpXchgInst>(inst)) {
+    auto size = sizeOf(cmpXchg->getNewValOperand()->getType());
+    profileAccess(this->loadFunction, cmpXchg->getPointerOperand(), size);
+    profileAccess(this->storeFunction, cmpXchg->getPointerOperand(), size);
+    return;
+  }
+  if (auto memTransfer = dyn_cast<MemTransferInst>(inst)) {
+    profileAccess(this->loadFunction,
+                  memTransfer->getRawSource(),
+                  memTransfer->getLength());
+    profileAccess(this->storeFunction,
+                  memTransfer->getRawDest(),
+                  memTransfer->getLength());
+    return;
+  }
+  if (auto memSet = dyn_cast<MemSetInst>(inst)) {
+    profileAccess(this->storeFunction,
+                  memSet->getRawDest(),
+                  memSet->getLength());
+    return;
+  }
+
+  /*
+   * Calls.
+   * The callee (if instrumented) attributes its memory accesses to this call.
+   */
+  assert(isa<CallBase>(inst));
+  builder.CreateCall(this->callFunction, { instIDValue });
+
+  return;
+}
+
+void DependenceProfilerInstrumenter::instrumentLoop(
+    BasicBlock *header,
+    const std::vector<BasicBlock *> &entries,
+    uint64_t loopID) {
+  auto loopIDValue =
+      ConstantInt::get(Type::getInt64Ty(header->getContext()), loopID);
+
+  /*
+   * Notify the runtime when the loop starts.
+   */
+  for (auto entryBB : entries) {
+    IRBuilder<> builder(entryBB->getTerminator());
+    builder.CreateCall(this->loopEntryFunction, { loopIDValue });
+  }
+
+  /*
+   * Notify the runtime when an iteration starts.
+   */
+  IRBuilder<> builder(&*header->getFirstInsertionPt());
+  builder.CreateCall(this->loopIterationFunction, { loopIDValue });
+
+  return;
+}
+
+void DependenceProfilerInstrumenter::instrumentFunction(Function &F) {
+
+  /*
+   * Entry.
+   */
+  auto &entryBB = F.getEntryBlock();
+  IRBuilder<> entryBuilder(&*entryBB.getFirstInsertionPt());
+  entryBuilder.CreateCall(this->functionEntryFunction);
+
+  /*
+   * Exits.
+   */
+  std::vector<Instruction *> exits;
+  for (auto &BB : F) {
+    auto terminator = BB.getTerminator();
+    if (isa<ReturnInst>(terminator) || isa<ResumeInst>(terminator)) {
+      exits.push_back(terminator);
+    }
+  }
+  for (auto exitInst : exits) {
+    IRBuilder<> exitBuilder(exitInst);
+    exitBuilder.CreateCall(this->functionExitFunction);
+  }
+
+  return;
+}
+
+void DependenceProfilerInstrumenter::instrumentEntryPoint(
+    Function &mainF,
+    DependenceProfilerNumbering &numbering) {
+  auto &M = *mainF.getParent();
+
+  /*
+   * Create the tables the runtime needs to find the loops that include each
+   * instruction.
+   */
+  auto innermostLoopTable =
+      this->createTable(M,
+                        numbering.innermostLoopOfInstruction,
+                        "noelle_depprof_innermost_loops");
+  auto parentLoopTable = this->createTable(M,
+                                           numbering.loops.parentLoop,
+                                           "noelle_depprof_parent_loops");
+
+  /*
+   * Initialize the runtime before anything else.
+   */
+  auto &entryBB = mainF.getEntryBlock();
+  IRBuilder<> builder(&*entryBB.getFirstInsertionPt());
+  builder.CreateCall(
+      this->initializeFunction,
+      { builder.getInt64(numbering.instructions.size() - 1),
+        builder.getInt64(numbering.loops.getNumberOfLoops()),
+        innermostLoopTable,
+        parentLoopTable });
+
+  return;
+}
+
+Constant *DependenceProfilerInstrumenter::createTable(
+    Module &M,
+    const std::vector<uint64_t> &values,
+    const std::string &name) {
+  auto &context = M.getContext();
+  auto table = ConstantDataArray::get(context, ArrayRef<uint64_t>(values));
+  auto global = new GlobalVariable(M,
+                                   table->getType(),
+                                   true,
+                                   GlobalValue::PrivateLinkage,
+                                   table,
+                                   name);
+
+  return ConstantExpr::getPointerCast(global, Type::getInt64PtrTy(context));
+}
+
+} // namespace llvm::noelle
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/DependenceProfiler.hpp"
+
+namespace llvm::noelle {
+
+DependenceProfilerNumbering::DependenceProfilerNumbering(
+    Module &M,
+    std::function<LoopInfo &(Function &F)> getLoopInfo)
+  : loops{ M, getLoopInfo } {
+
+  /*
+   * Reserve the ID 0.
+   */
+  this->instructions.push_back(nullptr);
+  this->innermostLoopOfInstruction.push_back(0);
+
+  /*
+   * Number the instructions of the module.
+   */
+  for (auto &F : M) {
+    for (auto &BB : F) {
+      uint64_t innermostLoopID = 0;
+      auto it = this->loops.innermostLoopOfBasicBlock.find(&BB);
+      if (it != this->loops.innermostLoopOfBasicBlock.end()) {
+        innermostLoopID = it->second;
+      }
+      for (auto &I : BB) {
+        if (!DependenceProfilerNumbering::isProfiled(&I)) {
+          continue;
+        }
+        auto instID = this->instructions.size();
+        this->instructions.push_back(&I);
+        this->instructionIDs[&I] = instID;
+        this->innermostLoopOfInstruction.push_back(innermostLoopID);
+      }
+    }
+  }
+
+  return;
+}
+
+bool DependenceProfilerNumbering::isProfiled(Instruction *inst) {
+  if (isa<LoadInst>(inst) || isa<StoreInst>(inst)
+      || isa<AtomicRMWInst>(inst) || isa<AtomicCmpXchgInst>(inst)) {
+    return true;
+  }
+  if (isa<MemIntrinsic>(inst)) {
+    return true;
+  }
+  if (isa<IntrinsicInst>(inst)) {
+    return false;
+  }
+  if (isa<CallBase>(inst)) {
+    return true;
+  }
+
+  return false;
+}
+
+} // namespace llvm::noelle
@@ -0,0 +1,65 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/DependenceProfiler.hpp"
+
+namespace llvm::noelle {
+
+static cl::opt<std::string> DependenceProfileFile(
+    "noelle-deps-prof-file",
+    cl::init("noelle_deps.prof"),
+    cl::desc("File generated by a binary instrumented by noelle-prof-deps"));
+
+bool DependenceProfilerInstrumenter::doInitialization(Module &M) {
+  return false;
+}
+
+void DependenceProfilerInstrumenter::getAnalysisUsage(
+    AnalysisUsage &AU) const {
+  AU.addRequired<LoopInfoWrapperPass>();
+
+  return;
+}
+
+bool DependenceProfilerEmbedder::doInitialization(Module &M) {
+  this->profileFileName = DependenceProfileFile.getValue();
+
+  return false;
+}
+
+void DependenceProfilerEmbedder::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<LoopInfoWrapperPass>();
+
+  return;
+}
+
+// Next there is code to register your passes to "opt"
+char DependenceProfilerInstrumenter::ID = 0;
+static RegisterPass<DependenceProfilerInstrumenter> X(
+    "DependenceProfilerInstrumenter",
+    "Inject the memory dependence profiler");
+
+char DependenceProfilerEmbedder::ID = 0;
+static RegisterPass<DependenceProfilerEmbedder> Y(
+    "DependenceProfilerEmbedder",
+    "Embed the memory dependence profile");
+
+} // namespace llvm::noelle
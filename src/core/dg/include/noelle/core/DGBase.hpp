@@ -328,6 +328,7 @@ public:
       isControl(false),
       isLoopCarried(false),
       isRemovable(false),
+      distance{ 0 },
       dataDepType{ DG_DATA_NONE },
       remeds(nullptr) {
     return;
@@ -409,6 +410,15 @@ public:
     return (remeds) ? std::make_optional<SetOfRemedies>(*remeds) : std::nullopt;
   }
 
+  /*
+   * Loop-carried memory dependences whose two accesses can only touch the same
+   * location in iterations exactly N apart carry the distance N.
+   * A distance of 0 means the distance is unknown.
+   */
+  uint32_t getDependenceDistance() const {
+    return distance;
+  }
+
   void setControl(bool ctrl) {
     isControl = ctrl;
   }
@@ -432,6 +442,9 @@ public:
   void setRemovable(bool rem) {
     isRemovable = rem;
   }
+  void setDependenceDistance(uint32_t d) {
+    distance = d;
+  }
 
   void setEdgeAttributes(bool mem,
                          bool must,
@@ -450,6 +463,20 @@ public:
   void addSubEdge(DGEdge<SubT> *edge) {
     subEdges.insert(edge);
     isLoopCarried |= edge->isLoopCarriedDependence();
+
+    /*
+     * The distance of the aggregated edge is the shortest distance of its
+     * sub-edges, and it is unknown as soon as one of them is unknown.
+     */
+    auto subDistance = edge->getDependenceDistance();
+    if (subEdges.size() == 1) {
+      distance = subDistance;
+    } else if ((distance != 0) && (subDistance != 0)) {
+      distance = std::min(distance, subDistance);
+    } else {
+      distance = 0;
+    }
+
     if (edge->isRemovableDependence()
         && (subEdges.size() == 1 || this->isRemovableDependence())) {
       isRemovable = true;
@@ -472,6 +499,7 @@ public:
     setLoopCarried(false);
     remeds = nullptr;
     setRemovable(false);
+    setDependenceDistance(0);
   }
 
   std::string toString();
@@ -499,6 +527,7 @@ protected:
   bool isControl;
   bool isLoopCarried;
   bool isRemovable;
+  uint32_t distance;
 
   DataDependenceType dataDepType;
 
@@ -904,6 +933,7 @@ DGEdgeBase<T, SubT>::DGEdgeBase(const DGEdgeBase<T, SubT> &oldEdge) {
   setLoopCarried(oldEdge.isLoopCarriedDependence());
   setRemovable(oldEdge.isRemovableDependence());
   setRemedies(oldEdge.getRemedies());
+  setDependenceDistance(oldEdge.getDependenceDistance());
   for (auto subEdge : oldEdge.subEdges)
     addSubEdge(subEdge);
 }
@@ -943,6 +973,9 @@ std::string DGEdgeBase<T, SubT>::toString() {
   ros << "Attributes: ";
   if (this->isLoopCarried) {
     ros << "Loop-carried ";
+    if (this->distance > 0) {
+      ros << "(distance " << this->distance << ") ";
+    }
   }
   if (this->isControlDependence()) {
     ros << "Control ";
@@ -0,0 +1,188 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/DGBase.hpp"
+
+namespace llvm::noelle {
+
+/*
+ * Strongly connected components of a dependence graph.
+ *
+ * The components are computed with an iterative version of Tarjan's algorithm
+ * that runs on dense node indices: the adjacency of the graph is first packed
+ * in flat arrays (CSR format) and then visited once without recursion.
+ *
+ * Components are returned in reverse topological order (like
+ * llvm::scc_iterator): if there is an edge from component A to component B,
+ * then B comes before A.
+ */
+template <class T>
+class DGStronglyConnectedComponents {
+public:
+  typedef std::vector<DGNode<T> *> Component;
+
+  /*
+   * Compute the strongly connected components of the graph composed by
+   * @nodes.
+   * Only edges between nodes of @nodes for which @includeEdge returns true are
+   * considered (all of them if @includeEdge is nullptr).
+   */
+  static std::vector<Component> compute(
+      const std::vector<DGNode<T> *> &nodes,
+      std::function<bool(DGEdge<T> *)> includeEdge);
+
+  /*
+   * Compute the strongly connected components of all nodes of @graph.
+   */
+  static std::vector<Component> compute(DG<T> &graph);
+};
+
+template <class T>
+std::vector<typename DGStronglyConnectedComponents<T>::Component>
+DGStronglyConnectedComponents<T>::compute(
+    const std::vector<DGNode<T> *> &nodes,
+    std::function<bool(DGEdge<T> *)> includeEdge) {
+  std::vector<Component> components;
+  const uint32_t numberOfNodes = nodes.size();
+  if (numberOfNodes == 0) {
+    return components;
+  }
+
+  /*
+   * Assign a dense index to every node.
+   */
+  std::unordered_map<DGNode<T> *, uint32_t> nodeIndexes;
+  nodeIndexes.reserve(numberOfNodes);
+  for (uint32_t i = 0; i < numberOfNodes; i++) {
+    nodeIndexes[nodes[i]] = i;
+  }
+
+  /*
+   * Pack the adjacency of the graph in flat arrays.
+   * The successors of node i are successors[offsets[i], offsets[i+1]).
+   */
+  std::vector<uint32_t> offsets(numberOfNodes + 1, 0);
+  std::vector<uint32_t> successors;
+  for (uint32_t i = 0; i < numberOfNodes; i++) {
+    offsets[i] = successors.size();
+    for (auto edge : nodes[i]->getOutgoingEdges()) {
+      if (includeEdge && !includeEdge(edge)) {
+        continue;
+      }
+      auto succIt = nodeIndexes.find(edge->getIncomingNode());
+      if (succIt == nodeIndexes.end()) {
+        continue;
+      }
+      successors.push_back(succIt->second);
+    }
+  }
+  offsets[numberOfNodes] = successors.size();
+
+  /*
+   * Iterative Tarjan.
+   *
+   * @visitIndex is the DFS pre-order number of a node (UNVISITED if the node
+   * has not been reached yet) and @lowLink is the smallest pre-order number
+   * reachable from the node through nodes that are still on the stack.
+   */
+  const uint32_t UNVISITED = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> visitIndex(numberOfNodes, UNVISITED);
+  std::vector<uint32_t> lowLink(numberOfNodes, 0);
+  std::vector<bool> onStack(numberOfNodes, false);
+  std::vector<uint32_t> sccStack;
+  std::vector<std::pair<uint32_t, uint32_t>> dfsStack;
+  uint32_t nextVisitIndex = 0;
+
+  auto visit = [&](uint32_t n) {
+    visitIndex[n] = nextVisitIndex;
+    lowLink[n] = nextVisitIndex;
+    nextVisitIndex++;
+    sccStack.push_back(n);
+    onStack[n] = true;
+    dfsStack.push_back(std::make_pair(n, offsets[n]));
+  };
+
+  for (uint32_t root = 0; root < numberOfNodes; root++) {
+    if (visitIndex[root] != UNVISITED) {
+      continue;
+    }
+    visit(root);
+
+    while (!dfsStack.empty()) {
+      auto n = dfsStack.back().first;
+      auto nextSuccessor = dfsStack.back().second;
+
+      /*
+       * Visit the next successor of @n.
+       */
+      if (nextSuccessor < offsets[n + 1]) {
+        dfsStack.back().second++;
+        auto succ = successors[nextSuccessor];
+        if (visitIndex[succ] == UNVISITED) {
+          visit(succ);
+        } else if (onStack[succ]) {
+          lowLink[n] = std::min(lowLink[n], visitIndex[succ]);
+        }
+        continue;
+      }
+
+      /*
+       * All successors of @n have been visited.
+       * Check if @n is the root of a component.
+       */
+      dfsStack.pop_back();
+      if (lowLink[n] == visitIndex[n]) {
+        Component component;
+        uint32_t member;
+        do {
+          member = sccStack.back();
+          sccStack.pop_back();
+          onStack[member] = false;
+          component.push_back(nodes[member]);
+        } while (member != n);
+        components.push_back(std::move(component));
+      }
+
+      /*
+       * Propagate the low link to the parent of @n in the DFS tree.
+       */
+      if (!dfsStack.empty()) {
+        auto parent = dfsStack.back().first;
+        lowLink[parent] = std::min(lowLink[parent], lowLink[n]);
+      }
+    }
+  }
+
+  return components;
+}
+
+template <class T>
+std::vector<typename DGStronglyConnectedComponents<T>::Component>
+DGStronglyConnectedComponents<T>::compute(DG<T> &graph) {
+  std::vector<DGNode<T> *> nodes{ graph.begin_nodes(), graph.end_nodes() };
+
+  return compute(nodes, nullptr);
+}
+
+} // namespace llvm::noelle
@@ -24,6 +24,7 @@
 #include "noelle/core/SystemHeaders.hpp"
 #include "noelle/core/LoopStructure.hpp"
 #include "noelle/core/SCC.hpp"
+#include "noelle/core/LoopHistogram.hpp"
 
 namespace llvm::noelle {
 
@@ -121,6 +122,25 @@ public:
 
   double getAverageTotalInstructionsPerIteration(LoopStructure *loop) const;
 
+  /*
+   * Return the histogram of the iterations executed per invocation of @loop.
+   * Return nullptr if @loop has not been profiled by noelle-prof-loops.
+   */
+  const LoopHistogram *getIterationsPerInvocationHistogram(
+      LoopStructure *loop) const;
+
+  /*
+   * Return the histogram of the instructions (including the ones executed by
+   * the callees) executed per iteration of @loop.
+   * Return nullptr if @loop has not been profiled by noelle-prof-loops.
+   */
+  const LoopHistogram *getTotalInstructionsPerIterationHistogram(
+      LoopStructure *loop) const;
+
+  void setLoopHistograms(BasicBlock *header,
+                         const LoopHistogram &iterationsPerInvocation,
+                         const LoopHistogram &instructionsPerIteration);
+
   /*
    * =========================== Functions ==================================
    */
@@ -172,6 +192,8 @@ private:
   std::unordered_map<Function *, uint64_t> functionSelfInstructions;
   std::unordered_map<Function *, uint64_t> functionTotalInstructions;
   std::unordered_map<Instruction *, uint64_t> instructionTotalInstructions;
+  std::unordered_map<BasicBlock *, LoopHistogram> loopIterationsHistograms;
+  std::unordered_map<BasicBlock *, LoopHistogram> loopInstructionsHistograms;
   uint64_t moduleNumberOfInstructionsExecuted;
 
   void computeTotalInstructions(Module &M);
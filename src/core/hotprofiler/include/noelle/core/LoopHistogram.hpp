@@ -0,0 +1,70 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+
+namespace llvm::noelle {
+
+/*
+ * Histogram with logarithmic buckets.
+ *
+ * Bucket 0 counts the samples equal to 0, and bucket i > 0 counts the samples
+ * in [2^(i-1), 2^i - 1].
+ */
+class LoopHistogram {
+public:
+  LoopHistogram();
+
+  LoopHistogram(const std::vector<uint64_t> &samplesPerBucket);
+
+  uint64_t getNumberOfSamples(void) const;
+
+  uint32_t getNumberOfBuckets(void) const;
+
+  uint64_t getSamples(uint32_t bucket) const;
+
+  /*
+   * Return the lower bound of the bucket that includes the sample at
+   * @percentile (between 0 and 100).
+   */
+  uint64_t getPercentile(double percentile) const;
+
+  /*
+   * Return the fraction of samples that are certainly lower than @value.
+   *
+   * @return Between 0 and 1
+   */
+  double getFractionOfSamplesBelow(uint64_t value) const;
+
+  static uint32_t getBucket(uint64_t value);
+
+  static uint64_t getBucketLowerBound(uint32_t bucket);
+
+  static uint64_t getBucketUpperBound(uint32_t bucket);
+
+private:
+  std::vector<uint64_t> samples;
+  uint64_t totalSamples;
+};
+
+} // namespace llvm::noelle
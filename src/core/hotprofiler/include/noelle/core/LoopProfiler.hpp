@@ -0,0 +1,110 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/LoopHistogram.hpp"
+
+namespace llvm::noelle {
+
+/*
+ * Loops of a module numbered in the same way by the instrumenters and by the
+ * embedders of the profilers (loop profiler and memory dependence profiler).
+ *
+ * IDs start from 1 as 0 is reserved to mean "none".
+ */
+class LoopProfilerNumbering {
+public:
+  LoopProfilerNumbering(Module &M,
+                        std::function<LoopInfo &(Function &F)> getLoopInfo);
+
+  uint64_t getNumberOfLoops(void) const;
+
+  /*
+   * Header of each loop and the basic blocks outside the loop that jump to it
+   * (indexed by loop ID).
+   * Loops are not kept as LoopInfo is released when moving to another
+   * function.
+   */
+  std::vector<BasicBlock *> loopHeaders;
+
+  std::vector<std::vector<BasicBlock *>> loopEntries;
+
+  /*
+   * ID of the parent of each loop (indexed by loop ID) and ID of the innermost
+   * loop that includes each basic block (basic blocks outside loops are not
+   * included).
+   */
+  std::vector<uint64_t> parentLoop;
+
+  std::unordered_map<BasicBlock *, uint64_t> innermostLoopOfBasicBlock;
+};
+
+/*
+ * Inject the code that collects the histograms of iterations per invocation
+ * and of instructions per iteration of every loop.
+ */
+class LoopProfilerInstrumenter : public ModulePass {
+public:
+  static char ID;
+
+  LoopProfilerInstrumenter();
+
+  bool doInitialization(Module &M) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+  bool runOnModule(Module &M) override;
+};
+
+/*
+ * Embed the histograms generated by a binary instrumented by
+ * LoopProfilerInstrumenter.
+ */
+class LoopProfilerEmbedder : public ModulePass {
+public:
+  static char ID;
+
+  LoopProfilerEmbedder();
+
+  bool doInitialization(Module &M) override;
+
+  void getAnalysisUsage(AnalysisUsage &AU) const override;
+
+  bool runOnModule(Module &M) override;
+
+  /*
+   * Metadata attached to the terminator of the header of loops.
+   */
+  static const std::string ITERATIONS_METADATA;
+  static const std::string INSTRUCTIONS_METADATA;
+
+  static MDNode *embedHistogram(LLVMContext &context,
+                                const std::vector<uint64_t> &samples);
+
+  static LoopHistogram fetchHistogram(MDNode *md);
+
+private:
+  std::string profileFileName;
+};
+
+} // namespace llvm::noelle
@@ -21,6 +21,7 @@
  */
 #include "noelle/core/SystemHeaders.hpp"
 #include "noelle/core/HotProfiler.hpp"
+#include "noelle/core/LoopProfiler.hpp"
 
 using namespace llvm;
 using namespace llvm::noelle;
@@ -82,6 +83,24 @@ void HotProfiler::analyzeProfiles(Module &M) {
         this->hot.setBranchFrequency(&bb, succBB, probValue);
       }
     }
+
+    /*
+     * Set the histograms of the loops profiled by noelle-prof-loops.
+     */
+    for (auto &bb : F) {
+      auto terminator = bb.getTerminator();
+      auto iterationsMD =
+          terminator->getMetadata(LoopProfilerEmbedder::ITERATIONS_METADATA);
+      auto instructionsMD =
+          terminator->getMetadata(LoopProfilerEmbedder::INSTRUCTIONS_METADATA);
+      if ((iterationsMD == nullptr) || (instructionsMD == nullptr)) {
+        continue;
+      }
+      this->hot.setLoopHistograms(
+          &bb,
+          LoopProfilerEmbedder::fetchHistogram(iterationsMD),
+          LoopProfilerEmbedder::fetchHistogram(instructionsMD));
+    }
   }
 
   /*
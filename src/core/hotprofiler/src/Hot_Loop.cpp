@@ -196,4 +196,33 @@ uint64_t Hot::getIterations(LoopStructure *l) const {
   return loopIterations;
 }
 
+const LoopHistogram *Hot::getIterationsPerInvocationHistogram(
+    LoopStructure *loop) const {
+  auto it = this->loopIterationsHistograms.find(loop->getHeader());
+  if (it == this->loopIterationsHistograms.end()) {
+    return nullptr;
+  }
+
+  return &it->second;
+}
+
+const LoopHistogram *Hot::getTotalInstructionsPerIterationHistogram(
+    LoopStructure *loop) const {
+  auto it = this->loopInstructionsHistograms.find(loop->getHeader());
+  if (it == this->loopInstructionsHistograms.end()) {
+    return nullptr;
+  }
+
+  return &it->second;
+}
+
+void Hot::setLoopHistograms(BasicBlock *header,
+                            const LoopHistogram &iterationsPerInvocation,
+                            const LoopHistogram &instructionsPerIteration) {
+  this->loopIterationsHistograms[header] = iterationsPerInvocation;
+  this->loopInstructionsHistograms[header] = instructionsPerIteration;
+
+  return;
+}
+
 } // namespace llvm::noelle
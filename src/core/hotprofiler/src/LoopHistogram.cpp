@@ -0,0 +1,121 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopHistogram.hpp"
+
+namespace llvm::noelle {
+
+LoopHistogram::LoopHistogram() : totalSamples{ 0 } {
+  return;
+}
+
+LoopHistogram::LoopHistogram(const std::vector<uint64_t> &samplesPerBucket)
+  : samples{ samplesPerBucket },
+    totalSamples{ 0 } {
+  for (auto s : this->samples) {
+    this->totalSamples += s;
+  }
+
+  return;
+}
+
+uint64_t LoopHistogram::getNumberOfSamples(void) const {
+  return this->totalSamples;
+}
+
+uint32_t LoopHistogram::getNumberOfBuckets(void) const {
+  return this->samples.size();
+}
+
+uint64_t LoopHistogram::getSamples(uint32_t bucket) const {
+  if (bucket >= this->samples.size()) {
+    return 0;
+  }
+
+  return this->samples[bucket];
+}
+
+uint64_t LoopHistogram::getPercentile(double percentile) const {
+  if (this->totalSamples == 0) {
+    return 0;
+  }
+
+  /*
+   * Find the bucket that includes the sample at @percentile.
+   */
+  auto target = (percentile / 100.0) * ((double)this->totalSamples);
+  uint64_t samplesSoFar = 0;
+  for (auto b = 0u; b < this->samples.size(); b++) {
+    samplesSoFar += this->samples[b];
+    if (((double)samplesSoFar) >= target && (this->samples[b] > 0)) {
+      return LoopHistogram::getBucketLowerBound(b);
+    }
+  }
+
+  return LoopHistogram::getBucketLowerBound(this->samples.size() - 1);
+}
+
+double LoopHistogram::getFractionOfSamplesBelow(uint64_t value) const {
+  if (this->totalSamples == 0) {
+    return 0;
+  }
+
+  uint64_t samplesBelow = 0;
+  for (auto b = 0u; b < this->samples.size(); b++) {
+    if (LoopHistogram::getBucketUpperBound(b) >= value) {
+      break;
+    }
+    samplesBelow += this->samples[b];
+  }
+
+  return ((double)samplesBelow) / ((double)this->totalSamples);
+}
+
+uint32_t LoopHistogram::getBucket(uint64_t value) {
+  uint32_t bucket = 0;
+  while (value > 0) {
+    bucket++;
+    value >>= 1;
+  }
+
+  return bucket;
+}
+
+uint64_t LoopHistogram::getBucketLowerBound(uint32_t bucket) {
+  if (bucket == 0) {
+    return 0;
+  }
+
+  return ((uint64_t)1) << (bucket - 1);
+}
+
+uint64_t LoopHistogram::getBucketUpperBound(uint32_t bucket) {
+  if (bucket == 0) {
+    return 0;
+  }
+  if (bucket >= 64) {
+    return UINT64_MAX;
+  }
+
+  return (((uint64_t)1) << bucket) - 1;
+}
+
+} // namespace llvm::noelle
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopProfiler.hpp"
+
+namespace llvm::noelle {
+
+const std::string LoopProfilerEmbedder::ITERATIONS_METADATA =
+    "noelle.prof.loop.iterations";
+const std::string LoopProfilerEmbedder::INSTRUCTIONS_METADATA =
+    "noelle.prof.loop.instructions";
+
+LoopProfilerNumbering::LoopProfilerNumbering(
+    Module &M,
+    std::function<LoopInfo &(Function &F)> getLoopInfo) {
+
+  /*
+   * Reserve the ID 0.
+   */
+  this->loopHeaders.push_back(nullptr);
+  this->loopEntries.push_back({});
+  this->parentLoop.push_back(0);
+
+  for (auto &F : M) {
+    if (F.isDeclaration()) {
+      continue;
+    }
+
+    /*
+     * The loop info of @F must be consumed before fetching the one of another
+     * function.
+     */
+    auto &LI = getLoopInfo(F);
+    std::unordered_map<Loop *, uint64_t> loopIDs;
+    for (auto loop : LI.getLoopsInPreorder()) {
+      auto loopID = this->loopHeaders.size();
+      loopIDs[loop] = loopID;
+
+      /*
+       * Keep the header and its predecessors that are outside the loop.
+       */
+      auto header = loop->getHeader();
+      this->loopHeaders.push_back(header);
+      std::vector<BasicBlock *> entries;
+      for (auto predBB : predecessors(header)) {
+        if (loop->contains(predBB)) {
+          continue;
+        }
+        if (std::find(entries.begin(), entries.end(), predBB)
+            != entries.end()) {
+          continue;
+        }
+        entries.push_back(predBB);
+      }
+      this->loopEntries.push_back(entries);
+
+      /*
+       * Parent loop.
+       * Loops are visited in pre-order, so the parent is already numbered.
+       */
+      uint64_t parentLoopID = 0;
+      if (auto parent = loop->getParentLoop()) {
+        parentLoopID = loopIDs.at(parent);
+      }
+      this->parentLoop.push_back(parentLoopID);
+    }
+
+    /*
+     * Map the basic blocks to their innermost loop.
+     */
+    for (auto &BB : F) {
+      if (auto loop = LI.getLoopFor(&BB)) {
+        this->innermostLoopOfBasicBlock[&BB] = loopIDs.at(loop);
+      }
+    }
+  }
+
+  return;
+}
+
+uint64_t LoopProfilerNumbering::getNumberOfLoops(void) const {
+  return this->loopHeaders.size() - 1;
+}
+
+MDNode *LoopProfilerEmbedder::embedHistogram(
+    LLVMContext &context,
+    const std::vector<uint64_t> &samples) {
+  auto int64Type = Type::getInt64Ty(context);
+  std::vector<Metadata *> buckets;
+  for (auto s : samples) {
+    buckets.push_back(ConstantAsMetadata::get(ConstantInt::get(int64Type, s)));
+  }
+
+  return MDNode::get(context, buckets);
+}
+
+LoopHistogram LoopProfilerEmbedder::fetchHistogram(MDNode *md) {
+  std::vector<uint64_t> samples;
+  for (auto &op : md->operands()) {
+    auto c = cast<ConstantAsMetadata>(op)->getValue();
+    samples.push_back(cast<ConstantInt>(c)->getZExtValue());
+  }
+
+  return LoopHistogram(samples);
+}
+
+} // namespace llvm::noelle
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <fstream>
+
+#include "noelle/core/LoopProfiler.hpp"
+
+namespace llvm::noelle {
+
+LoopProfilerEmbedder::LoopProfilerEmbedder() : ModulePass{ ID } {
+  return;
+}
+
+bool LoopProfilerEmbedder::runOnModule(Module &M) {
+  errs() << "LoopProfiler: Embed the profile " << this->profileFileName
+         << "\n";
+
+  /*
+   * Number the loops in the same way the instrumenter did.
+   */
+  auto getLoopInfo = [this](Function &F) -> LoopInfo & {
+    return this->getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo();
+  };
+  LoopProfilerNumbering numbering(M, getLoopInfo);
+
+  /*
+   * Open the profile.
+   */
+  std::ifstream profile(this->profileFileName);
+  if (!profile.is_open()) {
+    errs() << "LoopProfiler: ERROR: cannot open " << this->profileFileName
+           << "\n";
+    return false;
+  }
+
+  /*
+   * Check that the profile has been generated from this module.
+   */
+  std::string tag;
+  uint64_t profiledLoops = 0;
+  profile >> tag >> profiledLoops;
+  if ((tag != "NOELLE_LOOP_PROF")
+      || (profiledLoops != numbering.getNumberOfLoops())) {
+    errs() << "LoopProfiler: ERROR: the profile does not match the module\n";
+    return false;
+  }
+
+  /*
+   * Embed the histograms.
+   *
+   * Each line is "L ID N ITERATIONS_BUCKETS M INSTRUCTIONS_BUCKETS".
+   */
+  auto &context = M.getContext();
+  std::string kind;
+  while (profile >> kind) {
+    assert(kind == "L");
+    uint64_t loopID;
+    profile >> loopID;
+    assert((loopID > 0) && (loopID <= numbering.getNumberOfLoops()));
+
+    auto fetchBuckets = [&profile](void) -> std::vector<uint64_t> {
+      uint64_t buckets;
+      profile >> buckets;
+      std::vector<uint64_t> samples(buckets, 0);
+      for (auto b = 0u; b < buckets; b++) {
+        profile >> samples[b];
+      }
+      return samples;
+    };
+    auto iterations = fetchBuckets();
+    auto instructions = fetchBuckets();
+
+    auto headerTerminator = numbering.loopHeaders[loopID]->getTerminator();
+    headerTerminator->setMetadata(
+        LoopProfilerEmbedder::ITERATIONS_METADATA,
+        LoopProfilerEmbedder::embedHistogram(context, iterations));
+    headerTerminator->setMetadata(
+        LoopProfilerEmbedder::INSTRUCTIONS_METADATA,
+        LoopProfilerEmbedder::embedHistogram(context, instructions));
+  }
+
+  return true;
+}
+
+} // namespace llvm::noelle
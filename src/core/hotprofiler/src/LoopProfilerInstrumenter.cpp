@@ -0,0 +1,131 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopProfiler.hpp"
+
+namespace llvm::noelle {
+
+LoopProfilerInstrumenter::LoopProfilerInstrumenter() : ModulePass{ ID } {
+  return;
+}
+
+bool LoopProfilerInstrumenter::runOnModule(Module &M) {
+  errs() << "LoopProfiler: Instrument the module\n";
+
+  /*
+   * Number the loops of the module.
+   */
+  auto getLoopInfo = [this](Function &F) -> LoopInfo & {
+    return this->getAnalysis<LoopInfoWrapperPass>(F).getLoopInfo();
+  };
+  LoopProfilerNumbering numbering(M, getLoopInfo);
+  errs() << "LoopProfiler:   Loops to profile = "
+         << numbering.getNumberOfLoops() << "\n";
+
+  /*
+   * Declare the runtime.
+   */
+  auto &context = M.getContext();
+  auto voidType = Type::getVoidTy(context);
+  auto int64Type = Type::getInt64Ty(context);
+  auto initializeFunction =
+      M.getOrInsertFunction("noelle_loopprof_initialize", voidType, int64Type);
+  auto loopEntryFunction =
+      M.getOrInsertFunction("noelle_loopprof_loop_entry", voidType, int64Type);
+  auto loopIterationFunction =
+      M.getOrInsertFunction("noelle_loopprof_loop_iteration",
+                            voidType,
+                            int64Type);
+  auto instructionsCounter =
+      M.getOrInsertGlobal("noelle_loopprof_instructions", int64Type);
+
+  /*
+   * The counter is per thread (see the runtime).
+   */
+  if (auto counterGlobal = dyn_cast<GlobalVariable>(instructionsCounter)) {
+    counterGlobal->setThreadLocal(true);
+  }
+
+  /*
+   * Count the instructions executed.
+   *
+   * The counter is updated inline once per basic block to keep the overhead
+   * low. Sizes are fetched before injecting any code.
+   */
+  std::vector<std::pair<BasicBlock *, uint64_t>> basicBlocks;
+  for (auto &F : M) {
+    for (auto &BB : F) {
+      basicBlocks.push_back(std::make_pair(&BB, BB.size()));
+    }
+  }
+  for (auto &pair : basicBlocks) {
+    IRBuilder<> builder(pair.first->getTerminator());
+    auto oldValue = builder.CreateLoad(int64Type, instructionsCounter);
+    auto newValue =
+        builder.CreateAdd(oldValue, ConstantInt::get(int64Type, pair.second));
+    builder.CreateStore(newValue, instructionsCounter);
+  }
+
+  /*
+   * Notify the runtime when a loop starts and when its iterations start.
+   *
+   * A loop starts when control flows from outside the loop to its header.
+   * Hence, the notification is placed on these edges rather than at the end
+   * of the basic blocks they come from (which could also jump elsewhere and
+   * therefore record invocations that never happened).
+   */
+  for (auto i = 1u; i <= numbering.getNumberOfLoops(); i++) {
+    auto loopID = ConstantInt::get(int64Type, i);
+    auto header = numbering.loopHeaders[i];
+    for (auto entryBB : numbering.loopEntries[i]) {
+      auto entryEdgeBB = entryBB;
+      auto entryTerminator = entryBB->getTerminator();
+      if (entryTerminator->getNumSuccessors() > 1) {
+        auto succNum = GetSuccessorNumber(entryBB, header);
+        if (auto newBB = SplitCriticalEdge(entryTerminator, succNum)) {
+          entryEdgeBB = newBB;
+        }
+      }
+      IRBuilder<> builder(entryEdgeBB->getTerminator());
+      builder.CreateCall(loopEntryFunction, { loopID });
+    }
+    IRBuilder<> builder(&*header->getFirstInsertionPt());
+    builder.CreateCall(loopIterationFunction, { loopID });
+  }
+
+  /*
+   * Initialize the runtime at the entry point of the program.
+   */
+  auto mainF = M.getFunction("main");
+  if (mainF == nullptr || mainF->isDeclaration()) {
+    errs() << "LoopProfiler: WARNING: the module has no entry point. The "
+              "runtime will not be initialized\n";
+    return true;
+  }
+  IRBuilder<> builder(&*mainF->getEntryBlock().getFirstInsertionPt());
+  builder.CreateCall(
+      initializeFunction,
+      { ConstantInt::get(int64Type, numbering.getNumberOfLoops()) });
+
+  return true;
+}
+
+} // namespace llvm::noelle
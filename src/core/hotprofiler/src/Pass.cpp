@@ -21,10 +21,16 @@
  */
 #include "noelle/core/SystemHeaders.hpp"
 #include "noelle/core/HotProfiler.hpp"
+#include "noelle/core/LoopProfiler.hpp"
 
 using namespace llvm;
 using namespace llvm::noelle;
 
+static cl::opt<std::string> LoopProfileFile(
+    "noelle-loop-prof-file",
+    cl::init("noelle_loops.prof"),
+    cl::desc("File generated by a binary instrumented by noelle-prof-loops"));
+
 HotProfiler::HotProfiler() : ModulePass(ID), hot{} {
 
   return;
@@ -74,3 +80,35 @@ static RegisterStandardPasses _RegPass2(
         PM.add(_PassMaker = new HotProfiler());
       }
     }); // ** for -O0
+
+bool LoopProfilerInstrumenter::doInitialization(Module &M) {
+  return false;
+}
+
+void LoopProfilerInstrumenter::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<LoopInfoWrapperPass>();
+
+  return;
+}
+
+bool LoopProfilerEmbedder::doInitialization(Module &M) {
+  this->profileFileName = LoopProfileFile.getValue();
+
+  return false;
+}
+
+void LoopProfilerEmbedder::getAnalysisUsage(AnalysisUsage &AU) const {
+  AU.addRequired<LoopInfoWrapperPass>();
+
+  return;
+}
+
+char LoopProfilerInstrumenter::ID = 0;
+static RegisterPass<LoopProfilerInstrumenter> Y(
+    "LoopProfilerInstrumenter",
+    "Inject the profiler of loop iterations and iteration costs");
+
+char LoopProfilerEmbedder::ID = 0;
+static RegisterPass<LoopProfilerEmbedder> Z(
+    "LoopProfilerEmbedder",
+    "Embed the histograms of loop iterations and iteration costs");
@@ -27,6 +27,23 @@
 
 namespace llvm::noelle {
 
+/*
+ * A transformed version of a loop that can be selected at runtime.
+ *
+ * Variant IDs are shared with the runtime (see NOELLE_getLoopVariant): 0 is
+ * the original loop, and the transformation T is 1 + T (e.g., 1 + DOALL_ID).
+ * envOffsetForExitVariable is the offset of the exit variable within envArray
+ * (see LoopEnvironmentBuilder::getOffsetOfEnvironmentVariable).
+ */
+struct TransformedLoopVariant {
+  uint32_t variantID;
+  BasicBlock *startOfLoop;
+  BasicBlock *endOfLoop;
+  Value *envArray;
+  Value *envOffsetForExitVariable;
+  uint32_t minIdleCores;
+};
+
 class Linker {
 public:
   Linker(Module &m, TypesManager *tm);
@@ -36,22 +53,39 @@ public:
       BasicBlock *startOfParLoopInOriginalFunc,
       BasicBlock *endOfParLoopInOriginalFunc,
       Value *envArray,
-      Value *envIndexForExitVariable,
+      Value *envOffsetForExitVariable,
       std::vector<BasicBlock *> &loopExitBlocks,
       uint32_t minIdleCores);
 
+  /*
+   * Link several transformed versions of a loop to the original function.
+   * The version to run is chosen at runtime: the first variant is the default
+   * one, and the original loop runs if the chosen variant cannot start.
+   */
+  void linkTransformedLoopVariantsToOriginalFunction(
+      BasicBlock *originalPreHeader,
+      uint64_t loopID,
+      std::vector<TransformedLoopVariant> &variants,
+      std::vector<BasicBlock *> &loopExitBlocks);
+
   void substituteOriginalLoopWithTransformedLoop(
       LoopStructure *originalLoop,
       BasicBlock *startOfParLoopInOriginalFunc,
       BasicBlock *endOfParLoopInOriginalFunc,
       Value *envArray,
-      Value *envIndexForExitVariable,
+      Value *envOffsetForExitVariable,
       std::vector<BasicBlock *> &loopExitBlocks,
       uint32_t minIdleCores);
 
 private:
   Module &program;
   TypesManager *tm;
+
+  void linkExitOfTransformedLoop(BasicBlock *originalHeader,
+                                 BasicBlock *endOfParLoopInOriginalFunc,
+                                 Value *envArray,
+                                 Value *envOffsetForExitVariable,
+                                 std::vector<BasicBlock *> &loopExitBlocks);
 };
 
 } // namespace llvm::noelle
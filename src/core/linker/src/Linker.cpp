@@ -20,7 +20,6 @@
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "noelle/core/Linker.hpp"
-#include "noelle/core/Architecture.hpp"
 
 namespace llvm::noelle {
 
@@ -34,7 +33,7 @@ void Linker::linkTransformedLoopToOriginalFunction(
     BasicBlock *startOfParLoopInOriginalFunc,
     BasicBlock *endOfParLoopInOriginalFunc,
     Value *envArray,
-    Value *envIndexForExitVariable,
+    Value *envOffsetForExitVariable,
     std::vector<BasicBlock *> &loopExitBlocks,
     uint32_t minIdleCores) {
 
@@ -74,6 +73,123 @@ void Linker::linkTransformedLoopToOriginalFunction(
                                  originalHeader);
   originalTerminator->eraseFromParent();
 
+  /*
+   * Link the end of the transformed loop to the loop exits.
+   */
+  this->linkExitOfTransformedLoop(originalHeader,
+                                  endOfParLoopInOriginalFunc,
+                                  envArray,
+                                  envOffsetForExitVariable,
+                                  loopExitBlocks);
+
+  return;
+}
+
+void Linker::linkTransformedLoopVariantsToOriginalFunction(
+    BasicBlock *originalPreHeader,
+    uint64_t loopID,
+    std::vector<TransformedLoopVariant> &variants,
+    std::vector<BasicBlock *> &loopExitBlocks) {
+  assert(variants.size() > 0);
+
+  /*
+   * Fetch the runtime APIs to invoke.
+   */
+  auto coreChecker = this->program.getFunction("NOELLE_getAvailableCores");
+  assert(coreChecker != nullptr);
+  auto variantSelector = this->program.getFunction("NOELLE_getLoopVariant");
+  assert(variantSelector != nullptr);
+
+  /*
+   * Create the constants.
+   */
+  auto integerType = this->tm->getIntegerType(32);
+  auto int64 = this->tm->getIntegerType(64);
+  auto sequentialVariant = ConstantInt::get(int64, 0);
+  uint64_t availableVariants = 0;
+  for (auto &variant : variants) {
+    availableVariants |= (((uint64_t)1) << variant.variantID);
+  }
+
+  /*
+   * Fetch the terminator of the preheader.
+   */
+  auto originalTerminator = originalPreHeader->getTerminator();
+
+  /*
+   * Fetch the header of the original loop.
+   */
+  auto originalHeader = originalTerminator->getSuccessor(0);
+
+  /*
+   * Ask the runtime which variant to run.
+   */
+  IRBuilder<> loopSwitchBuilder(originalTerminator);
+  auto chosenVariant = loopSwitchBuilder.CreateCall(
+      variantSelector->getFunctionType(),
+      variantSelector,
+      ArrayRef<Value *>(
+          { ConstantInt::get(int64, loopID),
+            ConstantInt::get(int64, availableVariants),
+            ConstantInt::get(int64, variants[0].variantID) }));
+  auto callToCoreChecker =
+      loopSwitchBuilder.CreateCall(coreChecker->getFunctionType(), coreChecker);
+
+  /*
+   * Fall back to the original loop if there are not enough idle cores for the
+   * chosen variant.
+   *
+   * All decisions are taken within the preheader so the header of the original
+   * loop keeps its only predecessor outside the loop.
+   */
+  Value *variantToRun = sequentialVariant;
+  for (auto &variant : variants) {
+    auto variantIDValue = ConstantInt::get(int64, variant.variantID);
+    auto minIdleCoresValue = ConstantInt::get(integerType, variant.minIdleCores);
+    auto isChosen = loopSwitchBuilder.CreateICmpEQ(chosenVariant, variantIDValue);
+    auto canStart =
+        loopSwitchBuilder.CreateICmpUGE(callToCoreChecker, minIdleCoresValue);
+    variantToRun =
+        loopSwitchBuilder.CreateSelect(loopSwitchBuilder.CreateAnd(isChosen,
+                                                                   canStart),
+                                       variantIDValue,
+                                       variantToRun);
+  }
+  auto variantSwitch =
+      loopSwitchBuilder.CreateSwitch(variantToRun, originalHeader);
+  for (auto &variant : variants) {
+    auto variantIDValue =
+        cast<ConstantInt>(ConstantInt::get(int64, variant.variantID));
+    variantSwitch->addCase(variantIDValue, variant.startOfLoop);
+  }
+  originalTerminator->eraseFromParent();
+
+  /*
+   * Link the end of every variant to the loop exits.
+   */
+  for (auto &variant : variants) {
+    this->linkExitOfTransformedLoop(originalHeader,
+                                    variant.endOfLoop,
+                                    variant.envArray,
+                                    variant.envOffsetForExitVariable,
+                                    loopExitBlocks);
+  }
+
+  return;
+}
+
+void Linker::linkExitOfTransformedLoop(
+    BasicBlock *originalHeader,
+    BasicBlock *endOfParLoopInOriginalFunc,
+    Value *envArray,
+    Value *envOffsetForExitVariable,
+    std::vector<BasicBlock *> &loopExitBlocks) {
+
+  /*
+   * Create the constants.
+   */
+  auto integerType = this->tm->getIntegerType(32);
+
   /*
    * Load exit block environment variable and branch to the correct loop exit
    * block
@@ -85,18 +201,13 @@ void Linker::linkTransformedLoopToOriginalFunction(
   } else {
 
     /*
-     * Compute how many values can fit in a cache line.
+     * Fetch the exit variable at its offset within the environment array.
      */
-    auto valuesInCacheLine =
-        Architecture::getCacheLineBytes() / sizeof(int64_t);
-
     auto int64 = this->tm->getIntegerType(64);
     auto exitEnvPtr = endBuilder.CreateInBoundsGEP(
         envArray,
         ArrayRef<Value *>({ cast<Value>(ConstantInt::get(int64, 0)),
-                            endBuilder.CreateMul(
-                                envIndexForExitVariable,
-                                ConstantInt::get(int64, valuesInCacheLine)) }));
+                            envOffsetForExitVariable }));
     auto exitEnvCast =
         endBuilder.CreateIntCast(endBuilder.CreateLoad(exitEnvPtr),
                                  integerType,
@@ -137,7 +248,7 @@ void Linker::substituteOriginalLoopWithTransformedLoop(
     BasicBlock *startOfParLoopInOriginalFunc,
     BasicBlock *endOfParLoopInOriginalFunc,
     Value *envArray,
-    Value *envIndexForExitVariable,
+    Value *envOffsetForExitVariable,
     std::vector<BasicBlock *> &loopExitBlocks,
     uint32_t minIdleCores) {
 
@@ -170,18 +281,13 @@ void Linker::substituteOriginalLoopWithTransformedLoop(
   } else {
 
     /*
-     * Compute how many values can fit in a cache line.
+     * Fetch the exit variable at its offset within the environment array.
      */
-    auto valuesInCacheLine =
-        Architecture::getCacheLineBytes() / sizeof(int64_t);
-
     auto int64 = this->tm->getIntegerType(64);
     auto exitEnvPtr = endBuilder.CreateInBoundsGEP(
         envArray,
         ArrayRef<Value *>({ cast<Value>(ConstantInt::get(int64, 0)),
-                            endBuilder.CreateMul(
-                                envIndexForExitVariable,
-                                ConstantInt::get(int64, valuesInCacheLine)) }));
+                            envOffsetForExitVariable }));
     auto integerType = this->tm->getIntegerType(32);
     auto exitEnvCast =
         endBuilder.CreateIntCast(endBuilder.CreateLoad(exitEnvPtr),
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/LoopStructure.hpp"
+#include "noelle/core/LoopDependenceInfo.hpp"
+
+namespace llvm::noelle {
+
+class LoopCollapse {
+public:
+  /*
+   * Methods
+   */
+  LoopCollapse();
+
+  /*
+   * Check if the loop @innerLoop, which is the only loop nested in
+   * @outerLoop, can be collapsed with @outerLoop into a single loop.
+   *
+   * The two loops need to form a perfect, rectangular loop nest.
+   * Moreover, their induction variables need to iterate from 0 with a unit
+   * step toward a bound, so that the number of iterations of both loops can be
+   * computed before the loop nest starts.
+   * Finally, the induction variables must be used only to compute the
+   * linearized index i*M+j of the loop nest, where M is the bound of the inner
+   * loop, without overflow. This keeps the memory accesses of the collapsed
+   * loop as analyzable as the original ones, as they are going to be indexed
+   * by the induction variable of the collapsed loop.
+   */
+  bool canCollapseLoops(LoopDependenceInfo const &outerLoop,
+                        LoopStructure *innerLoop);
+
+  /*
+   * Collapse the loop @innerLoop into @outerLoop.
+   *
+   * After the transformation, @outerLoop iterates over the linearized
+   * iteration space of the original loop nest (i.e., the product of the trip
+   * counts of the two loops) in the original order, its induction variable
+   * replaces the linearized indexes, and @innerLoop executes a single
+   * iteration (so it is not a loop anymore).
+   */
+  bool collapseLoops(LoopDependenceInfo const &outerLoop,
+                     LoopStructure *innerLoop);
+
+private:
+  /*
+   * The iteration space of a loop in while form.
+   */
+  struct IterationSpace {
+    LoopStructure *loop;
+    PHINode *iv;
+    ICmpInst *exitCmp;
+    BinaryOperator *ivUpdate;
+    Value *start;
+    Value *bound;
+    ConstantInt *step;
+    CmpInst::Predicate predicateToContinue;
+  };
+
+  /*
+   * Methods
+   */
+  bool fetchIterationSpace(LoopDependenceInfo const &outerLoop,
+                           LoopStructure *loop,
+                           IterationSpace &space);
+
+  Value *generateCodeToComputeTripCount(IterationSpace &space,
+                                        IRBuilder<> &builder);
+
+  bool fetchLinearizedIndexes(
+      IterationSpace &outer,
+      IterationSpace &inner,
+      std::unordered_set<BinaryOperator *> &rowOffsets,
+      std::unordered_set<BinaryOperator *> &linearizedIndexes);
+};
+
+} // namespace llvm::noelle
@@ -0,0 +1,379 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopCollapse.hpp"
+#include "noelle/core/LoopInterchange.hpp"
+
+namespace llvm::noelle {
+
+bool LoopCollapse::canCollapseLoops(LoopDependenceInfo const &outerLoop,
+                                    LoopStructure *innerLoop) {
+  assert(innerLoop != nullptr);
+
+  /*
+   * Collapsing keeps the original order of the iterations.
+   * Hence, it only requires the two loops to form a perfect, rectangular loop
+   * nest.
+   */
+  LoopInterchange li;
+  if (!li.isPerfectlyNestedRectangularLoopNest(outerLoop, innerLoop)) {
+    return false;
+  }
+
+  /*
+   * The trip counts of both loops must be computable before the loop nest
+   * starts.
+   */
+  IterationSpace outer;
+  IterationSpace inner;
+  if (!this->fetchIterationSpace(outerLoop,
+                                 outerLoop.getLoopStructure(),
+                                 outer)) {
+    return false;
+  }
+  if (!this->fetchIterationSpace(outerLoop, innerLoop, inner)) {
+    return false;
+  }
+
+  /*
+   * The induction variables must be used only to compute the linearized
+   * indexes of the loop nest, which are going to be replaced by the induction
+   * variable of the collapsed loop.
+   */
+  std::unordered_set<BinaryOperator *> rowOffsets;
+  std::unordered_set<BinaryOperator *> linearizedIndexes;
+  if (!this->fetchLinearizedIndexes(outer,
+                                    inner,
+                                    rowOffsets,
+                                    linearizedIndexes)) {
+    return false;
+  }
+
+  return true;
+}
+
+bool LoopCollapse::collapseLoops(LoopDependenceInfo const &outerLoop,
+                                 LoopStructure *innerLoop) {
+
+  /*
+   * Check if the collapse is legal.
+   */
+  if (!this->canCollapseLoops(outerLoop, innerLoop)) {
+    return false;
+  }
+
+  /*
+   * Fetch the iteration spaces of the two loops.
+   */
+  IterationSpace outer;
+  IterationSpace inner;
+  this->fetchIterationSpace(outerLoop, outerLoop.getLoopStructure(), outer);
+  this->fetchIterationSpace(outerLoop, innerLoop, inner);
+  auto outerHeader = outer.loop->getHeader();
+  auto innerHeader = inner.loop->getHeader();
+  auto innerLatch = *inner.loop->getLatches().begin();
+  auto innerExitBB = inner.loop->getLoopExitBasicBlocks()[0];
+  std::unordered_set<BinaryOperator *> rowOffsets;
+  std::unordered_set<BinaryOperator *> linearizedIndexes;
+  this->fetchLinearizedIndexes(outer, inner, rowOffsets, linearizedIndexes);
+
+  /*
+   * Compute the number of iterations of the collapsed loop before the loop
+   * nest starts.
+   *
+   * NOTE: the bounds of both loops are invariant in the loop nest, so they are
+   * available in the pre-header of the outer loop.
+   *
+   * NOTE: the product cannot overflow. When both loops iterate, the original
+   * code computes the last linearized index, which is the product minus one,
+   * without signed overflow (see fetchLinearizedIndexes). Otherwise, the
+   * product is zero.
+   */
+  IRBuilder<> preHeaderBuilder(outer.loop->getPreHeader()->getTerminator());
+  auto outerTripCount =
+      this->generateCodeToComputeTripCount(outer, preHeaderBuilder);
+  auto innerTripCount =
+      this->generateCodeToComputeTripCount(inner, preHeaderBuilder);
+  auto iterations =
+      preHeaderBuilder.CreateNUWMul(outerTripCount, innerTripCount);
+
+  /*
+   * The induction variable of the outer loop becomes the linearized iteration
+   * of the loop nest, which is the linearized index computed by the original
+   * code.
+   *
+   * NOTE: the induction variables of both loops start from 0 and have a unit
+   * step (see fetchLinearizedIndexes).
+   */
+  for (auto index : linearizedIndexes) {
+    index->replaceAllUsesWith(outer.iv);
+    index->eraseFromParent();
+  }
+  for (auto rowOffset : rowOffsets) {
+    rowOffset->eraseFromParent();
+  }
+
+  /*
+   * Iterate the outer loop over the linearized iteration space.
+   *
+   * NOTE: the last update of the induction variable computes the number of
+   * iterations, which can exceed the maximum signed value of its type.
+   */
+  outer.ivUpdate->setHasNoSignedWrap(false);
+  outer.ivUpdate->setHasNoUnsignedWrap(false);
+  auto outerHeaderBr = cast<BranchInst>(outerHeader->getTerminator());
+  auto predicateToContinue =
+      outer.loop->isIncluded(outerHeaderBr->getSuccessor(0))
+          ? CmpInst::ICMP_ULT
+          : CmpInst::ICMP_UGE;
+  IRBuilder<> exitCmpBuilder(outer.exitCmp);
+  auto newExitCmp =
+      exitCmpBuilder.CreateICmp(predicateToContinue, outer.iv, iterations);
+  outer.exitCmp->replaceAllUsesWith(newExitCmp);
+  outer.exitCmp->eraseFromParent();
+
+  /*
+   * The inner loop executes a single iteration for every iteration of the
+   * outer one.
+   *
+   * Always jump to the body of the inner loop from its header, and leave the
+   * inner loop from its latch.
+   */
+  auto &cxt = innerHeader->getContext();
+  auto innerHeaderBr = cast<BranchInst>(innerHeader->getTerminator());
+  auto jumpToBody = inner.loop->isIncluded(innerHeaderBr->getSuccessor(0));
+  innerHeaderBr->setCondition(ConstantInt::getBool(cxt, jumpToBody));
+  inner.exitCmp->eraseFromParent();
+  innerLatch->getTerminator()->replaceUsesOfWith(innerHeader, innerExitBB);
+
+  /*
+   * Remove the induction variable of the inner loop.
+   */
+  inner.iv->removeIncomingValue(innerLatch, false);
+  inner.ivUpdate->eraseFromParent();
+  inner.iv->eraseFromParent();
+
+  return true;
+}
+
+bool LoopCollapse::fetchIterationSpace(LoopDependenceInfo const &outerLoop,
+                                       LoopStructure *loop,
+                                       IterationSpace &space) {
+
+  /*
+   * Fetch the instructions that control the loop.
+   *
+   * NOTE: the loop nest is perfect and rectangular, so the loop is in while
+   * form and its governing induction variable is updated by adding or
+   * subtracting a step.
+   */
+  auto ivManager = outerLoop.getInductionVariableManager();
+  auto iv = ivManager->getLoopGoverningInductionVariable(*loop);
+  assert(iv != nullptr);
+  auto phi = iv->getLoopEntryPHI();
+  auto latch = *loop->getLatches().begin();
+  auto headerBr = cast<BranchInst>(loop->getHeader()->getTerminator());
+  auto exitCmp = cast<ICmpInst>(headerBr->getCondition());
+  auto ivUpdate = cast<BinaryOperator>(phi->getIncomingValueForBlock(latch));
+
+  /*
+   * The step must be a constant.
+   */
+  auto stepValue = (ivUpdate->getOperand(0) == phi) ? ivUpdate->getOperand(1)
+                                                    : ivUpdate->getOperand(0);
+  auto step = dyn_cast<ConstantInt>(stepValue);
+  if ((step == nullptr) || step->isZero()) {
+    return false;
+  }
+  if (ivUpdate->getOpcode() == Instruction::Sub) {
+    step = cast<ConstantInt>(ConstantInt::get(step->getType(),
+                                              -step->getValue()));
+  }
+
+  /*
+   * Normalize the exit condition to be true when the loop continues, with the
+   * induction variable on the left.
+   */
+  auto predicate = exitCmp->getPredicate();
+  if (exitCmp->getOperand(1) == phi) {
+    predicate = CmpInst::getSwappedPredicate(predicate);
+  }
+  if (!loop->isIncluded(headerBr->getSuccessor(0))) {
+    predicate = CmpInst::getInversePredicate(predicate);
+  }
+
+  /*
+   * The induction variable must move toward the bound.
+   */
+  auto isStepPositive = step->getValue().isStrictlyPositive();
+  switch (predicate) {
+    case CmpInst::ICMP_SLT:
+    case CmpInst::ICMP_ULT:
+      if (!isStepPositive) {
+        return false;
+      }
+      break;
+    case CmpInst::ICMP_SGT:
+    case CmpInst::ICMP_UGT:
+      if (isStepPositive) {
+        return false;
+      }
+      break;
+    case CmpInst::ICMP_NE:
+      if ((!step->isOne()) && (!step->isMinusOne())) {
+        return false;
+      }
+      break;
+    default:
+      return false;
+  }
+
+  space.loop = loop;
+  space.iv = phi;
+  space.exitCmp = exitCmp;
+  space.ivUpdate = ivUpdate;
+  space.start = phi->getIncomingValueForBlock(loop->getPreHeader());
+  space.bound = (exitCmp->getOperand(0) == phi) ? exitCmp->getOperand(1)
+                                                : exitCmp->getOperand(0);
+  space.step = step;
+  space.predicateToContinue = predicate;
+
+  return true;
+}
+
+Value *LoopCollapse::generateCodeToComputeTripCount(IterationSpace &space,
+                                                    IRBuilder<> &builder) {
+
+  /*
+   * Compute the distance to cover.
+   */
+  auto isStepPositive = space.step->getValue().isStrictlyPositive();
+  auto distance = isStepPositive ? builder.CreateSub(space.bound, space.start)
+                                 : builder.CreateSub(space.start, space.bound);
+
+  /*
+   * Loops that iterate until the induction variable is different than the
+   * bound have a unit step.
+   */
+  if (space.predicateToContinue == CmpInst::ICMP_NE) {
+    return distance;
+  }
+
+  /*
+   * Compute the number of steps needed to cover the distance.
+   */
+  auto stepSize = isStepPositive ? space.step->getValue()
+                                 : -space.step->getValue();
+  auto stepSizeValue = ConstantInt::get(space.step->getType(), stepSize);
+  auto stepSizeMinusOne = ConstantInt::get(space.step->getType(), stepSize - 1);
+  auto roundedDistance = builder.CreateAdd(distance, stepSizeMinusOne);
+  auto steps = builder.CreateUDiv(roundedDistance, stepSizeValue);
+
+  /*
+   * The loop does not iterate if its first iteration does not satisfy the
+   * exit condition.
+   */
+  auto doesIterate =
+      builder.CreateICmp(space.predicateToContinue, space.start, space.bound);
+  auto tripCount = builder.CreateSelect(doesIterate,
+                                        steps,
+                                        ConstantInt::get(steps->getType(), 0));
+
+  return tripCount;
+}
+
+bool LoopCollapse::fetchLinearizedIndexes(
+    IterationSpace &outer,
+    IterationSpace &inner,
+    std::unordered_set<BinaryOperator *> &rowOffsets,
+    std::unordered_set<BinaryOperator *> &linearizedIndexes) {
+
+  /*
+   * Both induction variables must start from 0 and have a unit step.
+   * Hence, the linearized index i*M+j, where M is the bound of the inner loop,
+   * is the number of iterations of the loop nest executed before (i, j).
+   */
+  for (auto space : { &outer, &inner }) {
+    auto start = dyn_cast<ConstantInt>(space->start);
+    if ((start == nullptr) || (!start->isZero()) || (!space->step->isOne())) {
+      return false;
+    }
+  }
+
+  /*
+   * Every use of the induction variable of the outer loop must be the row
+   * offset i*M, and every use of a row offset must add the induction variable
+   * of the inner loop to it.
+   *
+   * NOTE: these operations must not wrap. This guarantees the linearized
+   * indexes, and therefore the iterations of the collapsed loop, fit in the
+   * type of the induction variables.
+   */
+  for (auto user : outer.iv->users()) {
+    if ((user == outer.exitCmp) || (user == outer.ivUpdate)) {
+      continue;
+    }
+    auto rowOffset = dyn_cast<BinaryOperator>(user);
+    if ((rowOffset == nullptr) || (rowOffset->getOpcode() != Instruction::Mul)
+        || (!rowOffset->hasNoSignedWrap())) {
+      return false;
+    }
+    auto otherOp = (rowOffset->getOperand(0) == outer.iv)
+                       ? rowOffset->getOperand(1)
+                       : rowOffset->getOperand(0);
+    if (otherOp != inner.bound) {
+      return false;
+    }
+    for (auto rowOffsetUser : rowOffset->users()) {
+      auto index = dyn_cast<BinaryOperator>(rowOffsetUser);
+      if ((index == nullptr) || (index->getOpcode() != Instruction::Add)
+          || (!index->hasNoSignedWrap())) {
+        return false;
+      }
+      auto otherIndexOp = (index->getOperand(0) == rowOffset)
+                              ? index->getOperand(1)
+                              : index->getOperand(0);
+      if (otherIndexOp != inner.iv) {
+        return false;
+      }
+      linearizedIndexes.insert(index);
+    }
+    rowOffsets.insert(rowOffset);
+  }
+
+  /*
+   * Every use of the induction variable of the inner loop must be a
+   * linearized index.
+   */
+  for (auto user : inner.iv->users()) {
+    if ((user == inner.exitCmp) || (user == inner.ivUpdate)) {
+      continue;
+    }
+    auto index = dyn_cast<BinaryOperator>(user);
+    if (linearizedIndexes.find(index) == linearizedIndexes.end()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace llvm::noelle
@@ -38,6 +38,16 @@ namespace llvm::noelle {
 
 class LoopDependenceInfo {
 public:
+  /*
+   * Provide the LLVM loop, the dominators, and the scalar evolution of a loop
+   * to the function given as input.
+   * These analyses are requested only when a part of the LDI that needs them
+   * is computed.
+   */
+  typedef std::function<void(
+      std::function<void(Loop *l, DominatorSummary &DS, ScalarEvolution &SE)>)>
+      FunctionAnalysesFetcher;
+
   /*
    * Constructors.
    */
@@ -97,8 +107,34 @@ public:
       bool enableLoopAwareDependenceAnalyses,
       uint32_t chunkSize);
 
+  /*
+   * Create an LDI whose dependences and analyses are computed the first time
+   * they are requested.
+   * Both @fG and the analyses provided by @fetchFunctionAnalyses must stay
+   * valid until then.
+   */
+  LoopDependenceInfo(
+      PDG *fG,
+      LoopForestNode *loop,
+      Loop *l,
+      ScalarEvolution &SE,
+      uint32_t maxCores,
+      bool enableFloatAsReal,
+      std::unordered_set<LoopDependenceInfoOptimization> optimizations,
+      bool enableLoopAwareDependenceAnalyses,
+      uint32_t chunkSize,
+      FunctionAnalysesFetcher fetchFunctionAnalyses);
+
   LoopDependenceInfo() = delete;
 
+  /*
+   * Compute all the dependences and analyses of the loop that have not been
+   * computed yet.
+   * LDIs can compute their analyses in parallel as long as the ones running
+   * at the same time do not share their function analyses.
+   */
+  void computeAllAnalyses(void);
+
   /*
    * Return the object containing all loop structures at and nested within this
    * loop
@@ -198,6 +234,16 @@ private:
 
   LoopTransformationsManager *loopTransformationsManager;
 
+  PDG *functionDG; /* Dependence graph the loop DG is extracted from.
+                    * It is used only until the loop DG is computed.
+                    */
+
+  SCCDAG *loopSCCDAG;
+
+  bool enableFloatAsReal;
+
+  FunctionAnalysesFetcher fetchFunctionAnalyses;
+
   /*
    * Methods
    */
@@ -209,6 +255,24 @@ private:
                                               DominatorSummary &DS,
                                               ScalarEvolution &SE);
 
+  /*
+   * Compute the loop DG, its SCCDAG, the memory cloning analysis, and the
+   * environment.
+   * Memory cloning is computed with the loop DG because it removes dependences
+   * from it.
+   */
+  void computeDependencesIfNeeded(void);
+
+  void computeInvariantsIfNeeded(void);
+
+  void computeInductionVariablesIfNeeded(void);
+
+  void computeDomainSpaceIfNeeded(void);
+
+  void computeSCCDAGAttrsIfNeeded(void);
+
+  LoopDependenceInfo *getNonConstLDI(void) const;
+
   uint64_t computeTripCounts(Loop *l, ScalarEvolution &SE);
 
   void removeUnnecessaryDependenciesThatCloningMemoryNegates(
@@ -221,6 +285,9 @@ private:
       PDG *loopDG,
       DominatorSummary &DS);
 
+  void markDependencesNeverObservedByTheProfiler(LoopForestNode *loopNode,
+                                                 PDG *loopDG);
+
   SCCDAG *computeSCCDAGWithOnlyVariableAndControlDependences(PDG *loopDG);
 };
 
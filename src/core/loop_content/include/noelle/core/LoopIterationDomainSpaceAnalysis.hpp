@@ -33,6 +33,16 @@ namespace llvm::noelle {
 
 class LoopIterationDomainSpaceAnalysis {
 public:
+  /*
+   * Outcome of testing two memory accesses for a dependence between different
+   * iterations of the outermost loop.
+   */
+  enum DependenceTestResult {
+    NO_DEPENDENCE,
+    CONSTANT_DISTANCE,
+    UNKNOWN_DISTANCE
+  };
+
   LoopIterationDomainSpaceAnalysis(LoopForestNode *loops,
                                    InductionVariableManager &ivManager,
                                    ScalarEvolution &SE);
@@ -51,6 +61,40 @@ public:
       Instruction *from,
       Instruction *to) const;
 
+  /*
+   * Return the induction variables that index the dimensions of the memory
+   * location accessed by @memoryAccess, from the outermost dimension to the
+   * innermost one.
+   * Dimensions that are not indexed by an induction variable are nullptr.
+   * The vector is empty if the access could not be delinearized.
+   */
+  std::vector<InductionVariable *> getInductionVariablesOfSubscripts(
+      Instruction *memoryAccess) const;
+
+  /*
+   * Like getInductionVariablesOfSubscripts, but a dimension is indexed by an
+   * induction variable only if its subscript is an affine recurrence of the
+   * loop of that variable with a non-zero constant step and a start that is
+   * invariant in the loop nest (e.g., 2*i+3 but neither i+j nor i*j).
+   * Hence, two instances of @memoryAccess access the same location only if
+   * that induction variable has the same value.
+   * The vector is empty if the subscripts do not identify a unique location.
+   */
+  std::vector<InductionVariable *> getInductionVariablesOfAffineSubscripts(
+      Instruction *memoryAccess) const;
+
+  /*
+   * Test the delinearized subscripts of @from and @to with the exact SIV test
+   * and the GCD test.
+   * When the result is CONSTANT_DISTANCE, @from of iteration i and @to of
+   * iteration i+@distance are the only instances that can access the same
+   * memory location (@distance can be zero or negative).
+   */
+  DependenceTestResult computeDependenceDistanceBetweenIterations(
+      Instruction *from,
+      Instruction *to,
+      int64_t &distance) const;
+
 private:
   /*
    * Long-lived references
@@ -88,6 +132,13 @@ private:
     SmallVector<const SCEV *, 4> sizes;
     const SCEV *elementSize;
 
+    /*
+     * Pointer the subscripts are relative to, and whether they come from the
+     * delinearization of the access function or from the GEP indexes
+     */
+    const SCEV *subscriptsBase;
+    bool isDelinearized;
+
     /*
      * Track the instruction and the IV corresponding to each subscript
      * This instruction may either be
@@ -128,6 +179,16 @@ private:
   bool isInnerDimensionSubscriptsBounded(ScalarEvolution &SE,
                                          MemoryAccessSpace *space);
 
+  /*
+   * Memory access spaces whose subscripts can be compared dimension by
+   * dimension by the dependence tests
+   */
+  std::unordered_set<MemoryAccessSpace *> affineTestableAccesses;
+
+  void identifyAffineTestableAccesses(ScalarEvolution &SE);
+
+  bool isInvariantInTopLoop(const SCEV *scev) const;
+
   // bool isIVRelatedSCEVBounded (ScalarEvolution &SE, MemoryAccessSpace *space)
   // ;
 };
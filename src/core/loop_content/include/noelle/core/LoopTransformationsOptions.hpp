@@ -28,6 +28,11 @@ namespace llvm::noelle {
 
 class LoopTransformationsManager {
 public:
+  /*
+   * Chunk size used by DOALL when none is specified for a loop.
+   */
+  static constexpr uint32_t defaultChunkSize = 8;
+
   LoopTransformationsManager(
       uint32_t maxNumberOfCores,
       uint32_t chunkSize,
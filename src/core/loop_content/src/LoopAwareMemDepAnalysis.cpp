@@ -23,6 +23,7 @@
 #include "noelle/core/LoopCarriedDependencies.hpp"
 #include "noelle/core/AliasAnalysisEngine.hpp"
 #include "noelle/core/LoopDependenceInfo.hpp"
+#include "noelle/core/DependenceQueryCache.hpp"
 #include "LoopAwareMemDepAnalysis.hpp"
 
 /*
@@ -77,6 +78,65 @@ static RegisterStandardPasses _RegPass2(
       }
     }); // ** for -O0
 
+#ifdef ENABLE_SCAF
+/*
+ * Return the subset of @depTypes (bit 0 for RAW, bit 1 for WAW, bit 2 for WAR)
+ * that SCAF disproves from @i to @j within @l.
+ * SCAF is queried only for the types the session has not asked about yet.
+ */
+static uint8_t disproveMemoryDep(Instruction *i,
+                                 Instruction *j,
+                                 uint8_t depTypes,
+                                 Loop *l,
+                                 bool isLoopCarried) {
+  auto &cache = DependenceQueryCache::getSessionCache();
+  const DataDependenceType types[] = { DG_DATA_RAW, DG_DATA_WAW, DG_DATA_WAR };
+
+  /*
+   * Fetch the answers the session already has.
+   */
+  uint8_t disprovedDepTypes = 0;
+  uint8_t unknownDepTypes = 0;
+  for (uint8_t k = 0; k <= 2; ++k) {
+    if (!(depTypes & (1 << k))) {
+      continue;
+    }
+    auto disproved =
+        cache.isDependenceDisproved(i, j, types[k], l, isLoopCarried);
+    if (!disproved) {
+      unknownDepTypes |= 1 << k;
+    } else if (*disproved) {
+      disprovedDepTypes |= 1 << k;
+    }
+  }
+  if (!unknownDepTypes) {
+    return disprovedDepTypes;
+  }
+
+  /*
+   * Query SCAF for the rest and remember its answers.
+   */
+  uint8_t newlyDisprovedDepTypes =
+      isLoopCarried
+          ? disproveLoopCarriedMemoryDep(i, j, unknownDepTypes, l, NoelleSCAFAA)
+          : disproveIntraIterationMemoryDep(i,
+                                            j,
+                                            unknownDepTypes,
+                                            l,
+                                            NoelleSCAFAA);
+  for (uint8_t k = 0; k <= 2; ++k) {
+    if (!(unknownDepTypes & (1 << k))) {
+      continue;
+    }
+    auto disproved = (newlyDisprovedDepTypes & (1 << k)) != 0;
+    cache.setDependenceDisproved(i, j, types[k], l, isLoopCarried, disproved);
+  }
+  disprovedDepTypes |= newlyDisprovedDepTypes;
+
+  return disprovedDepTypes;
+}
+#endif
+
 void refinePDGWithLoopAwareMemDepAnalysis(
     PDG *loopDG,
     Loop *l,
@@ -98,6 +158,13 @@ void refinePDGWithSCAF(PDG *loopDG, Loop *l) {
   auto li = &ModuleLoops->getAnalysis_LoopInfo(l->getHeader()->getParent());
   l = li->getLoopFor(l->getHeader());
 
+  /*
+   * Drop the answers about the function of the loop if its code changed
+   * since they were computed.
+   */
+  DependenceQueryCache::getSessionCache().validate(
+      *l->getHeader()->getParent());
+
   /*
    * Iterate over all the edges of the loop PDG and collect memory deps to be
    * queried. For each pair of instructions with a memory dependence map it to
@@ -175,18 +242,14 @@ void refinePDGWithSCAF(PDG *loopDG, Loop *l) {
       }
     }
     // Try to disprove all the reported loop-carried deps
-    uint8_t disprovedLCDepTypes =
-        disproveLoopCarriedMemoryDep(i, j, depTypes, l, NoelleSCAFAA);
+    uint8_t disprovedLCDepTypes = disproveMemoryDep(i, j, depTypes, l, true);
 
     // for every disproved loop-carried dependence
     // check if there is a intra-iteration dependence
     uint8_t disprovedIIDepTypes = 0;
     if (disprovedLCDepTypes) {
-      disprovedIIDepTypes = disproveIntraIterationMemoryDep(i,
-                                                            j,
-                                                            disprovedLCDepTypes,
-                                                            l,
-                                                            NoelleSCAFAA);
+      disprovedIIDepTypes =
+          disproveMemoryDep(i, j, disprovedLCDepTypes, l, false);
 
       // remove any edge that SCAF disproved both its loop-carried and
       // intra-iteration version
@@ -283,6 +346,7 @@ void refinePDGWithLIDS(PDG *loopDG,
   auto dfr = computeReachabilityFromInstructions(loopStructure);
 
   std::unordered_set<DGEdge<Value> *> edgesToRemove;
+  std::unordered_set<DGEdge<Value> *> edgesToUnmarkAsLoopCarried;
   for (auto dependency :
        LoopCarriedDependencies::getLoopCarriedDependenciesForLoop(
            *loopStructure,
@@ -300,6 +364,30 @@ void refinePDGWithLIDS(PDG *loopDG,
     if (!fromInst || !toInst)
       continue;
 
+    /*
+     * Run the affine dependence tests on the delinearized subscripts.
+     * Accesses that never touch the same location do not depend on each
+     * other, accesses that only do within the same iteration are not
+     * loop-carried, and the remaining ones are annotated with their distance.
+     */
+    int64_t distance;
+    auto testResult = LIDS->computeDependenceDistanceBetweenIterations(
+        fromInst,
+        toInst,
+        distance);
+    if (testResult == LoopIterationDomainSpaceAnalysis::NO_DEPENDENCE) {
+      edgesToRemove.insert(dependency);
+      continue;
+    }
+    if (testResult == LoopIterationDomainSpaceAnalysis::CONSTANT_DISTANCE) {
+      if (distance == 0) {
+        edgesToUnmarkAsLoopCarried.insert(dependency);
+        continue;
+      }
+      dependency->setDependenceDistance(
+          (uint32_t)(distance < 0 ? -distance : distance));
+    }
+
     /*
      * Loop carried dependencies are conservatively marked as such; we can only
      * remove dependencies between a producer and consumer where we know the
@@ -320,6 +408,9 @@ void refinePDGWithLIDS(PDG *loopDG,
     edge->setLoopCarried(false);
     loopDG->removeEdge(edge);
   }
+  for (auto edge : edgesToUnmarkAsLoopCarried) {
+    edge->setLoopCarried(false);
+  }
 
   /*
    * Free the memory
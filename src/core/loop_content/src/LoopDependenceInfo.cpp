@@ -26,6 +26,9 @@
 #include "noelle/core/LoopDependenceInfo.hpp"
 #include "LoopAwareMemDepAnalysis.hpp"
 #include "noelle/core/LoopCarriedDependencies.hpp"
+#include "noelle/core/DependenceProfile.hpp"
+#include "noelle/core/CompileTimeProfiler.hpp"
+#include "noelle/core/Utils.hpp"
 
 namespace llvm::noelle {
 
@@ -109,7 +112,7 @@ LoopDependenceInfo::LoopDependenceInfo(
                        enableFloatAsReal,
                        optimizations,
                        enableLoopAwareDependenceAnalyses,
-                       8) {
+                       LoopTransformationsManager::defaultChunkSize) {
   return;
 }
 
@@ -124,9 +127,57 @@ LoopDependenceInfo::LoopDependenceInfo(
     std::unordered_set<LoopDependenceInfoOptimization> optimizations,
     bool enableLoopAwareDependenceAnalyses,
     uint32_t chunkSize)
+  : LoopDependenceInfo(
+      fG,
+      loopNode,
+      l,
+      SE,
+      maxCores,
+      enableFloatAsReal,
+      optimizations,
+      enableLoopAwareDependenceAnalyses,
+      chunkSize,
+      [l, &DS, &SE](
+          std::function<void(Loop *, DominatorSummary &, ScalarEvolution &)>
+              f) { f(l, DS, SE); }) {
+
+  /*
+   * The analyses given as input are not guaranteed to outlive the
+   * constructor. Hence, we compute everything now.
+   */
+  this->computeAllAnalyses();
+  this->fetchFunctionAnalyses = nullptr;
+
+  return;
+}
+
+LoopDependenceInfo::LoopDependenceInfo(
+    PDG *fG,
+    LoopForestNode *loopNode,
+    Loop *l,
+    ScalarEvolution &SE,
+    uint32_t maxCores,
+    bool enableFloatAsReal,
+    std::unordered_set<LoopDependenceInfoOptimization> optimizations,
+    bool enableLoopAwareDependenceAnalyses,
+    uint32_t chunkSize,
+    FunctionAnalysesFetcher fetchFunctionAnalyses)
   : loop{ loopNode },
-    memoryCloningAnalysis{ nullptr } {
+    environment{ nullptr },
+    loopDG{ nullptr },
+    inductionVariables{ nullptr },
+    invariantManager{ nullptr },
+    loopGoverningIVAttribution{ nullptr },
+    domainSpaceAnalysis{ nullptr },
+    memoryCloningAnalysis{ nullptr },
+    sccdagAttrs{ nullptr },
+    functionDG{ fG },
+    loopSCCDAG{ nullptr },
+    enableFloatAsReal{ enableFloatAsReal },
+    fetchFunctionAnalyses{ fetchFunctionAnalyses } {
   assert(this->loop != nullptr);
+  CompileTimePhase phase("Loop content");
+  CompileTimeProfiler::getProfiler().incrementCounter("loops analyzed");
 
   /*
    * Assertions.
@@ -149,16 +200,52 @@ LoopDependenceInfo::LoopDependenceInfo(
    */
   this->loopTransformationsManager->enableAllTransformations();
 
+  /*
+   * Compute the trip count of the loop.
+   * Everything else is computed when it is requested.
+   */
+  {
+    std::lock_guard<std::mutex> contextGuard(Utils::getLLVMContextLock());
+    this->fetchLoopAndBBInfo(l, SE);
+  }
+
+  return;
+}
+
+void LoopDependenceInfo::computeAllAnalyses(void) {
+  this->computeDependencesIfNeeded();
+  this->computeInvariantsIfNeeded();
+  this->computeInductionVariablesIfNeeded();
+  this->computeDomainSpaceIfNeeded();
+  this->computeSCCDAGAttrsIfNeeded();
+
+  return;
+}
+
+void LoopDependenceInfo::computeDependencesIfNeeded(void) {
+  if (this->loopDG != nullptr) {
+    return;
+  }
+  CompileTimePhase phase("Loop content");
+  assert(this->fetchFunctionAnalyses != nullptr);
+
   /*
    * Fetch the loop dependence graph (i.e., the subset of the PDG that relates
-   * to the loop @l) and its SCCDAG.
+   * to the loop) and its SCCDAG.
    */
-  this->fetchLoopAndBBInfo(l, SE);
   auto ls = this->getLoopStructure();
   auto loopExitBlocks = ls->getLoopExitBasicBlocks();
-  auto DGs = this->createDGsForLoop(l, loopNode, fG, DS, SE);
-  this->loopDG = DGs.first;
-  auto loopSCCDAG = DGs.second;
+  this->fetchFunctionAnalyses(
+      [this](Loop *l, DominatorSummary &DS, ScalarEvolution &SE) {
+        auto DGs = this->createDGsForLoop(l,
+                                          this->loop,
+                                          this->functionDG,
+                                          DS,
+                                          SE);
+        this->loopDG = DGs.first;
+        this->loopSCCDAG = DGs.second;
+      });
+  this->functionDG = nullptr;
 
   /*
    * Create the environment for the loop.
@@ -188,8 +275,22 @@ LoopDependenceInfo::LoopDependenceInfo(
       stackObjectsThatWillBeCloned.insert(stackObject);
     }
   }
-  this->environment =
-      new LoopEnvironment(loopDG, loopExitBlocks, stackObjectsThatWillBeCloned);
+  {
+    std::lock_guard<std::mutex> contextGuard(Utils::getLLVMContextLock());
+    this->environment = new LoopEnvironment(loopDG,
+                                            loopExitBlocks,
+                                            stackObjectsThatWillBeCloned);
+  }
+
+  return;
+}
+
+void LoopDependenceInfo::computeInvariantsIfNeeded(void) {
+  if (this->invariantManager != nullptr) {
+    return;
+  }
+  this->computeDependencesIfNeeded();
+  CompileTimePhase phase("Loop content");
 
   /*
    * Create the invariant manager.
@@ -199,6 +300,16 @@ LoopDependenceInfo::LoopDependenceInfo(
   auto topLoop = this->loop->getLoop();
   this->invariantManager = new InvariantManager(topLoop, this->loopDG);
 
+  return;
+}
+
+void LoopDependenceInfo::computeInductionVariablesIfNeeded(void) {
+  if (this->inductionVariables != nullptr) {
+    return;
+  }
+  this->computeInvariantsIfNeeded();
+  CompileTimePhase phase("Loop content");
+
   /*
    * Create the induction variable manager.
    *
@@ -211,44 +322,85 @@ LoopDependenceInfo::LoopDependenceInfo(
    */
   auto loopSCCDAGWithoutMemoryDeps =
       this->computeSCCDAGWithOnlyVariableAndControlDependences(loopDG);
-  this->inductionVariables =
-      new InductionVariableManager(this->loop,
-                                   *invariantManager,
-                                   SE,
-                                   *loopSCCDAGWithoutMemoryDeps,
-                                   *environment,
-                                   *l);
-
-  /*
-   * Calculate various attributes on SCCs
-   */
-  this->sccdagAttrs = new SCCDAGAttrs(enableFloatAsReal,
-                                      loopDG,
-                                      loopSCCDAG,
-                                      this->loop,
-                                      *inductionVariables,
-                                      DS);
-  this->domainSpaceAnalysis =
-      new LoopIterationDomainSpaceAnalysis(this->loop,
-                                           *this->inductionVariables,
-                                           SE);
+  this->fetchFunctionAnalyses(
+      [this, loopSCCDAGWithoutMemoryDeps](Loop *l,
+                                          DominatorSummary &DS,
+                                          ScalarEvolution &SE) {
+        std::lock_guard<std::mutex> contextGuard(Utils::getLLVMContextLock());
+        this->inductionVariables =
+            new InductionVariableManager(this->loop,
+                                         *this->invariantManager,
+                                         SE,
+                                         *loopSCCDAGWithoutMemoryDeps,
+                                         *this->environment,
+                                         *l);
+      });
 
   /*
    * Collect induction variable information
    */
+  auto topLoop = this->loop->getLoop();
+  auto loopExitBlocks = topLoop->getLoopExitBasicBlocks();
   auto iv =
       this->inductionVariables->getLoopGoverningInductionVariable(*topLoop);
-  loopGoverningIVAttribution =
-      iv == nullptr ? nullptr
-                    : new LoopGoverningIVAttribution(
-                        topLoop,
-                        *iv,
-                        *loopSCCDAG->sccOfValue(iv->getLoopEntryPHI()),
-                        loopExitBlocks);
+  this->loopGoverningIVAttribution =
+      iv == nullptr
+          ? nullptr
+          : new LoopGoverningIVAttribution(
+              topLoop,
+              *iv,
+              *this->loopSCCDAG->sccOfValue(iv->getLoopEntryPHI()),
+              loopExitBlocks);
+
+  return;
+}
+
+void LoopDependenceInfo::computeDomainSpaceIfNeeded(void) {
+  if (this->domainSpaceAnalysis != nullptr) {
+    return;
+  }
+  this->computeInductionVariablesIfNeeded();
+  CompileTimePhase phase("Loop content");
+
+  this->fetchFunctionAnalyses(
+      [this](Loop *l, DominatorSummary &DS, ScalarEvolution &SE) {
+        std::lock_guard<std::mutex> contextGuard(Utils::getLLVMContextLock());
+        this->domainSpaceAnalysis =
+            new LoopIterationDomainSpaceAnalysis(this->loop,
+                                                 *this->inductionVariables,
+                                                 SE);
+      });
 
   return;
 }
 
+void LoopDependenceInfo::computeSCCDAGAttrsIfNeeded(void) {
+  if (this->sccdagAttrs != nullptr) {
+    return;
+  }
+  this->computeInductionVariablesIfNeeded();
+  CompileTimePhase phase("Loop content");
+
+  /*
+   * Calculate various attributes on SCCs
+   */
+  this->fetchFunctionAnalyses(
+      [this](Loop *l, DominatorSummary &DS, ScalarEvolution &SE) {
+        this->sccdagAttrs = new SCCDAGAttrs(this->enableFloatAsReal,
+                                            this->loopDG,
+                                            this->loopSCCDAG,
+                                            this->loop,
+                                            *this->inductionVariables,
+                                            DS);
+      });
+
+  return;
+}
+
+LoopDependenceInfo *LoopDependenceInfo::getNonConstLDI(void) const {
+  return const_cast<LoopDependenceInfo *>(this);
+}
+
 void LoopDependenceInfo::copyParallelizationOptionsFrom(
     LoopDependenceInfo *otherLDI) {
   auto otherLTM = otherLDI->getLoopTransformationsManager();
@@ -301,6 +453,7 @@ std::pair<PDG *, SCCDAG *> LoopDependenceInfo::createDGsForLoop(
     PDG *functionDG,
     DominatorSummary &DS,
     ScalarEvolution &SE) {
+  CompileTimePhase phase("Loop dependence graph");
 
   /*
    * Create the loop dependence graph.
@@ -318,14 +471,6 @@ std::pair<PDG *, SCCDAG *> LoopDependenceInfo::createDGsForLoop(
     loopInternals.push_back(internalNode.first);
   }
 
-  /*
-   * Compute the SCCDAG using only variable-related dependences.
-   * This will be used to detect induction variables.
-   */
-  auto loopInternalDG = loopDG->createSubgraphFromValues(loopInternals, false);
-  auto loopSCCDAGWithoutMemoryDeps =
-      this->computeSCCDAGWithOnlyVariableAndControlDependences(loopInternalDG);
-
   /*
    * Detect the loop-carried data dependences.
    *
@@ -340,26 +485,37 @@ std::pair<PDG *, SCCDAG *> LoopDependenceInfo::createDGsForLoop(
    */
   LoopCarriedDependencies::setLoopCarriedDependencies(loopNode, DS, *loopDG);
 
-  /*
-   * Detect loop invariants and induction variables.
-   */
-  auto loopStructure = loopNode->getLoop();
-  auto loopExitBlocks = loopStructure->getLoopExitBasicBlocks();
-  auto env = LoopEnvironment(loopDG, loopExitBlocks, {});
-  auto invManager = InvariantManager(loopStructure, loopDG);
-  auto ivManager = InductionVariableManager(loopNode,
-                                            invManager,
-                                            SE,
-                                            *loopSCCDAGWithoutMemoryDeps,
-                                            env,
-                                            *l);
-
   /*
    * Perform loop-aware memory dependence analysis to refine the loop dependence
    * graph.
+   *
+   * These analyses query scalar evolution, add entries to the LLVM context,
+   * and rely on alias analyses shared by all loops. Hence, only one loop at a
+   * time can run them.
    */
-  auto domainSpace = LoopIterationDomainSpaceAnalysis(loopNode, ivManager, SE);
+  auto loopStructure = loopNode->getLoop();
   if (this->loopTransformationsManager->areLoopAwareAnalysesEnabled()) {
+    std::lock_guard<std::mutex> contextGuard(Utils::getLLVMContextLock());
+
+    /*
+     * Detect loop invariants and induction variables.
+     *
+     * Induction variables are detected on the SCCDAG of the loop computed
+     * using only variable-related dependences.
+     */
+    auto loopSCCDAGWithoutMemoryDeps =
+        this->computeSCCDAGWithOnlyVariableAndControlDependences(loopDG);
+    auto loopExitBlocks = loopStructure->getLoopExitBasicBlocks();
+    auto env = LoopEnvironment(loopDG, loopExitBlocks, {});
+    auto invManager = InvariantManager(loopStructure, loopDG);
+    auto ivManager = InductionVariableManager(loopNode,
+                                              invManager,
+                                              SE,
+                                              *loopSCCDAGWithoutMemoryDeps,
+                                              env,
+                                              *l);
+    auto domainSpace =
+        LoopIterationDomainSpaceAnalysis(loopNode, ivManager, SE);
     refinePDGWithLoopAwareMemDepAnalysis(loopDG,
                                          l,
                                          loopStructure,
@@ -388,10 +544,23 @@ std::pair<PDG *, SCCDAG *> LoopDependenceInfo::createDGsForLoop(
   }
 
   /*
-   * Build a SCCDAG of loop-internal instructions
+   * Mark the memory dependences that never manifested at run time as
+   * removable.
    */
-  loopInternalDG = loopDG->createSubgraphFromValues(loopInternals, false);
-  auto loopSCCDAG = new SCCDAG(loopInternalDG);
+  if (this->loopTransformationsManager->isOptimizationEnabled(
+          LoopDependenceInfoOptimization::MEMORY_DEPENDENCE_PROFILE_ID)) {
+    std::lock_guard<std::mutex> contextGuard(Utils::getLLVMContextLock());
+    this->markDependencesNeverObservedByTheProfiler(loopNode, loopDG);
+  }
+
+  /*
+   * Build a SCCDAG of loop-internal instructions.
+   *
+   * The SCCDAG copies the nodes and edges it needs, so a view of the loop
+   * dependence graph is enough (no need to duplicate the loop DG first).
+   */
+  PDGSubgraphView loopInternalDG(loopDG, loopInternals, false);
+  auto loopSCCDAG = new SCCDAG(&loopInternalDG);
 
 /*
  * Safety check: check that the SCCDAG includes all instructions of the loop
@@ -408,7 +577,7 @@ std::pair<PDG *, SCCDAG *> LoopDependenceInfo::createDGsForLoop(
       for (auto &I : *bbIter) {
         assert(std::find(loopInternals.begin(), loopInternals.end(), &I)
                != loopInternals.end());
-        assert(loopInternalDG->isInternal(&I));
+        assert(loopInternalDG.isInternal(&I));
         assert(loopSCCDAG->doesItContain(&I));
         numberOfInstructionsInLoop++;
       }
@@ -418,7 +587,8 @@ std::pair<PDG *, SCCDAG *> LoopDependenceInfo::createDGsForLoop(
      * Check that all LDI-specific containers include only loop instructions.
      */
     assert(loopInternals.size() == numberOfInstructionsInLoop);
-    assert(loopInternalDG->numNodes() == loopInternals.size());
+    assert(loopInternalDG.getNumberOfInstructionsIncluded()
+           == loopInternals.size());
   }
 #endif
 
@@ -493,6 +663,78 @@ void LoopDependenceInfo::
   return;
 }
 
+void LoopDependenceInfo::markDependencesNeverObservedByTheProfiler(
+    LoopForestNode *loopNode,
+    PDG *loopDG) {
+
+  /*
+   * Check that the dependence profile is available.
+   */
+  auto loopStructure = loopNode->getLoop();
+  auto M = loopStructure->getFunction()->getParent();
+  if (!DependenceProfile::isAvailable(*M)) {
+    return;
+  }
+
+  for (auto edge : loopDG->getEdges()) {
+
+    /*
+     * Only memory dependences between instructions of the loop are profiled.
+     */
+    if (!edge->isMemoryDependence()) {
+      continue;
+    }
+    auto producer = dyn_cast<Instruction>(edge->getOutgoingT());
+    auto consumer = dyn_cast<Instruction>(edge->getIncomingT());
+    if (!producer || !consumer) {
+      continue;
+    }
+    if (!loopStructure->isIncluded(producer)
+        || !loopStructure->isIncluded(consumer)) {
+      continue;
+    }
+
+    /*
+     * The profile of both instructions must be trustworthy.
+     * This is not the case when they did not execute or when they can access
+     * memory that was not instrumented.
+     */
+    if (!DependenceProfile::canBeTrusted(producer)
+        || !DependenceProfile::canBeTrusted(consumer)) {
+      continue;
+    }
+
+    /*
+     * Check if the dependence manifested.
+     */
+    auto type = edge->dataDependenceType();
+    if (!DependenceProfile::wasObserved(producer, consumer, type)) {
+      auto remedy = std::make_shared<DependenceProfileRemedy>(edge, true);
+      auto remedies = std::make_shared<Remedies>();
+      remedies->insert(remedy);
+      edge->addRemedies(remedies);
+      continue;
+    }
+
+    /*
+     * The dependence manifested.
+     * Check if it only manifested within single iterations of the loop.
+     */
+    if (edge->isLoopCarriedDependence()
+        && !DependenceProfile::wasObservedAsLoopCarried(producer,
+                                                        consumer,
+                                                        type,
+                                                        loopStructure)) {
+      auto remedy = std::make_shared<DependenceProfileRemedy>(edge, false);
+      auto remedies = std::make_shared<Remedies>();
+      remedies->insert(remedy);
+      edge->addRemedies(remedies);
+    }
+  }
+
+  return;
+}
+
 void LoopDependenceInfo::removeUnnecessaryDependenciesThatCloningMemoryNegates(
     LoopForestNode *loopNode,
     PDG *loopInternalDG,
@@ -595,6 +837,8 @@ void LoopDependenceInfo::removeUnnecessaryDependenciesThatCloningMemoryNegates(
 }
 
 PDG *LoopDependenceInfo::getLoopDG(void) const {
+  this->getNonConstLDI()->computeDependencesIfNeeded();
+
   return this->loopDG;
 }
 
@@ -623,21 +867,28 @@ LoopStructure *LoopDependenceInfo::getNestedMostLoopStructure(
 }
 
 bool LoopDependenceInfo::isSCCContainedInSubloop(SCC *scc) const {
+  this->getNonConstLDI()->computeSCCDAGAttrsIfNeeded();
+
   return this->sccdagAttrs->isSCCContainedInSubloop(this->loop, scc);
 }
 
 InductionVariableManager *LoopDependenceInfo::getInductionVariableManager(
     void) const {
-  return inductionVariables;
+  this->getNonConstLDI()->computeInductionVariablesIfNeeded();
+
+  return this->inductionVariables;
 }
 
 LoopGoverningIVAttribution *LoopDependenceInfo::getLoopGoverningIVAttribution(
     void) const {
-  return loopGoverningIVAttribution;
+  this->getNonConstLDI()->computeInductionVariablesIfNeeded();
+
+  return this->loopGoverningIVAttribution;
 }
 
 MemoryCloningAnalysis *LoopDependenceInfo::getMemoryCloningAnalysis(
     void) const {
+  this->getNonConstLDI()->computeDependencesIfNeeded();
   assert(
       this->memoryCloningAnalysis != nullptr
       && "Requesting memory cloning analysis without having specified LoopDependenceInfoOptimization::MEMORY_CLONING");
@@ -653,11 +904,15 @@ uint64_t LoopDependenceInfo::getCompileTimeTripCount(void) const {
 }
 
 InvariantManager *LoopDependenceInfo::getInvariantManager(void) const {
+  this->getNonConstLDI()->computeInvariantsIfNeeded();
+
   return this->invariantManager;
 }
 
 LoopIterationDomainSpaceAnalysis *LoopDependenceInfo::
     getLoopIterationDomainSpaceAnalysis(void) const {
+  this->getNonConstLDI()->computeDomainSpaceIfNeeded();
+
   return this->domainSpaceAnalysis;
 }
 
@@ -666,10 +921,14 @@ LoopForestNode *LoopDependenceInfo::getLoopHierarchyStructures(void) const {
 }
 
 SCCDAGAttrs *LoopDependenceInfo::getSCCManager(void) const {
+  this->getNonConstLDI()->computeSCCDAGAttrsIfNeeded();
+
   return this->sccdagAttrs;
 }
 
 LoopEnvironment *LoopDependenceInfo::getEnvironment(void) const {
+  this->getNonConstLDI()->computeDependencesIfNeeded();
+
   return this->environment;
 }
 
@@ -685,25 +944,21 @@ SCCDAG *LoopDependenceInfo::computeSCCDAGWithOnlyVariableAndControlDependences(
   }
 
   /*
-   * Collect the dependences that we want to ignore.
-   */
-  std::unordered_set<DGEdge<Value> *> memDeps{};
-  for (auto currentDependence : loopDG->getSortedDependences()) {
-    if (currentDependence->isMemoryDependence()) {
-      memDeps.insert(currentDependence);
-    }
-  }
-
-  /*
-   * Compute the new loop dependence graph
+   * Compute the view of the loop dependence graph that ignores memory
+   * dependences.
    */
-  auto loopDGWithoutMemoryDeps =
-      loopDG->createSubgraphFromValues(loopInternals, false, memDeps);
+  auto isNotMemoryDependence = [](DGEdge<Value> *dep) -> bool {
+    return !dep->isMemoryDependence();
+  };
+  PDGSubgraphView loopDGWithoutMemoryDeps(loopDG,
+                                          loopInternals,
+                                          false,
+                                          isNotMemoryDependence);
 
   /*
    * Compute the SCCDAG
    */
-  auto loopSCCDAGWithoutMemoryDeps = new SCCDAG(loopDGWithoutMemoryDeps);
+  auto loopSCCDAGWithoutMemoryDeps = new SCCDAG(&loopDGWithoutMemoryDeps);
 
   return loopSCCDAGWithoutMemoryDeps;
 }
@@ -724,7 +979,6 @@ LoopDependenceInfo::~LoopDependenceInfo() {
     delete this->loopGoverningIVAttribution;
   }
 
-  assert(this->invariantManager);
   delete this->invariantManager;
 
   delete this->domainSpaceAnalysis;
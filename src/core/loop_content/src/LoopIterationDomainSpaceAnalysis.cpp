@@ -45,10 +45,57 @@ LoopIterationDomainSpaceAnalysis::LoopIterationDomainSpaceAnalysis(
   computeMemoryAccessSpace(SE);
   identifyIVForMemoryAccessSubscripts(SE);
   identifyNonOverlappingAccessesBetweenIterationsAcrossOneLoopInvocation(SE);
+  identifyAffineTestableAccesses(SE);
 
   return;
 }
 
+static bool getSmallConstant(const SCEV *scev, int64_t &value) {
+  auto constSCEV = dyn_cast<SCEVConstant>(scev);
+  if (!constSCEV) {
+    return false;
+  }
+
+  /*
+   * Keep the arithmetic of the dependence tests far from overflowing.
+   */
+  auto &apValue = constSCEV->getAPInt();
+  if (apValue.getMinSignedBits() > 32) {
+    return false;
+  }
+  value = apValue.getSExtValue();
+
+  return true;
+}
+
+static bool splitConstantTerm(const SCEV *scev,
+                              int64_t &constantTerm,
+                              SmallVector<const SCEV *, 4> &otherTerms) {
+  constantTerm = 0;
+  otherTerms.clear();
+
+  SmallVector<const SCEV *, 4> terms;
+  if (auto addSCEV = dyn_cast<SCEVAddExpr>(scev)) {
+    terms.append(addSCEV->op_begin(), addSCEV->op_end());
+  } else {
+    terms.push_back(scev);
+  }
+
+  for (auto term : terms) {
+    if (isa<SCEVConstant>(term)) {
+      int64_t value;
+      if (!getSmallConstant(term, value)) {
+        return false;
+      }
+      constantTerm += value;
+      continue;
+    }
+    otherTerms.push_back(term);
+  }
+
+  return true;
+}
+
 bool LoopIterationDomainSpaceAnalysis::
     areInstructionsAccessingDisjointMemoryLocationsBetweenIterations(
         Instruction *I,
@@ -86,6 +133,259 @@ bool LoopIterationDomainSpaceAnalysis::
                                                                accessSpaceJ);
 }
 
+std::vector<InductionVariable *> LoopIterationDomainSpaceAnalysis::
+    getInductionVariablesOfSubscripts(Instruction *memoryAccess) const {
+  std::vector<InductionVariable *> ivs{};
+
+  /*
+   * Fetch the memory space accessed.
+   */
+  auto spaceIt = this->accessSpaceByInstruction.find(memoryAccess);
+  if (spaceIt == this->accessSpaceByInstruction.end()) {
+    return ivs;
+  }
+  auto space = spaceIt->second;
+
+  /*
+   * Collect the induction variable of each dimension.
+   */
+  for (auto instIVPair : space->subscriptIVs) {
+    ivs.push_back(instIVPair.second);
+  }
+
+  return ivs;
+}
+
+std::vector<InductionVariable *> LoopIterationDomainSpaceAnalysis::
+    getInductionVariablesOfAffineSubscripts(Instruction *memoryAccess) const {
+  std::vector<InductionVariable *> ivs{};
+
+  /*
+   * Fetch the memory space accessed.
+   * Its subscripts must identify a unique location.
+   */
+  auto spaceIt = this->accessSpaceByInstruction.find(memoryAccess);
+  if (spaceIt == this->accessSpaceByInstruction.end()) {
+    return ivs;
+  }
+  auto space = spaceIt->second;
+  if (this->affineTestableAccesses.find(space)
+      == this->affineTestableAccesses.end()) {
+    return ivs;
+  }
+
+  /*
+   * Check the subscript of each dimension.
+   */
+  auto numSubscripts = space->subscripts.size();
+  for (auto i = 0u; i < numSubscripts; ++i) {
+    auto iv = space->subscriptIVs[i].second;
+    auto addRec = dyn_cast<SCEVAddRecExpr>(space->subscripts[i]);
+    if ((iv == nullptr) || (addRec == nullptr) || !addRec->isAffine()) {
+      ivs.push_back(nullptr);
+      continue;
+    }
+
+    /*
+     * The subscript must evolve with the loop of the induction variable only.
+     */
+    auto ivHeader = iv->getLoopEntryPHI()->getParent();
+    auto step = dyn_cast<SCEVConstant>(addRec->getOperand(1));
+    if ((addRec->getLoop()->getHeader() != ivHeader) || (step == nullptr)
+        || step->isZero() || !this->isInvariantInTopLoop(addRec->getStart())) {
+      ivs.push_back(nullptr);
+      continue;
+    }
+    ivs.push_back(iv);
+  }
+
+  return ivs;
+}
+
+LoopIterationDomainSpaceAnalysis::DependenceTestResult
+LoopIterationDomainSpaceAnalysis::computeDependenceDistanceBetweenIterations(
+    Instruction *from,
+    Instruction *to,
+    int64_t &distance) const {
+
+  /*
+   * Fetch the memory spaces accessed.
+   */
+  auto fromIt = this->accessSpaceByInstruction.find(from);
+  auto toIt = this->accessSpaceByInstruction.find(to);
+  if ((fromIt == this->accessSpaceByInstruction.end())
+      || (toIt == this->accessSpaceByInstruction.end())) {
+    return UNKNOWN_DISTANCE;
+  }
+  auto fromSpace = fromIt->second;
+  auto toSpace = toIt->second;
+  if ((this->affineTestableAccesses.find(fromSpace)
+       == this->affineTestableAccesses.end())
+      || (this->affineTestableAccesses.find(toSpace)
+          == this->affineTestableAccesses.end())) {
+    return UNKNOWN_DISTANCE;
+  }
+
+  /*
+   * Subscripts can only be compared dimension by dimension if they index the
+   * same array with the same shape, and the two instructions access elements
+   * of the same type (the element size of a memory space comes from only one
+   * of its accesses).
+   */
+  auto getAccessedType = [](Instruction *inst) -> Type * {
+    if (auto store = dyn_cast<StoreInst>(inst)) {
+      return store->getValueOperand()->getType();
+    }
+    if (auto load = dyn_cast<LoadInst>(inst)) {
+      return load->getType();
+    }
+    return nullptr;
+  };
+  auto fromType = getAccessedType(from);
+  if ((fromType == nullptr) || (fromType != getAccessedType(to))) {
+    return UNKNOWN_DISTANCE;
+  }
+  if (!fromSpace->isDelinearized) {
+    auto fromGEP = dyn_cast<GetElementPtrInst>(fromSpace->memoryAccessor);
+    auto toGEP = dyn_cast<GetElementPtrInst>(toSpace->memoryAccessor);
+    if ((fromGEP == nullptr) || (toGEP == nullptr)
+        || (fromGEP->getSourceElementType()
+            != toGEP->getSourceElementType())) {
+      return UNKNOWN_DISTANCE;
+    }
+  }
+  auto numSubscripts = fromSpace->subscripts.size();
+  if ((fromSpace->subscriptsBase != toSpace->subscriptsBase)
+      || (fromSpace->isDelinearized != toSpace->isDelinearized)
+      || (fromSpace->elementSize != toSpace->elementSize)
+      || (numSubscripts != toSpace->subscripts.size())) {
+    return UNKNOWN_DISTANCE;
+  }
+  if ((numSubscripts > 1) && (fromSpace->sizes != toSpace->sizes)) {
+    return UNKNOWN_DISTANCE;
+  }
+
+  /*
+   * Test each dimension.
+   * A dimension constrains the iterations i1 (of @from) and i2 (of @to) that
+   * can access the same location only if both subscripts have the same
+   * non-constant terms.
+   */
+  auto topLoop = this->loops->getLoop();
+  auto isWithinTopLoop = [topLoop](const SCEVAddRecExpr *addRec) -> bool {
+    return topLoop->isIncluded(addRec->getLoop()->getHeader());
+  };
+  auto hasDistance = false;
+  auto isDistanceVarying = false;
+  int64_t commonDistance = 0;
+  for (auto i = 0u; i < numSubscripts; ++i) {
+
+    /*
+     * Split each subscript into start + step * (iteration of the loop it
+     * evolves in).
+     * Subscripts invariant in the top loop have a step of zero.
+     */
+    auto splitSubscript = [this, &isWithinTopLoop](const SCEV *subscript,
+                                                   const SCEV *&start,
+                                                   int64_t &step,
+                                                   const Loop *&loop) -> bool {
+      start = subscript;
+      step = 0;
+      loop = nullptr;
+      if (this->isInvariantInTopLoop(subscript)) {
+        return true;
+      }
+      auto addRec = dyn_cast<SCEVAddRecExpr>(subscript);
+      if ((addRec == nullptr) || (!addRec->isAffine())
+          || (!isWithinTopLoop(addRec))) {
+        return false;
+      }
+      if (!getSmallConstant(addRec->getOperand(1), step)) {
+        return false;
+      }
+      start = addRec->getStart();
+      loop = addRec->getLoop();
+      return this->isInvariantInTopLoop(start);
+    };
+    const SCEV *fromStart;
+    const SCEV *toStart;
+    int64_t fromStep, toStep;
+    const Loop *fromLoop;
+    const Loop *toLoop;
+    if (!splitSubscript(fromSpace->subscripts[i], fromStart, fromStep, fromLoop)
+        || !splitSubscript(toSpace->subscripts[i], toStart, toStep, toLoop)) {
+      continue;
+    }
+
+    /*
+     * The starts must differ by a constant for the tests to apply.
+     */
+    int64_t fromConstant, toConstant;
+    SmallVector<const SCEV *, 4> fromTerms, toTerms;
+    if (!splitConstantTerm(fromStart, fromConstant, fromTerms)
+        || !splitConstantTerm(toStart, toConstant, toTerms)
+        || (fromTerms != toTerms)) {
+      continue;
+    }
+    auto startDifference = fromConstant - toConstant;
+
+    /*
+     * ZIV test: neither subscript evolves in the top loop.
+     */
+    if ((fromLoop == nullptr) && (toLoop == nullptr)) {
+      if (startDifference != 0) {
+        return NO_DEPENDENCE;
+      }
+      continue;
+    }
+
+    /*
+     * Exact strong SIV test: both subscripts evolve in the same loop with the
+     * same step, so fromConstant + step * i1 = toConstant + step * i2 fixes
+     * i2 - i1.
+     */
+    if ((fromLoop == toLoop) && (fromStep == toStep) && (fromStep != 0)) {
+      if ((startDifference % fromStep) != 0) {
+        return NO_DEPENDENCE;
+      }
+      if (fromLoop->getHeader() != topLoop->getHeader()) {
+        continue;
+      }
+      auto dimensionDistance = startDifference / fromStep;
+      if (hasDistance && (dimensionDistance != commonDistance)) {
+        return NO_DEPENDENCE;
+      }
+      hasDistance = true;
+      commonDistance = dimensionDistance;
+      continue;
+    }
+
+    /*
+     * GCD test (weak SIV and MIV subscripts): fromStep * i1 - toStep * i2 =
+     * -startDifference has an integer solution only if the GCD of the steps
+     * divides the difference of the starts.
+     */
+    auto gcd = (int64_t)GreatestCommonDivisor64(
+        (uint64_t)(fromStep < 0 ? -fromStep : fromStep),
+        (uint64_t)(toStep < 0 ? -toStep : toStep));
+    if ((gcd != 0) && ((startDifference % gcd) != 0)) {
+      return NO_DEPENDENCE;
+    }
+    auto isTopLoop = [topLoop](const Loop *loop) -> bool {
+      return (loop != nullptr) && (loop->getHeader() == topLoop->getHeader());
+    };
+    if (isTopLoop(fromLoop) || isTopLoop(toLoop)) {
+      isDistanceVarying = true;
+    }
+  }
+  if (isDistanceVarying || !hasDistance) {
+    return UNKNOWN_DISTANCE;
+  }
+  distance = commonDistance;
+
+  return CONSTANT_DISTANCE;
+}
+
 bool LoopIterationDomainSpaceAnalysis::
     isMemoryAccessSpaceEquivalentForTopLoopIVSubscript(
         MemoryAccessSpace *space1,
@@ -238,9 +538,12 @@ void LoopIterationDomainSpaceAnalysis::computeMemoryAccessSpace(
      * Determine the accessed type
      */
     Type *accessedType = nullptr;
-    for (auto accesses : accessSpaceByInstruction) {
-      Instruction *accessor = accesses.first;
+    for (auto user : memoryAccessor->users()) {
+      auto accessor = cast<Instruction>(user);
       if (auto store = dyn_cast<StoreInst>(accessor)) {
+        if (store->getPointerOperand() != memoryAccessor) {
+          continue;
+        }
         accessedType = store->getValueOperand()->getType();
       } else if (auto load = dyn_cast<LoadInst>(accessor)) {
         accessedType = load->getType();
@@ -286,10 +589,14 @@ void LoopIterationDomainSpaceAnalysis::computeMemoryAccessSpace(
                                                 memAccessSpace->subscripts,
                                                 memAccessSpace->sizes,
                                                 memAccessSpace->elementSize);
+    memAccessSpace->subscriptsBase = basePointer;
+    memAccessSpace->isDelinearized = true;
 
     if (memAccessSpace->subscripts.size() == 0) {
+      memAccessSpace->isDelinearized = false;
       if (auto gep =
               dyn_cast<GetElementPtrInst>(memAccessSpace->memoryAccessor)) {
+        memAccessSpace->subscriptsBase = SE.getSCEV(gep->getPointerOperand());
         SmallVector<int, 4> sizes;
         ScalarEvolutionDelinearization::getIndexExpressionsFromGEP(
             SE,
@@ -635,7 +942,11 @@ void LoopIterationDomainSpaceAnalysis::identifyIVForMemoryAccessSubscripts(
 
 LoopIterationDomainSpaceAnalysis::MemoryAccessSpace::MemoryAccessSpace(
     Instruction *memoryAccessor)
-  : memoryAccessor{ memoryAccessor } {}
+  : memoryAccessor{ memoryAccessor },
+    memoryAccessorSCEV{ nullptr },
+    elementSize{ nullptr },
+    subscriptsBase{ nullptr },
+    isDelinearized{ false } {}
 
 LoopIterationDomainSpaceAnalysis::~LoopIterationDomainSpaceAnalysis() {
   accessSpaces.clear();
@@ -931,4 +1242,46 @@ bool LoopIterationDomainSpaceAnalysis::isInnerDimensionSubscriptsBounded(
   return true;
 }
 
+void LoopIterationDomainSpaceAnalysis::identifyAffineTestableAccesses(
+    ScalarEvolution &SE) {
+  for (auto &space : this->accessSpaces) {
+    auto numSubscripts = space->subscripts.size();
+    if ((numSubscripts == 0) || (space->elementSize == nullptr)
+        || (space->subscriptsBase == nullptr)) {
+      continue;
+    }
+
+    /*
+     * The subscripts of a multi-dimensional access identify a unique location
+     * only if the inner dimensions stay within their bounds.
+     */
+    if ((numSubscripts > 1)
+        && !this->isInnerDimensionSubscriptsBounded(SE, space.get())) {
+      continue;
+    }
+
+    this->affineTestableAccesses.insert(space.get());
+  }
+
+  return;
+}
+
+bool LoopIterationDomainSpaceAnalysis::isInvariantInTopLoop(
+    const SCEV *scev) const {
+  auto topLoop = this->loops->getLoop();
+  auto isVariant = [topLoop](const SCEV *s) -> bool {
+    if (auto addRec = dyn_cast<SCEVAddRecExpr>(s)) {
+      return topLoop->isIncluded(addRec->getLoop()->getHeader());
+    }
+    if (auto unknown = dyn_cast<SCEVUnknown>(s)) {
+      if (auto inst = dyn_cast<Instruction>(unknown->getValue())) {
+        return topLoop->isIncluded(inst);
+      }
+    }
+    return false;
+  };
+
+  return !SCEVExprContains(scev, isVariant);
+}
+
 } // namespace llvm::noelle
@@ -89,6 +89,7 @@ public:
 
   Value *getEnvironmentVariable(uint32_t id) const;
   uint32_t getIndexOfEnvironmentVariable(uint32_t id) const;
+  uint64_t getOffsetOfEnvironmentVariable(uint32_t id) const;
   bool isIncludedEnvironmentVariable(uint32_t id) const;
   Value *getAccumulatedReducedEnvironmentVariable(uint32_t id) const;
   Value *getReducedEnvironmentVariable(uint32_t id, uint32_t reducerInd) const;
@@ -110,6 +111,20 @@ private:
   std::unordered_map<uint32_t, uint32_t> envIDToIndex;
   std::unordered_map<uint32_t, uint32_t> indexToEnvID;
 
+  /*
+   * Layout of the environment array.
+   *
+   * Variables written by the tasks come first and each one has its own cache
+   * line, so the offset of the variable with index i is i times the number of
+   * int64 values in a cache line.
+   * Variables only read by the tasks (e.g., live-ins) follow and they are
+   * packed one per int64 value.
+   * envIndexToOffset maps the index of a variable to its offset in int64
+   * values. envArraySize is the number of int64 values of the array.
+   */
+  std::unordered_map<uint32_t, uint64_t> envIndexToOffset;
+  uint64_t envArraySize;
+
   /*
    * The environment variable types and their allocations
    */
@@ -130,9 +145,12 @@ private:
   void initializeBuilder(const std::vector<Type *> &varTypes,
                          const std::set<uint32_t> &singleVarIDs,
                          const std::set<uint32_t> &reducableVarIDs,
+                         const std::set<uint32_t> &readOnlyVarIDs,
                          uint64_t reducerCount,
                          uint64_t numberOfUsers);
 
+  static bool canBePacked(Type *varType);
+
   void createUsers(uint32_t numUsers);
 };
 
@@ -27,7 +27,9 @@ namespace llvm::noelle {
 
 class LoopEnvironmentUser {
 public:
-  LoopEnvironmentUser(std::unordered_map<uint32_t, uint32_t> &envIDToIndex);
+  LoopEnvironmentUser(
+      std::unordered_map<uint32_t, uint32_t> &envIDToIndex,
+      std::unordered_map<uint32_t, uint64_t> &envIndexToOffset);
 
   LoopEnvironmentUser() = delete;
 
@@ -65,6 +67,7 @@ private:
   std::set<uint32_t> liveInIDs;
   std::set<uint32_t> liveOutIDs;
   std::unordered_map<uint32_t, uint32_t> &envIDToIndex;
+  std::unordered_map<uint32_t, uint64_t> &envIndexToOffset;
 };
 
 } // namespace llvm::noelle
@@ -57,9 +57,14 @@ LoopEnvironmentBuilder::LoopEnvironmentBuilder(
 
   /*
    * Group environment variables into reducable and not.
+   *
+   * Tasks only read live-in variables.
+   * Tasks also only read the environment variable of a reducable variable,
+   * which points to the private copies of the tasks.
    */
   std::set<uint32_t> nonReducableVars;
   std::set<uint32_t> reducableVars;
+  std::set<uint32_t> readOnlyVars;
   for (auto liveInVariableID : environment->getEnvIDsOfLiveInVars()) {
     if (shouldThisVariableBeSkipped(liveInVariableID, false)) {
       continue;
@@ -69,6 +74,7 @@ LoopEnvironmentBuilder::LoopEnvironmentBuilder(
     } else {
       nonReducableVars.insert(liveInVariableID);
     }
+    readOnlyVars.insert(liveInVariableID);
   }
   for (auto liveOutVariableID : environment->getEnvIDsOfLiveOutVars()) {
     if (shouldThisVariableBeSkipped(liveOutVariableID, true)) {
@@ -76,6 +82,7 @@ LoopEnvironmentBuilder::LoopEnvironmentBuilder(
     }
     if (shouldThisVariableBeReduced(liveOutVariableID, true)) {
       reducableVars.insert(liveOutVariableID);
+      readOnlyVars.insert(liveOutVariableID);
     } else {
       nonReducableVars.insert(liveOutVariableID);
     }
@@ -94,6 +101,7 @@ LoopEnvironmentBuilder::LoopEnvironmentBuilder(
   this->initializeBuilder(environment->getTypesOfEnvironmentLocations(),
                           nonReducableVars,
                           reducableVars,
+                          readOnlyVars,
                           reducerCount,
                           numberOfUsers);
 
@@ -110,11 +118,15 @@ LoopEnvironmentBuilder::LoopEnvironmentBuilder(
   : CXT{ cxt } {
 
   /*
-   * Initialize the builder
+   * Initialize the builder.
+   *
+   * We do not know which variables are only read by the tasks, so every
+   * variable gets its own cache line.
    */
   this->initializeBuilder(varTypes,
                           singleVarIDs,
                           reducableVarIDs,
+                          {},
                           reducerCount,
                           numberOfUsers);
 
@@ -125,24 +137,66 @@ void LoopEnvironmentBuilder::initializeBuilder(
     const std::vector<Type *> &varTypes,
     const std::set<uint32_t> &singleVarIDs,
     const std::set<uint32_t> &reducableVarIDs,
+    const std::set<uint32_t> &readOnlyVarIDs,
     uint64_t reducerCount,
     uint64_t numberOfUsers) {
 
   /*
-   * Build up envID to index map and reverse map
+   * Split the variables between the ones that need their own cache line and
+   * the ones that can be packed.
+   *
+   * A variable can be packed if tasks only read it and it fits in an int64
+   * value.
+   */
+  std::vector<uint32_t> paddedVarIDs;
+  std::vector<uint32_t> packedVarIDs;
+  auto splitVariable = [&](uint32_t varID) {
+    if ((readOnlyVarIDs.find(varID) != readOnlyVarIDs.end())
+        && canBePacked(varTypes.at(varID))) {
+      packedVarIDs.push_back(varID);
+    } else {
+      paddedVarIDs.push_back(varID);
+    }
+  };
+  for (auto singleVarID : singleVarIDs) {
+    splitVariable(singleVarID);
+  }
+  for (auto reducableVarID : reducableVarIDs) {
+    splitVariable(reducableVarID);
+  }
+
+  /*
+   * Compute how many values can fit in a cache line.
+   */
+  auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
+
+  /*
+   * Build up envID to index map and reverse map, and lay out the variables.
    */
   uint32_t index = 0;
-  for (auto singleVarID : singleVarIDs) {
-    this->envIDToIndex[singleVarID] = index;
-    this->indexToEnvID[index] = singleVarID;
+  uint64_t offset = 0;
+  for (auto varID : paddedVarIDs) {
+    this->envIDToIndex[varID] = index;
+    this->indexToEnvID[index] = varID;
+    this->envIndexToOffset[index] = offset;
     index++;
+    offset += valuesInCacheLine;
   }
-  for (auto reducableVarID : reducableVarIDs) {
-    this->envIDToIndex[reducableVarID] = index;
-    this->indexToEnvID[index] = reducableVarID;
+  for (auto varID : packedVarIDs) {
+    this->envIDToIndex[varID] = index;
+    this->indexToEnvID[index] = varID;
+    this->envIndexToOffset[index] = offset;
     index++;
+    offset++;
   }
 
+  /*
+   * Round the size of the array up to whole cache lines, so variables added
+   * later start on their own cache line.
+   */
+  this->envArraySize = ((offset + valuesInCacheLine - 1) / valuesInCacheLine)
+                       * valuesInCacheLine;
+
   /*
    * Initialize fields
    */
@@ -162,16 +216,11 @@ void LoopEnvironmentBuilder::initializeBuilder(
   assert(this->envSize == this->envTypes.size()
          && "Environment variables must either be singular or reducible\n");
 
-  /*
-   * Compute how many values can fit in a cache line.
-   */
-  auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
-
   /*
    * Define the LLVM type for the array of environment values.
    */
   auto int64 = IntegerType::get(this->CXT, 64);
-  this->envArrayType = ArrayType::get(int64, this->envSize * valuesInCacheLine);
+  this->envArrayType = ArrayType::get(int64, this->envArraySize);
 
   /*
    * Initialize the index-to-variable map.
@@ -195,12 +244,34 @@ void LoopEnvironmentBuilder::initializeBuilder(
 
 void LoopEnvironmentBuilder::createUsers(uint32_t numUsers) {
   for (auto i = 0u; i < numUsers; ++i) {
-    this->envUsers.push_back(new LoopEnvironmentUser(this->envIDToIndex));
+    this->envUsers.push_back(
+        new LoopEnvironmentUser(this->envIDToIndex, this->envIndexToOffset));
   }
 
   return;
 }
 
+bool LoopEnvironmentBuilder::canBePacked(Type *varType) {
+  assert(varType != nullptr);
+
+  /*
+   * Pointers are stored in int64 values.
+   */
+  if (varType->isPointerTy()) {
+    return true;
+  }
+
+  /*
+   * Check scalars.
+   */
+  if (varType->isIntegerTy() || varType->isFloatingPointTy()) {
+    auto bits = varType->getPrimitiveSizeInBits();
+    return (bits > 0) && (bits <= 64);
+  }
+
+  return false;
+}
+
 void LoopEnvironmentBuilder::addVariableToEnvironment(uint64_t varID,
                                                       Type *varType) {
 
@@ -218,19 +289,21 @@ void LoopEnvironmentBuilder::addVariableToEnvironment(uint64_t varID,
          && "This variable is already in of the environment\n");
   this->envIDToIndex[varID] = this->envSize;
   this->indexToEnvID[this->envSize] = varID;
-  this->envSize++;
   this->envTypes.push_back(varType);
 
   /*
-   * Compute how many values can fit in a cache line.
+   * The new variable gets its own cache line at the end of the array.
    */
   auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
+  this->envIndexToOffset[this->envSize] = this->envArraySize;
+  this->envArraySize += valuesInCacheLine;
+  this->envSize++;
 
   /*
    * Define the LLVM type for the array of environment values.
    */
   auto int64 = IntegerType::get(this->CXT, 64);
-  this->envArrayType = ArrayType::get(int64, this->envSize * valuesInCacheLine);
+  this->envArrayType = ArrayType::get(int64, this->envArraySize);
 
   /*
    * Set the index-to-var map for the new variable.
@@ -276,21 +349,12 @@ void LoopEnvironmentBuilder::generateEnvVariables(IRBuilder<> builder) {
   auto int64 = IntegerType::get(builder.getContext(), 64);
   auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
   auto fetchCastedEnvPtr =
-      [&](Value *arr, int envIndex, Type *ptrType) -> Value * {
+      [&](Value *arr, uint64_t offset, Type *ptrType) -> Value * {
     /*
-     * Compute the offset of the variable with index "envIndex" that is stored
-     * inside the environment.
-     *
-     * Compute how many values can fit in a cache line.
-     */
-    auto valuesInCacheLine =
-        Architecture::getCacheLineBytes() / sizeof(int64_t);
-    auto indValue =
-        cast<Value>(ConstantInt::get(int64, envIndex * valuesInCacheLine));
-
-    /*
-     * Compute the address of the variable with index "envIndex".
+     * Compute the address of the value stored at "offset" (in int64 values)
+     * inside the array.
      */
+    auto indValue = cast<Value>(ConstantInt::get(int64, offset));
     auto envPtr =
         builder.CreateInBoundsGEP(arr, ArrayRef<Value *>({ zeroV, indValue }));
 
@@ -315,7 +379,9 @@ void LoopEnvironmentBuilder::generateEnvVariables(IRBuilder<> builder) {
   for (auto envIndex : singleIndices) {
     auto ptrType = PointerType::getUnqual(this->envTypes[envIndex]);
     this->envIndexToVar[envIndex] =
-        fetchCastedEnvPtr(this->envArray, envIndex, ptrType);
+        fetchCastedEnvPtr(this->envArray,
+                          this->envIndexToOffset.at(envIndex),
+                          ptrType);
   }
 
   /*
@@ -360,14 +426,17 @@ void LoopEnvironmentBuilder::generateEnvVariables(IRBuilder<> builder) {
      * environment.
      */
     auto reduceArrPtrType = PointerType::getUnqual(reduceArrAlloca->getType());
-    auto envPtr = fetchCastedEnvPtr(this->envArray, envIndex, reduceArrPtrType);
+    auto envPtr = fetchCastedEnvPtr(this->envArray,
+                                    this->envIndexToOffset.at(envIndex),
+                                    reduceArrPtrType);
     builder.CreateStore(reduceArrAlloca, envPtr);
 
     /*
      * Compute and cache the pointer of each element of the vectorized variable.
      */
     for (auto i = 0u; i < this->numReducers; ++i) {
-      auto reducePtr = fetchCastedEnvPtr(reduceArrAlloca, i, ptrType);
+      auto reducePtr =
+          fetchCastedEnvPtr(reduceArrAlloca, i * valuesInCacheLine, ptrType);
       this->envIndexToReducableVar[envIndex].push_back(reducePtr);
     }
   }
@@ -627,6 +696,13 @@ uint32_t LoopEnvironmentBuilder::getIndexOfEnvironmentVariable(
   return this->envIDToIndex.at(id);
 }
 
+uint64_t LoopEnvironmentBuilder::getOffsetOfEnvironmentVariable(
+    uint32_t id) const {
+  auto ind = this->getIndexOfEnvironmentVariable(id);
+
+  return this->envIndexToOffset.at(ind);
+}
+
 bool LoopEnvironmentBuilder::isIncludedEnvironmentVariable(uint32_t id) const {
   return (this->envIDToIndex.find(id) != this->envIDToIndex.end());
 }
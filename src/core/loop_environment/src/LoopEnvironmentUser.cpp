@@ -25,11 +25,13 @@
 namespace llvm::noelle {
 
 LoopEnvironmentUser::LoopEnvironmentUser(
-    std::unordered_map<uint32_t, uint32_t> &envIDToIndex)
+    std::unordered_map<uint32_t, uint32_t> &envIDToIndex,
+    std::unordered_map<uint32_t, uint64_t> &envIndexToOffset)
   : envIndexToPtr{},
     liveInIDs{},
     liveOutIDs{},
-    envIDToIndex{ envIDToIndex } {
+    envIDToIndex{ envIDToIndex },
+    envIndexToOffset{ envIndexToOffset } {
   envIndexToPtr.clear();
   liveInIDs.clear();
   liveOutIDs.clear();
@@ -70,16 +72,11 @@ Instruction *LoopEnvironmentUser::createEnvironmentVariablePointer(
   auto int64 = IntegerType::get(builder.getContext(), 64);
   auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
 
-  /*
-   * Compute how many values can fit in a cache line.
-   */
-  auto valuesInCacheLine = Architecture::getCacheLineBytes() / sizeof(int64_t);
-
   /*
    * Compute the offset of the environment variable.
    */
   auto envIndV =
-      cast<Value>(ConstantInt::get(int64, envIndex * valuesInCacheLine));
+      cast<Value>(ConstantInt::get(int64, this->envIndexToOffset.at(envIndex)));
 
   /*
    * Compute the address of the environment variable
@@ -124,7 +121,7 @@ void LoopEnvironmentUser::createReducableEnvPtr(IRBuilder<> builder,
   auto int64 = IntegerType::get(builder.getContext(), 64);
   auto zeroV = cast<Value>(ConstantInt::get(int64, 0));
   auto envIndV =
-      cast<Value>(ConstantInt::get(int64, envIndex * valuesInCacheLine));
+      cast<Value>(ConstantInt::get(int64, this->envIndexToOffset.at(envIndex)));
 
   auto envReduceGEP =
       builder.CreateInBoundsGEP(this->envArray,
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/LoopStructure.hpp"
+#include "noelle/core/LoopDependenceInfo.hpp"
+#include "noelle/core/PDG.hpp"
+
+namespace llvm::noelle {
+
+class LoopFusion {
+public:
+  /*
+   * Methods
+   */
+  LoopFusion();
+
+  /*
+   * Check if the loop @second can be fused into the loop @first.
+   *
+   * The two loops need to be siblings with @second executed right after
+   * @first, they need to iterate the same number of times, and every
+   * dependence from @first to @second needs to connect the same iteration of
+   * the two loops.
+   */
+  bool canFuseLoops(LoopDependenceInfo const &first,
+                    LoopDependenceInfo const &second,
+                    PDG *pdg,
+                    LoopInfo &LI,
+                    DominatorTree &DT,
+                    ScalarEvolution &SE);
+
+  /*
+   * Fuse the loop @second into the loop @first.
+   * The body of @second runs at the end of every iteration of @first.
+   */
+  bool fuseLoops(LoopDependenceInfo const &first,
+                 LoopDependenceInfo const &second,
+                 PDG *pdg,
+                 LoopInfo &LI,
+                 DominatorTree &DT,
+                 ScalarEvolution &SE);
+
+private:
+  /*
+   * Methods
+   */
+  bool haveFusableShapes(LoopStructure *first,
+                         LoopStructure *second,
+                         LoopInfo &LI);
+
+  bool haveTheSameIterationSpace(LoopDependenceInfo const &first,
+                                 LoopDependenceInfo const &second,
+                                 LoopInfo &LI,
+                                 ScalarEvolution &SE);
+
+  bool areLiveValuesPreserved(LoopStructure *first,
+                              LoopStructure *second,
+                              DominatorTree &DT);
+
+  bool areDependencesPreserved(LoopStructure *first,
+                               LoopStructure *second,
+                               PDG *pdg,
+                               LoopInfo &LI,
+                               ScalarEvolution &SE);
+
+  bool doTheyAccessTheSameLocationOnTheSameIteration(Instruction *fromInst,
+                                                     Loop *fromLoop,
+                                                     Instruction *toInst,
+                                                     Loop *toLoop,
+                                                     ScalarEvolution &SE);
+
+  void doFusion(LoopStructure *first, LoopStructure *second);
+};
+
+} // namespace llvm::noelle
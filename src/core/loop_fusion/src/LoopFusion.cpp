@@ -0,0 +1,444 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopFusion.hpp"
+
+namespace llvm::noelle {
+
+bool LoopFusion::canFuseLoops(LoopDependenceInfo const &first,
+                              LoopDependenceInfo const &second,
+                              PDG *pdg,
+                              LoopInfo &LI,
+                              DominatorTree &DT,
+                              ScalarEvolution &SE) {
+  assert(pdg != nullptr);
+
+  /*
+   * Fetch the loops.
+   */
+  auto firstLS = first.getLoopStructure();
+  auto secondLS = second.getLoopStructure();
+  if (firstLS == secondLS) {
+    return false;
+  }
+
+  /*
+   * Check the control flow of the two loops.
+   */
+  if (!this->haveFusableShapes(firstLS, secondLS, LI)) {
+    return false;
+  }
+
+  /*
+   * Check that the two loops execute the same number of iterations.
+   */
+  if (!this->haveTheSameIterationSpace(first, second, LI, SE)) {
+    return false;
+  }
+
+  /*
+   * Check that values produced by the loops are still available where they
+   * are used.
+   */
+  if (!this->areLiveValuesPreserved(firstLS, secondLS, DT)) {
+    return false;
+  }
+
+  /*
+   * Check that the fusion does not reorder dependent instructions.
+   */
+  if (!this->areDependencesPreserved(firstLS, secondLS, pdg, LI, SE)) {
+    return false;
+  }
+
+  return true;
+}
+
+bool LoopFusion::fuseLoops(LoopDependenceInfo const &first,
+                           LoopDependenceInfo const &second,
+                           PDG *pdg,
+                           LoopInfo &LI,
+                           DominatorTree &DT,
+                           ScalarEvolution &SE) {
+
+  /*
+   * Check if the fusion is legal.
+   */
+  if (!this->canFuseLoops(first, second, pdg, LI, DT, SE)) {
+    return false;
+  }
+
+  /*
+   * Fuse the loops.
+   */
+  this->doFusion(first.getLoopStructure(), second.getLoopStructure());
+
+  return true;
+}
+
+bool LoopFusion::haveFusableShapes(LoopStructure *first,
+                                   LoopStructure *second,
+                                   LoopInfo &LI) {
+
+  /*
+   * The two loops must belong to the same function and be siblings.
+   */
+  if (first->getFunction() != second->getFunction()) {
+    return false;
+  }
+  auto firstLoop = LI.getLoopFor(first->getHeader());
+  auto secondLoop = LI.getLoopFor(second->getHeader());
+  if ((firstLoop == nullptr) || (secondLoop == nullptr)) {
+    return false;
+  }
+  if (firstLoop->getParentLoop() != secondLoop->getParentLoop()) {
+    return false;
+  }
+
+  /*
+   * Both loops must be in while form: the header is the only block that
+   * exits the loop, and there is a single latch.
+   */
+  for (auto loop : { firstLoop, secondLoop }) {
+    if (loop->getExitingBlock() != loop->getHeader()) {
+      return false;
+    }
+    if (loop->getLoopLatch() == nullptr) {
+      return false;
+    }
+    if (loop->getLoopPreheader() == nullptr) {
+      return false;
+    }
+    if (loop->getExitBlock() == nullptr) {
+      return false;
+    }
+    auto headerBr = dyn_cast<BranchInst>(loop->getHeader()->getTerminator());
+    if ((headerBr == nullptr) || (!headerBr->isConditional())) {
+      return false;
+    }
+    auto latchBr = dyn_cast<BranchInst>(loop->getLoopLatch()->getTerminator());
+    if ((latchBr == nullptr) || (latchBr->isConditional())) {
+      return false;
+    }
+  }
+
+  /*
+   * The second loop must start right after the first one ends.
+   * The block in between must be empty so nothing needs to be moved.
+   */
+  auto betweenBB = firstLoop->getExitBlock();
+  if (betweenBB != secondLoop->getLoopPreheader()) {
+    return false;
+  }
+  if (betweenBB->getSinglePredecessor() != first->getHeader()) {
+    return false;
+  }
+  if (betweenBB->size() != 1) {
+    return false;
+  }
+
+  /*
+   * The exit block of the second loop must be reached only by the second loop.
+   */
+  auto secondExitBB = secondLoop->getExitBlock();
+  if (secondExitBB->getSinglePredecessor() != second->getHeader()) {
+    return false;
+  }
+
+  return true;
+}
+
+bool LoopFusion::haveTheSameIterationSpace(LoopDependenceInfo const &first,
+                                           LoopDependenceInfo const &second,
+                                           LoopInfo &LI,
+                                           ScalarEvolution &SE) {
+
+  /*
+   * Both loops must be governed by an induction variable.
+   */
+  auto firstGIV = first.getLoopGoverningIVAttribution();
+  auto secondGIV = second.getLoopGoverningIVAttribution();
+  if ((firstGIV == nullptr) || (secondGIV == nullptr)) {
+    return false;
+  }
+
+  /*
+   * The governing induction variables must evolve in the same way.
+   */
+  auto &firstIV = firstGIV->getInductionVariable();
+  auto &secondIV = secondGIV->getInductionVariable();
+  if (firstIV.getStartValue() != secondIV.getStartValue()) {
+    return false;
+  }
+  if ((firstIV.getStepSCEV() == nullptr)
+      || (firstIV.getStepSCEV() != secondIV.getStepSCEV())) {
+    return false;
+  }
+
+  /*
+   * The two loops must execute the same number of iterations.
+   */
+  auto firstLoop = LI.getLoopFor(first.getLoopStructure()->getHeader());
+  auto secondLoop = LI.getLoopFor(second.getLoopStructure()->getHeader());
+  auto firstTripCount = SE.getBackedgeTakenCount(firstLoop);
+  auto secondTripCount = SE.getBackedgeTakenCount(secondLoop);
+  if (isa<SCEVCouldNotCompute>(firstTripCount)) {
+    return false;
+  }
+  if (firstTripCount != secondTripCount) {
+    return false;
+  }
+
+  return true;
+}
+
+bool LoopFusion::areLiveValuesPreserved(LoopStructure *first,
+                                        LoopStructure *second,
+                                        DominatorTree &DT) {
+
+  /*
+   * Values produced by the first loop cannot be consumed by the second one:
+   * they would be consumed one iteration at a time after the fusion.
+   */
+  for (auto bb : first->getBasicBlocks()) {
+    for (auto &inst : *bb) {
+      for (auto user : inst.users()) {
+        auto userInst = dyn_cast<Instruction>(user);
+        if (userInst == nullptr) {
+          continue;
+        }
+        if (second->isIncluded(userInst)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  /*
+   * Only the PHIs of the header of the second loop survive the fusion as
+   * values that dominate the code after the loop.
+   */
+  auto secondHeader = second->getHeader();
+  for (auto &inst : *secondHeader) {
+    if (isa<PHINode>(&inst)) {
+      continue;
+    }
+    for (auto user : inst.users()) {
+      auto userInst = dyn_cast<Instruction>(user);
+      if ((userInst == nullptr) || (!second->isIncluded(userInst))) {
+        return false;
+      }
+    }
+  }
+
+  /*
+   * The initial values of the second loop need to be available before the
+   * first loop starts.
+   */
+  auto firstPreHeader = first->getPreHeader();
+  for (auto &phi : secondHeader->phis()) {
+    auto initialValue =
+        phi.getIncomingValueForBlock(second->getPreHeader());
+    auto initialInst = dyn_cast<Instruction>(initialValue);
+    if (initialInst == nullptr) {
+      continue;
+    }
+    if (!DT.dominates(initialInst->getParent(), firstPreHeader)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool LoopFusion::areDependencesPreserved(LoopStructure *first,
+                                         LoopStructure *second,
+                                         PDG *pdg,
+                                         LoopInfo &LI,
+                                         ScalarEvolution &SE) {
+  auto firstLoop = LI.getLoopFor(first->getHeader());
+  auto secondLoop = LI.getLoopFor(second->getHeader());
+
+  /*
+   * Check every dependence that goes from the first loop to the second one.
+   *
+   * Dependences that go the other way are carried by an outer loop, which
+   * still executes the fused loop in order.
+   */
+  for (auto bb : first->getBasicBlocks()) {
+    for (auto &inst : *bb) {
+      auto node = pdg->fetchNode(&inst);
+      if (node == nullptr) {
+        continue;
+      }
+      for (auto edge : node->getOutgoingEdges()) {
+        if (edge->isControlDependence()) {
+          continue;
+        }
+        auto dst = dyn_cast<Instruction>(edge->getIncomingT());
+        if ((dst == nullptr) || (!second->isIncluded(dst))) {
+          continue;
+        }
+
+        /*
+         * Data dependences through variables have already been checked.
+         * Memory dependences are preserved only if both instructions access
+         * the same location on the same iteration, which the fused loop
+         * still executes in the original order.
+         */
+        if (!edge->isMemoryDependence()) {
+          return false;
+        }
+        if (!this->doTheyAccessTheSameLocationOnTheSameIteration(&inst,
+                                                                 firstLoop,
+                                                                 dst,
+                                                                 secondLoop,
+                                                                 SE)) {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+bool LoopFusion::doTheyAccessTheSameLocationOnTheSameIteration(
+    Instruction *fromInst,
+    Loop *fromLoop,
+    Instruction *toInst,
+    Loop *toLoop,
+    ScalarEvolution &SE) {
+
+  /*
+   * Fetch the memory accessed.
+   */
+  auto fromPtr = getLoadStorePointerOperand(fromInst);
+  auto toPtr = getLoadStorePointerOperand(toInst);
+  if ((fromPtr == nullptr) || (toPtr == nullptr)) {
+    return false;
+  }
+
+  /*
+   * The two instructions must access the same amount of memory.
+   */
+  auto fromType = cast<PointerType>(fromPtr->getType())->getElementType();
+  auto toType = cast<PointerType>(toPtr->getType())->getElementType();
+  auto &DL = fromInst->getModule()->getDataLayout();
+  if (DL.getTypeStoreSize(fromType) != DL.getTypeStoreSize(toType)) {
+    return false;
+  }
+
+  /*
+   * The addresses must be affine functions of the iteration of their own
+   * loop.
+   */
+  auto fromSCEV = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(fromPtr));
+  auto toSCEV = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(toPtr));
+  if ((fromSCEV == nullptr) || (toSCEV == nullptr)) {
+    return false;
+  }
+  if ((fromSCEV->getLoop() != fromLoop) || (toSCEV->getLoop() != toLoop)) {
+    return false;
+  }
+  if ((!fromSCEV->isAffine()) || (!toSCEV->isAffine())) {
+    return false;
+  }
+
+  /*
+   * The two functions must be the same.
+   */
+  if (fromSCEV->getStart() != toSCEV->getStart()) {
+    return false;
+  }
+  if (fromSCEV->getStepRecurrence(SE) != toSCEV->getStepRecurrence(SE)) {
+    return false;
+  }
+
+  return true;
+}
+
+void LoopFusion::doFusion(LoopStructure *first, LoopStructure *second) {
+
+  /*
+   * Fetch the basic blocks involved.
+   */
+  auto firstPreHeader = first->getPreHeader();
+  auto firstHeader = first->getHeader();
+  auto firstLatch = *first->getLatches().begin();
+  auto secondPreHeader = second->getPreHeader();
+  auto secondHeader = second->getHeader();
+  auto secondLatch = *second->getLatches().begin();
+  auto secondExitBB = second->getLoopExitBasicBlocks()[0];
+
+  /*
+   * The header of the second loop cannot exit anymore: the first loop exits
+   * on the same iteration.
+   */
+  auto secondHeaderBr = cast<BranchInst>(secondHeader->getTerminator());
+  auto secondBody = second->isIncluded(secondHeaderBr->getSuccessor(0))
+                        ? secondHeaderBr->getSuccessor(0)
+                        : secondHeaderBr->getSuccessor(1);
+  BranchInst::Create(secondBody, secondHeaderBr);
+  secondHeaderBr->eraseFromParent();
+
+  /*
+   * Move the PHIs of the second loop to the header of the fused loop.
+   */
+  std::vector<PHINode *> secondPHIs;
+  for (auto &phi : secondHeader->phis()) {
+    secondPHIs.push_back(&phi);
+  }
+  for (auto phi : secondPHIs) {
+    phi->moveBefore(firstHeader->getFirstNonPHI());
+    auto preHeaderIndex = phi->getBasicBlockIndex(secondPreHeader);
+    phi->setIncomingBlock(preHeaderIndex, firstPreHeader);
+  }
+
+  /*
+   * Chain the body of the second loop after the body of the first one, and
+   * close the fused loop with the latch of the second loop.
+   */
+  firstLatch->getTerminator()->replaceUsesOfWith(firstHeader, secondHeader);
+  secondLatch->getTerminator()->replaceUsesOfWith(secondHeader, firstHeader);
+  for (auto &phi : firstHeader->phis()) {
+    auto latchIndex = phi.getBasicBlockIndex(firstLatch);
+    if (latchIndex >= 0) {
+      phi.setIncomingBlock(latchIndex, secondLatch);
+    }
+  }
+
+  /*
+   * Exit the fused loop to the exit of the second loop.
+   */
+  auto betweenBr = secondPreHeader->getTerminator();
+  betweenBr->replaceUsesOfWith(secondHeader, secondExitBB);
+  for (auto &phi : secondExitBB->phis()) {
+    auto headerIndex = phi.getBasicBlockIndex(secondHeader);
+    if (headerIndex >= 0) {
+      phi.setIncomingBlock(headerIndex, secondPreHeader);
+    }
+  }
+
+  return;
+}
+
+} // namespace llvm::noelle
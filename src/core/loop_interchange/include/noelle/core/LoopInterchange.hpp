@@ -0,0 +1,114 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/LoopStructure.hpp"
+#include "noelle/core/LoopDependenceInfo.hpp"
+
+namespace llvm::noelle {
+
+class LoopInterchange {
+public:
+  /*
+   * Methods
+   */
+  LoopInterchange();
+
+  /*
+   * Check if the loop @innerLoop, which is the only loop nested in
+   * @outerLoop, can be swapped with @outerLoop.
+   *
+   * The two loops need to be perfectly nested, in while form, and governed by
+   * induction variables whose bounds are invariant in the whole loop nest.
+   * Moreover, every memory dependence of the nest needs to connect accesses to
+   * the same location that are indexed by both induction variables.
+   */
+  bool canInterchangeLoops(LoopDependenceInfo const &outerLoop,
+                           LoopStructure *innerLoop);
+
+  /*
+   * Check if the loop @innerLoop is the only code executed by @outerLoop, and
+   * if the two loops are in while form and governed by induction variables
+   * whose bounds are invariant in the whole loop nest.
+   */
+  bool isPerfectlyNestedRectangularLoopNest(LoopDependenceInfo const &outerLoop,
+                                            LoopStructure *innerLoop);
+
+  /*
+   * Swap the loop @outerLoop with the loop @innerLoop nested in it.
+   */
+  bool interchangeLoops(LoopDependenceInfo const &outerLoop,
+                        LoopStructure *innerLoop);
+
+  /*
+   * Check if the iterations of @outerLoop and @innerLoop can be reordered
+   * without changing the order of dependent memory accesses.
+   */
+  bool areDependencesPreserved(LoopDependenceInfo const &outerLoop,
+                               LoopStructure *innerLoop);
+
+  /*
+   * Count the memory accesses of the loop nest @outerLoop whose innermost
+   * dimension is indexed by the governing induction variable of @loop.
+   * These are the accesses that are unit-stride when @loop is the innermost
+   * loop of the nest.
+   */
+  uint64_t getNumberOfAccessesIndexedInTheInnermostDimension(
+      LoopDependenceInfo const &outerLoop,
+      LoopStructure *loop);
+
+private:
+  /*
+   * The instructions that control the iterations of a loop in while form.
+   */
+  struct LoopControl {
+    LoopStructure *loop;
+    PHINode *iv;
+    ICmpInst *exitCmp;
+    BinaryOperator *ivUpdate;
+  };
+
+  /*
+   * Methods
+   */
+  bool fetchLoopControl(LoopDependenceInfo const &outerLoop,
+                        LoopStructure *loop,
+                        LoopControl &control);
+
+  bool isPerfectlyNested(LoopControl &outer,
+                         LoopControl &inner,
+                         std::vector<Instruction *> &instructionsToSink);
+
+  bool isInvariantInLoop(LoopControl &control, LoopStructure *loop);
+
+  bool doTheyAccessTheSameLocationOnlyOnTheSameIteration(
+      Instruction *fromInst,
+      Instruction *toInst,
+      PHINode *outerIV,
+      PHINode *innerIV,
+      LoopIterationDomainSpaceAnalysis *domainSpace);
+
+  void swapLoopControls(LoopControl &outer, LoopControl &inner);
+};
+
+} // namespace llvm::noelle
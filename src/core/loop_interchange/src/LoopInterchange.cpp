@@ -0,0 +1,571 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopInterchange.hpp"
+
+namespace llvm::noelle {
+
+bool LoopInterchange::canInterchangeLoops(LoopDependenceInfo const &outerLoop,
+                                          LoopStructure *innerLoop) {
+  assert(innerLoop != nullptr);
+
+  /*
+   * The two loops must form a perfect, rectangular loop nest.
+   */
+  if (!this->isPerfectlyNestedRectangularLoopNest(outerLoop, innerLoop)) {
+    return false;
+  }
+
+  /*
+   * The new order of iterations must preserve the dependences.
+   */
+  if (!this->areDependencesPreserved(outerLoop, innerLoop)) {
+    return false;
+  }
+
+  return true;
+}
+
+bool LoopInterchange::isPerfectlyNestedRectangularLoopNest(
+    LoopDependenceInfo const &outerLoop,
+    LoopStructure *innerLoop) {
+  assert(innerLoop != nullptr);
+
+  /*
+   * The inner loop must be the only loop nested in the outer one.
+   */
+  auto outerNode = outerLoop.getLoopHierarchyStructures();
+  auto children = outerNode->getChildren();
+  if (children.size() != 1) {
+    return false;
+  }
+  auto innerNode = *children.begin();
+  if (innerNode->getLoop() != innerLoop) {
+    return false;
+  }
+
+  /*
+   * Fetch the instructions that control the iterations of the two loops.
+   */
+  LoopControl outer;
+  LoopControl inner;
+  if (!this->fetchLoopControl(outerLoop, outerLoop.getLoopStructure(), outer)) {
+    return false;
+  }
+  if (!this->fetchLoopControl(outerLoop, innerLoop, inner)) {
+    return false;
+  }
+  if (outer.iv->getType() != inner.iv->getType()) {
+    return false;
+  }
+
+  /*
+   * The iteration space of the loop nest must be rectangular.
+   */
+  if (!this->isInvariantInLoop(outer, outer.loop)) {
+    return false;
+  }
+  if (!this->isInvariantInLoop(inner, outer.loop)) {
+    return false;
+  }
+
+  /*
+   * The inner loop must be the only code executed by the outer loop.
+   */
+  std::vector<Instruction *> instructionsToSink{};
+  if (!this->isPerfectlyNested(outer, inner, instructionsToSink)) {
+    return false;
+  }
+
+  return true;
+}
+
+bool LoopInterchange::interchangeLoops(LoopDependenceInfo const &outerLoop,
+                                       LoopStructure *innerLoop) {
+
+  /*
+   * Check if the interchange is legal.
+   */
+  if (!this->canInterchangeLoops(outerLoop, innerLoop)) {
+    return false;
+  }
+
+  /*
+   * Fetch the instructions that control the iterations of the two loops.
+   */
+  LoopControl outer;
+  LoopControl inner;
+  this->fetchLoopControl(outerLoop, outerLoop.getLoopStructure(), outer);
+  this->fetchLoopControl(outerLoop, innerLoop, inner);
+  std::vector<Instruction *> instructionsToSink{};
+  this->isPerfectlyNested(outer, inner, instructionsToSink);
+
+  /*
+   * Move the computation executed by the outer loop only into the inner loop.
+   * This computation is going to depend on the induction variable of the new
+   * inner loop.
+   */
+  auto insertPoint = innerLoop->getHeader()->getFirstNonPHI();
+  for (auto inst : instructionsToSink) {
+    inst->moveBefore(insertPoint);
+  }
+
+  /*
+   * Swap the iteration spaces of the two loops.
+   */
+  this->swapLoopControls(outer, inner);
+
+  return true;
+}
+
+bool LoopInterchange::areDependencesPreserved(
+    LoopDependenceInfo const &outerLoop,
+    LoopStructure *innerLoop) {
+
+  /*
+   * Fetch the induction variables of the two loops.
+   */
+  LoopControl outer;
+  LoopControl inner;
+  if (!this->fetchLoopControl(outerLoop, outerLoop.getLoopStructure(), outer)) {
+    return false;
+  }
+  if (!this->fetchLoopControl(outerLoop, innerLoop, inner)) {
+    return false;
+  }
+
+  /*
+   * Check every memory dependence of the loop nest.
+   */
+  auto outerLS = outerLoop.getLoopStructure();
+  auto ldg = outerLoop.getLoopDG();
+  auto domainSpace = outerLoop.getLoopIterationDomainSpaceAnalysis();
+  for (auto edge : ldg->getEdges()) {
+    if (!edge->isMemoryDependence()) {
+      continue;
+    }
+    auto fromInst = dyn_cast<Instruction>(edge->getOutgoingT());
+    auto toInst = dyn_cast<Instruction>(edge->getIncomingT());
+    if ((fromInst == nullptr) || (toInst == nullptr)) {
+      continue;
+    }
+    if ((!outerLS->isIncluded(fromInst)) || (!outerLS->isIncluded(toInst))) {
+      continue;
+    }
+    if (!this->doTheyAccessTheSameLocationOnlyOnTheSameIteration(fromInst,
+                                                                 toInst,
+                                                                 outer.iv,
+                                                                 inner.iv,
+                                                                 domainSpace)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+uint64_t LoopInterchange::getNumberOfAccessesIndexedInTheInnermostDimension(
+    LoopDependenceInfo const &outerLoop,
+    LoopStructure *loop) {
+
+  /*
+   * Fetch the induction variable of the loop.
+   */
+  auto ivManager = outerLoop.getInductionVariableManager();
+  auto iv = ivManager->getLoopGoverningInductionVariable(*loop);
+  if (iv == nullptr) {
+    return 0;
+  }
+
+  /*
+   * Count the accesses that walk through the innermost dimension of the
+   * memory they access as @loop iterates.
+   */
+  uint64_t accesses = 0;
+  auto domainSpace = outerLoop.getLoopIterationDomainSpaceAnalysis();
+  for (auto inst : outerLoop.getLoopStructure()->getInstructions()) {
+    if ((!isa<LoadInst>(inst)) && (!isa<StoreInst>(inst))) {
+      continue;
+    }
+    auto ivs = domainSpace->getInductionVariablesOfSubscripts(inst);
+    if (ivs.size() == 0) {
+      continue;
+    }
+    if (ivs.back() == iv) {
+      accesses++;
+    }
+  }
+
+  return accesses;
+}
+
+bool LoopInterchange::fetchLoopControl(LoopDependenceInfo const &outerLoop,
+                                       LoopStructure *loop,
+                                       LoopControl &control) {
+
+  /*
+   * Fetch the governing induction variable of the loop.
+   */
+  auto ivManager = outerLoop.getInductionVariableManager();
+  auto iv = ivManager->getLoopGoverningInductionVariable(*loop);
+  if (iv == nullptr) {
+    return false;
+  }
+
+  /*
+   * The loop must have a pre-header and a single latch.
+   */
+  auto header = loop->getHeader();
+  auto latches = loop->getLatches();
+  if ((loop->getPreHeader() == nullptr) || (latches.size() != 1)) {
+    return false;
+  }
+  auto latch = *latches.begin();
+
+  /*
+   * The loop must be in while form: the header is the only block that exits
+   * the loop.
+   */
+  if (loop->numberOfExitBasicBlocks() != 1) {
+    return false;
+  }
+  for (auto bb : loop->getBasicBlocks()) {
+    if (bb == header) {
+      continue;
+    }
+    for (auto succ : successors(bb)) {
+      if (!loop->isIncluded(succ)) {
+        return false;
+      }
+    }
+  }
+
+  /*
+   * The governing induction variable must be the only value carried across
+   * iterations by the header.
+   */
+  auto phi = iv->getLoopEntryPHI();
+  if (phi->getParent() != header) {
+    return false;
+  }
+  for (auto &headerPHI : header->phis()) {
+    if (&headerPHI != phi) {
+      return false;
+    }
+  }
+  if (phi->getNumIncomingValues() != 2) {
+    return false;
+  }
+
+  /*
+   * The exit condition must compare the induction variable with a bound.
+   */
+  auto headerBr = dyn_cast<BranchInst>(header->getTerminator());
+  if ((headerBr == nullptr) || (!headerBr->isConditional())) {
+    return false;
+  }
+  auto exitCmp = dyn_cast<ICmpInst>(headerBr->getCondition());
+  if ((exitCmp == nullptr) || (exitCmp->getParent() != header)
+      || (!exitCmp->hasOneUse())) {
+    return false;
+  }
+  if ((exitCmp->getOperand(0) == phi) == (exitCmp->getOperand(1) == phi)) {
+    return false;
+  }
+
+  /*
+   * The induction variable must be updated by adding or subtracting a step.
+   */
+  auto ivUpdate = dyn_cast<BinaryOperator>(phi->getIncomingValueForBlock(latch));
+  if ((ivUpdate == nullptr) || (!ivUpdate->hasOneUse())) {
+    return false;
+  }
+  if ((ivUpdate->getOpcode() != Instruction::Add)
+      && (ivUpdate->getOpcode() != Instruction::Sub)) {
+    return false;
+  }
+  if ((ivUpdate->getOperand(0) == phi) == (ivUpdate->getOperand(1) == phi)) {
+    return false;
+  }
+  if ((ivUpdate->getOpcode() == Instruction::Sub)
+      && (ivUpdate->getOperand(0) != phi)) {
+    return false;
+  }
+
+  control.loop = loop;
+  control.iv = phi;
+  control.exitCmp = exitCmp;
+  control.ivUpdate = ivUpdate;
+
+  return true;
+}
+
+bool LoopInterchange::isInvariantInLoop(LoopControl &control,
+                                        LoopStructure *loop) {
+
+  /*
+   * Fetch the values that define the iteration space.
+   */
+  std::vector<Value *> values{};
+  values.push_back(
+      control.iv->getIncomingValueForBlock(control.loop->getPreHeader()));
+  for (auto &op : control.ivUpdate->operands()) {
+    if (op != control.iv) {
+      values.push_back(op);
+    }
+  }
+  for (auto &op : control.exitCmp->operands()) {
+    if (op != control.iv) {
+      values.push_back(op);
+    }
+  }
+
+  /*
+   * Check that none of them is computed by @loop.
+   */
+  for (auto value : values) {
+    auto inst = dyn_cast<Instruction>(value);
+    if (inst == nullptr) {
+      continue;
+    }
+    if (loop->isIncluded(inst)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool LoopInterchange::isPerfectlyNested(
+    LoopControl &outer,
+    LoopControl &inner,
+    std::vector<Instruction *> &instructionsToSink) {
+
+  /*
+   * The induction variables must be used only within their loops.
+   */
+  for (auto user : outer.iv->users()) {
+    if (!outer.loop->isIncluded(cast<Instruction>(user))) {
+      return false;
+    }
+  }
+  for (auto user : inner.iv->users()) {
+    if (!inner.loop->isIncluded(cast<Instruction>(user))) {
+      return false;
+    }
+  }
+
+  /*
+   * Collect the basic blocks of the outer loop that are not part of the inner
+   * one, in an order that respects their dominance.
+   */
+  auto outerHeader = outer.loop->getHeader();
+  std::vector<BasicBlock *> outerOnlyBBs{};
+  std::unordered_set<BasicBlock *> visited{ outerHeader };
+  std::queue<BasicBlock *> worklist{};
+  worklist.push(outerHeader);
+  while (!worklist.empty()) {
+    auto bb = worklist.front();
+    worklist.pop();
+    outerOnlyBBs.push_back(bb);
+
+    std::vector<BasicBlock *> nextBBs{};
+    for (auto succ : successors(bb)) {
+      if (!outer.loop->isIncluded(succ)) {
+        continue;
+      }
+      if (inner.loop->isIncluded(succ)) {
+        for (auto innerExitBB : inner.loop->getLoopExitBasicBlocks()) {
+          nextBBs.push_back(innerExitBB);
+        }
+        continue;
+      }
+      nextBBs.push_back(succ);
+    }
+    for (auto nextBB : nextBBs) {
+      if (visited.find(nextBB) != visited.end()) {
+        continue;
+      }
+      visited.insert(nextBB);
+      worklist.push(nextBB);
+    }
+  }
+  if (outerOnlyBBs.size()
+      != (outer.loop->getBasicBlocks().size()
+          - inner.loop->getBasicBlocks().size())) {
+    return false;
+  }
+
+  /*
+   * Check the instructions executed only by the outer loop.
+   * Besides the ones that control the outer loop, only computation without
+   * side effects used by the inner loop is allowed. This computation can be
+   * moved into the inner loop.
+   */
+  std::vector<Instruction *> candidates{};
+  for (auto bb : outerOnlyBBs) {
+    for (auto &inst : *bb) {
+      if ((&inst == outer.iv) || (&inst == outer.exitCmp)
+          || (&inst == outer.ivUpdate)) {
+        continue;
+      }
+      if (isa<PHINode>(&inst)) {
+        return false;
+      }
+      if (auto br = dyn_cast<BranchInst>(&inst)) {
+        if ((bb != outerHeader) && br->isConditional()) {
+          return false;
+        }
+        continue;
+      }
+      if (inst.isTerminator()) {
+        return false;
+      }
+      if (inst.mayReadOrWriteMemory() || inst.mayHaveSideEffects()) {
+        return false;
+      }
+      candidates.push_back(&inst);
+    }
+  }
+  std::unordered_set<Instruction *> candidatesSet(candidates.begin(),
+                                                  candidates.end());
+  for (auto inst : candidates) {
+    for (auto user : inst->users()) {
+      auto userInst = cast<Instruction>(user);
+      if (inner.loop->isIncluded(userInst)) {
+        continue;
+      }
+      if (candidatesSet.find(userInst) != candidatesSet.end()) {
+        continue;
+      }
+      return false;
+    }
+  }
+  instructionsToSink = candidates;
+
+  return true;
+}
+
+bool LoopInterchange::doTheyAccessTheSameLocationOnlyOnTheSameIteration(
+    Instruction *fromInst,
+    Instruction *toInst,
+    PHINode *outerIV,
+    PHINode *innerIV,
+    LoopIterationDomainSpaceAnalysis *domainSpace) {
+
+  /*
+   * The two instructions must access memory through the same address.
+   */
+  auto fromPtr = getLoadStorePointerOperand(fromInst);
+  auto toPtr = getLoadStorePointerOperand(toInst);
+  if ((fromPtr == nullptr) || (fromPtr != toPtr)) {
+    return false;
+  }
+
+  /*
+   * One dimension of the address must be an affine function of only the
+   * induction variable of one of the two loops (e.g., A[i+j] does not qualify).
+   * In this case, the dependence is not carried by that loop, and therefore
+   * it is carried forward by the other loop no matter their order.
+   */
+  for (auto iv :
+       domainSpace->getInductionVariablesOfAffineSubscripts(fromInst)) {
+    if (iv == nullptr) {
+      continue;
+    }
+    auto ivPHI = iv->getLoopEntryPHI();
+    if ((ivPHI == outerIV) || (ivPHI == innerIV)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void LoopInterchange::swapLoopControls(LoopControl &outer,
+                                       LoopControl &inner) {
+
+  /*
+   * Collect the uses of the induction variables that do not control the loops.
+   */
+  std::vector<Use *> outerIVUses{};
+  for (auto &use : outer.iv->uses()) {
+    auto user = use.getUser();
+    if ((user == outer.exitCmp) || (user == outer.ivUpdate)) {
+      continue;
+    }
+    outerIVUses.push_back(&use);
+  }
+  std::vector<Use *> innerIVUses{};
+  for (auto &use : inner.iv->uses()) {
+    auto user = use.getUser();
+    if ((user == inner.exitCmp) || (user == inner.ivUpdate)) {
+      continue;
+    }
+    innerIVUses.push_back(&use);
+  }
+
+  /*
+   * Swap the initial values of the induction variables.
+   */
+  auto outerStartIndex =
+      outer.iv->getBasicBlockIndex(outer.loop->getPreHeader());
+  auto innerStartIndex =
+      inner.iv->getBasicBlockIndex(inner.loop->getPreHeader());
+  auto outerStart = outer.iv->getIncomingValue(outerStartIndex);
+  auto innerStart = inner.iv->getIncomingValue(innerStartIndex);
+  outer.iv->setIncomingValue(outerStartIndex, innerStart);
+  inner.iv->setIncomingValue(innerStartIndex, outerStart);
+
+  /*
+   * Swap the updates and the exit conditions of the induction variables.
+   */
+  auto swapInstructions = [&outer, &inner](Instruction *outerInst,
+                                           Instruction *innerInst) {
+    auto newOuterInst = innerInst->clone();
+    newOuterInst->replaceUsesOfWith(inner.iv, outer.iv);
+    newOuterInst->insertBefore(outerInst);
+    auto newInnerInst = outerInst->clone();
+    newInnerInst->replaceUsesOfWith(outer.iv, inner.iv);
+    newInnerInst->insertBefore(innerInst);
+    outerInst->replaceAllUsesWith(newOuterInst);
+    innerInst->replaceAllUsesWith(newInnerInst);
+    outerInst->eraseFromParent();
+    innerInst->eraseFromParent();
+  };
+  swapInstructions(outer.ivUpdate, inner.ivUpdate);
+  swapInstructions(outer.exitCmp, inner.exitCmp);
+
+  /*
+   * The code of the loop nest now uses the induction variable that iterates
+   * over its original values.
+   */
+  for (auto use : outerIVUses) {
+    use->set(inner.iv);
+  }
+  for (auto use : innerIVUses) {
+    use->set(outer.iv);
+  }
+
+  return;
+}
+
+} // namespace llvm::noelle
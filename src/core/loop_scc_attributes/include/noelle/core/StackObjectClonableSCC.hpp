@@ -41,7 +41,7 @@ public:
    * Return the memory locations that can be safely clone to void reusing the
    * same memory locations between invocations of this SCC.
    */
-  std::set<AllocaInst *> getMemoryLocationsToClone(void) const;
+  std::set<Instruction *> getMemoryLocationsToClone(void) const;
 
   static bool classof(const GenericSCC *s);
 
@@ -19,6 +19,7 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include "noelle/core/Utils.hpp"
 #include "AccumulatorOpInfo.hpp"
 
 namespace llvm::noelle {
@@ -89,6 +90,13 @@ Instruction::BinaryOps AccumulatorOpInfo::accumOpForType(unsigned op,
 
 Value *AccumulatorOpInfo::generateIdentityFor(Instruction *accumulator,
                                               Type *castType) {
+
+  /*
+   * Constants are uniqued by the LLVM context, which can be shared with other
+   * threads that analyze loops.
+   */
+  std::lock_guard<std::mutex> contextGuard(Utils::getLLVMContextLock());
+
   Value *initVal = nullptr;
   auto opIdentity = this->opIdentities[accumulator->getOpcode()];
   if (castType->isIntegerTy())
@@ -38,9 +38,9 @@ bool StackObjectClonableSCC::classof(const GenericSCC *s) {
   return (s->getKind() == GenericSCC::SCCKind::STACK_OBJECT_CLONABLE);
 }
 
-std::set<AllocaInst *> StackObjectClonableSCC::getMemoryLocationsToClone(
+std::set<Instruction *> StackObjectClonableSCC::getMemoryLocationsToClone(
     void) const {
-  std::set<AllocaInst *> allocations;
+  std::set<Instruction *> allocations;
   for (auto location : this->_clonableMemoryLocations) {
     allocations.insert(location->getAllocation());
   }
@@ -28,6 +28,7 @@
 #include "noelle/core/LoopCarriedUnknownSCC.hpp"
 #include "noelle/core/LoopCarriedDependencies.hpp"
 #include "noelle/core/UnknownClosedFormSCC.hpp"
+#include "noelle/core/CompileTimeProfiler.hpp"
 
 namespace llvm::noelle {
 
@@ -41,6 +42,7 @@ SCCDAGAttrs::SCCDAGAttrs(bool enableFloatAsReal,
     loopDG{ loopDG },
     sccdag{ loopSCCDAG },
     memoryCloningAnalysis{ nullptr } {
+  CompileTimePhase phase("SCCDAG attributes");
 
   /*
    * Partition dependences between intra-iteration and iter-iteration ones.
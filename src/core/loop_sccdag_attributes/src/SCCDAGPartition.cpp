@@ -20,6 +20,7 @@
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "noelle/core/SCCDAGPartition.hpp"
+#include "noelle/core/DGStronglyConnectedComponents.hpp"
 
 namespace llvm::noelle {
 
@@ -179,52 +180,20 @@ void SCCDAGPartition::collapseCycles(void) {
    * Use Tarjan's algorithm to collapse all cycles
    */
   std::set<std::unordered_set<SCCSet *> *> collapsedSets;
-  std::unordered_set<SCCSet *> visited;
-  for (auto nodeToVisit : getNodes()) {
-    auto setToVisit = nodeToVisit->getT();
-    if (visited.find(setToVisit) != visited.end())
-      continue;
+  for (auto &cycle : DGStronglyConnectedComponents<SCCSet>::compute(*this)) {
 
     /*
-     * To use the DGGraphWrapper, the entry node must be set to the node
-     * where the traversal starts from
+     * Fetch a newly identified cycle of SCC sets.
      */
-    setEntryNode(nodeToVisit);
-    DGGraphWrapper<SCCDAGPartition, SCCSet> wrapper(this);
-    // nodeToVisit->print(errs() << "Visiting node using scc_iterator\n");
+    auto unwrappedSets = new std::unordered_set<SCCSet *>();
+    for (auto unwrappedNode : cycle) {
+      unwrappedSets->insert(unwrappedNode->getT());
+    }
 
     /*
-     * scc_iterator collects all cycles found from the entry node to leaves of
-     * the graph reachable by that node
+     * Collapse sets that form a cycle into one set
      */
-    for (auto dgI = scc_begin(&wrapper); dgI != scc_end(&wrapper); ++dgI) {
-
-      /*
-       * Fetch a newly identified cycle of SCC sets.
-       */
-      const std::vector<DGNodeWrapper<SCCSet> *> &setNodes = *dgI;
-      auto firstNodeWrapper = *setNodes.begin();
-      auto firstSet = firstNodeWrapper->wrappedNode->getT();
-      if (visited.find(firstSet) != visited.end()) {
-        continue;
-      }
-
-      auto unwrappedSets = new std::unordered_set<SCCSet *>();
-      for (auto setWrapper : setNodes) {
-        auto unwrappedNode = setWrapper->wrappedNode;
-        auto unwrappedSet = unwrappedNode->getT();
-        unwrappedSets->insert(unwrappedSet);
-        // for (auto scc : unwrappedSet->sccs) {
-        //   scc->printMinimal(errs() << "Contained SCC:\n");
-        // }
-      }
-
-      /*
-       * Collapse sets that form a cycle into one set
-       */
-      visited.insert(unwrappedSets->begin(), unwrappedSets->end());
-      collapsedSets.insert(unwrappedSets);
-    }
+    collapsedSets.insert(unwrappedSets);
   }
 
   for (auto setsToMerge : collapsedSets) {
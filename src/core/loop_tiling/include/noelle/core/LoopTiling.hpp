@@ -0,0 +1,73 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/LoopStructure.hpp"
+#include "noelle/core/LoopDependenceInfo.hpp"
+
+namespace llvm::noelle {
+
+class LoopTiling {
+public:
+  /*
+   * Methods
+   */
+  LoopTiling();
+
+  /*
+   * Check if the loop @innerLoop, which is the only loop nested in
+   * @outerLoop, can be tiled.
+   *
+   * Tiling @innerLoop splits its iterations in tiles and runs the whole
+   * @outerLoop for each tile. Hence, the two loops must be interchangeable.
+   * Moreover, the inner loop needs to iterate with a positive constant step
+   * until its induction variable reaches a bound.
+   */
+  bool canTileLoop(LoopDependenceInfo const &outerLoop,
+                   LoopStructure *innerLoop);
+
+  /*
+   * Tile the loop @innerLoop with tiles of @tileSize iterations.
+   */
+  bool tileLoop(LoopDependenceInfo const &outerLoop,
+                LoopStructure *innerLoop,
+                uint64_t tileSize);
+
+  /*
+   * Check if the loop nest @outerLoop reads memory locations indexed only by
+   * @innerLoop, which are therefore read again by every iteration of
+   * @outerLoop.
+   */
+  bool isDataReusedAcrossOuterIterations(LoopDependenceInfo const &outerLoop,
+                                         LoopStructure *innerLoop);
+
+private:
+  /*
+   * Methods
+   */
+  CmpInst::Predicate getPredicateToContinue(LoopStructure *loop,
+                                            PHINode *iv,
+                                            ICmpInst *exitCmp);
+};
+
+} // namespace llvm::noelle
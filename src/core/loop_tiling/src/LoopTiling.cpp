@@ -0,0 +1,269 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopTiling.hpp"
+#include "noelle/core/LoopInterchange.hpp"
+
+namespace llvm::noelle {
+
+bool LoopTiling::canTileLoop(LoopDependenceInfo const &outerLoop,
+                             LoopStructure *innerLoop) {
+  assert(innerLoop != nullptr);
+
+  /*
+   * Every tile of the inner loop runs all iterations of the outer loop.
+   * This requires the two loops to be interchangeable.
+   */
+  LoopInterchange li;
+  if (!li.canInterchangeLoops(outerLoop, innerLoop)) {
+    return false;
+  }
+
+  /*
+   * Fetch the governing induction variable of the inner loop.
+   */
+  auto ivManager = outerLoop.getInductionVariableManager();
+  auto iv = ivManager->getLoopGoverningInductionVariable(*innerLoop);
+  auto phi = iv->getLoopEntryPHI();
+  auto header = innerLoop->getHeader();
+  auto latch = *innerLoop->getLatches().begin();
+
+  /*
+   * The induction variable must grow by a constant step.
+   */
+  auto ivUpdate = cast<BinaryOperator>(phi->getIncomingValueForBlock(latch));
+  if (ivUpdate->getOpcode() != Instruction::Add) {
+    return false;
+  }
+  auto stepValue = (ivUpdate->getOperand(0) == phi) ? ivUpdate->getOperand(1)
+                                                    : ivUpdate->getOperand(0);
+  auto step = dyn_cast<ConstantInt>(stepValue);
+  if ((step == nullptr) || (!step->getValue().isStrictlyPositive())) {
+    return false;
+  }
+
+  /*
+   * The inner loop must iterate while its induction variable is below a
+   * bound.
+   */
+  auto exitCmp =
+      cast<ICmpInst>(cast<BranchInst>(header->getTerminator())->getCondition());
+  auto predicate = this->getPredicateToContinue(innerLoop, phi, exitCmp);
+  if ((predicate != CmpInst::ICMP_SLT) && (predicate != CmpInst::ICMP_ULT)) {
+    return false;
+  }
+
+  /*
+   * The iteration space of the inner loop must not be defined by an outer
+   * loop, which includes the loop over tiles of an inner loop that has been
+   * tiled already.
+   */
+  auto start = phi->getIncomingValueForBlock(innerLoop->getPreHeader());
+  auto bound = (exitCmp->getOperand(0) == phi) ? exitCmp->getOperand(1)
+                                               : exitCmp->getOperand(0);
+  auto outerNode = outerLoop.getLoopHierarchyStructures();
+  for (auto node = outerNode->getParent(); node != nullptr;
+       node = node->getParent()) {
+    for (auto value : { start, bound }) {
+      auto inst = dyn_cast<Instruction>(value);
+      if ((inst != nullptr) && node->getLoop()->isIncluded(inst)) {
+        return false;
+      }
+    }
+  }
+
+  /*
+   * The values that leave the outer loop must not be computed by it, as the
+   * outer loop is going to be executed once per tile.
+   */
+  auto outerLS = outerLoop.getLoopStructure();
+  auto outerExitBB = outerLS->getLoopExitBasicBlocks()[0];
+  for (auto &exitPHI : outerExitBB->phis()) {
+    auto value = exitPHI.getIncomingValueForBlock(outerLS->getHeader());
+    auto inst = dyn_cast<Instruction>(value);
+    if ((inst != nullptr) && outerLS->isIncluded(inst)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool LoopTiling::tileLoop(LoopDependenceInfo const &outerLoop,
+                          LoopStructure *innerLoop,
+                          uint64_t tileSize) {
+
+  /*
+   * Check if the tiling is legal.
+   */
+  if (tileSize < 2) {
+    return false;
+  }
+  if (!this->canTileLoop(outerLoop, innerLoop)) {
+    return false;
+  }
+
+  /*
+   * Fetch the instructions that control the inner loop.
+   */
+  auto ivManager = outerLoop.getInductionVariableManager();
+  auto iv = ivManager->getLoopGoverningInductionVariable(*innerLoop);
+  auto phi = iv->getLoopEntryPHI();
+  auto latch = *innerLoop->getLatches().begin();
+  auto ivUpdate = cast<BinaryOperator>(phi->getIncomingValueForBlock(latch));
+  auto step = (ivUpdate->getOperand(0) == phi)
+                  ? cast<ConstantInt>(ivUpdate->getOperand(1))
+                  : cast<ConstantInt>(ivUpdate->getOperand(0));
+  auto exitCmp = cast<ICmpInst>(
+      cast<BranchInst>(innerLoop->getHeader()->getTerminator())
+          ->getCondition());
+  auto predicate = this->getPredicateToContinue(innerLoop, phi, exitCmp);
+  auto start = phi->getIncomingValueForBlock(innerLoop->getPreHeader());
+  auto bound = (exitCmp->getOperand(0) == phi) ? exitCmp->getOperand(1)
+                                               : exitCmp->getOperand(0);
+
+  /*
+   * Fetch the outer loop.
+   */
+  auto outerLS = outerLoop.getLoopStructure();
+  auto outerPreHeader = outerLS->getPreHeader();
+  auto outerHeader = outerLS->getHeader();
+  auto outerExitBB = outerLS->getLoopExitBasicBlocks()[0];
+  auto f = outerLS->getFunction();
+  auto &cxt = f->getContext();
+
+  /*
+   * Create the loop over tiles.
+   */
+  auto tileHeader = BasicBlock::Create(cxt, "", f);
+  auto tileBody = BasicBlock::Create(cxt, "", f);
+  auto tileLatch = BasicBlock::Create(cxt, "", f);
+  auto tileStep = ConstantInt::get(cxt, step->getValue() * tileSize);
+
+  IRBuilder<> headerBuilder(tileHeader);
+  auto tileIV = headerBuilder.CreatePHI(phi->getType(), 2);
+  auto isTileValid = headerBuilder.CreateICmp(predicate, tileIV, bound);
+  headerBuilder.CreateCondBr(isTileValid, tileBody, outerExitBB);
+
+  /*
+   * Compute the bound of the current tile.
+   * The distance from the bound avoids overflowing the induction variable
+   * when computing the end of the last tile.
+   */
+  IRBuilder<> bodyBuilder(tileBody);
+  auto iterationsLeft = bodyBuilder.CreateSub(bound, tileIV);
+  auto isTileFull = bodyBuilder.CreateICmpUGT(iterationsLeft, tileStep);
+  auto tileEnd = bodyBuilder.CreateAdd(tileIV, tileStep);
+  auto tileBound = bodyBuilder.CreateSelect(isTileFull, tileEnd, bound);
+  bodyBuilder.CreateBr(outerHeader);
+
+  IRBuilder<> latchBuilder(tileLatch);
+  auto nextTileIV = latchBuilder.CreateAdd(tileIV, tileStep);
+  latchBuilder.CreateBr(tileHeader);
+
+  tileIV->addIncoming(start, outerPreHeader);
+  tileIV->addIncoming(nextTileIV, tileLatch);
+
+  /*
+   * Run the whole outer loop for every tile.
+   */
+  outerPreHeader->getTerminator()->replaceUsesOfWith(outerHeader, tileHeader);
+  for (auto &outerPHI : outerHeader->phis()) {
+    auto preHeaderIndex = outerPHI.getBasicBlockIndex(outerPreHeader);
+    outerPHI.setIncomingBlock(preHeaderIndex, tileBody);
+  }
+  outerHeader->getTerminator()->replaceUsesOfWith(outerExitBB, tileLatch);
+  for (auto &exitPHI : outerExitBB->phis()) {
+    auto headerIndex = exitPHI.getBasicBlockIndex(outerHeader);
+    exitPHI.setIncomingBlock(headerIndex, tileHeader);
+  }
+
+  /*
+   * Restrict the inner loop to the iterations of the current tile.
+   */
+  auto innerStartIndex = phi->getBasicBlockIndex(innerLoop->getPreHeader());
+  phi->setIncomingValue(innerStartIndex, tileIV);
+  exitCmp->replaceUsesOfWith(bound, tileBound);
+
+  return true;
+}
+
+bool LoopTiling::isDataReusedAcrossOuterIterations(
+    LoopDependenceInfo const &outerLoop,
+    LoopStructure *innerLoop) {
+
+  /*
+   * Fetch the governing induction variables of the two loops.
+   */
+  auto outerLS = outerLoop.getLoopStructure();
+  auto ivManager = outerLoop.getInductionVariableManager();
+  auto outerIV = ivManager->getLoopGoverningInductionVariable(*outerLS);
+  auto innerIV = ivManager->getLoopGoverningInductionVariable(*innerLoop);
+  if ((outerIV == nullptr) || (innerIV == nullptr)) {
+    return false;
+  }
+
+  /*
+   * Look for loads that are indexed by the inner loop but not by the outer
+   * one.
+   */
+  auto domainSpace = outerLoop.getLoopIterationDomainSpaceAnalysis();
+  for (auto inst : outerLS->getInstructions()) {
+    if (!isa<LoadInst>(inst)) {
+      continue;
+    }
+    auto ivs = domainSpace->getInductionVariablesOfSubscripts(inst);
+    auto isIndexedByOuter =
+        std::find(ivs.begin(), ivs.end(), outerIV) != ivs.end();
+    auto isIndexedByInner =
+        std::find(ivs.begin(), ivs.end(), innerIV) != ivs.end();
+    if (isIndexedByInner && (!isIndexedByOuter)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+CmpInst::Predicate LoopTiling::getPredicateToContinue(LoopStructure *loop,
+                                                      PHINode *iv,
+                                                      ICmpInst *exitCmp) {
+
+  /*
+   * Normalize the comparison to have the induction variable on the left.
+   */
+  auto predicate = exitCmp->getPredicate();
+  if (exitCmp->getOperand(1) == iv) {
+    predicate = CmpInst::getSwappedPredicate(predicate);
+  }
+
+  /*
+   * Normalize the comparison to be true when the loop continues.
+   */
+  auto headerBr = cast<BranchInst>(loop->getHeader()->getTerminator());
+  if (!loop->isIncluded(headerBr->getSuccessor(0))) {
+    predicate = CmpInst::getInversePredicate(predicate);
+  }
+
+  return predicate;
+}
+
+} // namespace llvm::noelle
@@ -48,6 +48,17 @@ public:
                  std::set<Instruction *> &instructionsRemoved,
                  std::set<Instruction *> &instructionsAdded);
 
+  bool fuseLoops(LoopDependenceInfo *first, LoopDependenceInfo *second);
+
+  bool interchangeLoops(LoopDependenceInfo *outerLoop,
+                        LoopStructure *innerLoop);
+
+  bool tileLoop(LoopDependenceInfo *outerLoop,
+                LoopStructure *innerLoop,
+                uint64_t tileSize);
+
+  bool collapseLoops(LoopDependenceInfo *outerLoop, LoopStructure *innerLoop);
+
   virtual ~LoopTransformer();
 
   bool doInitialization(Module &M) override;
@@ -24,6 +24,10 @@
 #include "noelle/core/LoopWhilify.hpp"
 #include "noelle/core/LoopUnroll.hpp"
 #include "noelle/core/LoopDistribution.hpp"
+#include "noelle/core/LoopFusion.hpp"
+#include "noelle/core/LoopInterchange.hpp"
+#include "noelle/core/LoopTiling.hpp"
+#include "noelle/core/LoopCollapse.hpp"
 
 namespace llvm::noelle {
 
@@ -166,4 +170,92 @@ bool LoopTransformer::splitLoop(LoopDependenceInfo *loop,
   return modified;
 }
 
+bool LoopTransformer::fuseLoops(LoopDependenceInfo *first,
+                                LoopDependenceInfo *second) {
+
+  /*
+   * Check trivial cases
+   */
+  if ((first == nullptr) || (second == nullptr)) {
+    return false;
+  }
+  if (this->pdg == nullptr) {
+    return false;
+  }
+
+  /*
+   * Fetch the analyses of the function that includes the loops.
+   */
+  auto func = first->getLoopStructure()->getFunction();
+  auto &LI = getAnalysis<LoopInfoWrapperPass>(*func).getLoopInfo();
+  auto &DT = getAnalysis<DominatorTreeWrapperPass>(*func).getDomTree();
+  auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(*func).getSE();
+
+  /*
+   * Fuse the loops.
+   */
+  LoopFusion lf;
+  auto modified = lf.fuseLoops(*first, *second, this->pdg, LI, DT, SE);
+
+  return modified;
+}
+
+bool LoopTransformer::interchangeLoops(LoopDependenceInfo *outerLoop,
+                                       LoopStructure *innerLoop) {
+
+  /*
+   * Check trivial cases
+   */
+  if ((outerLoop == nullptr) || (innerLoop == nullptr)) {
+    return false;
+  }
+
+  /*
+   * Interchange the loops.
+   */
+  LoopInterchange li;
+  auto modified = li.interchangeLoops(*outerLoop, innerLoop);
+
+  return modified;
+}
+
+bool LoopTransformer::tileLoop(LoopDependenceInfo *outerLoop,
+                               LoopStructure *innerLoop,
+                               uint64_t tileSize) {
+
+  /*
+   * Check trivial cases
+   */
+  if ((outerLoop == nullptr) || (innerLoop == nullptr)) {
+    return false;
+  }
+
+  /*
+   * Tile the loop.
+   */
+  LoopTiling lt;
+  auto modified = lt.tileLoop(*outerLoop, innerLoop, tileSize);
+
+  return modified;
+}
+
+bool LoopTransformer::collapseLoops(LoopDependenceInfo *outerLoop,
+                                    LoopStructure *innerLoop) {
+
+  /*
+   * Check trivial cases
+   */
+  if ((outerLoop == nullptr) || (innerLoop == nullptr)) {
+    return false;
+  }
+
+  /*
+   * Collapse the loops.
+   */
+  LoopCollapse lc;
+  auto modified = lc.collapseLoops(*outerLoop, innerLoop);
+
+  return modified;
+}
+
 } // namespace llvm::noelle
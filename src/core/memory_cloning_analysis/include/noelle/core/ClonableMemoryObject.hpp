@@ -31,13 +31,24 @@ namespace llvm::noelle {
 
 class ClonableMemoryObject {
 public:
-  ClonableMemoryObject(AllocaInst *allocation,
+  ClonableMemoryObject(Instruction *allocation,
                        uint64_t sizeInBits,
                        LoopStructure *loop,
                        DominatorSummary &DS,
                        PDG *ldg);
 
-  AllocaInst *getAllocation(void) const;
+  Instruction *getAllocation(void) const;
+
+  /*
+   * Return true if the object is allocated in the heap (e.g., malloc), false
+   * if it is a stack object (i.e., alloca).
+   */
+  bool isHeapObject(void) const;
+
+  /*
+   * Return the name of the function that releases the heap object.
+   */
+  std::string getDeallocatorName(void) const;
 
   std::unordered_set<Instruction *> getLoopInstructionsUsingLocation(
       void) const;
@@ -64,7 +75,7 @@ public:
   static bool isMemCpyInstrinsicCall(CallInst *call);
 
 private:
-  AllocaInst *allocation;
+  Instruction *allocation;
   Type *allocatedType;
   uint64_t sizeInBits;
   LoopStructure *loop;
@@ -76,42 +87,43 @@ private:
   std::unordered_set<Instruction *> storingInstructions;
   std::unordered_set<Instruction *> loadInstructions;
   std::unordered_set<Instruction *> nonStoringInstructions;
+  std::unordered_set<CallBase *> deallocations;
 
   bool identifyStoresAndOtherUsers(LoopStructure *loop, DominatorSummary &DS);
 
   bool isThereAMemoryDependenceBetweenLoopIterations(
       LoopStructure *loop,
-      AllocaInst *al,
+      Instruction *al,
       PDG *ldg,
       const std::unordered_set<Instruction *> &insts) const;
 
   bool isThereRAWThroughMemoryFromLoopToOutside(LoopStructure *loop,
-                                                AllocaInst *al,
+                                                Instruction *al,
                                                 PDG *ldg) const;
 
   bool isThereRAWThroughMemoryBetweenLoopIterations(LoopStructure *loop,
-                                                    AllocaInst *al,
+                                                    Instruction *al,
                                                     PDG *ldg) const;
 
   bool isThereRAWThroughMemoryBetweenLoopIterations(
       LoopStructure *loop,
-      AllocaInst *al,
+      Instruction *al,
       PDG *ldg,
       const std::unordered_set<Instruction *> &insts) const;
 
   bool isThereRAWThroughMemoryFromLoopToOutside(
       LoopStructure *loop,
-      AllocaInst *al,
+      Instruction *al,
       PDG *ldg,
       std::unordered_set<Instruction *> insts) const;
 
   bool isThereRAWThroughMemoryFromOutsideToLoop(LoopStructure *loop,
-                                                AllocaInst *al,
+                                                Instruction *al,
                                                 PDG *ldg) const;
 
   bool isThereRAWThroughMemoryFromOutsideToLoop(
       LoopStructure *loop,
-      AllocaInst *al,
+      Instruction *al,
       PDG *ldg,
       std::unordered_set<Instruction *> insts) const;
 
@@ -134,7 +146,7 @@ private:
   bool isOverrideSetFullyCoveringTheAllocationSpace(
       OverrideSet *overrideSet) const;
 
-  void setObjectScope(AllocaInst *allocation,
+  void setObjectScope(Instruction *allocation,
                       LoopStructure *loop,
                       DominatorSummary &ds);
 };
@@ -44,6 +44,8 @@ public:
 private:
   std::unordered_set<std::unique_ptr<ClonableMemoryObject>>
       clonableMemoryLocations;
+
+  uint64_t getSizeInBitsOfHeapObject(CallBase *allocation) const;
 };
 
 } // namespace llvm::noelle
@@ -19,6 +19,7 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include "noelle/core/Utils.hpp"
 #include "noelle/core/ClonableMemoryObject.hpp"
 
 namespace llvm::noelle {
@@ -98,7 +99,7 @@ std::unordered_set<Instruction *> ClonableMemoryObject::
   return instructions;
 }
 
-ClonableMemoryObject::ClonableMemoryObject(AllocaInst *allocation,
+ClonableMemoryObject::ClonableMemoryObject(Instruction *allocation,
                                            uint64_t sizeInBits,
                                            LoopStructure *loop,
                                            DominatorSummary &DS,
@@ -118,9 +119,14 @@ ClonableMemoryObject::ClonableMemoryObject(AllocaInst *allocation,
   this->setObjectScope(allocation, loop, DS);
 
   /*
-   * Identify the instructions that access the stack location.
+   * Identify the instructions that access the object.
+   * The type of heap objects is not known.
    */
-  this->allocatedType = allocation->getAllocatedType();
+  if (auto alloca = dyn_cast<AllocaInst>(allocation)) {
+    this->allocatedType = alloca->getAllocatedType();
+  } else {
+    this->allocatedType = nullptr;
+  }
   if (!this->identifyStoresAndOtherUsers(loop, DS)) {
     errs()
         << "ClonableMemoryObject:   We cannot identify memory accesses to it\n";
@@ -218,7 +224,17 @@ ClonableMemoryObject::ClonableMemoryObject(AllocaInst *allocation,
      * Values stored in the stack object before executing the loop could be read
      * within the loop. So we need to initialize the cloned object with the
      * original stack object.
+     *
+     * The size of heap objects might be known only at run time, so we do not
+     * initialize their private copies.
      */
+    if (this->isHeapObject()) {
+      this->isClonable = false;
+      errs()
+          << "ClonableMemoryObject:   The heap object would require initialization\n";
+      errs() << "ClonableMemoryObject: Exit\n";
+      return;
+    }
     this->needInitialization = true;
     this->isClonable = true;
     errs() << "ClonableMemoryObject:   It requires initialization\n";
@@ -226,6 +242,14 @@ ClonableMemoryObject::ClonableMemoryObject(AllocaInst *allocation,
     return;
   }
 
+  /*
+   * Heap objects need to be fully private to the loop.
+   */
+  if (this->isHeapObject()) {
+    errs() << "ClonableMemoryObject: Exit\n";
+    return;
+  }
+
   /*
    * Only consider struct and integer types for objects that has scope outside
    * the loop.
@@ -265,7 +289,7 @@ ClonableMemoryObject::ClonableMemoryObject(AllocaInst *allocation,
   return;
 }
 
-void ClonableMemoryObject::setObjectScope(AllocaInst *allocation,
+void ClonableMemoryObject::setObjectScope(Instruction *allocation,
                                           LoopStructure *loop,
                                           DominatorSummary &ds) {
 
@@ -307,10 +331,43 @@ void ClonableMemoryObject::setObjectScope(AllocaInst *allocation,
   return;
 }
 
-AllocaInst *ClonableMemoryObject::getAllocation(void) const {
+Instruction *ClonableMemoryObject::getAllocation(void) const {
   return this->allocation;
 }
 
+bool ClonableMemoryObject::isHeapObject(void) const {
+  return !isa<AllocaInst>(this->allocation);
+}
+
+std::string ClonableMemoryObject::getDeallocatorName(void) const {
+  assert(this->isHeapObject());
+
+  /*
+   * Use the function that the program already uses to release the object.
+   */
+  for (auto deallocation : this->deallocations) {
+    auto callee = deallocation->getCalledFunction();
+    if (callee != nullptr) {
+      return callee->getName().str();
+    }
+  }
+
+  /*
+   * The program never releases the object.
+   * Use the deallocator that matches the allocator.
+   */
+  auto allocator = cast<CallBase>(this->allocation)->getCalledFunction();
+  auto allocatorName = allocator->getName();
+  if (allocatorName == "_Znwm") {
+    return "_ZdlPv";
+  }
+  if (allocatorName == "_Znam") {
+    return "_ZdaPv";
+  }
+
+  return "free";
+}
+
 bool ClonableMemoryObject::isClonableLocation(void) const {
   return this->isClonable;
 }
@@ -392,6 +449,14 @@ bool ClonableMemoryObject::identifyStoresAndOtherUsers(LoopStructure *loop,
       }
       if (auto store = dyn_cast<StoreInst>(user)) {
 
+        /*
+         * The pointer to the object cannot be stored in memory, otherwise
+         * the object could be accessed through it.
+         */
+        if (this->isHeapObject() && (store->getValueOperand() == I)) {
+          return false;
+        }
+
         /*
          * As straightforward as it gets
          */
@@ -414,6 +479,17 @@ bool ClonableMemoryObject::identifyStoresAndOtherUsers(LoopStructure *loop,
           continue;
         }
 
+        /*
+         * Heap objects can be released only after the loop.
+         */
+        if (Utils::isDeallocator(call)) {
+          if (loop->isIncluded(call)) {
+            return false;
+          }
+          this->deallocations.insert(call);
+          continue;
+        }
+
         /*
          * We consider llvm.memcpy as a storing instruction if the use is the
          * dest (first operand)
@@ -473,7 +549,7 @@ bool ClonableMemoryObject::identifyStoresAndOtherUsers(LoopStructure *loop,
 
 bool ClonableMemoryObject::isThereRAWThroughMemoryBetweenLoopIterations(
     LoopStructure *loop,
-    AllocaInst *al,
+    Instruction *al,
     PDG *ldg) const {
   if (this->isThereRAWThroughMemoryBetweenLoopIterations(
           loop,
@@ -488,7 +564,7 @@ bool ClonableMemoryObject::isThereRAWThroughMemoryBetweenLoopIterations(
 
 bool ClonableMemoryObject::isThereAMemoryDependenceBetweenLoopIterations(
     LoopStructure *loop,
-    AllocaInst *al,
+    Instruction *al,
     PDG *ldg,
     const std::unordered_set<Instruction *> &insts) const {
 
@@ -570,7 +646,7 @@ bool ClonableMemoryObject::isThereAMemoryDependenceBetweenLoopIterations(
 
 bool ClonableMemoryObject::isThereRAWThroughMemoryBetweenLoopIterations(
     LoopStructure *loop,
-    AllocaInst *al,
+    Instruction *al,
     PDG *ldg,
     const std::unordered_set<Instruction *> &insts) const {
 
@@ -659,7 +735,7 @@ bool ClonableMemoryObject::isThereRAWThroughMemoryBetweenLoopIterations(
 
 bool ClonableMemoryObject::isThereRAWThroughMemoryFromOutsideToLoop(
     LoopStructure *loop,
-    AllocaInst *al,
+    Instruction *al,
     PDG *ldg,
     std::unordered_set<Instruction *> insts) const {
 
@@ -740,7 +816,7 @@ bool ClonableMemoryObject::isThereRAWThroughMemoryFromOutsideToLoop(
 
 bool ClonableMemoryObject::isThereRAWThroughMemoryFromLoopToOutside(
     LoopStructure *loop,
-    AllocaInst *al,
+    Instruction *al,
     PDG *ldg,
     std::unordered_set<Instruction *> insts) const {
 
@@ -821,7 +897,7 @@ bool ClonableMemoryObject::isThereRAWThroughMemoryFromLoopToOutside(
 
 bool ClonableMemoryObject::isThereRAWThroughMemoryFromOutsideToLoop(
     LoopStructure *loop,
-    AllocaInst *al,
+    Instruction *al,
     PDG *ldg) const {
 
   /*
@@ -849,7 +925,7 @@ bool ClonableMemoryObject::isThereRAWThroughMemoryFromOutsideToLoop(
 
 bool ClonableMemoryObject::isThereRAWThroughMemoryFromLoopToOutside(
     LoopStructure *loop,
-    AllocaInst *al,
+    Instruction *al,
     PDG *ldg) const {
 
   /*
@@ -1073,7 +1149,7 @@ bool ClonableMemoryObject::isOverrideSetFullyCoveringTheAllocationSpace(
     }
   }
 
-  if (this->allocation->getAllocatedType()->isStructTy()) {
+  if ((this->allocatedType != nullptr) && this->allocatedType->isStructTy()) {
 
     // errs() << "Number of elements covered: " << structElementsStoredTo.size()
     // << " versus struct element number: " <<
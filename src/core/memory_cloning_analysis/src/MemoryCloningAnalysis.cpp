@@ -19,6 +19,7 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include "noelle/core/Utils.hpp"
 #include "noelle/core/MemoryCloningAnalysis.hpp"
 
 namespace llvm::noelle {
@@ -95,10 +96,87 @@ MemoryCloningAnalysis::MemoryCloningAnalysis(LoopStructure *loop,
     this->clonableMemoryLocations.insert(std::move(location));
   }
 
+  /*
+   * Collect objects allocated in the heap before the loop.
+   * These are buffers reused by all iterations of the loop.
+   *
+   * Allocations done by invoke instructions are skipped as their clones could
+   * not be placed in the middle of the entry block of a task.
+   */
+  std::unordered_set<CallInst *> heapAllocations;
+  for (auto &I : instructions(function)) {
+    auto call = dyn_cast<CallInst>(&I);
+    if (call == nullptr) {
+      continue;
+    }
+    if ((!Utils::isAllocator(call)) || Utils::isReallocator(call)) {
+      continue;
+    }
+    if (loop->isIncluded(call)) {
+      continue;
+    }
+    if (!DS.DT.dominates(call->getParent(), loop->getHeader())) {
+      continue;
+    }
+    heapAllocations.insert(call);
+  }
+
+  /*
+   * Check each heap object.
+   */
+  for (auto allocation : heapAllocations) {
+
+    /*
+     * Check if the heap object is clonable.
+     */
+    auto sizeInBits = this->getSizeInBitsOfHeapObject(allocation);
+    auto location = std::make_unique<ClonableMemoryObject>(allocation,
+                                                           sizeInBits,
+                                                           loop,
+                                                           DS,
+                                                           ldg);
+    if (!location->isClonableLocation()) {
+      continue;
+    }
+
+    /*
+     * The heap object is clonable.
+     */
+    errs() << "MemoryCloningAnalysis:   The heap object "
+           << *location->getAllocation() << " can be cloned\n";
+    this->clonableMemoryLocations.insert(std::move(location));
+  }
+
   errs() << "MemoryCloningAnalysis: Exit\n";
   return;
 }
 
+uint64_t MemoryCloningAnalysis::getSizeInBitsOfHeapObject(
+    CallBase *allocation) const {
+
+  /*
+   * Multiply the constant arguments that define the size of the object.
+   * calloc takes the number of elements and the size of each of them; the
+   * other allocators take the number of bytes.
+   */
+  auto callee = allocation->getCalledFunction();
+  auto numberOfSizeArguments = (callee->getName() == "calloc") ? 2 : 1;
+  uint64_t bytes = 1;
+  for (auto i = 0; i < numberOfSizeArguments; i++) {
+    auto sizeArgument = dyn_cast<ConstantInt>(allocation->getArgOperand(i));
+    if (sizeArgument == nullptr) {
+
+      /*
+       * The size is known only at run time.
+       */
+      return 0;
+    }
+    bytes *= sizeArgument->getZExtValue();
+  }
+
+  return bytes * 8;
+}
+
 std::unordered_set<ClonableMemoryObject *> MemoryCloningAnalysis::
     getClonableMemoryObjects(void) const {
   std::unordered_set<ClonableMemoryObject *> locations{};
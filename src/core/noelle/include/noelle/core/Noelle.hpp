@@ -78,6 +78,12 @@ public:
 
   Linker *getLinker(void);
 
+  /*
+   * Return the information about the target @F is compiled for (e.g., the
+   * width of its vector registers).
+   */
+  TargetTransformInfo &getTargetTransformInfo(Function &F);
+
   std::set<AliasAnalysisEngine *> getAliasAnalysisEngines(void);
 
   LoopNestingGraph *getLoopNestingGraphForProgram(void);
@@ -148,6 +154,25 @@ public:
       LoopStructure *loop,
       std::unordered_set<LoopDependenceInfoOptimization> optimizations);
 
+  /*
+   * The LDIs returned by getLoop and getLoops are owned by NOELLE and they are
+   * reused by later requests of the same loops.
+   * After modifying the code of a function, invalidate its loops so later
+   * requests compute new LDIs. LDIs returned before stay allocated until NOELLE
+   * is destroyed.
+   */
+  void invalidateLoops(Function *f);
+
+  void invalidateLoops(void);
+
+  /*
+   * Return the index of @loop among the loops of the program.
+   * This is the index INDEX_FILE (and therefore the autotuner) uses to refer to
+   * @loop.
+   * Only loops returned by getLoopStructures have an index.
+   */
+  std::optional<uint32_t> getLoopIndex(LoopStructure *loop) const;
+
   uint32_t getNumberOfProgramLoops(void);
 
   uint32_t getNumberOfProgramLoops(double minimumHotness);
@@ -225,6 +250,43 @@ public:
   ~Noelle();
 
 private:
+  /*
+   * Loops of a function whose LDIs have been requested.
+   * The LDIs of a function share its loop forest, its dependence graph, and
+   * the LLVM analyses they compute on demand. The latter are computed here
+   * rather than through the pass manager, which frees them when an analysis
+   * of another function is requested.
+   */
+  class FunctionLoops {
+  public:
+    FunctionLoops(Function &F,
+                  TargetLibraryInfo &TLI,
+                  AssumptionCache &AC,
+                  PDG *functionDG,
+                  bool ownsFunctionDG);
+
+    DominatorTree *DT;
+    PostDominatorTree *PDT;
+    LoopInfo *LI;
+    ScalarEvolution *SE;
+    DominatorSummary *DS;
+    std::vector<LoopStructure *> loopStructures;
+    LoopForest *forest;
+    PDG *functionDG;
+    bool ownsFunctionDG;
+
+    /*
+     * LDIs indexed by the header of their loop, the optimizations enabled (one
+     * bit per optimization), the techniques to disable, the DOALL chunk size,
+     * and the maximum number of cores.
+     */
+    std::map<std::tuple<BasicBlock *, uint32_t, uint32_t, uint32_t, uint32_t>,
+             LoopDependenceInfo *>
+        loops;
+
+    ~FunctionLoops();
+  };
+
   Verbosity verbose;
   bool enableFloatAsReal;
   double minHot;
@@ -234,6 +296,7 @@ private:
   std::unordered_set<Transformation> enabledTransformations;
   bool hoistLoopsToMain;
   bool loopAwareDependenceAnalysis;
+  uint32_t loopAnalysesThreads;
   PDGAnalysis *pdgAnalysis;
   char *filterFileName;
   bool hasReadFilterFile;
@@ -248,30 +311,41 @@ private:
   MetadataManager *mm;
   Linker *linker;
   std::set<AliasAnalysisEngine *> aaEngines;
+  std::unordered_map<Function *, FunctionLoops *> functionLoops;
+  std::vector<FunctionLoops *> invalidatedFunctionLoops;
 
   uint32_t fetchTheNextValue(std::stringstream &stream);
 
   bool checkToGetLoopFilteringInfo(void);
 
+  FunctionLoops *fetchFunctionLoops(Function *f);
+
+  void freeLoops(void);
+
+  /*
+   * Return the LDI of the loop with header @header computed with the
+   * configuration given as input, allocating it first if needed.
+   */
   LoopDependenceInfo *getLoopDependenceInfoForLoop(
       BasicBlock *header,
-      PDG *functionPDG,
-      DominatorSummary *DS,
       uint32_t techniquesToDisable,
       uint32_t DOALLChunkSize,
       uint32_t maxCores,
       std::unordered_set<LoopDependenceInfoOptimization> optimizations);
 
-  LoopDependenceInfo *getLoopDependenceInfoForLoop(
-      LoopForestNode *loopNode,
-      Loop *loop,
-      PDG *functionPDG,
-      DominatorSummary *DS,
-      ScalarEvolution *SE,
-      uint32_t techniquesToDisable,
-      uint32_t DOALLChunkSize,
-      uint32_t maxCores,
-      std::unordered_set<LoopDependenceInfoOptimization> optimizations);
+  /*
+   * Compute the analyses of the LDIs given as input using
+   * @loopAnalysesThreads threads.
+   * The LDIs of a function share the function analyses, so they are all
+   * computed by the same thread.
+   */
+  void computeLoopsInParallel(
+      std::vector<Function *> const &functions,
+      std::unordered_map<Function *, std::vector<LoopDependenceInfo *>> const
+          &functionLDIs);
+
+  void setTechniquesToDisable(LoopDependenceInfo *ldi,
+                              uint32_t techniquesToDisable);
 
   bool isLoopHot(LoopStructure *loopStructure, double minimumHotness);
   bool isFunctionHot(Function *function, double minimumHotness);
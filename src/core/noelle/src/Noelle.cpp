@@ -35,6 +35,7 @@ Noelle::Noelle()
     programDependenceGraph{ nullptr },
     hoistLoopsToMain{ false },
     loopAwareDependenceAnalysis{ false },
+    loopAnalysesThreads{ 1 },
     fm{ nullptr },
     tm{ nullptr },
     cm{ nullptr },
@@ -157,6 +158,7 @@ bool Noelle::shouldLoopsBeHoistToMain(void) const {
 }
 
 Noelle::~Noelle() {
+  this->freeLoops();
 
   return;
 }
@@ -187,6 +189,12 @@ Linker *Noelle::getLinker(void) {
   return this->linker;
 }
 
+TargetTransformInfo &Noelle::getTargetTransformInfo(Function &F) {
+  auto &TTI = getAnalysis<TargetTransformInfoWrapperPass>().getTTI(F);
+
+  return TTI;
+}
+
 CompilationOptionsManager *Noelle::getCompilationOptionsManager(void) {
   assert(this->om != nullptr);
   return this->om;
@@ -20,6 +20,8 @@
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include <algorithm>
+#include <atomic>
+#include <thread>
 
 #include "noelle/core/SystemHeaders.hpp"
 #include "noelle/core/LoopStructure.hpp"
@@ -28,6 +30,7 @@
 #include "noelle/core/Architecture.hpp"
 #include "noelle/core/LoopForest.hpp"
 #include "noelle/core/HotProfiler.hpp"
+#include "noelle/core/CompileTimeProfiler.hpp"
 
 namespace llvm::noelle {
 
@@ -363,62 +366,43 @@ LoopDependenceInfo *Noelle::getLoop(LoopStructure *l) {
   return ldi;
 }
 
+std::optional<uint32_t> Noelle::getLoopIndex(LoopStructure *loop) const {
+  auto header = loop->getHeader();
+  auto it = this->loopHeaderToLoopIndexMap.find(header);
+  if (it == this->loopHeaderToLoopIndexMap.end()) {
+    return std::nullopt;
+  }
+
+  return it->second;
+}
+
 LoopDependenceInfo *Noelle::getLoop(
     LoopStructure *loop,
     std::unordered_set<LoopDependenceInfoOptimization> optimizations) {
 
   /*
-   * Fetch the the function dependence graph, post dominators, and scalar
-   * evolution
+   * Check if the loop has been selected by INDEX_FILE.
+   * If it hasn't, then it is configured with the default options.
    */
   auto header = loop->getHeader();
-  auto function = header->getParent();
-  auto funcPDG = this->getFunctionDependenceGraph(function);
-  auto DS = this->getDominators(function);
-
-  /*
-   * Check of loopIndex provided is within bounds
-   */
-  if (this->loopHeaderToLoopIndexMap.find(header)
-      == this->loopHeaderToLoopIndexMap.end()) {
+  if ((!this->hasReadFilterFile)
+      || (this->loopHeaderToLoopIndexMap.find(header)
+          == this->loopHeaderToLoopIndexMap.end())) {
     auto ldi =
-        this->getLoopDependenceInfoForLoop(header,
-                                           funcPDG,
-                                           DS,
-                                           0,
-                                           8,
-                                           this->om->getMaximumNumberOfCores(),
-                                           optimizations);
-
-    delete DS;
-    return ldi;
-  }
-
-  /*
-   * Fetch the loop index.
-   */
-  auto loopIndex = this->loopHeaderToLoopIndexMap.at(header);
+        this->getLoopDependenceInfoForLoop(
+            header,
+            0,
+            LoopTransformationsManager::defaultChunkSize,
+            this->om->getMaximumNumberOfCores(),
+            optimizations);
 
-  /*
-   * No filter file was provided. Construct LDI without profiler configurables
-   */
-  if (!this->hasReadFilterFile) {
-    auto ldi =
-        this->getLoopDependenceInfoForLoop(header,
-                                           funcPDG,
-                                           DS,
-                                           0,
-                                           8,
-                                           this->om->getMaximumNumberOfCores(),
-                                           optimizations);
-
-    delete DS;
     return ldi;
   }
 
   /*
    * Ensure loop configurables exist for this loop index
    */
+  auto loopIndex = this->loopHeaderToLoopIndexMap.at(header);
   if (loopIndex >= this->loopThreads.size()) {
     errs() << "ERROR: the 'INDEX_FILE' file isn't correct. There are more than "
            << this->loopThreads.size() << " loops available in the program\n";
@@ -428,14 +412,11 @@ LoopDependenceInfo *Noelle::getLoop(
   auto maximumNumberOfCoresForTheParallelization = this->loopThreads[loopIndex];
   auto ldi = this->getLoopDependenceInfoForLoop(
       header,
-      funcPDG,
-      DS,
       this->techniquesToDisable[loopIndex],
       this->DOALLChunkSize[loopIndex],
       maximumNumberOfCoresForTheParallelization,
       optimizations);
 
-  delete DS;
   return ldi;
 }
 
@@ -450,6 +431,7 @@ std::vector<LoopDependenceInfo *> *Noelle::getLoops(Function *function) {
 
 std::vector<LoopDependenceInfo *> *Noelle::getLoops(Function *function,
                                                     double minimumHotness) {
+  CompileTimePhase phase("Loops");
 
   /*
    * Allocate the vector of loops.
@@ -476,86 +458,30 @@ std::vector<LoopDependenceInfo *> *Noelle::getLoops(Function *function,
   }
 
   /*
-   * Fetch the function dependence graph.
-   */
-  auto funcPDG = this->getFunctionDependenceGraph(function);
-
-  /*
-   * Fetch the post dominators
-   */
-  auto DS = this->getDominators(function);
-
-  /*
-   * Fetch all loops of the current function.
+   * Fetch the loops of the function.
    */
-  auto loops = LI.getLoopsInPreorder();
+  auto loops = this->fetchFunctionLoops(function);
 
   /*
-   * Consider these loops.
-   *
-   * Collect the loop structures.
+   * Fetch the LDIs of the loops that are hot enough.
+   * Loops are considered in pre-order (outer loops first).
    */
-  std::vector<LoopStructure *> loopStructures;
-  for (auto loop : loops) {
-
-    /*
-     * Check if the loop is hot enough.
-     */
-    auto loopS = new LoopStructure(loop);
+  for (auto ls : loops->loopStructures) {
     if (minimumHotness > 0) {
-      if (!this->isLoopHot(loopS, minimumHotness)) {
-        delete loopS;
+      if (!this->isLoopHot(ls, minimumHotness)) {
         continue;
       }
     }
-
-    /*
-     * Append the loop
-     */
-    for (auto edge : funcPDG->getEdges()) {
-      assert(!edge->isLoopCarriedDependence() && "Flag set");
-    }
-    loopStructures.push_back(loopS);
-  }
-
-  /*
-   * Organize loops in forest.
-   */
-  auto forest = this->organizeLoopsInTheirNestingForest(loopStructures);
-
-  /*
-   * Allocate the loop wrapper.
-   */
-  for (auto tree : forest->getTrees()) {
-    for (auto loopNode : tree->getNodes()) {
-      auto ls = loopNode->getLoop();
-      assert(ls != nullptr);
-      assert(ls->getFunction() == function);
-
-      /*
-       * Forest generation invalids the previous generated LoopInfo, we need to
-       * recompute them
-       */
-      auto &newLI = getAnalysis<LoopInfoWrapperPass>(*function).getLoopInfo();
-      auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(*function).getSE();
-      auto llvmLoop = newLI.getLoopFor(ls->getHeader());
-      auto ldi = new LoopDependenceInfo(funcPDG,
-                                        loopNode,
-                                        llvmLoop,
-                                        *DS,
-                                        SE,
-                                        this->om->getMaximumNumberOfCores(),
-                                        this->enableFloatAsReal,
-                                        this->loopAwareDependenceAnalysis);
-      allLoops->push_back(ldi);
-    }
+    auto ldi =
+        this->getLoopDependenceInfoForLoop(
+            ls->getHeader(),
+            0,
+            LoopTransformationsManager::defaultChunkSize,
+            this->om->getMaximumNumberOfCores(),
+            {});
+    allLoops->push_back(ldi);
   }
 
-  /*
-   * Free the memory.
-   */
-  delete DS;
-
   return allLoops;
 }
 
@@ -566,6 +492,7 @@ std::vector<LoopDependenceInfo *> *Noelle::getLoops(void) {
 }
 
 std::vector<LoopDependenceInfo *> *Noelle::getLoops(double minimumHotness) {
+  CompileTimePhase phase("Loops");
 
   /*
    * Allocate the vector of loops.
@@ -592,6 +519,9 @@ std::vector<LoopDependenceInfo *> *Noelle::getLoops(double minimumHotness) {
     errs() << "Noelle: Filter out cold code\n";
   }
   auto nextLoopIndex = 0;
+  std::vector<Function *> functionsWithLoops;
+  std::unordered_map<Function *, LoopForest *> functionForests;
+  std::map<LoopStructure *, uint32_t> loopIDs;
   for (auto function : functions) {
 
     /*
@@ -622,17 +552,6 @@ std::vector<LoopDependenceInfo *> *Noelle::getLoops(double minimumHotness) {
       continue;
     }
 
-    /*
-     * Fetch the function dependence graph.
-     */
-    auto funcPDG = this->getFunctionDependenceGraph(function);
-
-    /*
-     * Fetch the post dominators and scalar evolutions
-     */
-    auto DS = this->getDominators(function);
-    auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(*function).getSE();
-
     /*
      * Fetch all loops of the current function.
      */
@@ -644,7 +563,6 @@ std::vector<LoopDependenceInfo *> *Noelle::getLoops(double minimumHotness) {
      * Organize loops in their forest
      */
     std::vector<LoopStructure *> loopStructures;
-    std::map<LoopStructure *, uint32_t> loopIDs;
     for (auto loop : loops) {
       auto currentLoopIndex = nextLoopIndex++;
 
@@ -725,10 +643,20 @@ std::vector<LoopDependenceInfo *> *Noelle::getLoops(double minimumHotness) {
      * Organize the loops in forest.
      */
     auto forest = this->organizeLoopsInTheirNestingForest(loopStructures);
+    functionsWithLoops.push_back(function);
+    functionForests[function] = forest;
+  }
 
-    /*
-     * Compute the LoopDependeceInfo abstractions.
-     */
+  /*
+   * Fetch the LoopDependeceInfo abstractions.
+   *
+   * Their analyses are computed when they are requested. If we have more than
+   * one thread available, we compute them now in parallel instead.
+   */
+  std::unordered_map<Function *, std::vector<LoopDependenceInfo *>>
+      functionLDIs;
+  for (auto function : functionsWithLoops) {
+    auto forest = functionForests.at(function);
     for (auto tree : forest->getTrees()) {
       for (auto loopNode : tree->getNodes()) {
 
@@ -739,55 +667,109 @@ std::vector<LoopDependenceInfo *> *Noelle::getLoops(double minimumHotness) {
         assert(loopIDs.find(ls) != loopIDs.end());
         auto currentLoopIndex = loopIDs[ls];
 
-        /*
-         * Fetch the LLVM loop
-         */
-        auto &LI =
-            getAnalysis<LoopInfoWrapperPass>(*ls->getFunction()).getLoopInfo();
-        auto LLVMLoop = LI.getLoopFor(ls->getHeader());
-
         /*
          * Check if we have to filter loops.
          */
         LoopDependenceInfo *ldi = nullptr;
         if (!filterLoops) {
-          ldi = new LoopDependenceInfo(funcPDG,
-                                       loopNode,
-                                       LLVMLoop,
-                                       *DS,
-                                       SE,
-                                       this->om->getMaximumNumberOfCores(),
-                                       this->enableFloatAsReal,
-                                       this->loopAwareDependenceAnalysis);
+          ldi = this->getLoopDependenceInfoForLoop(
+              ls->getHeader(),
+              0,
+              LoopTransformationsManager::defaultChunkSize,
+              this->om->getMaximumNumberOfCores(),
+              {});
 
         } else {
           auto maximumNumberOfCoresForTheParallelization =
               loopThreads[currentLoopIndex];
           assert(maximumNumberOfCoresForTheParallelization > 1);
           ldi = this->getLoopDependenceInfoForLoop(
-              loopNode,
-              LLVMLoop,
-              funcPDG,
-              DS,
-              &SE,
+              ls->getHeader(),
               this->techniquesToDisable[currentLoopIndex],
               this->DOALLChunkSize[currentLoopIndex],
               maximumNumberOfCoresForTheParallelization,
               {});
         }
         allLoops->push_back(ldi);
+        functionLDIs[function].push_back(ldi);
       }
     }
 
     /*
      * Free the memory.
+     *
+     * The LDIs use the loop forest of the whole function, which NOELLE owns.
      */
-    delete DS;
+    delete forest;
+  }
+  for (auto pair : loopIDs) {
+    delete pair.first;
+  }
+
+  /*
+   * Compute the analyses of the loops.
+   */
+  if (this->loopAnalysesThreads > 1) {
+    this->computeLoopsInParallel(functionsWithLoops, functionLDIs);
   }
 
   return allLoops;
 }
 
+void Noelle::computeLoopsInParallel(
+    std::vector<Function *> const &functions,
+    std::unordered_map<Function *, std::vector<LoopDependenceInfo *>> const
+        &functionLDIs) {
+
+  /*
+   * Each worker computes the analyses of the loops of one function at a time.
+   *
+   * The loops of a function share its dependence graph and its function
+   * analyses (e.g., scalar evolution), which are not thread-safe. Hence, the
+   * loops of a function are all handled by the same worker.
+   * The LDIs guard the code that modifies state shared across functions (e.g.,
+   * the LLVM context) with Utils::getLLVMContextLock.
+   */
+  std::atomic<uint64_t> nextFunctionIndex{ 0 };
+  auto worker = [&]() {
+    while (true) {
+      auto functionIndex = nextFunctionIndex.fetch_add(1);
+      if (functionIndex >= functions.size()) {
+        return;
+      }
+      auto function = functions[functionIndex];
+      auto it = functionLDIs.find(function);
+      if (it == functionLDIs.end()) {
+        continue;
+      }
+
+      /*
+       * Compute the analyses of the loops.
+       */
+      for (auto ldi : it->second) {
+        ldi->computeAllAnalyses();
+      }
+    }
+  };
+
+  /*
+   * Run the workers.
+   */
+  uint64_t numberOfThreads = this->loopAnalysesThreads;
+  if (numberOfThreads > functions.size()) {
+    numberOfThreads = functions.size();
+  }
+  std::vector<std::thread> threads;
+  for (auto i = 0u; i < numberOfThreads; i++) {
+    threads.push_back(std::thread(worker));
+  }
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  return;
+}
+
 uint32_t Noelle::getNumberOfProgramLoops(void) {
   return this->getNumberOfProgramLoops(this->minHot);
 }
@@ -1147,50 +1129,6 @@ void Noelle::sortByStaticNumberOfInstructions(
   return;
 }
 
-LoopDependenceInfo *Noelle::getLoopDependenceInfoForLoop(
-    BasicBlock *header,
-    PDG *functionPDG,
-    DominatorSummary *DS,
-    uint32_t techniquesToDisable,
-    uint32_t DOALLChunkSize,
-    uint32_t maxCores,
-    std::unordered_set<LoopDependenceInfoOptimization> optimizations) {
-
-  /*
-   * Fetch the function
-   */
-  auto function = header->getParent();
-
-  /*
-   * Fetch the ForestNode of the loop
-   */
-  auto allLoopsOfFunction = this->getLoopStructures(function, 0);
-  auto forest = this->organizeLoopsInTheirNestingForest(*allLoopsOfFunction);
-  auto newLoopNode = forest->getInnermostLoopThatContains(&*header->begin());
-
-  /*
-   * Fetch the llvm loop corresponding to the loop structure
-   */
-  auto &LI = getAnalysis<LoopInfoWrapperPass>(*function).getLoopInfo();
-  auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(*function).getSE();
-  auto llvmLoop = LI.getLoopFor(header);
-
-  /*
-   * Compute the LoopDependenceInfo
-   */
-  auto ldi = this->getLoopDependenceInfoForLoop(newLoopNode,
-                                                llvmLoop,
-                                                functionPDG,
-                                                DS,
-                                                &SE,
-                                                techniquesToDisable,
-                                                DOALLChunkSize,
-                                                maxCores,
-                                                optimizations);
-
-  return ldi;
-}
-
 /*
  * Get the loop nesting graph of the whole program
  * 1. Get all loops as nodes
@@ -1291,34 +1229,8 @@ LoopNestingGraph *Noelle::getLoopNestingGraphForProgram() {
   return loopNestingGraph;
 }
 
-LoopDependenceInfo *Noelle::getLoopDependenceInfoForLoop(
-    LoopForestNode *loopNode,
-    Loop *loop,
-    PDG *functionPDG,
-    DominatorSummary *DS,
-    ScalarEvolution *SE,
-    uint32_t techniquesToDisableForLoop,
-    uint32_t DOALLChunkSizeForLoop,
-    uint32_t maxCores,
-    std::unordered_set<LoopDependenceInfoOptimization> optimizations) {
-
-  /*
-   * Allocate the LDI.
-   */
-  auto ldi = new LoopDependenceInfo(functionPDG,
-                                    loopNode,
-                                    loop,
-                                    *DS,
-                                    *SE,
-                                    maxCores,
-                                    this->enableFloatAsReal,
-                                    optimizations,
-                                    this->loopAwareDependenceAnalysis,
-                                    DOALLChunkSizeForLoop);
-
-  /*
-   * Set the techniques that are enabled.
-   */
+void Noelle::setTechniquesToDisable(LoopDependenceInfo *ldi,
+                                    uint32_t techniquesToDisableForLoop) {
   auto ltm = ldi->getLoopTransformationsManager();
   auto disableTransformations = techniquesToDisableForLoop;
   switch (disableTransformations) {
@@ -1358,7 +1270,7 @@ LoopDependenceInfo *Noelle::getLoopDependenceInfoForLoop(
       abort();
   }
 
-  return ldi;
+  return;
 }
 
 bool Noelle::isLoopHot(LoopStructure *loopStructure, double minimumHotness) {
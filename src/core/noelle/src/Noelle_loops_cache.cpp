@@ -0,0 +1,233 @@
+/*
+ * Copyright 2016 - 2023  Angelo Matni, Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/LoopStructure.hpp"
+#include "noelle/core/Noelle.hpp"
+#include "noelle/core/LoopForest.hpp"
+
+namespace llvm::noelle {
+
+Noelle::FunctionLoops::FunctionLoops(Function &F,
+                                     TargetLibraryInfo &TLI,
+                                     AssumptionCache &AC,
+                                     PDG *functionDG,
+                                     bool ownsFunctionDG)
+  : functionDG{ functionDG },
+    ownsFunctionDG{ ownsFunctionDG } {
+
+  /*
+   * Compute the LLVM analyses of the function.
+   */
+  this->DT = new DominatorTree(F);
+  this->PDT = new PostDominatorTree();
+  this->PDT->recalculate(F);
+  this->LI = new LoopInfo(*this->DT);
+  this->SE = new ScalarEvolution(F, TLI, AC, *this->DT, *this->LI);
+  this->DS = new DominatorSummary(*this->DT, *this->PDT);
+
+  /*
+   * Organize all loops of the function in their nesting forest.
+   */
+  for (auto loop : this->LI->getLoopsInPreorder()) {
+    this->loopStructures.push_back(new LoopStructure(loop));
+  }
+  this->forest = new LoopForest(this->loopStructures, { { &F, this->DS } });
+
+  return;
+}
+
+Noelle::FunctionLoops::~FunctionLoops() {
+
+  /*
+   * Free the LDIs first as they rely on everything else.
+   */
+  for (auto pair : this->loops) {
+    delete pair.second;
+  }
+  delete this->forest;
+  for (auto ls : this->loopStructures) {
+    delete ls;
+  }
+  if (this->ownsFunctionDG) {
+    delete this->functionDG;
+  }
+
+  /*
+   * Free the LLVM analyses.
+   */
+  delete this->DS;
+  delete this->SE;
+  delete this->LI;
+  delete this->PDT;
+  delete this->DT;
+
+  return;
+}
+
+Noelle::FunctionLoops *Noelle::fetchFunctionLoops(Function *f) {
+
+  /*
+   * Check if we have already considered the loops of @f.
+   */
+  auto it = this->functionLoops.find(f);
+  if (it != this->functionLoops.end()) {
+    return it->second;
+  }
+
+  /*
+   * Fetch the dependence graph of the function.
+   *
+   * When the PDG of the program has been computed, the function dependence
+   * graph is a new copy of a subset of it. Hence, we own it.
+   */
+  auto ownsFunctionDG = (this->programDependenceGraph != nullptr);
+  auto functionDG = this->getFunctionDependenceGraph(f);
+
+  /*
+   * Allocate the loops of @f.
+   */
+  auto &TLI = getAnalysis<TargetLibraryInfoWrapperPass>().getTLI();
+  auto &AC = getAnalysis<AssumptionCacheTracker>().getAssumptionCache(*f);
+  auto loops = new FunctionLoops(*f, TLI, AC, functionDG, ownsFunctionDG);
+  this->functionLoops[f] = loops;
+
+  return loops;
+}
+
+LoopDependenceInfo *Noelle::getLoopDependenceInfoForLoop(
+    BasicBlock *header,
+    uint32_t techniquesToDisable,
+    uint32_t DOALLChunkSize,
+    uint32_t maxCores,
+    std::unordered_set<LoopDependenceInfoOptimization> optimizations) {
+
+  /*
+   * Fetch the loops of the function.
+   */
+  auto function = header->getParent();
+  auto loops = this->fetchFunctionLoops(function);
+
+  /*
+   * Check if the LDI has been computed already.
+   */
+  uint32_t optimizationsEnabled = 0;
+  for (auto optimization : optimizations) {
+    optimizationsEnabled |= (1 << optimization);
+  }
+  auto key = std::make_tuple(header,
+                             optimizationsEnabled,
+                             techniquesToDisable,
+                             DOALLChunkSize,
+                             maxCores);
+  auto it = loops->loops.find(key);
+  if (it != loops->loops.end()) {
+    return it->second;
+  }
+
+  /*
+   * Fetch the loop.
+   */
+  auto loopNode =
+      loops->forest->getInnermostLoopThatContains(&*header->begin());
+  auto llvmLoop = loops->LI->getLoopFor(header);
+  assert(loopNode != nullptr);
+  assert(llvmLoop != nullptr);
+
+  /*
+   * Allocate the LDI.
+   * Its dependences and analyses are computed when they are requested.
+   */
+  auto fetchFunctionAnalyses =
+      [loops, llvmLoop](
+          std::function<void(Loop *, DominatorSummary &, ScalarEvolution &)>
+              f) { f(llvmLoop, *loops->DS, *loops->SE); };
+  auto ldi = new LoopDependenceInfo(loops->functionDG,
+                                    loopNode,
+                                    llvmLoop,
+                                    *loops->SE,
+                                    maxCores,
+                                    this->enableFloatAsReal,
+                                    optimizations,
+                                    this->loopAwareDependenceAnalysis,
+                                    DOALLChunkSize,
+                                    fetchFunctionAnalyses);
+
+  /*
+   * Set the techniques that are enabled.
+   */
+  this->setTechniquesToDisable(ldi, techniquesToDisable);
+
+  /*
+   * Keep the LDI.
+   */
+  loops->loops[key] = ldi;
+
+  return ldi;
+}
+
+void Noelle::invalidateLoops(Function *f) {
+
+  /*
+   * Check if we have considered the loops of @f.
+   */
+  auto it = this->functionLoops.find(f);
+  if (it == this->functionLoops.end()) {
+    return;
+  }
+
+  /*
+   * Forget the loops of @f.
+   * Their LDIs might still be used by the caller, so they are freed only when
+   * NOELLE is.
+   */
+  this->invalidatedFunctionLoops.push_back(it->second);
+  this->functionLoops.erase(it);
+
+  /*
+   * Forget the answers of the dependence queries about @f.
+   */
+  DependenceQueryCache::getSessionCache().invalidate(f);
+
+  return;
+}
+
+void Noelle::invalidateLoops(void) {
+  for (auto pair : this->functionLoops) {
+    this->invalidatedFunctionLoops.push_back(pair.second);
+  }
+  this->functionLoops.clear();
+  DependenceQueryCache::getSessionCache().invalidate();
+
+  return;
+}
+
+void Noelle::freeLoops(void) {
+  this->invalidateLoops();
+  for (auto loops : this->invalidatedFunctionLoops) {
+    delete loops;
+  }
+  this->invalidatedFunctionLoops.clear();
+
+  return;
+}
+
+} // namespace llvm::noelle
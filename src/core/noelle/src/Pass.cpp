@@ -63,6 +63,23 @@ static cl::opt<bool> DisableDistribution(
     cl::ZeroOrMore,
     cl::Hidden,
     cl::desc("Disable the loop distribution"));
+static cl::opt<bool> DisableFusion("noelle-disable-loop-fusion",
+                                   cl::ZeroOrMore,
+                                   cl::Hidden,
+                                   cl::desc("Disable the loop fusion"));
+static cl::opt<bool> DisableInterchange(
+    "noelle-disable-loop-interchange",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc("Disable the loop interchange"));
+static cl::opt<bool> DisableTiling("noelle-disable-loop-tiling",
+                                   cl::ZeroOrMore,
+                                   cl::Hidden,
+                                   cl::desc("Disable the loop tiling"));
+static cl::opt<bool> DisableCollapse("noelle-disable-loop-collapse",
+                                     cl::ZeroOrMore,
+                                     cl::Hidden,
+                                     cl::desc("Disable the loop collapse"));
 static cl::opt<bool> DisableInvCM(
     "noelle-disable-loop-invariant-code-motion",
     cl::ZeroOrMore,
@@ -91,6 +108,12 @@ static cl::opt<bool> InlinerDisableHoistToMain(
     cl::ZeroOrMore,
     cl::Hidden,
     cl::desc("Disable the function inliner"));
+static cl::opt<int> LoopAnalysesThreads(
+    "noelle-loop-analyses-threads",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc(
+        "Number of threads used to compute the abstractions of loops of different functions (0 or 1: sequential)"));
 
 bool Noelle::doInitialization(Module &M) {
 
@@ -127,6 +150,18 @@ bool Noelle::doInitialization(Module &M) {
   if (DisableDistribution.getNumOccurrences() > 0) {
     this->enabledTransformations.erase(LOOP_DISTRIBUTION_ID);
   }
+  if (DisableFusion.getNumOccurrences() > 0) {
+    this->enabledTransformations.erase(LOOP_FUSION_ID);
+  }
+  if (DisableInterchange.getNumOccurrences() > 0) {
+    this->enabledTransformations.erase(LOOP_INTERCHANGE_ID);
+  }
+  if (DisableTiling.getNumOccurrences() > 0) {
+    this->enabledTransformations.erase(LOOP_TILING_ID);
+  }
+  if (DisableCollapse.getNumOccurrences() > 0) {
+    this->enabledTransformations.erase(LOOP_COLLAPSE_ID);
+  }
   if (DisableInvCM.getNumOccurrences() > 0) {
     this->enabledTransformations.erase(LOOP_INVARIANT_CODE_MOTION_ID);
   }
@@ -148,6 +183,9 @@ bool Noelle::doInitialization(Module &M) {
   if (DisableFloatAsReal.getNumOccurrences() > 0) {
     this->enableFloatAsReal = false;
   }
+  if (LoopAnalysesThreads.getValue() > 1) {
+    this->loopAnalysesThreads = LoopAnalysesThreads.getValue();
+  }
 
   /*
    * Allocate the managers.
@@ -171,6 +209,7 @@ bool Noelle::doInitialization(Module &M) {
 void Noelle::getAnalysisUsage(AnalysisUsage &AU) const {
   AU.addRequired<AssumptionCacheTracker>();
   AU.addRequired<TargetLibraryInfoWrapperPass>();
+  AU.addRequired<TargetTransformInfoWrapperPass>();
   AU.addRequired<PostDominatorTreeWrapperPass>();
   AU.addRequired<DominatorTreeWrapperPass>();
   AU.addRequired<LoopInfoWrapperPass>();
@@ -185,6 +224,12 @@ void Noelle::getAnalysisUsage(AnalysisUsage &AU) const {
 bool Noelle::runOnModule(Module &M) {
   this->pdgAnalysis = &getAnalysis<PDGAnalysis>();
 
+  /*
+   * The code might have changed since the last time we ran.
+   * Hence, forget the loops analyzed before.
+   */
+  this->freeLoops();
+
   return false;
 }
 
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/DGBase.hpp"
+#include "noelle/core/PDG.hpp"
+
+namespace llvm::noelle {
+
+/*
+ * Read-only view of a subset of a PDG.
+ *
+ * The view does not own nodes nor edges: they belong to the parent PDG.
+ * Nodes and edges of the view are the nodes and edges of the parent PDG that
+ * satisfy the membership of the view.
+ * Hence, creating a view costs only the size of the selected nodes rather than
+ * the size of the whole parent graph.
+ *
+ * The parent PDG must outlive the view.
+ * Changes to the parent PDG (e.g., edges removed) are reflected in the view.
+ */
+class PDGSubgraphView {
+public:
+  /*
+   * Constructor:
+   * Include only the values given as parameter.
+   * If @linkToExternal is true, then dependences that connect the values with
+   * the rest of the parent graph are included (the other endpoint becomes an
+   * external node of the view).
+   */
+  PDGSubgraphView(PDG *parent,
+                  const std::vector<Value *> &values,
+                  bool linkToExternal);
+
+  /*
+   * Constructor:
+   * Include only the values given as parameter and only the dependences for
+   * which @includeDependence returns true.
+   */
+  PDGSubgraphView(PDG *parent,
+                  const std::vector<Value *> &values,
+                  bool linkToExternal,
+                  std::function<bool(DGEdge<Value> *dependence)>
+                      includeDependence);
+
+  PDGSubgraphView() = delete;
+
+  /*
+   * Return true if @v is one of the values the view has been built for.
+   */
+  bool isInternal(Value *v) const;
+
+  /*
+   * Return true if @dependence belongs to the view.
+   */
+  bool isIncluded(DGEdge<Value> *dependence) const;
+
+  /*
+   * Return the nodes (internal first, then external) of the view.
+   * These are nodes of the parent graph.
+   */
+  std::vector<DGNode<Value> *> getNodes(void) const;
+
+  /*
+   * Return the number of instructions included in the view.
+   */
+  uint64_t getNumberOfInstructionsIncluded(void) const;
+
+private:
+  PDG *parent;
+  bool linkToExternal;
+  std::function<bool(DGEdge<Value> *)> includeDependence;
+  std::vector<DGNode<Value> *> internalNodes;
+  std::unordered_set<Value *> internalValues;
+  std::vector<DGNode<Value> *> externalNodes;
+  std::unordered_set<Value *> externalValues;
+
+  void addInternalValues(const std::vector<Value *> &values);
+
+  void computeExternalNodes(void);
+};
+
+} // namespace llvm::noelle
@@ -38,6 +38,13 @@ public:
   SCC(std::set<DGNode<Value> *> internalNodes,
       std::set<DGNode<Value> *> externalNodes);
 
+  /*
+   * Constructor: consider only the edges of @internalNodes for which
+   * @includeEdge returns true.
+   */
+  SCC(std::set<DGNode<Value> *> internalNodes,
+      std::function<bool(DGEdge<Value> *)> includeEdge);
+
   /*
    * Iterate over values inside the SCC until @funcToInvoke returns true or no
    * other one exists.
@@ -95,6 +102,10 @@ public:
 private:
   void copyNodesAndEdges(std::set<DGNode<Value> *> internalNodes,
                          std::set<DGNode<Value> *> externalNodes);
+
+  void copyNodesAndEdges(std::set<DGNode<Value> *> internalNodes,
+                         std::set<DGNode<Value> *> externalNodes,
+                         std::function<bool(DGEdge<Value> *)> includeEdge);
 };
 
 template <>
@@ -26,6 +26,7 @@
 #include "noelle/core/DGBase.hpp"
 #include "noelle/core/SCC.hpp"
 #include "noelle/core/PDG.hpp"
+#include "noelle/core/PDGSubgraphView.hpp"
 
 namespace llvm::noelle {
 
@@ -39,6 +40,13 @@ public:
    */
   SCCDAG(PDG *dependenceGraph);
 
+  /*
+   * Constructor.
+   * Nodes and edges are fetched from the view without copying the subgraph
+   * first.
+   */
+  SCCDAG(PDGSubgraphView *dependenceGraph);
+
   /*
    * Check if @inst is included in the SCCDAG.
    */
@@ -120,6 +128,9 @@ public:
   ~SCCDAG();
 
 protected:
+  void addSCCs(const std::vector<std::vector<DGNode<Value> *>> &components,
+               std::function<bool(Value *)> isInternal,
+               std::function<bool(DGEdge<Value> *)> includeEdge);
   void markValuesInSCC(void);
   void markEdgesAndSubEdges(void);
 
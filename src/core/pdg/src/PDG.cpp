@@ -190,25 +190,44 @@ void PDG::copyEdgesInto(
     PDG *newPDG,
     bool linkToExternal,
     std::unordered_set<DGEdge<Value> *> const &edgesToIgnore) {
-  for (auto *oldEdge : allEdges) {
-    if (edgesToIgnore.find(oldEdge) != edgesToIgnore.end()) {
+
+  /*
+   * Collect the nodes of @this that correspond to the internal nodes of the new
+   * graph.
+   *
+   * Every edge to copy has at least one endpoint that is internal to the new
+   * graph. Hence, we only need to visit the edges connected to these nodes
+   * rather than all edges of @this.
+   */
+  std::vector<DGNode<Value> *> nodesToVisit;
+  for (auto internalNodePair : newPDG->internalNodePairs()) {
+    auto v = internalNodePair.first;
+    if (!this->isInGraph(v)) {
       continue;
     }
+    nodesToVisit.push_back(this->fetchNode(v));
+  }
+
+  auto copyEdge = [this, newPDG, linkToExternal, &edgesToIgnore](
+                      DGEdge<Value> *oldEdge) {
+    if (edgesToIgnore.find(oldEdge) != edgesToIgnore.end()) {
+      return;
+    }
 
     auto nodePair = oldEdge->getNodePair();
     auto fromT = nodePair.first->getT();
     auto toT = nodePair.second->getT();
 
     /*
-     * Check whether edge belongs to nodes within function F
+     * Check whether edge belongs to nodes within the new graph
      */
     auto fromInclusion = newPDG->isInternal(fromT);
     auto toInclusion = newPDG->isInternal(toT);
     if (!fromInclusion && !toInclusion) {
-      continue;
+      return;
     }
     if (!linkToExternal && (!fromInclusion || !toInclusion)) {
-      continue;
+      return;
     }
 
     /*
@@ -221,6 +240,24 @@ void PDG::copyEdgesInto(
      * Copy edge to match properties (mem/var, must/may, RAW/WAW/WAR/control)
      */
     newPDG->copyAddEdge(*oldEdge);
+  };
+
+  /*
+   * Copy the edges.
+   *
+   * To copy each edge once, we consider all outgoing edges and only the
+   * incoming edges that come from nodes that are not internal to the new graph.
+   */
+  for (auto node : nodesToVisit) {
+    for (auto oldEdge : node->getOutgoingEdges()) {
+      copyEdge(oldEdge);
+    }
+    for (auto oldEdge : node->getIncomingEdges()) {
+      if (newPDG->isInternal(oldEdge->getOutgoingT())) {
+        continue;
+      }
+      copyEdge(oldEdge);
+    }
   }
 
   return;
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/PDGSubgraphView.hpp"
+
+namespace llvm::noelle {
+
+PDGSubgraphView::PDGSubgraphView(PDG *parent,
+                                 const std::vector<Value *> &values,
+                                 bool linkToExternal)
+  : PDGSubgraphView{ parent, values, linkToExternal, nullptr } {
+  return;
+}
+
+PDGSubgraphView::PDGSubgraphView(
+    PDG *parent,
+    const std::vector<Value *> &values,
+    bool linkToExternal,
+    std::function<bool(DGEdge<Value> *dependence)> includeDependence)
+  : parent{ parent },
+    linkToExternal{ linkToExternal },
+    includeDependence{ includeDependence } {
+  assert(parent != nullptr);
+
+  /*
+   * Add the internal nodes.
+   */
+  this->addInternalValues(values);
+
+  /*
+   * Add the external nodes.
+   */
+  if (this->linkToExternal) {
+    this->computeExternalNodes();
+  }
+
+  return;
+}
+
+void PDGSubgraphView::addInternalValues(const std::vector<Value *> &values) {
+  for (auto v : values) {
+
+    /*
+     * Only values that belong to the parent can be included.
+     */
+    if (!this->parent->isInGraph(v)) {
+      continue;
+    }
+    if (!this->internalValues.insert(v).second) {
+      continue;
+    }
+    this->internalNodes.push_back(this->parent->fetchNode(v));
+  }
+
+  return;
+}
+
+void PDGSubgraphView::computeExternalNodes(void) {
+
+  /*
+   * External nodes are the other endpoints of the dependences that connect an
+   * internal node with the rest of the parent graph.
+   */
+  auto addExternal = [this](DGNode<Value> *node) {
+    auto v = node->getT();
+    if (this->internalValues.find(v) != this->internalValues.end()) {
+      return;
+    }
+    if (!this->externalValues.insert(v).second) {
+      return;
+    }
+    this->externalNodes.push_back(node);
+  };
+  for (auto node : this->internalNodes) {
+    for (auto edge : node->getOutgoingEdges()) {
+      if (this->includeDependence && !this->includeDependence(edge)) {
+        continue;
+      }
+      addExternal(edge->getIncomingNode());
+    }
+    for (auto edge : node->getIncomingEdges()) {
+      if (this->includeDependence && !this->includeDependence(edge)) {
+        continue;
+      }
+      addExternal(edge->getOutgoingNode());
+    }
+  }
+
+  return;
+}
+
+bool PDGSubgraphView::isInternal(Value *v) const {
+  return this->internalValues.find(v) != this->internalValues.end();
+}
+
+bool PDGSubgraphView::isIncluded(DGEdge<Value> *dependence) const {
+
+  /*
+   * Check the filter given by the user.
+   */
+  if (this->includeDependence && !this->includeDependence(dependence)) {
+    return false;
+  }
+
+  /*
+   * Check the endpoints.
+   */
+  auto fromInternal = this->isInternal(dependence->getOutgoingT());
+  auto toInternal = this->isInternal(dependence->getIncomingT());
+  if (fromInternal && toInternal) {
+    return true;
+  }
+  if (!this->linkToExternal) {
+    return false;
+  }
+
+  return fromInternal || toInternal;
+}
+
+std::vector<DGNode<Value> *> PDGSubgraphView::getNodes(void) const {
+  std::vector<DGNode<Value> *> nodes{ this->internalNodes };
+  nodes.insert(nodes.end(),
+               this->externalNodes.begin(),
+               this->externalNodes.end());
+
+  return nodes;
+}
+
+uint64_t PDGSubgraphView::getNumberOfInstructionsIncluded(void) const {
+  return this->internalNodes.size();
+}
+
+} // namespace llvm::noelle
@@ -24,7 +24,13 @@
 
 namespace llvm::noelle {
 
-SCC::SCC(std::set<DGNode<Value> *> internalNodes) {
+SCC::SCC(std::set<DGNode<Value> *> internalNodes)
+  : SCC{ internalNodes, nullptr } {
+  return;
+}
+
+SCC::SCC(std::set<DGNode<Value> *> internalNodes,
+         std::function<bool(DGEdge<Value> *)> includeEdge) {
 
   /*
    * Collect all internal values
@@ -42,18 +48,24 @@ SCC::SCC(std::set<DGNode<Value> *> internalNodes) {
   std::set<DGNode<Value> *> externalNodes;
   for (auto node : internalNodes) {
     for (auto edge : node->getOutgoingEdges()) {
+      if (includeEdge && !includeEdge(edge)) {
+        continue;
+      }
       if (internalValues.find(edge->getIncomingT()) == internalValues.end()) {
         externalNodes.insert(edge->getIncomingNode());
       }
     }
     for (auto edge : node->getIncomingEdges()) {
+      if (includeEdge && !includeEdge(edge)) {
+        continue;
+      }
       if (internalValues.find(edge->getOutgoingT()) == internalValues.end()) {
         externalNodes.insert(edge->getOutgoingNode());
       }
     }
   }
 
-  copyNodesAndEdges(internalNodes, externalNodes);
+  copyNodesAndEdges(internalNodes, externalNodes, includeEdge);
 }
 
 SCC::SCC(std::set<DGNode<Value> *> internalNodes,
@@ -63,6 +75,12 @@ SCC::SCC(std::set<DGNode<Value> *> internalNodes,
 
 void SCC::copyNodesAndEdges(std::set<DGNode<Value> *> internalNodes,
                             std::set<DGNode<Value> *> externalNodes) {
+  copyNodesAndEdges(internalNodes, externalNodes, nullptr);
+}
+
+void SCC::copyNodesAndEdges(std::set<DGNode<Value> *> internalNodes,
+                            std::set<DGNode<Value> *> externalNodes,
+                            std::function<bool(DGEdge<Value> *)> includeEdge) {
 
   /*
    * Add all nodes by classification. Arbitrarily choose entry node from all
@@ -83,6 +101,9 @@ void SCC::copyNodesAndEdges(std::set<DGNode<Value> *> internalNodes,
    */
   for (auto node : internalNodes) {
     for (auto edge : node->getOutgoingEdges()) {
+      if (includeEdge && !includeEdge(edge)) {
+        continue;
+      }
       auto incomingT = edge->getIncomingT();
       if (isExternal(incomingT))
         continue;
@@ -95,12 +116,18 @@ void SCC::copyNodesAndEdges(std::set<DGNode<Value> *> internalNodes,
    */
   for (auto node : internalNodes) {
     for (auto edge : node->getOutgoingEdges()) {
+      if (includeEdge && !includeEdge(edge)) {
+        continue;
+      }
       auto incomingT = edge->getIncomingNode()->getT();
       if (isInternal(incomingT))
         continue;
       copyAddEdge(*edge);
     }
     for (auto edge : node->getIncomingEdges()) {
+      if (includeEdge && !includeEdge(edge)) {
+        continue;
+      }
       auto outgoingT = edge->getOutgoingNode()->getT();
       if (isInternal(outgoingT))
         continue;
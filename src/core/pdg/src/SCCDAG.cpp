@@ -20,7 +20,7 @@
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "noelle/core/SystemHeaders.hpp"
-#include "noelle/core/DGGraphTraits.hpp"
+#include "noelle/core/DGStronglyConnectedComponents.hpp"
 #include "noelle/core/SCCDAG.hpp"
 #include "llvm/InitializePasses.h"
 
@@ -31,53 +31,53 @@ SCCDAG::SCCDAG(PDG *pdg) {
   /*
    * Create nodes of the SCCDAG.
    *
-   * Iterate over all nodes in the PDG to calculate strongly connected
-   * components (see Tarjan's DFS algo).
+   * Compute the strongly connected components of the PDG in a single pass over
+   * all of its nodes.
    */
-  std::set<DGNode<Value> *> visited;
-  DGNode<Value> *originalEntryNode = pdg->getEntryNode();
+  std::vector<DGNode<Value> *> nodes{ pdg->begin_nodes(), pdg->end_nodes() };
+  auto components =
+      DGStronglyConnectedComponents<Value>::compute(nodes, nullptr);
+  this->addSCCs(
+      components,
+      [pdg](Value *v) -> bool { return pdg->isInternal(v); },
+      nullptr);
 
-  for (auto nodeToVisit : pdg->getNodes()) {
-    if (visited.find(nodeToVisit) != visited.end())
-      continue;
-
-    pdg->setEntryNode(nodeToVisit);
-
-    DGGraphWrapper<PDG, Value> pdgWrapper(pdg);
-
-    for (auto pdgI = scc_begin(&pdgWrapper); pdgI != scc_end(&pdgWrapper);
-         ++pdgI) {
+  /*
+   * Create the map from a Value to an SCC included in the SCCDAG.
+   */
+  this->markValuesInSCC();
 
-      /*
-       * Identify a new SCC.
-       */
-      const std::vector<DGNodeWrapper<Value> *> &sccNodes = *pdgI;
-      auto firstNodeWrapper = *sccNodes.begin();
-      auto firstNode = firstNodeWrapper->wrappedNode;
-      if (visited.find(firstNode) != visited.end()) {
-        continue;
-      }
+  /*
+   * Create dependences between nodes of the SCCDAG.
+   */
+  this->markEdgesAndSubEdges();
 
-      std::set<DGNode<Value> *> unwrappedNodes{};
-      for (auto sccNode : sccNodes) {
-        unwrappedNodes.insert(sccNode->wrappedNode);
-      }
+  /*
+   * Compute transitive dependences between nodes of the SCCDAG.
+   */
+  orderedDirty = true;
+  this->computeReachabilityAmongSCCs();
 
-      /*
-       * Add a new SCC to the SCCDAG.
-       */
-      visited.insert(unwrappedNodes.begin(), unwrappedNodes.end());
-      auto scc = new SCC(unwrappedNodes);
-      auto isInternal = false;
-      for (auto node : unwrappedNodes) {
-        isInternal |= pdg->isInternal(node->getT());
-      }
+  return;
+}
 
-      this->addNode(scc, /*inclusion=*/isInternal);
-    }
-  }
+SCCDAG::SCCDAG(PDGSubgraphView *view) {
 
-  pdg->setEntryNode(originalEntryNode);
+  /*
+   * Create nodes of the SCCDAG.
+   *
+   * Only dependences included in the view are considered.
+   */
+  auto includeEdge = [view](DGEdge<Value> *edge) -> bool {
+    return view->isIncluded(edge);
+  };
+  auto components =
+      DGStronglyConnectedComponents<Value>::compute(view->getNodes(),
+                                                    includeEdge);
+  this->addSCCs(
+      components,
+      [view](Value *v) -> bool { return view->isInternal(v); },
+      includeEdge);
 
   /*
    * Create the map from a Value to an SCC included in the SCCDAG.
@@ -98,6 +98,28 @@ SCCDAG::SCCDAG(PDG *pdg) {
   return;
 }
 
+void SCCDAG::addSCCs(
+    const std::vector<std::vector<DGNode<Value> *>> &components,
+    std::function<bool(Value *)> isInternal,
+    std::function<bool(DGEdge<Value> *)> includeEdge) {
+  for (auto &component : components) {
+
+    /*
+     * Add a new SCC to the SCCDAG.
+     */
+    std::set<DGNode<Value> *> sccNodes{ component.begin(), component.end() };
+    auto scc = new SCC(sccNodes, includeEdge);
+    auto isSCCInternal = false;
+    for (auto node : component) {
+      isSCCInternal |= isInternal(node->getT());
+    }
+
+    this->addNode(scc, /*inclusion=*/isSCCInternal);
+  }
+
+  return;
+}
+
 bool SCCDAG::doesItContain(Instruction *inst) const {
 
   /*
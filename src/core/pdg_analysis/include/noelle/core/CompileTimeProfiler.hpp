@@ -0,0 +1,131 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+#include "noelle/core/SystemHeaders.hpp"
+
+namespace llvm::noelle {
+
+/*
+ * Hierarchical timers and counters of the compilation time spent by NOELLE.
+ *
+ * The profiler is disabled by default and every call returns immediately
+ * until it is enabled (see the -noelle-compile-time-profile option).
+ * Phases nest: a phase that begins while another one is running (on the same
+ * thread) becomes its child. Phases with the same name and parent are merged
+ * in the JSON output, while every single execution of a phase is an event of
+ * the Chrome trace output (chrome://tracing).
+ */
+class CompileTimeProfiler {
+public:
+  enum OutputFormat { JSON, CHROME_TRACE };
+
+  static CompileTimeProfiler &getProfiler(void);
+
+  void enable(const std::string &outputFileName, OutputFormat format);
+
+  bool isEnabled(void) const;
+
+  void beginPhase(const char *name);
+
+  void endPhase(void);
+
+  void incrementCounter(const char *name, uint64_t amount = 1);
+
+  /*
+   * Write the phases completed so far and the counters to the output file.
+   */
+  void dump(void);
+
+private:
+  CompileTimeProfiler();
+
+  class PhaseNode {
+  public:
+    std::string name;
+    uint64_t parent;
+    std::map<std::string, uint64_t> children;
+    uint64_t calls;
+    uint64_t nanoseconds;
+  };
+
+  class PhaseEvent {
+  public:
+    uint64_t node;
+    uint64_t thread;
+    uint64_t start;
+    uint64_t duration;
+  };
+
+  class ThreadState {
+  public:
+    uint64_t ID;
+    std::vector<std::pair<uint64_t, uint64_t>> openPhases;
+  };
+
+  std::atomic<bool> enabled;
+  OutputFormat format;
+  std::string outputFileName;
+  std::chrono::steady_clock::time_point origin;
+  std::mutex lock;
+
+  /*
+   * Node 0 is the root of the phase tree.
+   */
+  std::vector<PhaseNode> nodes;
+  std::vector<PhaseEvent> events;
+  std::unordered_map<std::thread::id, ThreadState> threads;
+  std::map<std::string, uint64_t> counters;
+
+  uint64_t now(void) const;
+
+  ThreadState &fetchThreadState(void);
+
+  void dumpAsJSON(std::ostream &stream) const;
+
+  void dumpPhaseAsJSON(std::ostream &stream,
+                       uint64_t node,
+                       uint32_t indentation) const;
+
+  void dumpAsChromeTrace(std::ostream &stream) const;
+
+  static std::string escape(const std::string &name);
+};
+
+/*
+ * Time the scope it is declared in as a phase of the compile-time profiler.
+ */
+class CompileTimePhase {
+public:
+  CompileTimePhase(const char *name);
+
+  ~CompileTimePhase();
+
+private:
+  bool started;
+};
+
+} // namespace llvm::noelle
@@ -0,0 +1,176 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/DGBase.hpp"
+
+namespace llvm::noelle {
+
+/*
+ * Answers of the dependence queries asked during a session.
+ *
+ * Alias answers are kept only while the memory dependences of a function are
+ * computed.
+ * Answers of the loop-aware dependence analyses are shared by all the loops
+ * of the session and they are keyed by the pair of instructions, the type of
+ * the dependence, and the loop.
+ *
+ * The answers about a function are dropped when its dependences are computed
+ * again, when its loops are invalidated, or when its size changes.
+ */
+class DependenceQueryCache {
+public:
+  static DependenceQueryCache &getSessionCache(void);
+
+  /*
+   * @isMemoryAccessQuery distinguishes queries about the memory locations
+   * accessed by two instructions from queries about two pointers.
+   * The answer does not depend on the order of @v1 and @v2.
+   */
+  std::optional<AliasResult> getAliasResult(Function &F,
+                                            Value *v1,
+                                            Value *v2,
+                                            bool isMemoryAccessQuery);
+
+  void setAliasResult(Function &F,
+                      Value *v1,
+                      Value *v2,
+                      bool isMemoryAccessQuery,
+                      AliasResult result);
+
+  /*
+   * Return whether the loop-aware dependence analyses disproved the
+   * dependence of type @type from @from to @to within @loop.
+   * @isLoopCarried selects the loop-carried version of the dependence rather
+   * than the intra-iteration one.
+   */
+  std::optional<bool> isDependenceDisproved(Instruction *from,
+                                            Instruction *to,
+                                            DataDependenceType type,
+                                            Loop *loop,
+                                            bool isLoopCarried);
+
+  void setDependenceDisproved(Instruction *from,
+                              Instruction *to,
+                              DataDependenceType type,
+                              Loop *loop,
+                              bool isLoopCarried,
+                              bool disproved);
+
+  /*
+   * Drop the answers about @F if its code changed since they were computed.
+   * This catches changes that were not followed by an invalidation.
+   */
+  void validate(Function &F);
+
+  /*
+   * Drop the answers about @F.
+   */
+  void invalidate(Function *F);
+
+  /*
+   * Drop the answers about all functions.
+   */
+  void invalidate(void);
+
+  /*
+   * Statistics of the session.
+   */
+  uint64_t getNumberOfAliasQueries(void) const;
+
+  uint64_t getNumberOfAliasHits(void) const;
+
+  uint64_t getNumberOfLoopAwareQueries(void) const;
+
+  uint64_t getNumberOfLoopAwareHits(void) const;
+
+  uint64_t getNumberOfInvalidations(void) const;
+
+private:
+  class AliasQueryKey {
+  public:
+    const Value *first;
+    const Value *second;
+    bool isMemoryAccessQuery;
+
+    bool operator==(const AliasQueryKey &other) const;
+  };
+
+  class AliasQueryKeyHash {
+  public:
+    size_t operator()(const AliasQueryKey &key) const;
+  };
+
+  class LoopAwareQueryKey {
+  public:
+    const Instruction *from;
+    const Instruction *to;
+    DataDependenceType type;
+    const BasicBlock *loopHeader;
+    bool isLoopCarried;
+
+    bool operator==(const LoopAwareQueryKey &other) const;
+  };
+
+  class LoopAwareQueryKeyHash {
+  public:
+    size_t operator()(const LoopAwareQueryKey &key) const;
+  };
+
+  /*
+   * Answers about a function, and the size of the function when they were
+   * computed.
+   */
+  class FunctionQueries {
+  public:
+    uint64_t numberOfBasicBlocks;
+    uint64_t numberOfInstructions;
+    std::unordered_map<AliasQueryKey, AliasResult, AliasQueryKeyHash>
+        aliasResults;
+    std::unordered_map<LoopAwareQueryKey, bool, LoopAwareQueryKeyHash>
+        loopAwareResults;
+  };
+
+  std::mutex lock;
+  std::unordered_map<const Function *, FunctionQueries *> functionQueries;
+
+  std::atomic<uint64_t> aliasQueries;
+  std::atomic<uint64_t> aliasHits;
+  std::atomic<uint64_t> loopAwareQueries;
+  std::atomic<uint64_t> loopAwareHits;
+  std::atomic<uint64_t> invalidations;
+
+  DependenceQueryCache();
+
+  ~DependenceQueryCache();
+
+  FunctionQueries *fetchQueries(Function &F);
+
+  void invalidateWithoutLock(const Function *F);
+
+  static AliasQueryKey getAliasKey(Value *v1,
+                                   Value *v2,
+                                   bool isMemoryAccessQuery);
+};
+
+} // namespace llvm::noelle
@@ -29,9 +29,12 @@
 #include "noelle/core/PDG.hpp"
 #include "noelle/core/CallGraph.hpp"
 #include "noelle/core/AliasAnalysisEngine.hpp"
+#include "noelle/core/DependenceQueryCache.hpp"
 
 namespace llvm::noelle {
 
+class MemorySummaryAnalysis;
+
 enum class PDGVerbosity { Disabled, Minimal, Maximal, MaximalAndPDG };
 
 class PDGAnalysis : public ModulePass {
@@ -44,6 +47,8 @@ public:
 
   bool doInitialization(Module &M) override;
 
+  bool doFinalization(Module &M) override;
+
   void getAnalysisUsage(AnalysisUsage &AU) const override;
 
   void releaseMemory() override;
@@ -76,8 +81,17 @@ private:
   bool disableSVF;
   bool disableAllocAA;
   bool disableRA;
+  bool disableMemorySummaries;
+  uint32_t reachabilityThreads;
   PDGPrinter printer;
   noelle::CallGraph *noelleCG;
+  MemorySummaryAnalysis *memorySummaries;
+
+  /*
+   * Answers of the dependence queries of the session while the memory
+   * dependences of a function are computed (nullptr otherwise).
+   */
+  DependenceQueryCache *queryCache;
 
   std::unordered_set<const Function *> internalFuncs;
   std::unordered_set<const Function *> unhandledExternalFuncs;
@@ -92,6 +106,7 @@ private:
   bool isInternalFunctionThatReachUnhandledExternalFunction(const Function *F);
   bool cannotReachUnhandledExternalFunction(CallBase *call);
   bool hasNoMemoryOperations(CallBase *call);
+  MemorySummaryAnalysis *getMemorySummaries(void);
 
   bool comparePDGs(PDG *pdg1, PDG *pdg2);
   bool compareNodes(PDG *pdg1, PDG *pdg2);
@@ -137,22 +152,31 @@ private:
   void constructEdgesFromAliases(PDG *pdg, Module &M);
   void constructEdgesFromControl(PDG *pdg, Module &M);
   void constructEdgesFromAliasesForFunction(PDG *pdg, Function &F);
+  void constructEdgesFromAliasesForFunction(
+      PDG *pdg,
+      Function &F,
+      InstructionReachability *reachability);
   void constructEdgesFromControlForFunction(PDG *pdg, Function &F);
 
+  InstructionReachability *computeMemoryInstructionReachability(Function &F);
+  std::vector<InstructionReachability *>
+  computeMemoryInstructionReachabilityInParallel(
+      std::vector<Function *> const &functions);
+
   void iterateInstForStore(PDG *,
                            Function &,
                            AAResults &,
-                           DataFlowResult *,
+                           InstructionReachability *,
                            StoreInst *);
   void iterateInstForLoad(PDG *,
                           Function &,
                           AAResults &,
-                          DataFlowResult *,
+                          InstructionReachability *,
                           LoadInst *);
   void iterateInstForCall(PDG *,
                           Function &,
                           AAResults &,
-                          DataFlowResult *,
+                          InstructionReachability *,
                           CallBase *);
 
   template <class InstI, class InstJ>
@@ -162,6 +186,10 @@ private:
                               InstI *,
                               InstJ *,
                               DataDependenceType);
+  template <class InstI, class InstJ>
+  AliasResult doTheyAccessAliasingLocations(AAResults &AA,
+                                            InstI *instI,
+                                            InstJ *instJ);
   void addEdgeFromFunctionModRef(PDG *,
                                  Function &,
                                  AAResults &,
@@ -187,6 +215,9 @@ private:
                           AAResults &AA,
                           Value *instI,
                           Value *instJ);
+  AliasResult doTheyAliasWithoutCache(AAResults &AA,
+                                      Value *instI,
+                                      Value *instJ);
 
   bool edgeIsNotLoopCarriedMemoryDependency(DGEdge<Value> *edge);
   bool isBackedgeOfLoadStoreIntoSameOffsetOfArray(DGEdge<Value> *edge,
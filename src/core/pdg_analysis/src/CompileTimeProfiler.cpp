@@ -0,0 +1,327 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <fstream>
+#include <iomanip>
+
+#include "noelle/core/CompileTimeProfiler.hpp"
+
+namespace llvm::noelle {
+
+CompileTimeProfiler &CompileTimeProfiler::getProfiler(void) {
+  static CompileTimeProfiler profiler;
+
+  return profiler;
+}
+
+CompileTimeProfiler::CompileTimeProfiler()
+  : enabled{ false },
+    format{ JSON },
+    origin{ std::chrono::steady_clock::now() } {
+
+  /*
+   * Create the root of the phase tree.
+   */
+  PhaseNode root;
+  root.parent = 0;
+  root.calls = 0;
+  root.nanoseconds = 0;
+  this->nodes.push_back(root);
+
+  return;
+}
+
+void CompileTimeProfiler::enable(const std::string &outputFileName,
+                                 OutputFormat format) {
+  std::lock_guard<std::mutex> guard(this->lock);
+  this->outputFileName = outputFileName;
+  this->format = format;
+  this->enabled = true;
+
+  return;
+}
+
+bool CompileTimeProfiler::isEnabled(void) const {
+  return this->enabled;
+}
+
+void CompileTimeProfiler::beginPhase(const char *name) {
+  if (!this->enabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(this->lock);
+
+  /*
+   * Fetch the node of the phase, which is a child of the innermost phase
+   * running on the current thread.
+   */
+  auto &thread = this->fetchThreadState();
+  uint64_t parent = 0;
+  if (!thread.openPhases.empty()) {
+    parent = thread.openPhases.back().first;
+  }
+  uint64_t node;
+  auto &siblings = this->nodes[parent].children;
+  auto nodeIt = siblings.find(name);
+  if (nodeIt != siblings.end()) {
+    node = nodeIt->second;
+  } else {
+    node = this->nodes.size();
+    siblings[name] = node;
+    PhaseNode newNode;
+    newNode.name = name;
+    newNode.parent = parent;
+    newNode.calls = 0;
+    newNode.nanoseconds = 0;
+    this->nodes.push_back(newNode);
+  }
+
+  /*
+   * Start the phase.
+   */
+  thread.openPhases.push_back(std::make_pair(node, this->now()));
+
+  return;
+}
+
+void CompileTimeProfiler::endPhase(void) {
+  if (!this->enabled) {
+    return;
+  }
+  auto end = this->now();
+  std::lock_guard<std::mutex> guard(this->lock);
+
+  /*
+   * Fetch the innermost phase running on the current thread.
+   */
+  auto &thread = this->fetchThreadState();
+  if (thread.openPhases.empty()) {
+    return;
+  }
+  auto node = thread.openPhases.back().first;
+  auto start = thread.openPhases.back().second;
+  thread.openPhases.pop_back();
+
+  /*
+   * Account the phase.
+   */
+  auto duration = end - start;
+  this->nodes[node].calls++;
+  this->nodes[node].nanoseconds += duration;
+  if (this->format == CHROME_TRACE) {
+    PhaseEvent event;
+    event.node = node;
+    event.thread = thread.ID;
+    event.start = start;
+    event.duration = duration;
+    this->events.push_back(event);
+  }
+
+  return;
+}
+
+void CompileTimeProfiler::incrementCounter(const char *name,
+                                           uint64_t amount) {
+  if (!this->enabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(this->lock);
+  this->counters[name] += amount;
+
+  return;
+}
+
+void CompileTimeProfiler::dump(void) {
+  if (!this->enabled) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(this->lock);
+
+  /*
+   * Open the output file.
+   */
+  std::ofstream outputFile(this->outputFileName);
+  if (!outputFile.is_open()) {
+    errs() << "NOELLE: CompileTimeProfiler: Error = cannot open "
+           << this->outputFileName << "\n";
+    return;
+  }
+
+  /*
+   * Dump.
+   */
+  outputFile << std::fixed << std::setprecision(3);
+  if (this->format == CHROME_TRACE) {
+    this->dumpAsChromeTrace(outputFile);
+  } else {
+    this->dumpAsJSON(outputFile);
+  }
+
+  return;
+}
+
+uint64_t CompileTimeProfiler::now(void) const {
+  auto elapsed = std::chrono::steady_clock::now() - this->origin;
+
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+CompileTimeProfiler::ThreadState &CompileTimeProfiler::fetchThreadState(void) {
+  auto threadID = std::this_thread::get_id();
+  auto threadIt = this->threads.find(threadID);
+  if (threadIt != this->threads.end()) {
+    return threadIt->second;
+  }
+
+  auto &thread = this->threads[threadID];
+  thread.ID = this->threads.size() - 1;
+
+  return thread;
+}
+
+void CompileTimeProfiler::dumpAsJSON(std::ostream &stream) const {
+
+  /*
+   * Dump the phases.
+   */
+  stream << "{\n  \"phases\": [";
+  auto first = true;
+  for (auto &child : this->nodes[0].children) {
+    stream << (first ? "\n" : ",\n");
+    this->dumpPhaseAsJSON(stream, child.second, 4);
+    first = false;
+  }
+  stream << "\n  ],\n";
+
+  /*
+   * Dump the counters.
+   */
+  stream << "  \"counters\": {";
+  first = true;
+  for (auto &counter : this->counters) {
+    stream << (first ? "\n" : ",\n");
+    stream << "    \"" << escape(counter.first) << "\": " << counter.second;
+    first = false;
+  }
+  stream << "\n  }\n}\n";
+
+  return;
+}
+
+void CompileTimeProfiler::dumpPhaseAsJSON(std::ostream &stream,
+                                          uint64_t node,
+                                          uint32_t indentation) const {
+  auto &phase = this->nodes[node];
+  std::string spaces(indentation, ' ');
+
+  /*
+   * The self time of a phase is the time not spent in its sub-phases.
+   */
+  auto selfNanoseconds = phase.nanoseconds;
+  for (auto &child : phase.children) {
+    auto childNanoseconds = this->nodes[child.second].nanoseconds;
+    selfNanoseconds -= std::min(selfNanoseconds, childNanoseconds);
+  }
+
+  stream << spaces << "{\n";
+  stream << spaces << "  \"name\": \"" << escape(phase.name) << "\",\n";
+  stream << spaces << "  \"calls\": " << phase.calls << ",\n";
+  stream << spaces << "  \"total_ms\": " << (phase.nanoseconds / 1e6)
+         << ",\n";
+  stream << spaces << "  \"self_ms\": " << (selfNanoseconds / 1e6) << ",\n";
+  stream << spaces << "  \"children\": [";
+  auto first = true;
+  for (auto &child : phase.children) {
+    stream << (first ? "\n" : ",\n");
+    this->dumpPhaseAsJSON(stream, child.second, indentation + 4);
+    first = false;
+  }
+  stream << (first ? "]\n" : "\n" + spaces + "  ]\n");
+  stream << spaces << "}";
+
+  return;
+}
+
+void CompileTimeProfiler::dumpAsChromeTrace(std::ostream &stream) const {
+
+  /*
+   * Dump the phases as complete events (timestamps are in microseconds).
+   */
+  stream << "{\n  \"displayTimeUnit\": \"ms\",\n  \"traceEvents\": [";
+  auto first = true;
+  uint64_t end = 0;
+  for (auto &event : this->events) {
+    stream << (first ? "\n" : ",\n");
+    stream << "    {\"name\": \"" << escape(this->nodes[event.node].name)
+           << "\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << event.thread
+           << ", \"ts\": " << (event.start / 1e3)
+           << ", \"dur\": " << (event.duration / 1e3) << "}";
+    end = std::max(end, event.start + event.duration);
+    first = false;
+  }
+
+  /*
+   * Dump the final value of the counters.
+   */
+  for (auto &counter : this->counters) {
+    stream << (first ? "\n" : ",\n");
+    stream << "    {\"name\": \"" << escape(counter.first)
+           << "\", \"ph\": \"C\", \"pid\": 0, \"tid\": 0, \"ts\": "
+           << (end / 1e3) << ", \"args\": {\"value\": " << counter.second
+           << "}}";
+    first = false;
+  }
+  stream << "\n  ]\n}\n";
+
+  return;
+}
+
+std::string CompileTimeProfiler::escape(const std::string &name) {
+  std::string escapedName;
+  for (auto c : name) {
+    if ((c == '"') || (c == '\\')) {
+      escapedName.push_back('\\');
+    }
+    escapedName.push_back(c);
+  }
+
+  return escapedName;
+}
+
+CompileTimePhase::CompileTimePhase(const char *name) : started{ false } {
+  auto &profiler = CompileTimeProfiler::getProfiler();
+  if (profiler.isEnabled()) {
+    profiler.beginPhase(name);
+    this->started = true;
+  }
+
+  return;
+}
+
+CompileTimePhase::~CompileTimePhase() {
+  if (this->started) {
+    CompileTimeProfiler::getProfiler().endPhase();
+  }
+
+  return;
+}
+
+} // namespace llvm::noelle
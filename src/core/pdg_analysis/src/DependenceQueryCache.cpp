@@ -0,0 +1,259 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/DependenceQueryCache.hpp"
+
+namespace llvm::noelle {
+
+DependenceQueryCache::DependenceQueryCache()
+  : aliasQueries{ 0 },
+    aliasHits{ 0 },
+    loopAwareQueries{ 0 },
+    loopAwareHits{ 0 },
+    invalidations{ 0 } {
+  return;
+}
+
+DependenceQueryCache::~DependenceQueryCache() {
+  for (auto pair : this->functionQueries) {
+    delete pair.second;
+  }
+
+  return;
+}
+
+DependenceQueryCache &DependenceQueryCache::getSessionCache(void) {
+  static DependenceQueryCache cache;
+
+  return cache;
+}
+
+std::optional<AliasResult> DependenceQueryCache::getAliasResult(
+    Function &F,
+    Value *v1,
+    Value *v2,
+    bool isMemoryAccessQuery) {
+  this->aliasQueries++;
+
+  /*
+   * Look up the answer.
+   */
+  std::lock_guard<std::mutex> guard(this->lock);
+  auto queries = this->fetchQueries(F);
+  auto key = DependenceQueryCache::getAliasKey(v1, v2, isMemoryAccessQuery);
+  auto resultIt = queries->aliasResults.find(key);
+  if (resultIt == queries->aliasResults.end()) {
+    return std::nullopt;
+  }
+  this->aliasHits++;
+
+  return resultIt->second;
+}
+
+void DependenceQueryCache::setAliasResult(Function &F,
+                                          Value *v1,
+                                          Value *v2,
+                                          bool isMemoryAccessQuery,
+                                          AliasResult result) {
+  std::lock_guard<std::mutex> guard(this->lock);
+  auto queries = this->fetchQueries(F);
+  auto key = DependenceQueryCache::getAliasKey(v1, v2, isMemoryAccessQuery);
+  queries->aliasResults.insert_or_assign(key, result);
+
+  return;
+}
+
+std::optional<bool> DependenceQueryCache::isDependenceDisproved(
+    Instruction *from,
+    Instruction *to,
+    DataDependenceType type,
+    Loop *loop,
+    bool isLoopCarried) {
+  this->loopAwareQueries++;
+
+  /*
+   * Look up the answer.
+   */
+  std::lock_guard<std::mutex> guard(this->lock);
+  auto queries = this->fetchQueries(*from->getFunction());
+  LoopAwareQueryKey key{ from, to, type, loop->getHeader(), isLoopCarried };
+  auto resultIt = queries->loopAwareResults.find(key);
+  if (resultIt == queries->loopAwareResults.end()) {
+    return std::nullopt;
+  }
+  this->loopAwareHits++;
+
+  return resultIt->second;
+}
+
+void DependenceQueryCache::setDependenceDisproved(Instruction *from,
+                                                  Instruction *to,
+                                                  DataDependenceType type,
+                                                  Loop *loop,
+                                                  bool isLoopCarried,
+                                                  bool disproved) {
+  std::lock_guard<std::mutex> guard(this->lock);
+  auto queries = this->fetchQueries(*from->getFunction());
+  LoopAwareQueryKey key{ from, to, type, loop->getHeader(), isLoopCarried };
+  queries->loopAwareResults.insert_or_assign(key, disproved);
+
+  return;
+}
+
+void DependenceQueryCache::validate(Function &F) {
+  std::lock_guard<std::mutex> guard(this->lock);
+
+  /*
+   * Check if there are answers about @F.
+   */
+  auto queriesIt = this->functionQueries.find(&F);
+  if (queriesIt == this->functionQueries.end()) {
+    return;
+  }
+
+  /*
+   * Drop them if the size of @F changed.
+   */
+  auto queries = queriesIt->second;
+  if ((queries->numberOfBasicBlocks != F.size())
+      || (queries->numberOfInstructions != F.getInstructionCount())) {
+    this->invalidateWithoutLock(&F);
+  }
+
+  return;
+}
+
+void DependenceQueryCache::invalidate(Function *F) {
+  std::lock_guard<std::mutex> guard(this->lock);
+  this->invalidateWithoutLock(F);
+
+  return;
+}
+
+void DependenceQueryCache::invalidate(void) {
+  std::lock_guard<std::mutex> guard(this->lock);
+  for (auto pair : this->functionQueries) {
+    delete pair.second;
+    this->invalidations++;
+  }
+  this->functionQueries.clear();
+
+  return;
+}
+
+uint64_t DependenceQueryCache::getNumberOfAliasQueries(void) const {
+  return this->aliasQueries;
+}
+
+uint64_t DependenceQueryCache::getNumberOfAliasHits(void) const {
+  return this->aliasHits;
+}
+
+uint64_t DependenceQueryCache::getNumberOfLoopAwareQueries(void) const {
+  return this->loopAwareQueries;
+}
+
+uint64_t DependenceQueryCache::getNumberOfLoopAwareHits(void) const {
+  return this->loopAwareHits;
+}
+
+uint64_t DependenceQueryCache::getNumberOfInvalidations(void) const {
+  return this->invalidations;
+}
+
+DependenceQueryCache::FunctionQueries *DependenceQueryCache::fetchQueries(
+    Function &F) {
+  auto queriesIt = this->functionQueries.find(&F);
+  if (queriesIt != this->functionQueries.end()) {
+    return queriesIt->second;
+  }
+
+  /*
+   * Start recording the answers about @F.
+   */
+  auto queries = new FunctionQueries();
+  queries->numberOfBasicBlocks = F.size();
+  queries->numberOfInstructions = F.getInstructionCount();
+  this->functionQueries[&F] = queries;
+
+  return queries;
+}
+
+void DependenceQueryCache::invalidateWithoutLock(const Function *F) {
+  auto queriesIt = this->functionQueries.find(F);
+  if (queriesIt == this->functionQueries.end()) {
+    return;
+  }
+  delete queriesIt->second;
+  this->functionQueries.erase(queriesIt);
+  this->invalidations++;
+
+  return;
+}
+
+DependenceQueryCache::AliasQueryKey DependenceQueryCache::getAliasKey(
+    Value *v1,
+    Value *v2,
+    bool isMemoryAccessQuery) {
+
+  /*
+   * Alias queries are symmetric, so the pair is ordered by address.
+   */
+  AliasQueryKey key{ std::min(v1, v2), std::max(v1, v2), isMemoryAccessQuery };
+
+  return key;
+}
+
+bool DependenceQueryCache::AliasQueryKey::operator==(
+    const AliasQueryKey &other) const {
+  return (this->first == other.first) && (this->second == other.second)
+         && (this->isMemoryAccessQuery == other.isMemoryAccessQuery);
+}
+
+size_t DependenceQueryCache::AliasQueryKeyHash::operator()(
+    const AliasQueryKey &key) const {
+  auto h = std::hash<const Value *>{}(key.first);
+  h = (h * 31) ^ std::hash<const Value *>{}(key.second);
+  h = (h * 31) ^ key.isMemoryAccessQuery;
+
+  return h;
+}
+
+bool DependenceQueryCache::LoopAwareQueryKey::operator==(
+    const LoopAwareQueryKey &other) const {
+  return (this->from == other.from) && (this->to == other.to)
+         && (this->type == other.type)
+         && (this->loopHeader == other.loopHeader)
+         && (this->isLoopCarried == other.isLoopCarried);
+}
+
+size_t DependenceQueryCache::LoopAwareQueryKeyHash::operator()(
+    const LoopAwareQueryKey &key) const {
+  auto h = std::hash<const Instruction *>{}(key.from);
+  h = (h * 31) ^ std::hash<const Instruction *>{}(key.to);
+  h = (h * 31) ^ std::hash<const BasicBlock *>{}(key.loopHeader);
+  h = (h * 31) ^ key.type;
+  h = (h * 31) ^ key.isLoopCarried;
+
+  return h;
+}
+
+} // namespace llvm::noelle
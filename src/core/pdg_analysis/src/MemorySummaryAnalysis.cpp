@@ -0,0 +1,532 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "llvm/Analysis/ValueTracking.h"
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/PDGAnalysis.hpp"
+#include "noelle/core/Utils.hpp"
+#include "MemorySummaryAnalysis.hpp"
+#include "IntegrationWithSVF.hpp"
+
+namespace llvm::noelle {
+
+MemoryFootprint::MemoryFootprint(uint32_t numberOfObjects,
+                                 uint32_t numberOfArguments)
+  : objects(numberOfObjects, false),
+    arguments(numberOfArguments, false),
+    unknown{ false } {
+  return;
+}
+
+bool MemoryFootprint::isEmpty(void) const {
+  return (!this->unknown) && this->objects.none() && this->arguments.none();
+}
+
+bool MemoryFootprint::add(MemoryFootprint const &other) {
+  assert(this->objects.size() == other.objects.size());
+  assert(this->arguments.size() == other.arguments.size());
+
+  /*
+   * Check if @other brings anything new.
+   */
+  auto changed = false;
+  if (other.unknown && !this->unknown) {
+    this->unknown = true;
+    changed = true;
+  }
+  auto newObjects = other.objects;
+  newObjects.reset(this->objects);
+  if (newObjects.any()) {
+    this->objects |= other.objects;
+    changed = true;
+  }
+  auto newArguments = other.arguments;
+  newArguments.reset(this->arguments);
+  if (newArguments.any()) {
+    this->arguments |= other.arguments;
+    changed = true;
+  }
+
+  return changed;
+}
+
+FunctionMemorySummary::FunctionMemorySummary(uint32_t numberOfObjects,
+                                             uint32_t numberOfArguments)
+  : read(numberOfObjects, numberOfArguments),
+    written(numberOfObjects, numberOfArguments) {
+  return;
+}
+
+MemorySummaryAnalysis::MemorySummaryAnalysis(Module &M, noelle::CallGraph *cg)
+  : M{ M } {
+
+  /*
+   * Identify the abstract memory objects of the program.
+   */
+  this->collectAbstractObjects();
+
+  /*
+   * Summarize the functions from the callees to the callers.
+   */
+  auto scccag = cg->getSCCCAG();
+  for (auto node : scccag->getNodesInBottomUpOrder()) {
+
+    /*
+     * Fetch the functions with a body that belong to the current node.
+     */
+    std::vector<Function *> functions;
+    if (node->isAnSCC()) {
+      auto sccNode = static_cast<SCCCAGNode_SCC *>(node);
+      for (auto cgNode : sccNode->getNodes()) {
+        auto functionNode = static_cast<CallGraphFunctionNode *>(cgNode);
+        functions.push_back(functionNode->getFunction());
+      }
+    } else {
+      auto functionNode = static_cast<SCCCAGNode_Function *>(node);
+      auto cgNode =
+          static_cast<CallGraphFunctionNode *>(functionNode->getNode());
+      functions.push_back(cgNode->getFunction());
+    }
+    std::vector<Function *> functionsToSummarize;
+    for (auto f : functions) {
+      if (f->empty()) {
+        continue;
+      }
+      this->summaries[f] =
+          new FunctionMemorySummary(this->objectIDs.size(), f->arg_size());
+      functionsToSummarize.push_back(f);
+    }
+
+    /*
+     * Compute the summaries until they reach a fixed point.
+     * Summaries only grow and they are bounded, so this terminates.
+     */
+    auto modified = false;
+    do {
+      modified = false;
+      for (auto f : functionsToSummarize) {
+        modified |= this->summarize(*f);
+      }
+    } while (modified);
+  }
+
+  return;
+}
+
+void MemorySummaryAnalysis::collectAbstractObjects(void) {
+
+  /*
+   * Global variables.
+   */
+  for (auto &g : this->M.globals()) {
+    auto id = this->objectIDs.size();
+    this->objectIDs[&g] = id;
+  }
+
+  /*
+   * Stack and heap allocations.
+   */
+  std::unordered_map<Function *, std::vector<uint32_t>> stackObjects;
+  for (auto &F : this->M) {
+    for (auto &I : instructions(F)) {
+      if (isa<AllocaInst>(&I)) {
+        auto id = this->objectIDs.size();
+        this->objectIDs[&I] = id;
+        stackObjects[&F].push_back(id);
+        continue;
+      }
+      if (auto call = dyn_cast<CallBase>(&I)) {
+        if (Utils::isAllocator(call) && !Utils::isReallocator(call)) {
+          auto id = this->objectIDs.size();
+          this->objectIDs[&I] = id;
+        }
+      }
+    }
+  }
+
+  /*
+   * Stack objects of a function cannot be accessed by its callers.
+   */
+  for (auto &F : this->M) {
+    BitVector bv(this->objectIDs.size(), false);
+    for (auto id : stackObjects[&F]) {
+      bv.set(id);
+    }
+    this->localObjects[&F] = bv;
+  }
+
+  return;
+}
+
+bool MemorySummaryAnalysis::summarize(Function &F) {
+  auto summary = this->summaries.at(&F);
+
+  /*
+   * Collect the memory accessed by the instructions of @F.
+   */
+  auto read = this->newFootprint(F);
+  auto written = this->newFootprint(F);
+  for (auto &I : instructions(F)) {
+    this->addInstruction(F, &I, read, written);
+  }
+
+  /*
+   * Stack objects of @F are not visible to its callers.
+   */
+  auto &locals = this->localObjects.at(&F);
+  read.objects.reset(locals);
+  written.objects.reset(locals);
+
+  /*
+   * Update the summary.
+   */
+  auto modified = summary->read.add(read);
+  modified |= summary->written.add(written);
+
+  return modified;
+}
+
+MemoryFootprint MemorySummaryAnalysis::newFootprint(Function &F) const {
+  return MemoryFootprint(this->objectIDs.size(), F.arg_size());
+}
+
+void MemorySummaryAnalysis::addPointer(Function &F,
+                                       Value *pointer,
+                                       MemoryFootprint &footprint) {
+
+  /*
+   * Fetch the objects @pointer can point to.
+   */
+  SmallVector<const Value *, 4> objects;
+  GetUnderlyingObjects(pointer, objects, this->M.getDataLayout());
+
+  /*
+   * Map them to abstract memory objects.
+   */
+  for (auto constObject : objects) {
+    auto object = const_cast<Value *>(constObject);
+    if (auto arg = dyn_cast<Argument>(object)) {
+      if (arg->getParent() == &F) {
+        footprint.arguments.set(arg->getArgNo());
+        continue;
+      }
+    }
+    if (this->objectIDs.find(object) != this->objectIDs.end()) {
+      footprint.objects.set(this->objectIDs.at(object));
+      continue;
+    }
+    if (isa<ConstantPointerNull>(object) || isa<UndefValue>(object)) {
+      continue;
+    }
+    footprint.unknown = true;
+  }
+
+  return;
+}
+
+void MemorySummaryAnalysis::addInstruction(Function &F,
+                                           Instruction *i,
+                                           MemoryFootprint &read,
+                                           MemoryFootprint &written) {
+  if (auto load = dyn_cast<LoadInst>(i)) {
+    this->addPointer(F, load->getPointerOperand(), read);
+    return;
+  }
+  if (auto store = dyn_cast<StoreInst>(i)) {
+    this->addPointer(F, store->getPointerOperand(), written);
+    return;
+  }
+  if (auto rmw = dyn_cast<AtomicRMWInst>(i)) {
+    this->addPointer(F, rmw->getPointerOperand(), read);
+    this->addPointer(F, rmw->getPointerOperand(), written);
+    return;
+  }
+  if (auto cmpXchg = dyn_cast<AtomicCmpXchgInst>(i)) {
+    this->addPointer(F, cmpXchg->getPointerOperand(), read);
+    this->addPointer(F, cmpXchg->getPointerOperand(), written);
+    return;
+  }
+  if (auto call = dyn_cast<CallBase>(i)) {
+    this->addCall(F, call, read, written);
+    return;
+  }
+
+  /*
+   * Any other instruction that accesses memory (e.g., va_arg, fence) is
+   * handled conservatively.
+   */
+  if (i->mayReadOrWriteMemory()) {
+    read.unknown = true;
+    written.unknown = true;
+  }
+
+  return;
+}
+
+void MemorySummaryAnalysis::addCall(Function &F,
+                                    CallBase *call,
+                                    MemoryFootprint &read,
+                                    MemoryFootprint &written) {
+
+  /*
+   * Check if the call cannot access memory.
+   */
+  if (call->doesNotAccessMemory()) {
+    return;
+  }
+
+  /*
+   * Allocators return new memory, while deallocators only write the object they
+   * free.
+   */
+  if (Utils::isReallocator(call)) {
+    this->addPointer(F, call->getArgOperand(0), read);
+    this->addPointer(F, call->getArgOperand(0), written);
+    return;
+  }
+  if (Utils::isAllocator(call)) {
+    return;
+  }
+  if (Utils::isDeallocator(call)) {
+    this->addPointer(F, Utils::getFreedObject(call), written);
+    return;
+  }
+
+  /*
+   * Fetch the possible callees.
+   */
+  std::set<Function *> callees;
+  if (call->isInlineAsm()) {
+    read.unknown = true;
+    written.unknown = true;
+    return;
+  }
+  if (auto callee = call->getCalledFunction()) {
+    callees.insert(callee);
+  } else if (NoelleSVFIntegration::hasIndCSCallees(call)) {
+    for (auto callee : NoelleSVFIntegration::getIndCSCallees(call)) {
+      callees.insert(const_cast<Function *>(callee));
+    }
+  }
+  if (callees.size() == 0) {
+    read.unknown = true;
+    written.unknown = true;
+    return;
+  }
+
+  /*
+   * Add the memory accessed by the callees.
+   */
+  for (auto callee : callees) {
+
+    /*
+     * Check if the callee is a library function.
+     */
+    if (callee->empty()) {
+
+      /*
+       * Pure library functions without pointer arguments do not access memory.
+       */
+      auto hasPointerArguments = false;
+      for (auto &arg : call->args()) {
+        if (arg->getType()->isPointerTy()) {
+          hasPointerArguments = true;
+          break;
+        }
+      }
+      if (PDGAnalysis::isTheLibraryFunctionPure(callee) && (!hasPointerArguments)
+          && (!callee->doesNotReturn())) {
+        continue;
+      }
+
+      /*
+       * Rely on the attributes of the library function.
+       */
+      if (callee->doesNotAccessMemory()) {
+        continue;
+      }
+      auto onlyReads = callee->onlyReadsMemory() || call->onlyReadsMemory();
+      if (callee->onlyAccessesArgMemory()) {
+        for (auto &arg : call->args()) {
+          if (!arg->getType()->isPointerTy()) {
+            continue;
+          }
+          this->addPointer(F, arg, read);
+          if (!onlyReads) {
+            this->addPointer(F, arg, written);
+          }
+        }
+        continue;
+      }
+      read.unknown = true;
+      if (!onlyReads) {
+        written.unknown = true;
+      }
+      continue;
+    }
+
+    /*
+     * The callee has a body.
+     * Fetch its summary.
+     */
+    auto summary = this->getSummary(callee);
+    if (summary == nullptr) {
+      read.unknown = true;
+      written.unknown = true;
+      continue;
+    }
+
+    /*
+     * Map the summary of the callee to the caller.
+     */
+    auto mapSummary = [this, &F, call](MemoryFootprint const &calleeFootprint,
+                                       MemoryFootprint &callerFootprint) {
+      callerFootprint.objects |= calleeFootprint.objects;
+      if (calleeFootprint.unknown) {
+        callerFootprint.unknown = true;
+      }
+      for (auto argNo : calleeFootprint.arguments.set_bits()) {
+        if (argNo >= call->arg_size()) {
+          callerFootprint.unknown = true;
+          continue;
+        }
+        this->addPointer(F, call->getArgOperand(argNo), callerFootprint);
+      }
+    };
+    mapSummary(summary->read, read);
+    mapSummary(summary->written, written);
+  }
+
+  return;
+}
+
+FunctionMemorySummary *MemorySummaryAnalysis::getSummary(Function *f) const {
+  if (this->summaries.find(f) == this->summaries.end()) {
+    return nullptr;
+  }
+
+  return this->summaries.at(f);
+}
+
+std::pair<MemoryFootprint, MemoryFootprint> &MemorySummaryAnalysis::
+    getFootprint(Instruction *i) {
+
+  /*
+   * Check if we have already computed the footprint of @i.
+   */
+  auto it = this->footprints.find(i);
+  if (it != this->footprints.end()) {
+    return it->second;
+  }
+
+  /*
+   * Compute the memory read and written by @i.
+   */
+  auto &F = *i->getFunction();
+  auto read = this->newFootprint(F);
+  auto written = this->newFootprint(F);
+  this->addInstruction(F, i, read, written);
+  auto result =
+      this->footprints.insert(std::make_pair(i, std::make_pair(read, written)));
+
+  return result.first->second;
+}
+
+bool MemorySummaryAnalysis::mayConflict(Function &F,
+                                        MemoryFootprint const &f1,
+                                        MemoryFootprint const &f2) const {
+
+  /*
+   * Check the trivial cases.
+   */
+  if (f1.isEmpty() || f2.isEmpty()) {
+    return false;
+  }
+  if (f1.unknown || f2.unknown) {
+    return true;
+  }
+  if (f1.objects.anyCommon(f2.objects)) {
+    return true;
+  }
+
+  /*
+   * Memory reachable from the parameters of @F can be anything allocated
+   * outside the current invocation of @F. Hence, it cannot be a stack object
+   * of @F.
+   */
+  auto &locals = this->localObjects.at(&F);
+  auto mayConflictWithArguments = [&locals](MemoryFootprint const &other) {
+    if (other.arguments.any()) {
+      return true;
+    }
+    auto nonLocalObjects = other.objects;
+    nonLocalObjects.reset(locals);
+    return nonLocalObjects.any();
+  };
+  if (f1.arguments.any() && mayConflictWithArguments(f2)) {
+    return true;
+  }
+  if (f2.arguments.any() && mayConflictWithArguments(f1)) {
+    return true;
+  }
+
+  return false;
+}
+
+bool MemorySummaryAnalysis::mayDepend(CallBase *call, Instruction *i) {
+  assert(call->getFunction() == i->getFunction());
+  auto &F = *call->getFunction();
+
+  /*
+   * Fetch the memory accessed.
+   */
+  auto &callFootprint = this->getFootprint(call);
+  auto &iFootprint = this->getFootprint(i);
+
+  /*
+   * Check if one of them writes memory accessed by the other.
+   */
+  if (this->mayConflict(F, callFootprint.second, iFootprint.first)) {
+    return true;
+  }
+  if (this->mayConflict(F, callFootprint.second, iFootprint.second)) {
+    return true;
+  }
+  if (this->mayConflict(F, callFootprint.first, iFootprint.second)) {
+    return true;
+  }
+
+  return false;
+}
+
+bool MemorySummaryAnalysis::mayDepend(CallBase *call, CallBase *otherCall) {
+  return this->mayDepend(call, static_cast<Instruction *>(otherCall));
+}
+
+MemorySummaryAnalysis::~MemorySummaryAnalysis() {
+  for (auto pair : this->summaries) {
+    delete pair.second;
+  }
+
+  return;
+}
+
+} // namespace llvm::noelle
@@ -0,0 +1,139 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#pragma once
+
+#include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/CallGraph.hpp"
+#include "noelle/core/SCCCAG.hpp"
+
+namespace llvm::noelle {
+
+/*
+ * Set of abstract memory objects accessed by an instruction, a call, or a whole
+ * function.
+ *
+ * Abstract memory objects are global variables, stack allocations, and heap
+ * allocation sites of the program.
+ * Memory reachable from the formal parameters of the current function is
+ * tracked per parameter.
+ * Everything else is "unknown" memory, which can alias anything.
+ */
+class MemoryFootprint {
+public:
+  MemoryFootprint(uint32_t numberOfObjects, uint32_t numberOfArguments);
+
+  MemoryFootprint() = delete;
+
+  bool isEmpty(void) const;
+
+  /*
+   * Add @other to @this.
+   * Return true if @this changed.
+   */
+  bool add(MemoryFootprint const &other);
+
+  BitVector objects;
+
+  BitVector arguments;
+
+  bool unknown;
+};
+
+/*
+ * Memory read and written by a function (including its callees) as visible to
+ * its callers.
+ */
+class FunctionMemorySummary {
+public:
+  FunctionMemorySummary(uint32_t numberOfObjects, uint32_t numberOfArguments);
+
+  MemoryFootprint read;
+
+  MemoryFootprint written;
+};
+
+/*
+ * Bottom-up, summary-based, interprocedural mod/ref analysis.
+ *
+ * Functions are summarized following the SCCCAG from callees to callers.
+ * Functions that belong to the same SCC of the call graph are iterated until
+ * their summaries reach a fixed point.
+ */
+class MemorySummaryAnalysis {
+public:
+  MemorySummaryAnalysis(Module &M, noelle::CallGraph *cg);
+
+  MemorySummaryAnalysis() = delete;
+
+  /*
+   * Return false if @call cannot access the memory accessed by @i.
+   * Return true otherwise.
+   * @i must be a memory instruction of the same function of @call.
+   */
+  bool mayDepend(CallBase *call, Instruction *i);
+
+  /*
+   * Return false if @call and @otherCall cannot access the same memory (with
+   * at least one of them writing it).
+   * Return true otherwise.
+   * @call and @otherCall must belong to the same function.
+   */
+  bool mayDepend(CallBase *call, CallBase *otherCall);
+
+  FunctionMemorySummary *getSummary(Function *f) const;
+
+  ~MemorySummaryAnalysis();
+
+private:
+  Module &M;
+  std::unordered_map<Value *, uint32_t> objectIDs;
+  std::unordered_map<Function *, BitVector> localObjects;
+  std::unordered_map<Function *, FunctionMemorySummary *> summaries;
+  std::unordered_map<Instruction *, std::pair<MemoryFootprint, MemoryFootprint>>
+      footprints;
+
+  void collectAbstractObjects(void);
+
+  bool summarize(Function &F);
+
+  MemoryFootprint newFootprint(Function &F) const;
+
+  void addPointer(Function &F, Value *pointer, MemoryFootprint &footprint);
+
+  void addCall(Function &F,
+               CallBase *call,
+               MemoryFootprint &read,
+               MemoryFootprint &written);
+
+  void addInstruction(Function &F,
+                      Instruction *i,
+                      MemoryFootprint &read,
+                      MemoryFootprint &written);
+
+  std::pair<MemoryFootprint, MemoryFootprint> &getFootprint(Instruction *i);
+
+  bool mayConflict(Function &F,
+                   MemoryFootprint const &f1,
+                   MemoryFootprint const &f2) const;
+};
+
+} // namespace llvm::noelle
@@ -19,11 +19,15 @@
  OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
+#include <atomic>
+
 #include "noelle/core/SystemHeaders.hpp"
 #include "noelle/core/TalkDown.hpp"
 #include "noelle/core/PDGPrinter.hpp"
 #include "noelle/core/PDGAnalysis.hpp"
+#include "noelle/core/CompileTimeProfiler.hpp"
 #include "noelle/core/Utils.hpp"
+#include "MemorySummaryAnalysis.hpp"
 
 namespace llvm::noelle {
 
@@ -38,8 +42,12 @@ PDGAnalysis::PDGAnalysis()
     disableSVF{ false },
     disableAllocAA{ false },
     disableRA{ false },
+    disableMemorySummaries{ false },
+    reachabilityThreads{ 1 },
     printer{},
-    noelleCG{ nullptr } {
+    noelleCG{ nullptr },
+    memorySummaries{ nullptr },
+    queryCache{ nullptr } {
 
   return;
 }
@@ -59,6 +67,11 @@ void PDGAnalysis::releaseMemory() {
   }
   this->functionToFDGMap.clear();
 
+  if (this->memorySummaries) {
+    delete this->memorySummaries;
+  }
+  this->memorySummaries = nullptr;
+
   return;
 }
 
@@ -243,6 +256,7 @@ PDG *PDGAnalysis::constructPDGFromAnalysis(Module &M) {
   if (verbose >= PDGVerbosity::Maximal) {
     errs() << "PDGAnalysis: Construct PDG from Analysis\n";
   }
+  CompileTimePhase phase("PDG");
 
   auto pdg = new PDG(M);
 
@@ -252,6 +266,10 @@ PDG *PDGAnalysis::constructPDGFromAnalysis(Module &M) {
 
   trimDGUsingCustomAliasAnalysis(pdg);
 
+  auto &profiler = CompileTimeProfiler::getProfiler();
+  profiler.incrementCounter("PDG nodes", pdg->numNodes());
+  profiler.incrementCounter("PDG edges", pdg->numEdges());
+
   return pdg;
 }
 
@@ -259,12 +277,17 @@ PDG *PDGAnalysis::constructFunctionDGFromAnalysis(Function &F) {
   if (verbose >= PDGVerbosity::Maximal) {
     errs() << "PDGAnalysis: Construct function DG from Analysis\n";
   }
+  CompileTimePhase phase("Function DG");
 
   auto pdg = new PDG(F);
   constructEdgesFromUseDefs(pdg);
   constructEdgesFromAliasesForFunction(pdg, F);
   constructEdgesFromControlForFunction(pdg, F);
 
+  auto &profiler = CompileTimeProfiler::getProfiler();
+  profiler.incrementCounter("PDG nodes", pdg->numNodes());
+  profiler.incrementCounter("PDG edges", pdg->numEdges());
+
   return pdg;
 }
 
@@ -272,6 +295,7 @@ PDG *PDGAnalysis::constructPDGFromMetadata(Module &M) {
   if (verbose >= PDGVerbosity::Maximal) {
     errs() << "PDGAnalysis: Construct PDG from Metadata\n";
   }
+  CompileTimePhase phase("PDG from metadata");
 
   /*
    * Create the PDG.
@@ -480,6 +504,7 @@ MDNode *PDGAnalysis::getSubEdgesMetadata(
 }
 
 void PDGAnalysis::trimDGUsingCustomAliasAnalysis(PDG *pdg) {
+  CompileTimePhase phase("PDG: AllocAA");
 
   /*
    * Fetch AllocAA
@@ -504,6 +529,7 @@ void PDGAnalysis::trimDGUsingCustomAliasAnalysis(PDG *pdg) {
 }
 
 void PDGAnalysis::constructEdgesFromUseDefs(PDG *pdg) {
+  CompileTimePhase phase("PDG: variable dependences");
 
   /*
    * Add the dependences due to variables.
@@ -539,21 +565,33 @@ void PDGAnalysis::constructEdgesFromUseDefs(PDG *pdg) {
 void PDGAnalysis::constructEdgesFromAliases(PDG *pdg, Module &M) {
 
   /*
-   * Use alias analysis on stores, loads, and function calls to construct PDG
-   * edges
+   * Fetch the functions with a body.
    */
+  std::vector<Function *> functions;
   for (auto &F : M) {
-
-    /*
-     * Check if the function has a body.
-     */
-    if (F.empty())
+    if (F.empty()) {
       continue;
+    }
+    functions.push_back(&F);
+  }
 
-    /*
-     * Add the edges to the PDG.
-     */
-    constructEdgesFromAliasesForFunction(pdg, F);
+  /*
+   * Compute which memory instructions can reach which ones.
+   * This only reads the IR, so it is done for all functions in parallel.
+   */
+  auto reachabilities =
+      this->computeMemoryInstructionReachabilityInParallel(functions);
+
+  /*
+   * Use alias analysis on stores, loads, and function calls to construct PDG
+   * edges.
+   * This must be done sequentially as it relies on the LLVM pass manager.
+   */
+  for (auto i = 0u; i < functions.size(); i++) {
+    constructEdgesFromAliasesForFunction(pdg,
+                                         *functions[i],
+                                         reachabilities[i]);
+    delete reachabilities[i];
   }
 
   return;
@@ -562,13 +600,61 @@ void PDGAnalysis::constructEdgesFromAliases(PDG *pdg, Module &M) {
 void PDGAnalysis::constructEdgesFromAliasesForFunction(PDG *pdg, Function &F) {
 
   /*
-   * Fetch the alias analysis.
+   * Run the reachable analysis.
    */
-  auto &AA = getAnalysis<AAResultsWrapperPass>(F).getAAResults();
+  auto reachability = this->computeMemoryInstructionReachability(F);
 
   /*
-   * Run the reachable analysis.
+   * Add the edges to the PDG.
+   */
+  this->constructEdgesFromAliasesForFunction(pdg, F, reachability);
+
+  /*
+   * Free the memory.
+   */
+  delete reachability;
+
+  return;
+}
+
+void PDGAnalysis::constructEdgesFromAliasesForFunction(
+    PDG *pdg,
+    Function &F,
+    InstructionReachability *reachability) {
+  CompileTimePhase phase("PDG: memory dependences");
+
+  /*
+   * Drop the answers about the function the session has so far.
+   * The function might have changed since they were computed.
+   * The code does not change while its memory dependences are computed, so
+   * the new answers stay valid in the meantime.
+   */
+  this->queryCache = &DependenceQueryCache::getSessionCache();
+  this->queryCache->invalidate(&F);
+
+  /*
+   * Fetch the alias analysis.
    */
+  auto &AA = getAnalysis<AAResultsWrapperPass>(F).getAAResults();
+
+  for (auto &B : F) {
+    for (auto &I : B) {
+      if (auto store = dyn_cast<StoreInst>(&I)) {
+        iterateInstForStore(pdg, F, AA, reachability, store);
+      } else if (auto load = dyn_cast<LoadInst>(&I)) {
+        iterateInstForLoad(pdg, F, AA, reachability, load);
+      } else if (auto call = dyn_cast<CallBase>(&I)) {
+        iterateInstForCall(pdg, F, AA, reachability, call);
+      }
+    }
+  }
+  this->queryCache = nullptr;
+
+  return;
+}
+
+InstructionReachability *PDGAnalysis::computeMemoryInstructionReachability(
+    Function &F) {
   auto onlyMemoryInstructionFilter = [](Instruction *i) -> bool {
     if (isa<LoadInst>(i)) {
       return true;
@@ -581,33 +667,66 @@ void PDGAnalysis::constructEdgesFromAliasesForFunction(PDG *pdg, Function &F) {
     }
     return false;
   };
-  auto dfr =
-      this->disableRA
-          ? this->dfa.getFullSets(&F)
-          : this->dfa.runReachableAnalysis(&F, onlyMemoryInstructionFilter);
 
-  for (auto &B : F) {
-    for (auto &I : B) {
-      if (auto store = dyn_cast<StoreInst>(&I)) {
-        iterateInstForStore(pdg, F, AA, dfr, store);
-      } else if (auto load = dyn_cast<LoadInst>(&I)) {
-        iterateInstForLoad(pdg, F, AA, dfr, load);
-      } else if (auto call = dyn_cast<CallBase>(&I)) {
-        iterateInstForCall(pdg, F, AA, dfr, call);
+  /*
+   * If the reachable analysis is disabled, then every memory instruction is
+   * assumed to reach every other one.
+   */
+  auto reachability = new InstructionReachability(&F,
+                                                  onlyMemoryInstructionFilter,
+                                                  this->disableRA);
+
+  return reachability;
+}
+
+std::vector<InstructionReachability *> PDGAnalysis::
+    computeMemoryInstructionReachabilityInParallel(
+        std::vector<Function *> const &functions) {
+  CompileTimePhase phase("PDG: reachability");
+
+  /*
+   * Each worker computes the reachability of one function at a time and it
+   * writes only the slot of that function, so no lock is needed.
+   */
+  std::vector<InstructionReachability *> reachabilities(functions.size(),
+                                                        nullptr);
+  std::atomic<uint64_t> nextFunctionIndex{ 0 };
+  auto worker = [&]() {
+    while (true) {
+      auto functionIndex = nextFunctionIndex.fetch_add(1);
+      if (functionIndex >= functions.size()) {
+        return;
       }
+      auto function = functions[functionIndex];
+      reachabilities[functionIndex] =
+          this->computeMemoryInstructionReachability(*function);
     }
-  }
+  };
 
   /*
-   * Free the memory.
+   * Run the workers.
+   * The current thread is one of them.
    */
-  delete dfr;
+  uint64_t numberOfThreads = this->reachabilityThreads;
+  if (numberOfThreads > functions.size()) {
+    numberOfThreads = functions.size();
+  }
+  std::vector<std::thread> threads;
+  for (auto i = 1u; i < numberOfThreads; i++) {
+    threads.push_back(std::thread(worker));
+  }
+  worker();
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  return reachabilities;
 }
 
 void PDGAnalysis::iterateInstForCall(PDG *pdg,
                                      Function &F,
                                      AAResults &AA,
-                                     DataFlowResult *dfr,
+                                     InstructionReachability *reachability,
                                      CallBase *call) {
 
   /*
@@ -627,7 +746,7 @@ void PDGAnalysis::iterateInstForCall(PDG *pdg,
   /*
    * Identify all dependences with @call.
    */
-  for (auto I : dfr->OUT(call)) {
+  for (auto I : reachability->getReachableInstructions(call)) {
 
     /*
      * Check stores.
@@ -1122,6 +1241,10 @@ PDGAnalysis::~PDGAnalysis() {
     delete fdg;
   }
   this->functionToFDGMap.clear();
+
+  if (this->memorySummaries) {
+    delete this->memorySummaries;
+  }
 }
 
 // http://www.cplusplus.com/reference/clibrary/ and
@@ -24,6 +24,7 @@
 #include "noelle/core/PDGPrinter.hpp"
 #include "noelle/core/PDGAnalysis.hpp"
 #include "IntegrationWithSVF.hpp"
+#include "MemorySummaryAnalysis.hpp"
 
 namespace llvm::noelle {
 
@@ -35,6 +36,18 @@ noelle::CallGraph *PDGAnalysis::getProgramCallGraph(void) {
   return this->noelleCG;
 }
 
+MemorySummaryAnalysis *PDGAnalysis::getMemorySummaries(void) {
+  if (this->disableMemorySummaries) {
+    return nullptr;
+  }
+  if (this->memorySummaries == nullptr) {
+    auto cg = this->getProgramCallGraph();
+    this->memorySummaries = new MemorySummaryAnalysis(*this->M, cg);
+  }
+
+  return this->memorySummaries;
+}
+
 void PDGAnalysis::identifyFunctionsThatInvokeUnhandledLibrary(Module &M) {
 
   /*
@@ -23,6 +23,7 @@
 #include "noelle/core/TalkDown.hpp"
 #include "noelle/core/PDGPrinter.hpp"
 #include "noelle/core/PDGAnalysis.hpp"
+#include "noelle/core/CompileTimeProfiler.hpp"
 
 namespace llvm::noelle {
 
@@ -50,6 +51,7 @@ void PDGAnalysis::constructEdgesFromControl(PDG *pdg, Module &M) {
 
 void PDGAnalysis::constructEdgesFromControlForFunction(PDG *pdg, Function &F) {
   assert(pdg != nullptr);
+  CompileTimePhase phase("PDG: control dependences");
 
   /*
    * There is a control dependence from a basic block A to a basic block B iff
@@ -23,7 +23,9 @@
 #include "noelle/core/TalkDown.hpp"
 #include "noelle/core/PDGPrinter.hpp"
 #include "noelle/core/PDGAnalysis.hpp"
+#include "noelle/core/CompileTimeProfiler.hpp"
 #include "IntegrationWithSVF.hpp"
+#include "MemorySummaryAnalysis.hpp"
 #include "noelle/core/Utils.hpp"
 
 namespace llvm::noelle {
@@ -31,10 +33,10 @@ namespace llvm::noelle {
 void PDGAnalysis::iterateInstForStore(PDG *pdg,
                                       Function &F,
                                       AAResults &AA,
-                                      DataFlowResult *dfr,
+                                      InstructionReachability *reachability,
                                       StoreInst *store) {
 
-  for (auto I : dfr->OUT(store)) {
+  for (auto I : reachability->getReachableInstructions(store)) {
 
     /*
      * Check stores.
@@ -80,10 +82,10 @@ void PDGAnalysis::iterateInstForStore(PDG *pdg,
 void PDGAnalysis::iterateInstForLoad(PDG *pdg,
                                      Function &F,
                                      AAResults &AA,
-                                     DataFlowResult *dfr,
+                                     InstructionReachability *reachability,
                                      LoadInst *load) {
 
-  for (auto I : dfr->OUT(load)) {
+  for (auto I : reachability->getReachableInstructions(load)) {
 
     /*
      * Check stores.
@@ -164,6 +166,14 @@ void PDGAnalysis::addEdgeFromFunctionModRef(PDG *pdg,
     return;
   }
 
+  /*
+   * Check the interprocedural memory summaries.
+   */
+  auto summaries = this->getMemorySummaries();
+  if ((summaries != nullptr) && (!summaries->mayDepend(call, store))) {
+    return;
+  }
+
   /*
    * Query the LLVM alias analyses.
    */
@@ -292,6 +302,14 @@ void PDGAnalysis::addEdgeFromFunctionModRef(PDG *pdg,
     return;
   }
 
+  /*
+   * Check the interprocedural memory summaries.
+   */
+  auto summaries = this->getMemorySummaries();
+  if ((summaries != nullptr) && (!summaries->mayDepend(call, load))) {
+    return;
+  }
+
   /*
    * Query the LLVM alias analyses.
    */
@@ -418,6 +436,14 @@ void PDGAnalysis::addEdgeFromFunctionModRef(PDG *pdg,
     }
   }
 
+  /*
+   * Check the interprocedural memory summaries.
+   */
+  auto summaries = this->getMemorySummaries();
+  if ((summaries != nullptr) && (!summaries->mayDepend(call, otherCall))) {
+    return;
+  }
+
   /*
    * Query the LLVM alias analyses.
    */
@@ -695,21 +721,48 @@ void PDGAnalysis::addEdgeFromMemoryAlias(
     InstI *instI,
     InstJ *instJ,
     DataDependenceType dataDependenceType) {
-  auto must = false;
+
+  /*
+   * Check if the same query has already been answered.
+   * RAW and WAR dependences between a store and a load ask the same query.
+   */
+  assert(this->queryCache != nullptr);
+  auto aliasResult = this->queryCache->getAliasResult(F, instI, instJ, true);
+  if (!aliasResult) {
+    aliasResult = this->doTheyAccessAliasingLocations(AA, instI, instJ);
+    this->queryCache->setAliasResult(F, instI, instJ, true, *aliasResult);
+  }
+
+  /*
+   * Add the dependence.
+   */
+  if (*aliasResult == NoAlias) {
+    return;
+  }
+  auto must = (*aliasResult == MustAlias);
+  pdg->addEdge(instI, instJ)->setMemMustType(true, must, dataDependenceType);
+
+  return;
+}
+
+template <class InstI, class InstJ>
+AliasResult PDGAnalysis::doTheyAccessAliasingLocations(AAResults &AA,
+                                                        InstI *instI,
+                                                        InstJ *instJ) {
+
+  CompileTimeProfiler::getProfiler().incrementCounter("alias queries");
 
   /*
    * Query the LLVM alias analyses.
    */
   switch (AA.alias(MemoryLocation::get(instI), MemoryLocation::get(instJ))) {
     case NoAlias:
-      return;
+      return NoAlias;
     case PartialAlias:
     case MayAlias:
       break;
     case MustAlias:
-      pdg->addEdge(instI, instJ)
-          ->setMemMustType(true, true, dataDependenceType);
-      return;
+      return MustAlias;
   }
 
   /*
@@ -731,22 +784,16 @@ void PDGAnalysis::addEdgeFromMemoryAlias(
     switch (NoelleSVFIntegration::alias(MemoryLocation::get(instI),
                                         MemoryLocation::get(instJ))) {
       case NoAlias:
-        return;
+        return NoAlias;
       case PartialAlias:
       case MayAlias:
         break;
       case MustAlias:
-        must = true;
-        break;
+        return MustAlias;
     }
   }
 
-  /*
-   * There is a dependence.
-   */
-  pdg->addEdge(instI, instJ)->setMemMustType(true, must, dataDependenceType);
-
-  return;
+  return MayAlias;
 }
 
 AliasResult PDGAnalysis::doTheyAlias(PDG *pdg,
@@ -755,6 +802,26 @@ AliasResult PDGAnalysis::doTheyAlias(PDG *pdg,
                                      Value *instI,
                                      Value *instJ) {
 
+  /*
+   * Check if the same query has already been answered.
+   */
+  assert(this->queryCache != nullptr);
+  auto cachedResult = this->queryCache->getAliasResult(F, instI, instJ, false);
+  if (cachedResult) {
+    return *cachedResult;
+  }
+  auto result = this->doTheyAliasWithoutCache(AA, instI, instJ);
+  this->queryCache->setAliasResult(F, instI, instJ, false, result);
+
+  return result;
+}
+
+AliasResult PDGAnalysis::doTheyAliasWithoutCache(AAResults &AA,
+                                                 Value *instI,
+                                                 Value *instJ) {
+
+  CompileTimeProfiler::getProfiler().incrementCounter("alias queries");
+
   /*
    * Query the LLVM alias analyses.
    */
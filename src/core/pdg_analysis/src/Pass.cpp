@@ -22,6 +22,7 @@
 #include "noelle/core/SystemHeaders.hpp"
 #include "noelle/core/PDGAnalysis.hpp"
 #include "noelle/core/PDGPrinter.hpp"
+#include "noelle/core/CompileTimeProfiler.hpp"
 
 namespace llvm::noelle {
 
@@ -60,6 +61,29 @@ static cl::opt<bool> PDGRADisable(
     cl::ZeroOrMore,
     cl::Hidden,
     cl::desc("Disable the use of reaching analysis to compute the PDG"));
+static cl::opt<bool> PDGMemorySummariesDisable(
+    "noelle-disable-pdg-memory-summaries",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc(
+        "Disable the interprocedural memory summaries used for call dependences"));
+static cl::opt<int> PDGThreads(
+    "noelle-pdg-threads",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc("Threads used to compute the reachability of memory instructions "
+             "(default: all cores, 1: sequential)"));
+static cl::opt<std::string> CompileTimeProfile(
+    "noelle-compile-time-profile",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc("Profile the compilation time of NOELLE and dump it to a file"));
+static cl::opt<std::string> CompileTimeProfileFormat(
+    "noelle-compile-time-profile-format",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::init("json"),
+    cl::desc("Format of the compilation time profile (json or chrome)"));
 
 bool PDGAnalysis::doInitialization(Module &M) {
   this->verbose = static_cast<PDGVerbosity>(PDGVerbose.getValue());
@@ -71,6 +95,36 @@ bool PDGAnalysis::doInitialization(Module &M) {
   this->disableAllocAA =
       (PDGAllocAADisable.getNumOccurrences() > 0) ? true : false;
   this->disableRA = (PDGRADisable.getNumOccurrences() > 0) ? true : false;
+  this->disableMemorySummaries =
+      (PDGMemorySummariesDisable.getNumOccurrences() > 0) ? true : false;
+
+  auto threads = (PDGThreads.getNumOccurrences() > 0)
+                     ? PDGThreads.getValue()
+                     : (int)std::thread::hardware_concurrency();
+  this->reachabilityThreads = (threads > 1) ? threads : 1;
+
+  /*
+   * Enable the compilation time profiler.
+   */
+  if (CompileTimeProfile.getNumOccurrences() > 0) {
+    auto format = CompileTimeProfiler::JSON;
+    if (CompileTimeProfileFormat.getValue() == "chrome") {
+      format = CompileTimeProfiler::CHROME_TRACE;
+    }
+    CompileTimeProfiler::getProfiler().enable(CompileTimeProfile.getValue(),
+                                              format);
+  }
+
+  return false;
+}
+
+bool PDGAnalysis::doFinalization(Module &M) {
+
+  /*
+   * Dump the compilation time profile.
+   * All the passes that use NOELLE have completed by now.
+   */
+  CompileTimeProfiler::getProfiler().dump();
 
   return false;
 }
@@ -0,0 +1,492 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <set>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+/*
+ * Runtime of the memory dependence profiler (see noelle-prof-deps).
+ *
+ * Memory is tracked at the granularity of 8 bytes. Each granule keeps its
+ * last writer and the readers since then. An access is identified by its
+ * dynamic context: the chain of call sites that led to it followed by the
+ * instruction that performed it. A dependence between two accesses is
+ * attributed to the pair of instructions where their contexts diverge, which
+ * belong to the same function.
+ *
+ * Loop-carried dependences are identified with a global clock that ticks at
+ * every iteration of every loop: a dependence crosses iterations of a loop L
+ * if the source access happened during the current invocation of L, but
+ * before the current iteration of L started.
+ *
+ * The profiler can be used by multi-threaded programs. The call stack and the
+ * loops being executed are tracked per thread, while the shadow memory, the
+ * contexts, the clock, and the profile are shared and protected by a lock.
+ * Hence, dependences between accesses of different threads are recorded too.
+ */
+
+#define GRANULE_SHIFT 3
+
+#define DEP_RAW 0
+#define DEP_WAR 1
+#define DEP_WAW 2
+
+typedef struct {
+  uint64_t parent;
+  uint64_t instructionID;
+  uint64_t depth;
+} ContextNode_t;
+
+typedef struct {
+  uint64_t context;
+  uint64_t time;
+} Access_t;
+
+typedef struct {
+  bool hasWriter;
+  Access_t writer;
+  std::vector<Access_t> readers;
+} Granule_t;
+
+typedef struct {
+  uint64_t context;
+  uint64_t callSite;
+} Frame_t;
+
+typedef struct {
+  std::vector<Frame_t> stack;
+  uint64_t pendingCallSite;
+  std::vector<uint64_t> invocationStart;
+  std::vector<uint64_t> currentIteration;
+} ThreadState_t;
+
+class DependenceProfiler {
+public:
+  DependenceProfiler(uint64_t numberOfInstructions,
+                     uint64_t numberOfLoops,
+                     const uint64_t *innermostLoops,
+                     const uint64_t *parentLoops);
+
+  void access(uint64_t instID, void *address, uint64_t size, bool isWrite);
+
+  void call(uint64_t instID);
+
+  void functionEntry(void);
+
+  void functionExit(void);
+
+  void loopEntry(uint64_t loopID);
+
+  void loopIteration(uint64_t loopID);
+
+  void dump(const char *fileName);
+
+private:
+  uint64_t numberOfInstructions;
+  uint64_t numberOfLoops;
+  std::vector<uint64_t> innermostLoops;
+  std::vector<uint64_t> parentLoops;
+
+  /*
+   * Lock that protects the state shared by the threads.
+   */
+  std::mutex lock;
+
+  /*
+   * Dynamic contexts.
+   */
+  std::vector<ContextNode_t> contexts;
+  std::unordered_map<uint64_t, std::unordered_map<uint64_t, uint64_t>>
+      children;
+
+  /*
+   * Clock.
+   */
+  uint64_t now;
+
+  /*
+   * Shadow memory.
+   */
+  std::unordered_map<uint64_t, Granule_t> shadow;
+
+  /*
+   * Profile.
+   */
+  std::vector<bool> executed;
+  std::map<std::tuple<uint64_t, uint64_t, uint32_t>, std::set<uint64_t>>
+      dependences;
+
+  ThreadState_t &fetchThreadState(void);
+
+  uint64_t fetchContext(uint64_t parent, uint64_t instID);
+
+  void addDependence(const Access_t &src,
+                     uint64_t dstContext,
+                     uint32_t type,
+                     ThreadState_t &state);
+};
+
+static DependenceProfiler *profiler = nullptr;
+
+static thread_local ThreadState_t *threadState = nullptr;
+
+static void dumpProfile(void) {
+  auto fileName = getenv("NOELLE_DEPS_PROF_FILE");
+  if (fileName == nullptr) {
+    fileName = (char *)"noelle_deps.prof";
+  }
+  profiler->dump(fileName);
+
+  return;
+}
+
+extern "C" {
+
+void noelle_depprof_initialize(uint64_t numberOfInstructions,
+                               uint64_t numberOfLoops,
+                               const uint64_t *innermostLoops,
+                               const uint64_t *parentLoops) {
+  if (profiler != nullptr) {
+    return;
+  }
+  profiler = new DependenceProfiler(numberOfInstructions,
+                                    numberOfLoops,
+                                    innermostLoops,
+                                    parentLoops);
+  atexit(dumpProfile);
+
+  return;
+}
+
+void noelle_depprof_load(uint64_t instID, void *address, uint64_t size) {
+  if (profiler == nullptr) {
+    return;
+  }
+  profiler->access(instID, address, size, false);
+
+  return;
+}
+
+void noelle_depprof_store(uint64_t instID, void *address, uint64_t size) {
+  if (profiler == nullptr) {
+    return;
+  }
+  profiler->access(instID, address, size, true);
+
+  return;
+}
+
+void noelle_depprof_call(uint64_t instID) {
+  if (profiler == nullptr) {
+    return;
+  }
+  profiler->call(instID);
+
+  return;
+}
+
+void noelle_depprof_function_entry(void) {
+  if (profiler == nullptr) {
+    return;
+  }
+  profiler->functionEntry();
+
+  return;
+}
+
+void noelle_depprof_function_exit(void) {
+  if (profiler == nullptr) {
+    return;
+  }
+  profiler->functionExit();
+
+  return;
+}
+
+void noelle_depprof_loop_entry(uint64_t loopID) {
+  if (profiler == nullptr) {
+    return;
+  }
+  profiler->loopEntry(loopID);
+
+  return;
+}
+
+void noelle_depprof_loop_iteration(uint64_t loopID) {
+  if (profiler == nullptr) {
+    return;
+  }
+  profiler->loopIteration(loopID);
+
+  return;
+}
+}
+
+DependenceProfiler::DependenceProfiler(uint64_t numberOfInstructions,
+                                       uint64_t numberOfLoops,
+                                       const uint64_t *innermostLoops,
+                                       const uint64_t *parentLoops)
+  : numberOfInstructions{ numberOfInstructions },
+    numberOfLoops{ numberOfLoops },
+    innermostLoops(innermostLoops, innermostLoops + numberOfInstructions + 1),
+    parentLoops(parentLoops, parentLoops + numberOfLoops + 1),
+    now{ 0 },
+    executed(numberOfInstructions + 1, false) {
+
+  /*
+   * The root context: code executed outside any instrumented function.
+   */
+  this->contexts.push_back({ 0, 0, 0 });
+
+  return;
+}
+
+ThreadState_t &DependenceProfiler::fetchThreadState(void) {
+  if (threadState != nullptr) {
+    return *threadState;
+  }
+
+  /*
+   * This is the first time the current thread executes instrumented code.
+   * Its accesses start from the root context.
+   */
+  threadState = new ThreadState_t();
+  threadState->stack.push_back({ 0, 0 });
+  threadState->pendingCallSite = 0;
+  threadState->invocationStart.resize(this->numberOfLoops + 1, 0);
+  threadState->currentIteration.resize(this->numberOfLoops + 1, 0);
+
+  return *threadState;
+}
+
+void DependenceProfiler::access(uint64_t instID,
+                                void *address,
+                                uint64_t size,
+                                bool isWrite) {
+  auto &state = this->fetchThreadState();
+  std::lock_guard<std::mutex> guard(this->lock);
+  this->executed[instID] = true;
+  if (size == 0) {
+    return;
+  }
+
+  /*
+   * Fetch the context of the access.
+   */
+  auto context = this->fetchContext(state.stack.back().context, instID);
+
+  /*
+   * Check every granule touched by the access.
+   */
+  auto first = ((uint64_t)address) >> GRANULE_SHIFT;
+  auto last = (((uint64_t)address) + size - 1) >> GRANULE_SHIFT;
+  for (auto g = first; g <= last; g++) {
+    auto &granule = this->shadow[g];
+
+    if (!isWrite) {
+
+      /*
+       * RAW dependence.
+       */
+      if (granule.hasWriter) {
+        this->addDependence(granule.writer, context, DEP_RAW, state);
+      }
+
+      /*
+       * Track the reader.
+       */
+      auto found = false;
+      for (auto &reader : granule.readers) {
+        if (reader.context == context) {
+          reader.time = this->now;
+          found = true;
+          break;
+        }
+      }
+      if (!found) {
+        granule.readers.push_back({ context, this->now });
+      }
+      continue;
+    }
+
+    /*
+     * WAW and WAR dependences.
+     */
+    if (granule.hasWriter) {
+      this->addDependence(granule.writer, context, DEP_WAW, state);
+    }
+    for (auto &reader : granule.readers) {
+      this->addDependence(reader, context, DEP_WAR, state);
+    }
+
+    /*
+     * Track the writer.
+     */
+    granule.hasWriter = true;
+    granule.writer = { context, this->now };
+    granule.readers.clear();
+  }
+
+  return;
+}
+
+void DependenceProfiler::call(uint64_t instID) {
+  auto &state = this->fetchThreadState();
+  state.pendingCallSite = instID;
+  std::lock_guard<std::mutex> guard(this->lock);
+  this->executed[instID] = true;
+
+  return;
+}
+
+void DependenceProfiler::functionEntry(void) {
+  auto &state = this->fetchThreadState();
+  auto callSite = state.pendingCallSite;
+  std::lock_guard<std::mutex> guard(this->lock);
+  auto context = this->fetchContext(state.stack.back().context, callSite);
+  state.stack.push_back({ context, callSite });
+
+  return;
+}
+
+void DependenceProfiler::functionExit(void) {
+  auto &state = this->fetchThreadState();
+  if (state.stack.size() <= 1) {
+    return;
+  }
+
+  /*
+   * Restore the call site of the caller. This is needed when the caller is
+   * not instrumented and it invokes instrumented code several times (e.g.,
+   * callbacks).
+   */
+  auto frame = state.stack.back();
+  state.stack.pop_back();
+  state.pendingCallSite = frame.callSite;
+
+  return;
+}
+
+void DependenceProfiler::loopEntry(uint64_t loopID) {
+  auto &state = this->fetchThreadState();
+  std::lock_guard<std::mutex> guard(this->lock);
+  state.invocationStart[loopID] = this->now + 1;
+
+  return;
+}
+
+void DependenceProfiler::loopIteration(uint64_t loopID) {
+  auto &state = this->fetchThreadState();
+  std::lock_guard<std::mutex> guard(this->lock);
+  this->now++;
+  state.currentIteration[loopID] = this->now;
+
+  return;
+}
+
+uint64_t DependenceProfiler::fetchContext(uint64_t parent, uint64_t instID) {
+  auto &parentChildren = this->children[parent];
+  auto it = parentChildren.find(instID);
+  if (it != parentChildren.end()) {
+    return it->second;
+  }
+
+  auto context = this->contexts.size();
+  auto depth = this->contexts[parent].depth + 1;
+  this->contexts.push_back({ parent, instID, depth });
+  parentChildren[instID] = context;
+
+  return context;
+}
+
+void DependenceProfiler::addDependence(const Access_t &src,
+                                       uint64_t dstContext,
+                                       uint32_t type,
+                                       ThreadState_t &state) {
+
+  /*
+   * Find where the two contexts diverge.
+   */
+  auto srcContext = src.context;
+  while (this->contexts[srcContext].depth > this->contexts[dstContext].depth) {
+    srcContext = this->contexts[srcContext].parent;
+  }
+  while (this->contexts[dstContext].depth > this->contexts[srcContext].depth) {
+    dstContext = this->contexts[dstContext].parent;
+  }
+  while (this->contexts[srcContext].parent
+         != this->contexts[dstContext].parent) {
+    srcContext = this->contexts[srcContext].parent;
+    dstContext = this->contexts[dstContext].parent;
+  }
+  auto srcID = this->contexts[srcContext].instructionID;
+  auto dstID = this->contexts[dstContext].instructionID;
+  if ((srcID == 0) || (dstID == 0)) {
+    return;
+  }
+
+  /*
+   * Record the dependence.
+   */
+  auto &carryingLoops = this->dependences[std::make_tuple(srcID, dstID, type)];
+
+  /*
+   * Identify the loops that include both instructions and whose iterations
+   * have been crossed by the dependence.
+   * These are the loops the current thread is executing.
+   */
+  std::set<uint64_t> srcLoops;
+  for (auto l = this->innermostLoops[srcID]; l != 0; l = this->parentLoops[l]) {
+    srcLoops.insert(l);
+  }
+  for (auto l = this->innermostLoops[dstID]; l != 0; l = this->parentLoops[l]) {
+    if (srcLoops.find(l) == srcLoops.end()) {
+      continue;
+    }
+    if ((src.time >= state.invocationStart[l])
+        && (src.time < state.currentIteration[l])) {
+      carryingLoops.insert(l);
+    }
+  }
+
+  return;
+}
+
+void DependenceProfiler::dump(const char *fileName) {
+  std::lock_guard<std::mutex> guard(this->lock);
+  auto file = fopen(fileName, "w");
+  if (file == nullptr) {
+    fprintf(stderr, "DependenceProfiler: cannot write %s\n", fileName);
+    return;
+  }
+
+  fprintf(file,
+          "NOELLE_DEPS_PROF %lu %lu\n",
+          (unsigned long)this->numberOfInstructions,
+          (unsigned long)this->numberOfLoops);
+  for (auto i = 1u; i <= this->numberOfInstructions; i++) {
+    if (this->executed[i]) {
+      fprintf(file, "E %u\n", i);
+    }
+  }
+  const char *typeNames[] = { "RAW", "WAR", "WAW" };
+  for (auto &pair : this->dependences) {
+    fprintf(file,
+            "D %lu %lu %s %lu",
+            (unsigned long)std::get<0>(pair.first),
+            (unsigned long)std::get<1>(pair.first),
+            typeNames[std::get<2>(pair.first)],
+            (unsigned long)pair.second.size());
+    for (auto l : pair.second) {
+      fprintf(file, " %lu", (unsigned long)l);
+    }
+    fprintf(file, "\n");
+  }
+  fclose(file);
+
+  return;
+}
@@ -0,0 +1,192 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/*
+ * Runtime of the loop profiler (see noelle-prof-loops).
+ *
+ * For every loop, it collects the histogram of iterations per invocation and
+ * the histogram of instructions executed per iteration. Buckets are
+ * logarithmic: bucket 0 counts 0, and bucket i > 0 counts [2^(i-1), 2^i - 1].
+ *
+ * The instrumented code updates noelle_loopprof_instructions inline at every
+ * basic block. An invocation of a loop starts when the loop is entered from
+ * its preheader, and it is closed when the loop is entered again, when the
+ * thread that runs it exits, or when the program exits.
+ *
+ * The profiler can be used by multi-threaded programs. The instruction
+ * counter and the invocations being executed are tracked per thread, while
+ * the histograms are shared and updated atomically.
+ */
+
+#define HISTOGRAM_BUCKETS 65
+
+typedef struct {
+  bool active;
+  uint64_t iterations;
+  uint64_t iterationStart;
+} LoopInvocation_t;
+
+typedef struct {
+  std::atomic<uint64_t> iterationsHistogram[HISTOGRAM_BUCKETS];
+  std::atomic<uint64_t> instructionsHistogram[HISTOGRAM_BUCKETS];
+} LoopProfile_t;
+
+extern "C" {
+thread_local uint64_t noelle_loopprof_instructions = 0;
+}
+
+static uint64_t numberOfLoops = 0;
+
+static LoopProfile_t *loops = nullptr;
+
+static uint32_t getBucket(uint64_t value) {
+  uint32_t bucket = 0;
+  while (value > 0) {
+    bucket++;
+    value >>= 1;
+  }
+
+  return bucket;
+}
+
+static void addSample(std::atomic<uint64_t> *histogram, uint64_t value) {
+  histogram[getBucket(value)].fetch_add(1, std::memory_order_relaxed);
+
+  return;
+}
+
+/*
+ * Invocations of loops executed by a thread (indexed by loop ID).
+ */
+class ThreadInvocations {
+public:
+  std::vector<LoopInvocation_t> invocations;
+
+  LoopInvocation_t *fetchInvocation(uint64_t loopID) {
+    if ((loopID == 0) || (loopID > numberOfLoops)) {
+      return nullptr;
+    }
+    if (this->invocations.size() == 0) {
+      this->invocations.resize(numberOfLoops + 1, LoopInvocation_t{});
+    }
+
+    return &this->invocations[loopID];
+  }
+
+  void closeInvocation(uint64_t loopID) {
+    auto &invocation = this->invocations[loopID];
+    if (!invocation.active) {
+      return;
+    }
+    addSample(loops[loopID].iterationsHistogram, invocation.iterations);
+    invocation.active = false;
+
+    return;
+  }
+
+  void closeInvocations(void) {
+    for (auto i = 1u; i < this->invocations.size(); i++) {
+      this->closeInvocation(i);
+    }
+
+    return;
+  }
+
+  /*
+   * The invocations of the thread that exits the program are closed before
+   * the profile is dumped as thread-local objects are destroyed before the
+   * functions registered with atexit are invoked.
+   */
+  ~ThreadInvocations() {
+    this->closeInvocations();
+
+    return;
+  }
+};
+
+static thread_local ThreadInvocations threadInvocations;
+
+static void dumpHistogram(FILE *file, std::atomic<uint64_t> *histogram) {
+  auto buckets = HISTOGRAM_BUCKETS;
+  while ((buckets > 0) && (histogram[buckets - 1].load() == 0)) {
+    buckets--;
+  }
+  fprintf(file, " %d", buckets);
+  for (auto b = 0; b < buckets; b++) {
+    fprintf(file, " %lu", (unsigned long)histogram[b].load());
+  }
+
+  return;
+}
+
+static void dumpProfile(void) {
+  auto fileName = getenv("NOELLE_LOOP_PROF_FILE");
+  if (fileName == nullptr) {
+    fileName = (char *)"noelle_loops.prof";
+  }
+  auto file = fopen(fileName, "w");
+  if (file == nullptr) {
+    fprintf(stderr, "LoopProfiler: cannot write %s\n", fileName);
+    return;
+  }
+
+  fprintf(file, "NOELLE_LOOP_PROF %lu\n", (unsigned long)numberOfLoops);
+  for (auto i = 1u; i <= numberOfLoops; i++) {
+    auto &loop = loops[i];
+    fprintf(file, "L %u", i);
+    dumpHistogram(file, loop.iterationsHistogram);
+    dumpHistogram(file, loop.instructionsHistogram);
+    fprintf(file, "\n");
+  }
+  fclose(file);
+
+  return;
+}
+
+extern "C" {
+
+void noelle_loopprof_initialize(uint64_t loopsToProfile) {
+  if (loops != nullptr) {
+    return;
+  }
+  loops = new LoopProfile_t[loopsToProfile + 1]();
+  numberOfLoops = loopsToProfile;
+  atexit(dumpProfile);
+
+  return;
+}
+
+void noelle_loopprof_loop_entry(uint64_t loopID) {
+  auto invocation = threadInvocations.fetchInvocation(loopID);
+  if (invocation == nullptr) {
+    return;
+  }
+  threadInvocations.closeInvocation(loopID);
+  invocation->active = true;
+  invocation->iterations = 0;
+
+  return;
+}
+
+void noelle_loopprof_loop_iteration(uint64_t loopID) {
+  auto invocation = threadInvocations.fetchInvocation(loopID);
+  if ((invocation == nullptr) || !invocation->active) {
+    return;
+  }
+
+  /*
+   * Record the cost of the iteration that just ended.
+   */
+  if (invocation->iterations > 0) {
+    auto cost = noelle_loopprof_instructions - invocation->iterationStart;
+    addSample(loops[loopID].instructionsHistogram, cost);
+  }
+  invocation->iterations++;
+  invocation->iterationStart = noelle_loopprof_instructions;
+
+  return;
+}
+}
@@ -9,17 +9,20 @@ extern DispatcherInfo NOELLE_DOALLDispatcher(
     void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t),
     void *env,
     int64_t maxNumberOfCores,
-    int64_t chunkSize);
+    int64_t chunkSize,
+    int64_t loopID);
 
 extern void queuePush8(void *, int8_t *);
 extern void queuePush16(void *, int16_t *);
 extern void queuePush32(void *, int32_t *);
 extern void queuePush64(void *, int64_t *);
+extern void queuePushRecord(void *, void *);
 
 extern void queuePop8(void *, int8_t *);
 extern void queuePop16(void *, int16_t *);
 extern void queuePop32(void *, int32_t *);
 extern void queuePop64(void *, int64_t *);
+extern void queuePopRecord(void *, void *);
 
 extern void stageExecuter(void (*stage)(void *, void *), void *, void *);
 extern DispatcherInfo NOELLE_DSWPDispatcher(void *env,
@@ -58,16 +61,24 @@ extern DispatcherInfo NOELLE_HELIX_dispatcher_sequentialSegments(
 
 extern uint32_t NOELLE_getAvailableCores(void);
 
+extern int64_t NOELLE_getLoopVariant(int64_t loopID,
+                                     int64_t availableVariants,
+                                     int64_t defaultVariant);
+extern int64_t NOELLE_getLoopCores(int64_t loopID, int64_t maxCores);
+extern int64_t NOELLE_getLoopChunkSize(int64_t loopID, int64_t chunkSize);
+
 void SIMONE_CAMPANONI_IS_GOING_TO_REMOVE_THIS_FUNCTION(void) {
   queuePush8(0, 0);
   queuePush16(0, 0);
   queuePush32(0, 0);
   queuePush64(0, 0);
+  queuePushRecord(0, 0);
 
   queuePop8(0, 0);
   queuePop16(0, 0);
   queuePop32(0, 0);
   queuePop64(0, 0);
+  queuePopRecord(0, 0);
 
   stageExecuter(0, 0, 0);
   NOELLE_DSWPDispatcher(0, 0, 0, 0, 0);
@@ -77,7 +88,11 @@ void SIMONE_CAMPANONI_IS_GOING_TO_REMOVE_THIS_FUNCTION(void) {
   HELIX_wait(0);
   HELIX_signal(0);
 
-  NOELLE_DOALLDispatcher(0, 0, 0, 0);
+  NOELLE_DOALLDispatcher(0, 0, 0, 0, 0);
 
   NOELLE_getAvailableCores();
+
+  NOELLE_getLoopVariant(0, 0, 0);
+  NOELLE_getLoopCores(0, 0);
+  NOELLE_getLoopChunkSize(0, 0);
 }
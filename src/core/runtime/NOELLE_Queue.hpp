@@ -0,0 +1,329 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_QUEUE_HPP
+#define NOELLE_QUEUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+#include "NOELLE_ThreadPool.hpp"
+
+/*
+ * Unbounded queue between two stages of a DSWP loop.
+ *
+ * A queue has a single producer and a single consumer, so it needs no locks.
+ * Values are stored in segments of valuesPerSegment values linked in a list:
+ * the producer appends a new segment when the last one is full, and the
+ * consumer frees a segment when it has popped all its values.
+ */
+template <typename T>
+class NoelleQueue {
+public:
+  NoelleQueue();
+
+  void push(T value);
+
+  void waitPop(T &value);
+
+  ~NoelleQueue(void);
+
+private:
+  static constexpr uint32_t valuesPerSegment = 1024;
+
+  /*
+   * Number of times the consumer spins on an empty queue before yielding its
+   * core.
+   */
+  static constexpr uint32_t spinIterations = 1024;
+
+  struct Segment {
+    T values[valuesPerSegment];
+    std::atomic<Segment *> next;
+  };
+
+  /*
+   * Producer side.
+   */
+  Segment *tail;
+  uint32_t tailIndex;
+  std::atomic<uint64_t> pushed;
+
+  /*
+   * Consumer side.
+   *
+   * It is kept in a different cache line than the producer side.
+   */
+  char padding[64];
+  Segment *head;
+  uint32_t headIndex;
+  uint64_t popped;
+
+  static Segment *newSegment(void);
+};
+
+template <typename T>
+NoelleQueue<T>::NoelleQueue() {
+  auto segment = newSegment();
+  this->tail = segment;
+  this->tailIndex = 0;
+  this->pushed.store(0, std::memory_order_relaxed);
+  this->head = segment;
+  this->headIndex = 0;
+  this->popped = 0;
+
+  return;
+}
+
+template <typename T>
+void NoelleQueue<T>::push(T value) {
+
+  /*
+   * Append a new segment if the last one is full.
+   */
+  if (this->tailIndex == valuesPerSegment) {
+    auto segment = newSegment();
+    this->tail->next.store(segment, std::memory_order_release);
+    this->tail = segment;
+    this->tailIndex = 0;
+  }
+
+  /*
+   * Store the value and make it visible to the consumer.
+   */
+  this->tail->values[this->tailIndex] = value;
+  this->tailIndex++;
+  this->pushed.store(this->pushed.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+
+  return;
+}
+
+template <typename T>
+void NoelleQueue<T>::waitPop(T &value) {
+
+  /*
+   * Wait for a value.
+   */
+  uint32_t iterations = 0;
+  while (this->pushed.load(std::memory_order_acquire) == this->popped) {
+    if (iterations < spinIterations) {
+      NOELLE_spinPause();
+      iterations++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  /*
+   * Move to the next segment if the current one has been consumed.
+   */
+  if (this->headIndex == valuesPerSegment) {
+    auto nextSegment = this->head->next.load(std::memory_order_acquire);
+    delete this->head;
+    this->head = nextSegment;
+    this->headIndex = 0;
+  }
+
+  /*
+   * Pop the value.
+   */
+  value = this->head->values[this->headIndex];
+  this->headIndex++;
+  this->popped++;
+
+  return;
+}
+
+template <typename T>
+NoelleQueue<T>::~NoelleQueue(void) {
+  auto segment = this->head;
+  while (segment != nullptr) {
+    auto nextSegment = segment->next.load(std::memory_order_relaxed);
+    delete segment;
+    segment = nextSegment;
+  }
+
+  return;
+}
+
+template <typename T>
+typename NoelleQueue<T>::Segment *NoelleQueue<T>::newSegment(void) {
+  auto segment = new Segment();
+  segment->next.store(nullptr, std::memory_order_relaxed);
+
+  return segment;
+}
+
+/*
+ * Unbounded queue of fixed-size records between two stages of a DSWP loop.
+ *
+ * A record packs all the values a stage sends to another one at once (e.g.,
+ * several live values, vectors, aggregates), so they are synchronized with a
+ * single push and a single pop. The queue works like NoelleQueue, but the
+ * size of its records is known only at run time.
+ */
+class NoelleRecordQueue {
+public:
+  NoelleRecordQueue(uint64_t recordSize);
+
+  void push(void *record);
+
+  void waitPop(void *record);
+
+  ~NoelleRecordQueue(void);
+
+private:
+  static constexpr uint32_t recordsPerSegment = 1024;
+
+  static constexpr uint32_t spinIterations = 1024;
+
+  struct Segment {
+    char *records;
+    std::atomic<Segment *> next;
+  };
+
+  uint64_t recordSize;
+
+  /*
+   * Producer side.
+   */
+  Segment *tail;
+  uint32_t tailIndex;
+  std::atomic<uint64_t> pushed;
+
+  /*
+   * Consumer side.
+   *
+   * It is kept in a different cache line than the producer side.
+   */
+  char padding[64];
+  Segment *head;
+  uint32_t headIndex;
+  uint64_t popped;
+
+  Segment *newSegment(void);
+
+  static void deleteSegment(Segment *segment);
+};
+
+inline NoelleRecordQueue::NoelleRecordQueue(uint64_t recordSize)
+  : recordSize{ recordSize } {
+  auto segment = newSegment();
+  this->tail = segment;
+  this->tailIndex = 0;
+  this->pushed.store(0, std::memory_order_relaxed);
+  this->head = segment;
+  this->headIndex = 0;
+  this->popped = 0;
+
+  return;
+}
+
+inline void NoelleRecordQueue::push(void *record) {
+
+  /*
+   * Append a new segment if the last one is full.
+   */
+  if (this->tailIndex == recordsPerSegment) {
+    auto segment = newSegment();
+    this->tail->next.store(segment, std::memory_order_release);
+    this->tail = segment;
+    this->tailIndex = 0;
+  }
+
+  /*
+   * Copy the record and make it visible to the consumer.
+   */
+  auto slot = this->tail->records + (this->tailIndex * this->recordSize);
+  std::memcpy(slot, record, this->recordSize);
+  this->tailIndex++;
+  this->pushed.store(this->pushed.load(std::memory_order_relaxed) + 1,
+                     std::memory_order_release);
+
+  return;
+}
+
+inline void NoelleRecordQueue::waitPop(void *record) {
+
+  /*
+   * Wait for a record.
+   */
+  uint32_t iterations = 0;
+  while (this->pushed.load(std::memory_order_acquire) == this->popped) {
+    if (iterations < spinIterations) {
+      NOELLE_spinPause();
+      iterations++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  /*
+   * Move to the next segment if the current one has been consumed.
+   */
+  if (this->headIndex == recordsPerSegment) {
+    auto nextSegment = this->head->next.load(std::memory_order_acquire);
+    deleteSegment(this->head);
+    this->head = nextSegment;
+    this->headIndex = 0;
+  }
+
+  /*
+   * Copy the record out of the queue.
+   */
+  auto slot = this->head->records + (this->headIndex * this->recordSize);
+  std::memcpy(record, slot, this->recordSize);
+  this->headIndex++;
+  this->popped++;
+
+  return;
+}
+
+inline NoelleRecordQueue::~NoelleRecordQueue(void) {
+  auto segment = this->head;
+  while (segment != nullptr) {
+    auto nextSegment = segment->next.load(std::memory_order_relaxed);
+    deleteSegment(segment);
+    segment = nextSegment;
+  }
+
+  return;
+}
+
+inline NoelleRecordQueue::Segment *NoelleRecordQueue::newSegment(void) {
+  auto segment = new Segment();
+  segment->records = new char[this->recordSize * recordsPerSegment];
+  segment->next.store(nullptr, std::memory_order_relaxed);
+
+  return segment;
+}
+
+inline void NoelleRecordQueue::deleteSegment(Segment *segment) {
+  delete[] segment->records;
+  delete segment;
+
+  return;
+}
+
+#endif
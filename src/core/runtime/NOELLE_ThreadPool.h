@@ -0,0 +1,115 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_THREADPOOL_H
+#define NOELLE_THREADPOOL_H
+
+#include <stdint.h>
+
+/*
+ * C ABI of the thread pool of the NOELLE runtime.
+ *
+ * The DOALL, HELIX, and DSWP dispatchers submit their tasks through these
+ * functions.
+ *
+ * A pool starts its workers when it is created. Each worker owns a task slot:
+ * a submission claims the slot of an idle worker and the worker runs the task
+ * without going through a shared queue. If every worker is busy, a new worker
+ * is started, so tasks submitted together (e.g., the stages of a DSWP loop)
+ * always run concurrently.
+ *
+ * Workers can be split in groups (e.g., one per NUMA node). A worker belongs
+ * to the same group for its whole life and it runs the initializer of the
+ * pool once, when it starts (e.g., to bind itself to the CPUs of its group).
+ * Tasks submitted to a group only run on workers of that group.
+ *
+ * An idle worker waits for its next task according to the wait policy of the
+ * pool:
+ *   - NOELLE_WAIT_SPIN: the worker spins until a task arrives. This gives the
+ *     lowest dispatch latency, but idle workers keep their cores busy.
+ *   - NOELLE_WAIT_PARK: the worker sleeps until a task arrives.
+ *   - NOELLE_WAIT_HYBRID: the worker spins for spinIterations iterations and
+ *     then it sleeps.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+  NOELLE_WAIT_SPIN = 0,
+  NOELLE_WAIT_PARK = 1,
+  NOELLE_WAIT_HYBRID = 2
+} NOELLE_WaitPolicy_t;
+
+typedef void (*NOELLE_Task_t)(void *args);
+
+typedef void (*NOELLE_WorkerInitializer_t)(uint32_t group);
+
+/*
+ * Create a pool and start numberOfWorkers workers.
+ */
+void *NOELLE_ThreadPool_create(uint32_t numberOfWorkers,
+                               NOELLE_WaitPolicy_t waitPolicy,
+                               uint64_t spinIterations);
+
+/*
+ * Create a pool and start numberOfWorkers workers split in numberOfGroups
+ * groups of consecutive workers.
+ * initializer can be NULL.
+ */
+void *NOELLE_ThreadPool_createWithGroups(
+    uint32_t numberOfWorkers,
+    uint32_t numberOfGroups,
+    NOELLE_WorkerInitializer_t initializer,
+    NOELLE_WaitPolicy_t waitPolicy,
+    uint64_t spinIterations);
+
+/*
+ * Run task(args) on an idle worker of the pool.
+ * The caller is responsible for waiting for the task to complete.
+ */
+void NOELLE_ThreadPool_submit(void *pool, NOELLE_Task_t task, void *args);
+
+/*
+ * Run task(args) on an idle worker of the group given as input.
+ * The caller is responsible for waiting for the task to complete.
+ */
+void NOELLE_ThreadPool_submitToGroup(void *pool,
+                                     uint32_t group,
+                                     NOELLE_Task_t task,
+                                     void *args);
+
+/*
+ * Return the number of workers the pool has started so far.
+ */
+uint32_t NOELLE_ThreadPool_getNumberOfWorkers(void *pool);
+
+/*
+ * Stop the workers of the pool and free it.
+ * The pool must not have tasks running.
+ */
+void NOELLE_ThreadPool_destroy(void *pool);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,381 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef NOELLE_THREADPOOL_HPP
+#define NOELLE_THREADPOOL_HPP
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "NOELLE_ThreadPool.h"
+
+/*
+ * Hint to the core that the current thread is spinning.
+ */
+static inline void NOELLE_spinPause(void) {
+#if defined(__x86_64__) || defined(__i386__)
+  asm volatile("pause");
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+  return;
+}
+
+/*
+ * Thread pool of the NOELLE runtime (see NOELLE_ThreadPool.h for its C ABI).
+ */
+class NoelleThreadPool {
+public:
+  NoelleThreadPool(uint32_t numberOfWorkers,
+                   NOELLE_WaitPolicy_t waitPolicy,
+                   uint64_t spinIterations);
+
+  NoelleThreadPool(uint32_t numberOfWorkers,
+                   uint32_t numberOfGroups,
+                   NOELLE_WorkerInitializer_t initializer,
+                   NOELLE_WaitPolicy_t waitPolicy,
+                   uint64_t spinIterations);
+
+  void submit(NOELLE_Task_t task, void *args);
+
+  void submitToGroup(uint32_t group, NOELLE_Task_t task, void *args);
+
+  uint32_t getNumberOfWorkers(void) const;
+
+  ~NoelleThreadPool(void);
+
+private:
+  /*
+   * States of the task slot of a worker.
+   */
+  enum SlotState : uint32_t { IDLE, CLAIMED, READY, SHUTDOWN };
+
+  /*
+   * Every worker is allocated separately, so submitting a task to a worker
+   * does not interfere with the other ones.
+   */
+  struct Worker {
+    uint32_t group;
+    std::atomic<uint32_t> state;
+    std::atomic<bool> parked;
+    NOELLE_Task_t task;
+    void *args;
+    std::mutex parkLock;
+    std::condition_variable parkCondition;
+    std::thread thread;
+  };
+
+  /*
+   * Workers are never moved or freed while the pool is alive, so submissions
+   * can scan them without locks while new workers are added.
+   */
+  static constexpr uint32_t maximumNumberOfWorkers = 1024;
+  static constexpr uint32_t scansBeforeGrowing = 16;
+  Worker *workers[maximumNumberOfWorkers];
+  std::atomic<uint32_t> numberOfWorkers;
+  std::atomic<uint32_t> nextWorker;
+  std::mutex growLock;
+
+  /*
+   * Groups of workers.
+   * A worker is assigned to a group when it starts and it never changes it.
+   */
+  uint32_t numberOfGroups;
+  NOELLE_WorkerInitializer_t initializer;
+
+  NOELLE_WaitPolicy_t waitPolicy;
+  uint64_t spinIterations;
+
+  /*
+   * Submit a task to a worker of @group, or of any group if @group is
+   * negative.
+   */
+  void submitToWorker(int64_t group, NOELLE_Task_t task, void *args);
+
+  Worker *startWorker(uint32_t group, uint32_t initialState);
+
+  void runWorker(Worker *worker);
+
+  bool waitForTask(Worker *worker);
+};
+
+inline NoelleThreadPool::NoelleThreadPool(uint32_t numberOfWorkers,
+                                          NOELLE_WaitPolicy_t waitPolicy,
+                                          uint64_t spinIterations)
+  : NoelleThreadPool(numberOfWorkers, 1, nullptr, waitPolicy, spinIterations) {
+  return;
+}
+
+inline NoelleThreadPool::NoelleThreadPool(
+    uint32_t numberOfWorkers,
+    uint32_t numberOfGroups,
+    NOELLE_WorkerInitializer_t initializer,
+    NOELLE_WaitPolicy_t waitPolicy,
+    uint64_t spinIterations)
+  : numberOfWorkers{ 0 },
+    nextWorker{ 0 },
+    numberOfGroups{ numberOfGroups },
+    initializer{ initializer },
+    waitPolicy{ waitPolicy },
+    spinIterations{ spinIterations } {
+  assert(numberOfWorkers <= maximumNumberOfWorkers);
+  assert(numberOfGroups > 0);
+
+  /*
+   * Start the workers.
+   *
+   * Consecutive workers belong to the same group.
+   */
+  std::lock_guard<std::mutex> guard(this->growLock);
+  for (uint32_t i = 0; i < numberOfWorkers; i++) {
+    auto group = (((uint64_t)i) * numberOfGroups) / numberOfWorkers;
+    this->startWorker(group, IDLE);
+  }
+
+  return;
+}
+
+inline void NoelleThreadPool::submit(NOELLE_Task_t task, void *args) {
+  this->submitToWorker(-1, task, args);
+
+  return;
+}
+
+inline void NoelleThreadPool::submitToGroup(uint32_t group,
+                                            NOELLE_Task_t task,
+                                            void *args) {
+  assert(group < this->numberOfGroups);
+  this->submitToWorker(group, task, args);
+
+  return;
+}
+
+inline void NoelleThreadPool::submitToWorker(int64_t group,
+                                             NOELLE_Task_t task,
+                                             void *args) {
+  assert(task != nullptr);
+
+  /*
+   * Claim the slot of an idle worker of the group requested.
+   *
+   * The scan starts from a different worker at every submission to spread
+   * tasks submitted together across the slots.
+   * Workers signal the end of their task before releasing their slot, so
+   * busy slots are scanned a few times before giving up on them.
+   */
+  Worker *worker = nullptr;
+  auto start = this->nextWorker.fetch_add(1, std::memory_order_relaxed);
+  for (uint32_t scan = 0; (worker == nullptr) && (scan < scansBeforeGrowing);
+       scan++) {
+    auto workers = this->numberOfWorkers.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < workers; i++) {
+      auto candidate = this->workers[(start + i) % workers];
+      if ((group >= 0) && (candidate->group != group)) {
+        continue;
+      }
+      uint32_t expected = IDLE;
+      if (candidate->state.compare_exchange_strong(
+              expected,
+              CLAIMED,
+              std::memory_order_acquire)) {
+        worker = candidate;
+        break;
+      }
+    }
+    if (worker == nullptr) {
+      std::this_thread::yield();
+    }
+  }
+
+  /*
+   * Every worker is busy: start a new one.
+   *
+   * Tasks that can run anywhere spread the new workers across the groups.
+   */
+  if (worker == nullptr) {
+    std::lock_guard<std::mutex> guard(this->growLock);
+    auto newWorkerGroup =
+        (group >= 0) ? ((uint32_t)group) : (start % this->numberOfGroups);
+    worker = this->startWorker(newWorkerGroup, CLAIMED);
+  }
+
+  /*
+   * Hand the task to the worker.
+   */
+  worker->task = task;
+  worker->args = args;
+  worker->state.store(READY, std::memory_order_seq_cst);
+
+  /*
+   * Wake up the worker if it went to sleep.
+   *
+   * The worker sets its parked flag before checking its slot for the last
+   * time, so either it sees the task or we see the flag.
+   */
+  if (worker->parked.load(std::memory_order_seq_cst)) {
+    std::lock_guard<std::mutex> guard(worker->parkLock);
+    worker->parkCondition.notify_one();
+  }
+
+  return;
+}
+
+inline uint32_t NoelleThreadPool::getNumberOfWorkers(void) const {
+  return this->numberOfWorkers.load(std::memory_order_acquire);
+}
+
+inline NoelleThreadPool::Worker *NoelleThreadPool::startWorker(
+    uint32_t group,
+    uint32_t initialState) {
+
+  /*
+   * Check if we can start a new worker.
+   */
+  auto workerID = this->numberOfWorkers.load(std::memory_order_relaxed);
+  if (workerID >= maximumNumberOfWorkers) {
+    abort();
+  }
+
+  /*
+   * Allocate the worker.
+   */
+  auto worker = new Worker();
+  worker->group = group;
+  worker->state.store(initialState, std::memory_order_relaxed);
+  worker->parked.store(false, std::memory_order_relaxed);
+  worker->task = nullptr;
+  worker->args = nullptr;
+  worker->thread = std::thread(&NoelleThreadPool::runWorker, this, worker);
+
+  /*
+   * Publish the worker.
+   */
+  this->workers[workerID] = worker;
+  this->numberOfWorkers.store(workerID + 1, std::memory_order_release);
+
+  return worker;
+}
+
+inline void NoelleThreadPool::runWorker(Worker *worker) {
+
+  /*
+   * Initialize the worker for its group.
+   */
+  if (this->initializer != nullptr) {
+    this->initializer(worker->group);
+  }
+
+  while (this->waitForTask(worker)) {
+
+    /*
+     * Run the task.
+     */
+    worker->task(worker->args);
+
+    /*
+     * Make the slot available again.
+     */
+    worker->state.store(IDLE, std::memory_order_release);
+  }
+
+  return;
+}
+
+inline bool NoelleThreadPool::waitForTask(Worker *worker) {
+
+  /*
+   * Spin.
+   */
+  if (this->waitPolicy != NOELLE_WAIT_PARK) {
+    uint64_t iterations = 0;
+    while ((this->waitPolicy == NOELLE_WAIT_SPIN)
+           || (iterations < this->spinIterations)) {
+      auto state = worker->state.load(std::memory_order_acquire);
+      if (state == READY) {
+        return true;
+      }
+      if (state == SHUTDOWN) {
+        return false;
+      }
+      NOELLE_spinPause();
+      iterations++;
+    }
+  }
+
+  /*
+   * Park.
+   */
+  std::unique_lock<std::mutex> lock(worker->parkLock);
+  worker->parked.store(true, std::memory_order_seq_cst);
+  uint32_t state;
+  while (true) {
+    state = worker->state.load(std::memory_order_seq_cst);
+    if ((state == READY) || (state == SHUTDOWN)) {
+      break;
+    }
+    worker->parkCondition.wait(lock);
+  }
+  worker->parked.store(false, std::memory_order_relaxed);
+
+  return (state == READY);
+}
+
+inline NoelleThreadPool::~NoelleThreadPool(void) {
+
+  /*
+   * Stop the workers.
+   *
+   * A worker might still be releasing the slot of its last task, so we wait
+   * for the slot to be idle.
+   */
+  auto workers = this->numberOfWorkers.load(std::memory_order_acquire);
+  for (uint32_t i = 0; i < workers; i++) {
+    auto worker = this->workers[i];
+    uint32_t expected = IDLE;
+    while (!worker->state.compare_exchange_weak(expected,
+                                                SHUTDOWN,
+                                                std::memory_order_seq_cst)) {
+      expected = IDLE;
+      std::this_thread::yield();
+    }
+    {
+      std::lock_guard<std::mutex> guard(worker->parkLock);
+      worker->parkCondition.notify_one();
+    }
+  }
+
+  /*
+   * Free the workers.
+   */
+  for (uint32_t i = 0; i < workers; i++) {
+    auto worker = this->workers[i];
+    worker->thread.join();
+    delete worker;
+  }
+
+  return;
+}
+
+#endif
@@ -10,16 +10,23 @@
 #include <utility>
 #include <vector>
 #include <assert.h>
+#include <sched.h>
+#include <dirent.h>
 
-#include <ThreadSafeQueue.hpp>
-#include <ThreadSafeLockFreeQueue.hpp>
-#include <ThreadPools.hpp>
+#include "NOELLE_ThreadPool.h"
+#include "NOELLE_ThreadPool.hpp"
+#include "NOELLE_Queue.hpp"
 
 #include <condition_variable>
 #include <mutex>
 #include <queue>
 #include <utility>
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <map>
 
 /*
  * OPTIONS
@@ -28,8 +35,6 @@
 //#define RUNTIME_PRINT
 //#define DSWP_STATS
 
-using namespace MARC;
-
 #define CACHE_LINE_SIZE 64
 
 #ifdef DSWP_STATS
@@ -37,6 +42,7 @@ static int64_t numberOfPushes8 = 0;
 static int64_t numberOfPushes16 = 0;
 static int64_t numberOfPushes32 = 0;
 static int64_t numberOfPushes64 = 0;
+static int64_t numberOfPushesRecord = 0;
 #endif
 
 typedef struct {
@@ -48,36 +54,113 @@ typedef struct {
   pthread_spinlock_t endLock;
 } DOALL_args_t;
 
+/*
+ * Runtime configuration of a loop that has been compiled with several
+ * variants.
+ */
+typedef struct {
+  std::vector<uint32_t> variants;
+  uint32_t cores;
+  uint64_t chunkSize;
+} LoopConfiguration_t;
+
+/*
+ * Loop IDs are unknown for loops that have not been tagged by the compiler.
+ */
+#define NOELLE_UNKNOWN_LOOP_ID (-1)
+
+/*
+ * Memory blocks that store the arguments of the DOALL tasks dispatched by a
+ * thread.
+ *
+ * Every thread has its own cache, so dispatchers of different threads never
+ * synchronize to get or release a block.
+ * Free blocks are indexed by their number of cores. A thread can use several
+ * blocks of the same size at once (e.g., a parallelized loop invoked by the
+ * task that runs on the dispatching thread), so each size has a list of them.
+ */
+class DOALLArgsCache {
+public:
+  DOALL_args_t *getArgs(uint32_t cores);
+
+  void releaseArgs(DOALL_args_t *args, uint32_t cores);
+
+  ~DOALLArgsCache(void);
+
+private:
+  std::vector<std::vector<DOALL_args_t *>> freeArgs;
+};
+
 class NoelleRuntime {
 public:
   NoelleRuntime();
 
+  uint32_t getLoopVariant(uint64_t loopID,
+                          uint64_t availableVariants,
+                          uint32_t defaultVariant);
+
+  uint32_t getLoopCores(uint64_t loopID, uint32_t maxCores);
+
+  uint64_t getLoopChunkSize(uint64_t loopID, uint64_t chunkSize);
+
   uint32_t reserveCores(uint32_t coresRequested);
 
+  uint32_t reserveCoresForLoop(int64_t loopID, uint32_t coresRequested);
+
   void releaseCores(uint32_t coresReleased);
 
   uint32_t getAvailableCores(void);
 
-  DOALL_args_t *getDOALLArgs(uint32_t cores, uint32_t *index);
+  DOALL_args_t *getDOALLArgs(uint32_t cores);
+
+  void releaseDOALLArgs(DOALL_args_t *args, uint32_t cores);
+
+  bool isNUMAModeEnabled(void) const;
 
-  void releaseDOALLArgs(uint32_t index);
+  uint32_t getNUMANodeOfCore(uint32_t coreID, uint32_t numCores) const;
 
-  ThreadPoolForCSingleQueue *virgil;
+  void bindToNUMANode(uint32_t node);
+
+  void unbindFromNUMANodes(void);
+
+  void *threadPool;
 
   ~NoelleRuntime(void);
 
 private:
-  mutable pthread_spinlock_t doallMemoryLock;
-  std::vector<uint32_t> doallMemorySizes;
-  std::vector<bool> doallMemoryAvailability;
-  std::vector<DOALL_args_t *> doallMemory;
-
   uint32_t getMaximumNumberOfCores(void);
 
+  void loadLoopsConfiguration(void);
+
+  void loadNUMATopology(void);
+
+  /*
+   * NUMA mode.
+   *
+   * Each entry of numaNodes is the set of CPUs of a node that this process is
+   * allowed to run on.
+   * numaLoopCores is the number of cores a loop (indexed by loop ID) has been
+   * given the first time it ran; it is protected by spinLock, and each thread
+   * caches the entries it has already read.
+   */
+  bool numaMode;
+  std::vector<cpu_set_t> numaNodes;
+  cpu_set_t numaOriginalMask;
+  std::unordered_map<int64_t, uint32_t> numaLoopCores;
+
+  /*
+   * Per-loop configuration (indexed by loop ID).
+   * It is read once at startup and never modified afterwards.
+   */
+  std::unordered_map<uint64_t, LoopConfiguration_t> loopsConfiguration;
+
   /*
    * Current number of idle cores.
+   *
+   * Cores are reserved and released with atomic additions, so concurrent
+   * dispatchers never wait for each other.
    */
-  int32_t NOELLE_idleCores;
+  std::atomic<int32_t> NOELLE_idleCores;
 
   /*
    * Maximum number of cores.
@@ -97,6 +180,22 @@ uint64_t clocks_dispatch_ends[64];
 
 static NoelleRuntime runtime{};
 
+static thread_local DOALLArgsCache doallArgsCache;
+
+/*
+ * NUMA node the current thread is bound to (-1 if it is not bound).
+ */
+static thread_local int32_t currentNUMANode = -1;
+
+/*
+ * Bind a worker of the thread pool to its NUMA node once, when it starts.
+ */
+static void NOELLE_bindWorkerToNUMANode(uint32_t node) {
+  runtime.bindToNUMANode(node);
+
+  return;
+}
+
 extern "C" {
 
 /******************************************** NOELLE APIs
@@ -115,7 +214,8 @@ DispatcherInfo NOELLE_DOALLDispatcher(
     void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t),
     void *env,
     int64_t maxNumberOfCores,
-    int64_t chunkSize);
+    int64_t chunkSize,
+    int64_t loopID);
 
 #ifdef RUNTIME_PROFILE
 static __inline__ int64_t rdtsc_s(void) {
@@ -154,7 +254,7 @@ void printPulledP(int32_t *p) {
   printf("Pulled: %p\n", p);
 }
 
-void queuePush8(ThreadSafeQueue<int8_t> *queue, int8_t *val) {
+void queuePush8(NoelleQueue<int8_t> *queue, int8_t *val) {
   queue->push(*val);
 
 #ifdef DSWP_STATS
@@ -164,12 +264,12 @@ void queuePush8(ThreadSafeQueue<int8_t> *queue, int8_t *val) {
   return;
 }
 
-void queuePop8(ThreadSafeQueue<int8_t> *queue, int8_t *val) {
+void queuePop8(NoelleQueue<int8_t> *queue, int8_t *val) {
   queue->waitPop(*val);
   return;
 }
 
-void queuePush16(ThreadSafeQueue<int16_t> *queue, int16_t *val) {
+void queuePush16(NoelleQueue<int16_t> *queue, int16_t *val) {
   queue->push(*val);
 
 #ifdef DSWP_STATS
@@ -179,11 +279,11 @@ void queuePush16(ThreadSafeQueue<int16_t> *queue, int16_t *val) {
   return;
 }
 
-void queuePop16(ThreadSafeQueue<int16_t> *queue, int16_t *val) {
+void queuePop16(NoelleQueue<int16_t> *queue, int16_t *val) {
   queue->waitPop(*val);
 }
 
-void queuePush32(ThreadSafeQueue<int32_t> *queue, int32_t *val) {
+void queuePush32(NoelleQueue<int32_t> *queue, int32_t *val) {
   queue->push(*val);
 
 #ifdef DSWP_STATS
@@ -193,11 +293,11 @@ void queuePush32(ThreadSafeQueue<int32_t> *queue, int32_t *val) {
   return;
 }
 
-void queuePop32(ThreadSafeQueue<int32_t> *queue, int32_t *val) {
+void queuePop32(NoelleQueue<int32_t> *queue, int32_t *val) {
   queue->waitPop(*val);
 }
 
-void queuePush64(ThreadSafeQueue<int64_t> *queue, int64_t *val) {
+void queuePush64(NoelleQueue<int64_t> *queue, int64_t *val) {
   queue->push(*val);
 
 #ifdef DSWP_STATS
@@ -207,12 +307,28 @@ void queuePush64(ThreadSafeQueue<int64_t> *queue, int64_t *val) {
   return;
 }
 
-void queuePop64(ThreadSafeQueue<int64_t> *queue, int64_t *val) {
+void queuePop64(NoelleQueue<int64_t> *queue, int64_t *val) {
   queue->waitPop(*val);
 
   return;
 }
 
+void queuePushRecord(NoelleRecordQueue *queue, void *record) {
+  queue->push(record);
+
+#ifdef DSWP_STATS
+  numberOfPushesRecord++;
+#endif
+
+  return;
+}
+
+void queuePopRecord(NoelleRecordQueue *queue, void *record) {
+  queue->waitPop(record);
+
+  return;
+}
+
 /**********************************************************************
  *                DOALL
  **********************************************************************/
@@ -247,20 +363,21 @@ DispatcherInfo NOELLE_DOALLDispatcher(
     void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t),
     void *env,
     int64_t maxNumberOfCores,
-    int64_t chunkSize) {
+    int64_t chunkSize,
+    int64_t loopID) {
 #ifdef RUNTIME_PROFILE
   auto clocks_start = rdtsc_s();
 #endif
 
   /*
-   * Fetch VIRGIL
+   * Fetch the thread pool.
    */
-  auto virgil = runtime.virgil;
+  auto threadPool = runtime.threadPool;
 
   /*
    * Set the number of cores to use.
    */
-  auto numCores = runtime.reserveCores(maxNumberOfCores);
+  auto numCores = runtime.reserveCoresForLoop(loopID, maxNumberOfCores);
 #ifdef RUNTIME_PRINT
   std::cerr << "Starting dispatcher: num cores " << numCores
             << ", chunk size: " << chunkSize << std::endl;
@@ -269,12 +386,12 @@ DispatcherInfo NOELLE_DOALLDispatcher(
   /*
    * Allocate the memory to store the arguments.
    */
-  uint32_t doallMemoryIndex;
-  auto argsForAllCores = runtime.getDOALLArgs(numCores - 1, &doallMemoryIndex);
+  auto argsForAllCores = runtime.getDOALLArgs(numCores - 1);
 
   /*
    * Submit DOALL tasks.
    */
+  auto isNUMAModeEnabled = runtime.isNUMAModeEnabled();
   for (auto i = 0; i < (numCores - 1); ++i) {
 
     /*
@@ -292,8 +409,19 @@ DispatcherInfo NOELLE_DOALLDispatcher(
 
     /*
      * Submit
+     *
+     * In NUMA mode, the task runs on a worker pinned to the NUMA node of its
+     * core.
      */
-    virgil->submitAndDetach(NOELLE_DOALLTrampoline, argsPerCore);
+    if (isNUMAModeEnabled) {
+      auto node = runtime.getNUMANodeOfCore(i, numCores);
+      NOELLE_ThreadPool_submitToGroup(threadPool,
+                                      node,
+                                      NOELLE_DOALLTrampoline,
+                                      argsPerCore);
+    } else {
+      NOELLE_ThreadPool_submit(threadPool, NOELLE_DOALLTrampoline, argsPerCore);
+    }
 
 #ifdef RUNTIME_PROFILE
     clocks_dispatch_ends[i] = rdtsc_s();
@@ -311,8 +439,17 @@ DispatcherInfo NOELLE_DOALLDispatcher(
 
   /*
    * Run a task.
+   *
+   * In NUMA mode, the current thread runs its task on the NUMA node of the
+   * last core and it gets back its original CPUs afterwards.
    */
+  if (isNUMAModeEnabled) {
+    runtime.bindToNUMANode(runtime.getNUMANodeOfCore(numCores - 1, numCores));
+  }
   parallelizedLoop(env, numCores - 1, numCores, chunkSize);
+  if (isNUMAModeEnabled) {
+    runtime.unbindFromNUMANodes();
+  }
 
 /*
  * Wait for the remaining DOALL tasks.
@@ -335,7 +472,7 @@ DispatcherInfo NOELLE_DOALLDispatcher(
    * Free the cores and memory.
    */
   runtime.releaseCores(numCores);
-  runtime.releaseDOALLArgs(doallMemoryIndex);
+  runtime.releaseDOALLArgs(argsForAllCores, numCores - 1);
 
   /*
    * Prepare the return value.
@@ -498,9 +635,9 @@ static DispatcherInfo NOELLE_HELIX_dispatcher(
   assert(maxNumberOfCores > 1);
 
   /*
-   * Fetch VIRGIL
+   * Fetch the thread pool.
    */
-  auto virgil = runtime.virgil;
+  auto threadPool = runtime.threadPool;
 
   /*
    * Reserve the cores.
@@ -645,7 +782,7 @@ static DispatcherInfo NOELLE_HELIX_dispatcher(
     /*
      * Launch the thread.
      */
-    virgil->submitAndDetach(NOELLE_HELIXTrampoline, argsPerCore);
+    NOELLE_ThreadPool_submit(threadPool, NOELLE_HELIXTrampoline, argsPerCore);
 
     /*
      * Launch the helper thread.
@@ -842,9 +979,9 @@ DispatcherInfo NOELLE_DSWPDispatcher(void *env,
 #endif
 
   /*
-   * Fetch VIRGIL
+   * Fetch the thread pool.
    */
-  auto virgil = runtime.virgil;
+  auto threadPool = runtime.threadPool;
 
   /*
    * Reserve the cores.
@@ -854,24 +991,31 @@ DispatcherInfo NOELLE_DSWPDispatcher(void *env,
 
   /*
    * Allocate the communication queues.
+   *
+   * A positive size is the number of bits of the values of a scalar queue.
+   * A negative size -N describes a queue of records of N bytes.
    */
   void *localQueues[numberOfQueues];
   for (auto i = 0; i < numberOfQueues; ++i) {
+    if (queueSizes[i] < 0) {
+      localQueues[i] = new NoelleRecordQueue(-queueSizes[i]);
+      continue;
+    }
     switch (queueSizes[i]) {
       case 1:
-        localQueues[i] = new ThreadSafeLockFreeQueue<int8_t>();
+        localQueues[i] = new NoelleQueue<int8_t>();
         break;
       case 8:
-        localQueues[i] = new ThreadSafeLockFreeQueue<int8_t>();
+        localQueues[i] = new NoelleQueue<int8_t>();
         break;
       case 16:
-        localQueues[i] = new ThreadSafeLockFreeQueue<int16_t>();
+        localQueues[i] = new NoelleQueue<int16_t>();
         break;
       case 32:
-        localQueues[i] = new ThreadSafeLockFreeQueue<int32_t>();
+        localQueues[i] = new NoelleQueue<int32_t>();
         break;
       case 64:
-        localQueues[i] = new ThreadSafeLockFreeQueue<int64_t>();
+        localQueues[i] = new NoelleQueue<int64_t>();
         break;
       default:
         std::cerr << "NOELLE: Runtime: QUEUE SIZE INCORRECT" << std::endl;
@@ -909,7 +1053,7 @@ DispatcherInfo NOELLE_DSWPDispatcher(void *env,
     /*
      * Submit
      */
-    virgil->submitAndDetach(NOELLE_DSWPTrampoline, argsPerCore);
+    NOELLE_ThreadPool_submit(threadPool, NOELLE_DSWPTrampoline, argsPerCore);
 #ifdef RUNTIME_PRINT
     std::cerr << "Submitted stage" << std::endl;
 #endif
@@ -933,21 +1077,25 @@ DispatcherInfo NOELLE_DSWPDispatcher(void *env,
    */
   runtime.releaseCores(numCores);
   for (int i = 0; i < numberOfQueues; ++i) {
+    if (queueSizes[i] < 0) {
+      delete (NoelleRecordQueue *)(localQueues[i]);
+      continue;
+    }
     switch (queueSizes[i]) {
       case 1:
-        delete (ThreadSafeLockFreeQueue<int8_t> *)(localQueues[i]);
+        delete (NoelleQueue<int8_t> *)(localQueues[i]);
         break;
       case 8:
-        delete (ThreadSafeLockFreeQueue<int8_t> *)(localQueues[i]);
+        delete (NoelleQueue<int8_t> *)(localQueues[i]);
         break;
       case 16:
-        delete (ThreadSafeLockFreeQueue<int16_t> *)(localQueues[i]);
+        delete (NoelleQueue<int16_t> *)(localQueues[i]);
         break;
       case 32:
-        delete (ThreadSafeLockFreeQueue<int32_t> *)(localQueues[i]);
+        delete (NoelleQueue<int32_t> *)(localQueues[i]);
         break;
       case 64:
-        delete (ThreadSafeLockFreeQueue<int64_t> *)(localQueues[i]);
+        delete (NoelleQueue<int64_t> *)(localQueues[i]);
         break;
     }
   }
@@ -958,6 +1106,7 @@ DispatcherInfo NOELLE_DSWPDispatcher(void *env,
   std::cout << "DSWP: 2 Bytes pushes = " << numberOfPushes16 << std::endl;
   std::cout << "DSWP: 4 Bytes pushes = " << numberOfPushes32 << std::endl;
   std::cout << "DSWP: 8 Bytes pushes = " << numberOfPushes64 << std::endl;
+  std::cout << "DSWP: Record pushes = " << numberOfPushesRecord << std::endl;
 #endif
 
   DispatcherInfo dispatcherInfo;
@@ -970,120 +1119,508 @@ uint32_t NOELLE_getAvailableCores(void) {
 
   return idleCores;
 }
+
+/*
+ * Select the variant of a loop to run.
+ * Variant 0 is the original loop; transformation T is variant 1 + T.
+ */
+int64_t NOELLE_getLoopVariant(int64_t loopID,
+                              int64_t availableVariants,
+                              int64_t defaultVariant) {
+  return runtime.getLoopVariant(loopID, availableVariants, defaultVariant);
+}
+
+int64_t NOELLE_getLoopCores(int64_t loopID, int64_t maxCores) {
+  return runtime.getLoopCores(loopID, maxCores);
+}
+
+int64_t NOELLE_getLoopChunkSize(int64_t loopID, int64_t chunkSize) {
+  return runtime.getLoopChunkSize(loopID, chunkSize);
+}
+
+/**********************************************************************
+ *                Thread pool
+ **********************************************************************/
+void *NOELLE_ThreadPool_create(uint32_t numberOfWorkers,
+                               NOELLE_WaitPolicy_t waitPolicy,
+                               uint64_t spinIterations) {
+  return new NoelleThreadPool(numberOfWorkers, waitPolicy, spinIterations);
+}
+
+void *NOELLE_ThreadPool_createWithGroups(
+    uint32_t numberOfWorkers,
+    uint32_t numberOfGroups,
+    NOELLE_WorkerInitializer_t initializer,
+    NOELLE_WaitPolicy_t waitPolicy,
+    uint64_t spinIterations) {
+  return new NoelleThreadPool(numberOfWorkers,
+                              numberOfGroups,
+                              initializer,
+                              waitPolicy,
+                              spinIterations);
+}
+
+void NOELLE_ThreadPool_submit(void *pool, NOELLE_Task_t task, void *args) {
+  ((NoelleThreadPool *)pool)->submit(task, args);
+  return;
+}
+
+void NOELLE_ThreadPool_submitToGroup(void *pool,
+                                     uint32_t group,
+                                     NOELLE_Task_t task,
+                                     void *args) {
+  ((NoelleThreadPool *)pool)->submitToGroup(group, task, args);
+  return;
+}
+
+uint32_t NOELLE_ThreadPool_getNumberOfWorkers(void *pool) {
+  return ((NoelleThreadPool *)pool)->getNumberOfWorkers();
+}
+
+void NOELLE_ThreadPool_destroy(void *pool) {
+  delete (NoelleThreadPool *)pool;
+  return;
+}
 }
 
 NoelleRuntime::NoelleRuntime() {
   this->maxCores = this->getMaximumNumberOfCores();
-  this->NOELLE_idleCores = maxCores;
+  this->NOELLE_idleCores.store(maxCores);
 
   pthread_spin_init(&this->spinLock, 0);
-  pthread_spin_init(&this->doallMemoryLock, 0);
 #ifdef RUNTIME_PROFILE
   pthread_spin_init(&printLock, 0);
 #endif
 
   /*
-   * Allocate VIRGIL
+   * Start the thread pool.
+   *
+   * Idle workers spin for a while before sleeping unless NOELLE_WAIT_POLICY
+   * says otherwise (spin, park, or hybrid).
+   * NOELLE_SPIN_ITERATIONS sets how long the hybrid policy spins.
+   */
+  auto waitPolicy = NOELLE_WAIT_HYBRID;
+  auto waitPolicyEnvVar = getenv("NOELLE_WAIT_POLICY");
+  if (waitPolicyEnvVar != nullptr) {
+    std::string waitPolicyName(waitPolicyEnvVar);
+    if (waitPolicyName == "spin") {
+      waitPolicy = NOELLE_WAIT_SPIN;
+    } else if (waitPolicyName == "park") {
+      waitPolicy = NOELLE_WAIT_PARK;
+    } else if (waitPolicyName != "hybrid") {
+      std::cerr << "NOELLE: Runtime: WARNING: unknown wait policy "
+                << waitPolicyName << std::endl;
+    }
+  }
+  uint64_t spinIterations = 100000;
+  auto spinIterationsEnvVar = getenv("NOELLE_SPIN_ITERATIONS");
+  if (spinIterationsEnvVar != nullptr) {
+    spinIterations = strtoull(spinIterationsEnvVar, nullptr, 10);
+  }
+
+  /*
+   * Load the NUMA topology if the NUMA mode has been requested.
+   */
+  this->numaMode = false;
+  auto numaEnvVar = getenv("NOELLE_NUMA");
+  if ((numaEnvVar != nullptr) && (atoi(numaEnvVar) != 0)) {
+    this->loadNUMATopology();
+  }
+
+  /*
+   * In NUMA mode, each worker is pinned to one NUMA node for its whole life.
+   */
+  if (this->numaMode) {
+    this->threadPool =
+        NOELLE_ThreadPool_createWithGroups(maxCores,
+                                           this->numaNodes.size(),
+                                           NOELLE_bindWorkerToNUMANode,
+                                           waitPolicy,
+                                           spinIterations);
+  } else {
+    this->threadPool =
+        NOELLE_ThreadPool_create(maxCores, waitPolicy, spinIterations);
+  }
+
+  /*
+   * Load the configuration of the loops.
    */
-  this->virgil = new ThreadPoolForCSingleQueue(false, maxCores);
+  this->loadLoopsConfiguration();
 
   return;
 }
 
-DOALL_args_t *NoelleRuntime::getDOALLArgs(uint32_t cores, uint32_t *index) {
-  DOALL_args_t *argsForAllCores = nullptr;
+void NoelleRuntime::loadLoopsConfiguration(void) {
 
   /*
-   * Check if we can reuse a previously-allocated memory region.
+   * Fetch the configuration file.
+   *
+   * Each line describes a loop as follows:
+   *   loopID variants cores chunkSize
+   * where loopID is the index of the loop among the loops of the program (the
+   * one used by INDEX_FILE), variants is a comma-separated list of techniques
+   * (sequential, doall, dswp, helix) in order of preference. A value of 0 for
+   * cores or chunkSize keeps the one chosen by the compiler. Lines starting
+   * with # are ignored.
    */
-  pthread_spin_lock(&this->doallMemoryLock);
-  auto doallMemoryNumberOfChunks = this->doallMemoryAvailability.size();
-  for (auto i = 0; i < doallMemoryNumberOfChunks; i++) {
-    auto currentSize = this->doallMemorySizes[i];
-    if (true && (this->doallMemoryAvailability[i]) && (currentSize >= cores)) {
+  auto envVar = getenv("NOELLE_LOOPS_CONFIGURATION");
+  if (envVar == nullptr) {
+    return;
+  }
+  std::ifstream configurationFile(envVar);
+  if (!configurationFile.is_open()) {
+    std::cerr << "NOELLE: Runtime: WARNING: the loop configuration file "
+              << envVar << " cannot be opened" << std::endl;
+    return;
+  }
 
-      /*
-       * Found a memory block that can be reused.
-       */
-      argsForAllCores = this->doallMemory[i];
+  /*
+   * Parse the configuration.
+   */
+  std::unordered_map<std::string, uint32_t> variantIDs{ { "sequential", 0 },
+                                                        { "doall", 1 },
+                                                        { "dswp", 2 },
+                                                        { "helix", 3 } };
+  std::string line;
+  while (std::getline(configurationFile, line)) {
+    if ((line.size() == 0) || (line[0] == '#')) {
+      continue;
+    }
 
-      /*
-       * Set the block as in use.
-       */
-      this->doallMemoryAvailability[i] = false;
-      (*index) = i;
-      pthread_spin_unlock(&this->doallMemoryLock);
+    /*
+     * Fetch the fields of the current loop.
+     */
+    std::istringstream lineStream(line);
+    uint64_t loopID;
+    std::string variants;
+    LoopConfiguration_t conf;
+    conf.cores = 0;
+    conf.chunkSize = 0;
+    if (!(lineStream >> loopID >> variants)) {
+      continue;
+    }
+    lineStream >> conf.cores >> conf.chunkSize;
 
-      return argsForAllCores;
+    /*
+     * Translate the techniques into variant IDs.
+     */
+    std::istringstream variantsStream(variants);
+    std::string variant;
+    while (std::getline(variantsStream, variant, ',')) {
+      auto variantIt = variantIDs.find(variant);
+      if (variantIt == variantIDs.end()) {
+        std::cerr << "NOELLE: Runtime: WARNING: unknown variant " << variant
+                  << " for loop " << loopID << std::endl;
+        continue;
+      }
+      conf.variants.push_back(variantIt->second);
     }
+
+    this->loopsConfiguration[loopID] = conf;
   }
 
+  return;
+}
+
+void NoelleRuntime::loadNUMATopology(void) {
+
   /*
-   * We couldn't find anything available.
-   *
-   * Allocate a new memory region.
+   * Fetch the CPUs this process can run on.
    */
-  this->doallMemorySizes.push_back(cores);
-  this->doallMemoryAvailability.push_back(false);
-  posix_memalign((void **)&argsForAllCores,
-                 CACHE_LINE_SIZE,
-                 sizeof(DOALL_args_t) * cores);
-  this->doallMemory.push_back(argsForAllCores);
-  pthread_spin_unlock(&this->doallMemoryLock);
+  CPU_ZERO(&this->numaOriginalMask);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &this->numaOriginalMask) != 0) {
+    std::cerr << "NOELLE: Runtime: WARNING: the CPU affinity of the process "
+                 "cannot be fetched. NUMA mode is disabled"
+              << std::endl;
+    return;
+  }
+
+  /*
+   * Fetch the NUMA nodes.
+   */
+  auto nodesDirectory = opendir("/sys/devices/system/node");
+  if (nodesDirectory == nullptr) {
+    std::cerr << "NOELLE: Runtime: WARNING: the NUMA topology is not "
+                 "available. NUMA mode is disabled"
+              << std::endl;
+    return;
+  }
+  std::map<uint32_t, cpu_set_t> nodes;
+  while (auto entry = readdir(nodesDirectory)) {
+    uint32_t nodeID;
+    if (sscanf(entry->d_name, "node%u", &nodeID) != 1) {
+      continue;
+    }
+
+    /*
+     * Fetch the CPUs of the current node.
+     *
+     * The list is formatted as ranges separated by commas (e.g., 0-3,8-11).
+     */
+    std::ifstream cpuListFile(std::string("/sys/devices/system/node/")
+                              + entry->d_name + "/cpulist");
+    std::string cpuList;
+    if (!std::getline(cpuListFile, cpuList)) {
+      continue;
+    }
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    std::istringstream cpuListStream(cpuList);
+    std::string range;
+    while (std::getline(cpuListStream, range, ',')) {
+      uint32_t first, last;
+      auto fields = sscanf(range.c_str(), "%u-%u", &first, &last);
+      if (fields < 1) {
+        continue;
+      }
+      if (fields == 1) {
+        last = first;
+      }
+      for (auto cpu = first; (cpu <= last) && (cpu < CPU_SETSIZE); cpu++) {
+        if (CPU_ISSET(cpu, &this->numaOriginalMask)) {
+          CPU_SET(cpu, &cpus);
+        }
+      }
+    }
+
+    /*
+     * Skip nodes without CPUs we can use (e.g., memory-only nodes).
+     */
+    if (CPU_COUNT(&cpus) == 0) {
+      continue;
+    }
+    nodes[nodeID] = cpus;
+  }
+  closedir(nodesDirectory);
 
   /*
-   * Set the index.
+   * Nothing to do with a single node.
    */
-  (*index) = doallMemoryNumberOfChunks;
+  if (nodes.size() < 2) {
+#ifdef RUNTIME_PRINT
+    std::cerr << "NOELLE: Runtime: less than 2 NUMA nodes found" << std::endl;
+#endif
+    return;
+  }
 
   /*
-   * Initialize the memory.
+   * Nodes are kept in increasing order of their IDs so the mapping between
+   * cores and nodes does not depend on the order of the directory entries.
    */
-  for (auto i = 0; i < cores; ++i) {
-    auto argsPerCore = &argsForAllCores[i];
-    argsPerCore->coreID = i;
-    pthread_spin_init(&(argsPerCore->endLock), 0);
-    pthread_spin_lock(&(argsPerCore->endLock));
+  for (auto &node : nodes) {
+    this->numaNodes.push_back(node.second);
   }
+  this->numaMode = true;
 
-  return argsForAllCores;
+  return;
+}
+
+bool NoelleRuntime::isNUMAModeEnabled(void) const {
+  return this->numaMode;
+}
+
+uint32_t NoelleRuntime::getNUMANodeOfCore(uint32_t coreID,
+                                          uint32_t numCores) const {
+  assert(this->numaMode);
+  assert(coreID < numCores);
+
+  /*
+   * Cores are assigned to nodes in blocks, so the mapping only depends on the
+   * number of cores used by a loop.
+   * Hence, the iterations assigned to a core always run on the same node as
+   * long as the number of cores and the chunk size do not change.
+   */
+  auto node = (((uint64_t)coreID) * this->numaNodes.size()) / numCores;
+
+  return node;
 }
 
-void NoelleRuntime::releaseDOALLArgs(uint32_t index) {
-  pthread_spin_lock(&this->doallMemoryLock);
-  this->doallMemoryAvailability[index] = true;
-  pthread_spin_unlock(&this->doallMemoryLock);
+void NoelleRuntime::bindToNUMANode(uint32_t node) {
+  assert(this->numaMode);
+  assert(node < this->numaNodes.size());
+
+  /*
+   * Avoid the system call if the current thread is already on that node.
+   */
+  if (currentNUMANode == ((int32_t)node)) {
+    return;
+  }
+  pthread_setaffinity_np(pthread_self(),
+                         sizeof(cpu_set_t),
+                         &this->numaNodes[node]);
+  currentNUMANode = node;
+
+  return;
+}
+
+void NoelleRuntime::unbindFromNUMANodes(void) {
+  assert(this->numaMode);
+
+  pthread_setaffinity_np(pthread_self(),
+                         sizeof(cpu_set_t),
+                         &this->numaOriginalMask);
+  currentNUMANode = -1;
+
+  return;
+}
+
+uint32_t NoelleRuntime::getLoopVariant(uint64_t loopID,
+                                       uint64_t availableVariants,
+                                       uint32_t defaultVariant) {
+
+  /*
+   * Check if the loop has been configured.
+   */
+  auto confIt = this->loopsConfiguration.find(loopID);
+  if (confIt == this->loopsConfiguration.end()) {
+    return defaultVariant;
+  }
+
+  /*
+   * Pick the first variant preferred by the configuration that has been
+   * compiled.
+   * If none of them has been compiled, then the original loop runs.
+   */
+  for (auto variant : confIt->second.variants) {
+    if ((variant == 0) || (availableVariants & (((uint64_t)1) << variant))) {
+      return variant;
+    }
+  }
+
+  return 0;
+}
+
+uint32_t NoelleRuntime::getLoopCores(uint64_t loopID, uint32_t maxCores) {
+
+  /*
+   * The compiler sizes the data structures of the parallelized loop for
+   * maxCores cores, so the configuration can only lower it.
+   */
+  auto confIt = this->loopsConfiguration.find(loopID);
+  if (confIt == this->loopsConfiguration.end()) {
+    return maxCores;
+  }
+  auto cores = confIt->second.cores;
+  if ((cores == 0) || (cores > maxCores)) {
+    return maxCores;
+  }
+
+  return cores;
+}
+
+uint64_t NoelleRuntime::getLoopChunkSize(uint64_t loopID, uint64_t chunkSize) {
+  auto confIt = this->loopsConfiguration.find(loopID);
+  if (confIt == this->loopsConfiguration.end()) {
+    return chunkSize;
+  }
+  if (confIt->second.chunkSize == 0) {
+    return chunkSize;
+  }
+
+  return confIt->second.chunkSize;
+}
+
+DOALL_args_t *NoelleRuntime::getDOALLArgs(uint32_t cores) {
+  return doallArgsCache.getArgs(cores);
+}
+
+void NoelleRuntime::releaseDOALLArgs(DOALL_args_t *args, uint32_t cores) {
+  doallArgsCache.releaseArgs(args, cores);
+
   return;
 }
 
 uint32_t NoelleRuntime::reserveCores(uint32_t coresRequested) {
 
   /*
-   * Reserve the number of cores available.
+   * Reserve all the cores requested.
    */
-  pthread_spin_lock(&this->spinLock);
-  auto numCores = (this->NOELLE_idleCores >= coresRequested) ? coresRequested
-                                                             : NOELLE_idleCores;
+  int32_t requested = coresRequested;
+  auto idleCores = this->NOELLE_idleCores.fetch_sub(requested);
+
+  /*
+   * Keep the cores that were idle (at least one) and give back the others.
+   */
+  auto numCores = (idleCores >= requested) ? requested : idleCores;
   if (numCores < 1) {
     numCores = 1;
   }
-  this->NOELLE_idleCores -= numCores;
+  if (numCores < requested) {
+    this->NOELLE_idleCores.fetch_add(requested - numCores);
+  }
+
+  return numCores;
+}
+
+uint32_t NoelleRuntime::reserveCoresForLoop(int64_t loopID,
+                                            uint32_t coresRequested) {
+
+  /*
+   * The number of cores of a loop only needs to be stable in NUMA mode.
+   */
+  if (!this->numaMode || (loopID == NOELLE_UNKNOWN_LOOP_ID)) {
+    return this->reserveCores(coresRequested);
+  }
+
+  /*
+   * Check if the loop already run.
+   *
+   * In this case, it asks for the same number of cores as before, so every
+   * iteration runs on the same NUMA node of all the previous invocations.
+   * Like any other reservation, it gets fewer cores if fewer are idle (e.g.,
+   * when the loop is invoked by another parallel loop), which only costs the
+   * locality of that invocation.
+   * The number of cores of a loop never changes once set, so a thread only
+   * needs the lock the first time it runs a loop.
+   */
+  static thread_local std::unordered_map<int64_t, uint32_t> loopCores;
+  auto cachedIt = loopCores.find(loopID);
+  if (cachedIt != loopCores.end()) {
+    return this->reserveCores(cachedIt->second);
+  }
+  pthread_spin_lock(&this->spinLock);
+  auto loopIt = this->numaLoopCores.find(loopID);
+  if (loopIt != this->numaLoopCores.end()) {
+    auto loopCoresToUse = loopIt->second;
+    pthread_spin_unlock(&this->spinLock);
+    loopCores[loopID] = loopCoresToUse;
+
+    return this->reserveCores(loopCoresToUse);
+  }
   pthread_spin_unlock(&this->spinLock);
 
+  /*
+   * This is the first invocation of the loop.
+   *
+   * If another thread has set the cores of the loop in the meantime, those
+   * are the ones to use.
+   */
+  auto numCores = this->reserveCores(coresRequested);
+  pthread_spin_lock(&this->spinLock);
+  auto inserted = this->numaLoopCores.insert({ loopID, numCores });
+  auto loopCoresToUse = inserted.first->second;
+  pthread_spin_unlock(&this->spinLock);
+  loopCores[loopID] = loopCoresToUse;
+  if (loopCoresToUse != numCores) {
+    this->releaseCores(numCores);
+    numCores = this->reserveCores(loopCoresToUse);
+  }
+
   return numCores;
 }
 
 void NoelleRuntime::releaseCores(uint32_t coresReleased) {
   assert(coresReleased > 0);
 
-  pthread_spin_lock(&this->spinLock);
-  this->NOELLE_idleCores += coresReleased;
 #ifdef DEBUG
-  if (this->NOELLE_idleCores >= 0) {
-    assert(this->NOELLE_idleCores <= ((uint32_t)this->maxCores));
+  auto idleCores = this->NOELLE_idleCores.fetch_add(coresReleased)
+                   + ((int32_t)coresReleased);
+  if (idleCores >= 0) {
+    assert(idleCores <= ((int32_t)this->maxCores));
   }
+#else
+  this->NOELLE_idleCores.fetch_add(coresReleased);
 #endif
-  pthread_spin_unlock(&this->spinLock);
 
   return;
 }
@@ -1115,7 +1652,7 @@ uint32_t NoelleRuntime::getAvailableCores(void) {
   /*
    * Get the number of cores available.
    */
-  auto numCores = this->NOELLE_idleCores;
+  auto numCores = this->NOELLE_idleCores.load(std::memory_order_relaxed);
   if (numCores < 1) {
     numCores = 1;
   }
@@ -1123,6 +1660,65 @@ uint32_t NoelleRuntime::getAvailableCores(void) {
   return numCores;
 }
 
+DOALL_args_t *DOALLArgsCache::getArgs(uint32_t cores) {
+
+  /*
+   * Check if we can reuse a previously-allocated memory block.
+   */
+  if (cores >= this->freeArgs.size()) {
+    this->freeArgs.resize(cores + 1);
+  }
+  auto &freeArgsOfSize = this->freeArgs[cores];
+  if (!freeArgsOfSize.empty()) {
+    auto argsForAllCores = freeArgsOfSize.back();
+    freeArgsOfSize.pop_back();
+
+    return argsForAllCores;
+  }
+
+  /*
+   * We couldn't find anything available.
+   *
+   * Allocate a new memory block.
+   */
+  DOALL_args_t *argsForAllCores = nullptr;
+  posix_memalign((void **)&argsForAllCores,
+                 CACHE_LINE_SIZE,
+                 sizeof(DOALL_args_t) * cores);
+
+  /*
+   * Initialize the memory.
+   */
+  for (uint32_t i = 0; i < cores; ++i) {
+    auto argsPerCore = &argsForAllCores[i];
+    argsPerCore->coreID = i;
+    pthread_spin_init(&(argsPerCore->endLock), 0);
+    pthread_spin_lock(&(argsPerCore->endLock));
+  }
+
+  return argsForAllCores;
+}
+
+void DOALLArgsCache::releaseArgs(DOALL_args_t *args, uint32_t cores) {
+  assert(cores < this->freeArgs.size());
+  this->freeArgs[cores].push_back(args);
+
+  return;
+}
+
+DOALLArgsCache::~DOALLArgsCache(void) {
+  for (size_t cores = 0; cores < this->freeArgs.size(); ++cores) {
+    for (auto args : this->freeArgs[cores]) {
+      for (size_t i = 0; i < cores; ++i) {
+        pthread_spin_destroy(&(args[i].endLock));
+      }
+      free(args);
+    }
+  }
+
+  return;
+}
+
 NoelleRuntime::~NoelleRuntime(void) {
-  delete this->virgil;
+  NOELLE_ThreadPool_destroy(this->threadPool);
 }
@@ -34,6 +34,15 @@ patchInstallDir "noelle-meta-pdg-embed" ;
 patchInstallDir "noelle-meta-prof-clean" ;
 patchInstallDir "noelle-meta-prof-embed" ;
 patchInstallDir "noelle-prof-coverage" ;
+patchInstallDir "noelle-prof-deps" ;
+patchInstallDir "noelle-meta-deps-prof-embed" ;
+patchInstallDir "noelle-prof-loops" ;
+patchInstallDir "noelle-meta-loop-prof-embed" ;
 patchInstallDir "noelle-config" ;
 patchInstallDir "noelle-simplification" ;
 patchInstallDir "loopaa" ;
+
+# Runtimes of the profilers
+mkdir -p ${installDir}/lib ;
+cp runtime/DependenceProfiler_runtime.cpp ${installDir}/lib/ ;
+cp runtime/LoopProfiler_runtime.cpp ${installDir}/lib/ ;
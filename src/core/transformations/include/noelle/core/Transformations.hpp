@@ -37,14 +37,19 @@ enum Transformation {
   LOOP_WHILIFIER_ID,
   SCEV_SIMPLIFICATION_ID,
   DEVIRTUALIZER_ID,
+  LOOP_FUSION_ID,
+  LOOP_INTERCHANGE_ID,
+  LOOP_TILING_ID,
+  LOOP_COLLAPSE_ID,
 
   First = DOALL_ID,
-  Last = DEVIRTUALIZER_ID
+  Last = LOOP_COLLAPSE_ID
 };
 
 enum LoopDependenceInfoOptimization {
   MEMORY_CLONING_ID,
-  THREAD_SAFE_LIBRARY_ID
+  THREAD_SAFE_LIBRARY_ID,
+  MEMORY_DEPENDENCE_PROFILE_ID
 };
 
 } // namespace llvm::noelle
@@ -376,6 +376,11 @@ class autotuneProgram(MeasurementInterface):
     # Erase parameters that do not make sense
     self.eraseUselessParameters(indexes)
 
+    # Multiversioned binaries (compiled with -noelle-parallelizer-multiversioning) are configured at runtime
+    if ((not self.finalConfFlag) and self.isBinaryMultiversioned()):
+      self.writeLoopsConfiguration(indexes)
+      return 0
+
     # Write the configuration to the INDEX_FILE file
     inputName = os.environ['INPUT_NAME']
     outputFile = os.environ['INDEX_FILE']
@@ -406,6 +411,56 @@ class autotuneProgram(MeasurementInterface):
     return os.system(repoPath + '/src/scripts/backEnd') # generate the binary of the best configuration found
 
 
+  def isBinaryMultiversioned(self):
+    return bool(int(os.environ.get('MULTIVERSIONED_BINARY', '0')))
+
+
+  def writeLoopsConfiguration(self, indexes):
+    """
+    Write the configuration read by the NOELLE runtime at startup.
+    Loops are identified by their position in the design space, which is the loop index the parallelizer gives to the runtime (see Noelle::getLoopIndex).
+    """
+
+    # Parallelization techniques in order of preference for each set of disabled techniques (see eraseUselessParameters)
+    techniques = [
+      'doall,helix,dswp',
+      'doall,helix',
+      'doall,dswp',
+      'helix,dswp',
+      'doall',
+      'helix',
+      'dswp'
+    ]
+
+    lines = []
+    for loopID in range(0, len(indexes) // 9):
+      loopIndexes = indexes[loopID * 9 : (loopID + 1) * 9]
+
+      # Should the loop be parallelized?
+      if loopIndexes[0] == 0:
+        lines.append(str(loopID) + ' sequential 0 0')
+        continue
+
+      # Number of cores (NOELLE parallelizes a loop only if it has at least 2 cores, see INDEX_FILE)
+      cores = loopIndexes[4]
+      if cores < 2:
+        lines.append(str(loopID) + ' sequential 0 0')
+        continue
+
+      # Parallelization techniques and DOALL chunk factor
+      loopTechniques = techniques[loopIndexes[3]]
+      chunkSize = loopIndexes[5] + 1
+      lines.append(str(loopID) + ' ' + loopTechniques + ' ' + str(cores) + ' ' + str(chunkSize))
+
+    # Dump the configuration and make it visible to the binary run by the profiler
+    pathToConfigurationFile = os.path.abspath(os.environ.get('LOOPS_CONFIGURATION_FILE', 'noelle_loops.conf'))
+    with open(pathToConfigurationFile, 'w') as f:
+      f.write('\n'.join(lines) + '\n')
+    os.environ['NOELLE_LOOPS_CONFIGURATION'] = pathToConfigurationFile
+
+    return
+
+
   def eraseUselessParameters(self, indexes):
 
     # Erase parallelization parameters related to loops chosen to stay sequential
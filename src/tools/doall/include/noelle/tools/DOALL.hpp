@@ -69,6 +69,47 @@ protected:
    */
   void rewireLoopToIterateChunks(LoopDependenceInfo *LDI);
 
+  /*
+   * Check if the chunks of @LDI can be executed by an inner loop that keeps
+   * the original step of the loop, which can then be vectorized.
+   * This requires a loop governing IV that grows by a constant step until it
+   * reaches the exit condition value, and a header that only selects the
+   * values of IVs and reduction variables.
+   */
+  bool canIterateChunksThroughAnInnerLoop(LoopDependenceInfo *LDI) const;
+
+  /*
+   * Wrap the loop within the task with a loop over the chunks assigned to the
+   * task. The original loop iterates over [chunk start, chunk end) of each
+   * chunk.
+   */
+  void rewireLoopToIterateChunksThroughAnInnerLoop(LoopDependenceInfo *LDI);
+
+  void hoistExitConditionValueDerivation(LoopDependenceInfo *LDI,
+                                         LoopGoverningIVUtility &ivUtility,
+                                         IRBuilder<> &entryBuilder);
+
+  void addVectorizationHintsToChunkLoop(LoopDependenceInfo *LDI);
+
+  /*
+   * Return the number of elements of the smallest type accessed by @LDI that
+   * fit in a vector register.
+   */
+  uint32_t getNumberOfVectorLanes(LoopDependenceInfo *LDI) const;
+
+  uint64_t roundChunkSizeToVectorWidth(LoopDependenceInfo *LDI,
+                                       uint64_t chunkSize) const;
+
+  CmpInst::Predicate getPredicateToContinue(LoopDependenceInfo *LDI) const;
+
+  /*
+   * Return the chunk size to use for @LDI.
+   * It starts from the one set for the loop and it is adjusted by the
+   * histograms of the loop profiler when they are available.
+   * Chunks executed by an inner loop are a multiple of the vector width.
+   */
+  uint32_t computeChunkSize(LoopDependenceInfo *LDI) const;
+
   void addJumpToLoop(LoopDependenceInfo *LDI, Task *t);
 
   /*
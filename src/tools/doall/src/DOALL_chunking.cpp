@@ -137,42 +137,8 @@ void DOALL::rewireLoopToIterateChunks(LoopDependenceInfo *LDI) {
   /*
    * The exit condition value does not need to be computed each iteration and so
    * the value's derivation can be hoisted into the preheader.
-   *
-   * Instructions that the PDG states are independent can include PHI nodes.
-   * Assert that any PHIs are invariant. Hoist one of those values (if
-   * instructions) to the preheader.
    */
-  auto exitConditionValue =
-      fetchClone(loopGoverningIVAttr->getExitConditionValue());
-  if (auto exitConditionInst = dyn_cast<Instruction>(exitConditionValue)) {
-    auto &derivation = ivUtility.getConditionValueDerivation();
-    for (auto I : derivation) {
-      assert(
-          invariantManager->isLoopInvariant(I)
-          && "DOALL exit condition value is not derived from loop invariant values!");
-
-      /*
-       * Fetch the clone of @I
-       */
-      auto cloneI = task->getCloneOfOriginalInstruction(I);
-
-      if (auto clonePHI = dyn_cast<PHINode>(cloneI)) {
-        auto usedValue = clonePHI->getIncomingValue(0);
-        clonePHI->replaceAllUsesWith(usedValue);
-        clonePHI->eraseFromParent();
-        cloneI = dyn_cast<Instruction>(usedValue);
-        if (!cloneI) {
-          continue;
-        }
-      }
-
-      cloneI->removeFromParent();
-      entryBuilder.Insert(cloneI);
-    }
-
-    exitConditionInst->removeFromParent();
-    entryBuilder.Insert(exitConditionInst);
-  }
+  this->hoistExitConditionValueDerivation(LDI, ivUtility, entryBuilder);
 
   /*
    * NOTE: When loop governing IV attribution allows for any other instructions
@@ -554,4 +520,113 @@ void DOALL::rewireLoopToIterateChunks(LoopDependenceInfo *LDI) {
   return;
 }
 
+void DOALL::hoistExitConditionValueDerivation(
+    LoopDependenceInfo *LDI,
+    LoopGoverningIVUtility &ivUtility,
+    IRBuilder<> &entryBuilder) {
+
+  /*
+   * Fetch the task and the loop abstractions.
+   */
+  auto task = (DOALLTask *)tasks[0];
+  auto invariantManager = LDI->getInvariantManager();
+  auto loopGoverningIVAttr = LDI->getLoopGoverningIVAttribution();
+
+  /*
+   * The exit condition value does not need to be computed each iteration and so
+   * the value's derivation can be hoisted into the preheader.
+   *
+   * Instructions that the PDG states are independent can include PHI nodes.
+   * Assert that any PHIs are invariant. Hoist one of those values (if
+   * instructions) to the preheader.
+   */
+  auto exitConditionValue =
+      fetchClone(loopGoverningIVAttr->getExitConditionValue());
+  if (auto exitConditionInst = dyn_cast<Instruction>(exitConditionValue)) {
+    auto &derivation = ivUtility.getConditionValueDerivation();
+    for (auto I : derivation) {
+      assert(
+          invariantManager->isLoopInvariant(I)
+          && "DOALL exit condition value is not derived from loop invariant values!");
+
+      /*
+       * Fetch the clone of @I
+       */
+      auto cloneI = task->getCloneOfOriginalInstruction(I);
+
+      if (auto clonePHI = dyn_cast<PHINode>(cloneI)) {
+        auto usedValue = clonePHI->getIncomingValue(0);
+        clonePHI->replaceAllUsesWith(usedValue);
+        clonePHI->eraseFromParent();
+        cloneI = dyn_cast<Instruction>(usedValue);
+        if (!cloneI) {
+          continue;
+        }
+      }
+
+      cloneI->removeFromParent();
+      entryBuilder.Insert(cloneI);
+    }
+
+    exitConditionInst->removeFromParent();
+    entryBuilder.Insert(exitConditionInst);
+  }
+
+  return;
+}
+
+uint32_t DOALL::computeChunkSize(LoopDependenceInfo *LDI) const {
+
+  /*
+   * Fetch the chunk size set for the loop.
+   */
+  auto ltm = LDI->getLoopTransformationsManager();
+  uint64_t chunkSize = ltm->getChunkSize();
+
+  /*
+   * Check if the loop has been profiled.
+   */
+  auto profiles = this->n.getProfiles();
+  auto loopStructure = LDI->getLoopStructure();
+  auto iterationsHistogram =
+      profiles->getIterationsPerInvocationHistogram(loopStructure);
+  auto instructionsHistogram =
+      profiles->getTotalInstructionsPerIterationHistogram(loopStructure);
+  auto isProfiled =
+      (iterationsHistogram != nullptr) && (instructionsHistogram != nullptr);
+
+  /*
+   * Make chunks of cheap iterations large enough to amortize the cost of
+   * dispatching them.
+   */
+  if (isProfiled && (instructionsHistogram->getNumberOfSamples() > 0)) {
+    uint64_t minimumInstructionsPerChunk = 1000;
+    auto medianCost =
+        std::max(instructionsHistogram->getPercentile(50), (uint64_t)1);
+    auto chunkSizeForCost =
+        (minimumInstructionsPerChunk + medianCost - 1) / medianCost;
+    chunkSize = std::max(chunkSize, chunkSizeForCost);
+  }
+
+  /*
+   * Make chunks small enough to give work to every core in the typical
+   * invocation of the loop.
+   */
+  if (isProfiled && (iterationsHistogram->getNumberOfSamples() > 0)) {
+    auto medianIterations = iterationsHistogram->getPercentile(50);
+    uint64_t cores = ltm->getMaximumNumberOfCores();
+    auto chunkSizeForCores = std::max(medianIterations / cores, (uint64_t)1);
+    chunkSize = std::min(chunkSize, chunkSizeForCores);
+  }
+
+  /*
+   * Only chunks executed by an inner loop can be vectorized.
+   */
+  if (this->canIterateChunksThroughAnInnerLoop(LDI)) {
+    chunkSize = this->roundChunkSizeToVectorWidth(LDI, chunkSize);
+  }
+
+  return chunkSize;
+}
+
 } // namespace llvm::noelle
@@ -65,7 +65,7 @@ bool DOALL::apply(LoopDependenceInfo *LDI, Heuristics *h) {
   if (this->verbose != Verbosity::Disabled) {
     errs() << "DOALL: Start the parallelization\n";
     errs() << "DOALL:   Number of threads to extract = " << maxCores << "\n";
-    errs() << "DOALL:   Chunk size = " << ltm->getChunkSize() << "\n";
+    errs() << "DOALL:   Chunk size = " << this->computeChunkSize(LDI) << "\n";
   }
 
   /*
@@ -216,7 +216,11 @@ bool DOALL::apply(LoopDependenceInfo *LDI, Heuristics *h) {
   /*
    * Perform the iteration-chunking optimization
    */
-  this->rewireLoopToIterateChunks(LDI);
+  if (this->canIterateChunksThroughAnInnerLoop(LDI)) {
+    this->rewireLoopToIterateChunksThroughAnInnerLoop(LDI);
+  } else {
+    this->rewireLoopToIterateChunks(LDI);
+  }
   if (this->verbose >= Verbosity::Maximal) {
     errs() << "DOALL:  Rewired induction variables and reducible variables\n";
   }
@@ -281,23 +285,40 @@ void DOALL::addChunkFunctionExecutionAsideOriginalLoop(LoopDependenceInfo *LDI,
   /*
    * Fetch the number of cores
    */
+  IRBuilder<> doallBuilder(this->entryPointOfParallelizedLoop);
   auto ltm = LDI->getLoopTransformationsManager();
   auto cm = par.getConstantsManager();
-  auto numCores = cm->getIntegerConstant(ltm->getMaximumNumberOfCores(), 64);
+  auto numCores = this->getNumberOfCoresToUse(
+      doallBuilder,
+      LDI,
+      cm->getIntegerConstant(ltm->getMaximumNumberOfCores(), 64));
 
   /*
    * Fetch the chunk size.
    */
-  auto chunkSize = cm->getIntegerConstant(ltm->getChunkSize(), 64);
+  auto chunkSize = this->getChunkSizeToUse(
+      doallBuilder,
+      LDI,
+      cm->getIntegerConstant(this->computeChunkSize(LDI), 64));
+
+  /*
+   * Fetch the loop index, which the runtime uses to keep the mapping between
+   * iterations and cores stable across invocations of the loop.
+   * This is the same index used by the runtime configuration of the loop (see
+   * Noelle::getLoopIndex). Loops without an index are passed -1.
+   */
+  auto loopIndexOpt = this->noelle.getLoopIndex(LDI->getLoopStructure());
+  auto loopID = cm->getIntegerConstant(
+      loopIndexOpt ? ((int64_t)loopIndexOpt.value()) : -1,
+      64);
 
   /*
    * Call the function that incudes the parallelized loop.
    */
-  IRBuilder<> doallBuilder(this->entryPointOfParallelizedLoop);
   auto doallCallInst = doallBuilder.CreateCall(
       this->taskDispatcher,
       ArrayRef<Value *>(
-          { tasks[0]->getTaskBody(), envPtr, numCores, chunkSize }));
+          { tasks[0]->getTaskBody(), envPtr, numCores, chunkSize, loopID }));
   auto numThreadsUsed =
       doallBuilder.CreateExtractValue(doallCallInst, (uint64_t)0);
 
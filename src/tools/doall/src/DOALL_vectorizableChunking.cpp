@@ -0,0 +1,534 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "noelle/core/LoopIterationSCC.hpp"
+#include "noelle/core/ReductionSCC.hpp"
+#include "noelle/tools/DOALL.hpp"
+#include "noelle/tools/DOALLTask.hpp"
+
+namespace llvm::noelle {
+
+bool DOALL::canIterateChunksThroughAnInnerLoop(LoopDependenceInfo *LDI) const {
+
+  /*
+   * Fetch the loop governing IV.
+   */
+  auto loopStructure = LDI->getLoopStructure();
+  auto loopHeader = loopStructure->getHeader();
+  auto loopGoverningIVAttr = LDI->getLoopGoverningIVAttribution();
+  if (loopGoverningIVAttr == nullptr) {
+    return false;
+  }
+  auto &loopGoverningIV = loopGoverningIVAttr->getInductionVariable();
+  auto loopGoverningPHI = loopGoverningIV.getLoopEntryPHI();
+  if (!loopGoverningPHI->getType()->isIntegerTy()) {
+    return false;
+  }
+
+  /*
+   * The loop governing IV must grow by a constant step until it reaches the
+   * exit condition value.
+   * This is what allows a chunk to end at a given value of the IV.
+   */
+  auto step = dyn_cast_or_null<ConstantInt>(
+      loopGoverningIV.getSingleComputedStepValue());
+  if ((step == nullptr) || (!step->getValue().isStrictlyPositive())) {
+    return false;
+  }
+  if (loopGoverningIVAttr->getValueToCompareAgainstExitConditionValue()
+      != loopGoverningPHI) {
+    return false;
+  }
+  auto predicate = this->getPredicateToContinue(LDI);
+  if ((predicate != CmpInst::ICMP_SLT) && (predicate != CmpInst::ICMP_ULT)) {
+    return false;
+  }
+
+  /*
+   * The loop must be left only from its header.
+   */
+  if (loopStructure->numberOfExitBasicBlocks() != 1) {
+    return false;
+  }
+  for (auto bb : loopStructure->getBasicBlocks()) {
+    if (bb == loopHeader) {
+      continue;
+    }
+    for (auto succ : successors(bb)) {
+      if (!loopStructure->isIncluded(succ)) {
+        return false;
+      }
+    }
+  }
+
+  /*
+   * The header must only select the values of IVs and reduction variables
+   * and decide whether to execute another iteration.
+   * Hence, executing the header once more at the end of every chunk does not
+   * change the semantics of the loop.
+   */
+  auto sccManager = LDI->getSCCManager();
+  auto sccdag = sccManager->getSCCDAG();
+  auto ivManager = LDI->getInductionVariableManager();
+  for (auto &I : *loopHeader) {
+    if ((&I == loopGoverningIVAttr->getHeaderCompareInstructionToComputeExitCondition())
+        || (&I == loopGoverningIVAttr->getHeaderBrInst())) {
+      continue;
+    }
+    auto phi = dyn_cast<PHINode>(&I);
+    if (phi == nullptr) {
+      return false;
+    }
+    auto iv = ivManager->getInductionVariable(*loopStructure, phi);
+    if ((iv != nullptr) && (iv->getLoopEntryPHI() == phi)) {
+      continue;
+    }
+    auto sccInfo = sccManager->getSCCAttrs(sccdag->sccOfValue(phi));
+    if (!isa<ReductionSCC>(sccInfo)) {
+      return false;
+    }
+  }
+
+  /*
+   * The only values that can leave the task are reduction variables.
+   * This is because the task no longer leaves from the header of the loop.
+   */
+  auto env = LDI->getEnvironment();
+  for (auto envID : env->getEnvIDsOfLiveOutVars()) {
+    auto producer = env->getProducer(envID);
+    auto sccInfo = sccManager->getSCCAttrs(sccdag->sccOfValue(producer));
+    if (!isa<ReductionSCC>(sccInfo)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void DOALL::rewireLoopToIterateChunksThroughAnInnerLoop(
+    LoopDependenceInfo *LDI) {
+
+  /*
+   * Fetch the task.
+   */
+  auto task = (DOALLTask *)tasks[0];
+  assert(task != nullptr);
+  auto taskFunction = task->getTaskBody();
+  auto &cxt = taskFunction->getContext();
+
+  /*
+   * Fetch loop and IV information.
+   */
+  auto loopStructure = LDI->getLoopStructure();
+  auto loopHeader = loopStructure->getHeader();
+  auto preheaderClone =
+      task->getCloneOfOriginalBasicBlock(loopStructure->getPreHeader());
+  auto headerClone = task->getCloneOfOriginalBasicBlock(loopHeader);
+  auto allIVInfo = LDI->getInductionVariableManager();
+  auto loopGoverningIVAttr = LDI->getLoopGoverningIVAttribution();
+  auto &loopGoverningIV = loopGoverningIVAttr->getInductionVariable();
+  auto loopGoverningPHI = cast<PHINode>(
+      task->getCloneOfOriginalInstruction(loopGoverningIV.getLoopEntryPHI()));
+  auto cmpInst = cast<CmpInst>(task->getCloneOfOriginalInstruction(
+      loopGoverningIVAttr
+          ->getHeaderCompareInstructionToComputeExitCondition()));
+  auto brInst = cast<BranchInst>(task->getCloneOfOriginalInstruction(
+      loopGoverningIVAttr->getHeaderBrInst()));
+  auto exitSuccessorIndex =
+      loopStructure->isIncluded(loopGoverningIVAttr->getHeaderBrInst()
+                                    ->getSuccessor(0))
+          ? 1
+          : 0;
+  auto exitClone = brInst->getSuccessor(exitSuccessorIndex);
+
+  /*
+   * Collect clones of step size deriving values for all induction variables
+   * of the parallelized loop.
+   */
+  IRBuilder<> entryBuilder(task->getEntry());
+  entryBuilder.SetInsertPoint(task->getEntry()->getTerminator());
+  auto clonedStepSizeMap =
+      this->cloneIVStepValueComputation(LDI, 0, entryBuilder);
+
+  /*
+   * The exit condition value does not need to be computed each iteration and so
+   * the value's derivation can be hoisted into the preheader.
+   */
+  LoopGoverningIVUtility ivUtility(loopStructure,
+                                   *allIVInfo,
+                                   *loopGoverningIVAttr);
+  this->hoistExitConditionValueDerivation(LDI, ivUtility, entryBuilder);
+  auto exitConditionValue =
+      this->fetchClone(loopGoverningIVAttr->getExitConditionValue());
+
+  /*
+   * Create the loop over the chunks assigned to the current task.
+   *
+   * The header of this loop selects the first iteration of the next chunk.
+   * The latch skips the chunks assigned to the other tasks.
+   * The original loop becomes the inner loop that iterates over the iterations
+   * of a chunk.
+   */
+  auto chunkHeader = BasicBlock::Create(cxt, "chunk_header", taskFunction);
+  auto chunkLatch = BasicBlock::Create(cxt, "next_chunk", taskFunction);
+  IRBuilder<> chunkHeaderBuilder(chunkHeader);
+  auto chunkHeaderTerminator = chunkHeaderBuilder.CreateUnreachable();
+  IRBuilder<> chunkLatchBuilder(chunkLatch);
+  chunkLatchBuilder.CreateBr(chunkHeader);
+  preheaderClone->getTerminator()->replaceUsesOfWith(headerClone, chunkHeader);
+
+  /*
+   * Compute the distances between chunks.
+   * A chunk covers chunk_size iterations. The chunks of a task are
+   * num_cores * chunk_size iterations apart.
+   */
+  auto chunkCounterType = task->chunkSizeArg->getType();
+  auto coreOffset = entryBuilder.CreateMul(task->coreArg,
+                                           task->chunkSizeArg,
+                                           "coreIdx_X_chunkSize");
+  auto chunksDistance = entryBuilder.CreateMul(task->numCoresArg,
+                                               task->chunkSizeArg,
+                                               "numCores_X_chunkSize");
+  auto otherCoresChunks = entryBuilder.CreateMul(
+      entryBuilder.CreateSub(task->numCoresArg,
+                             ConstantInt::get(chunkCounterType, 1),
+                             "numCoresMinus1"),
+      task->chunkSizeArg,
+      "numCoresMinus1_X_chunkSize");
+  auto governingStep = clonedStepSizeMap.at(&loopGoverningIV);
+  auto chunkSpan = IVUtility::scaleInductionVariableStep(preheaderClone,
+                                                         loopGoverningPHI,
+                                                         governingStep,
+                                                         task->chunkSizeArg);
+  auto otherCoresSpan =
+      IVUtility::scaleInductionVariableStep(preheaderClone,
+                                            loopGoverningPHI,
+                                            governingStep,
+                                            otherCoresChunks);
+
+  /*
+   * Every IV starts a chunk from the value it has at the first iteration of
+   * that chunk.
+   */
+  std::unordered_map<PHINode *, PHINode *> chunkPHIs;
+  for (auto ivInfo : allIVInfo->getInductionVariables(*loopStructure)) {
+    auto ivPHI = cast<PHINode>(this->fetchClone(ivInfo->getLoopEntryPHI()));
+    auto startOfIV = this->fetchClone(ivInfo->getStartValue());
+    auto stepOfIV = clonedStepSizeMap.at(ivInfo);
+
+    /*
+     * Compute the first value of the IV for the current task.
+     */
+    auto nthCoreOffset = IVUtility::scaleInductionVariableStep(preheaderClone,
+                                                               ivPHI,
+                                                               stepOfIV,
+                                                               coreOffset);
+    auto offsetStartValue =
+        IVUtility::offsetIVPHI(preheaderClone, ivPHI, startOfIV, nthCoreOffset);
+
+    /*
+     * Create the PHI that tracks the value of the IV at the beginning of each
+     * chunk.
+     */
+    chunkHeaderBuilder.SetInsertPoint(chunkHeaderTerminator);
+    auto chunkPHI = chunkHeaderBuilder.CreatePHI(ivPHI->getType(), 2);
+    chunkPHI->addIncoming(offsetStartValue, preheaderClone);
+    chunkPHIs[ivPHI] = chunkPHI;
+    if (ivPHI == loopGoverningPHI) {
+      continue;
+    }
+
+    /*
+     * Jump over the chunks of the other tasks.
+     */
+    auto chunkStride = IVUtility::scaleInductionVariableStep(preheaderClone,
+                                                             ivPHI,
+                                                             stepOfIV,
+                                                             chunksDistance);
+    auto nextChunkValue =
+        IVUtility::offsetIVPHI(chunkLatch, ivPHI, chunkPHI, chunkStride);
+    chunkPHI->addIncoming(nextChunkValue, chunkLatch);
+  }
+
+  /*
+   * Reduction variables accumulate their values across chunks.
+   */
+  for (auto &phi : headerClone->phis()) {
+    if (chunkPHIs.find(&phi) != chunkPHIs.end()) {
+      continue;
+    }
+    chunkHeaderBuilder.SetInsertPoint(chunkHeaderTerminator);
+    auto chunkPHI = chunkHeaderBuilder.CreatePHI(phi.getType(), 2);
+    chunkPHI->addIncoming(phi.getIncomingValueForBlock(preheaderClone),
+                          preheaderClone);
+    chunkPHI->addIncoming(&phi, chunkLatch);
+    chunkPHIs[&phi] = chunkPHI;
+  }
+
+  /*
+   * Compute the end of the current chunk.
+   * The distance from the exit condition value avoids overflowing the IV when
+   * computing the end of the last chunk.
+   */
+  auto chunkStart = chunkPHIs.at(loopGoverningPHI);
+  chunkHeaderBuilder.SetInsertPoint(chunkHeaderTerminator);
+  auto iterationsLeft =
+      chunkHeaderBuilder.CreateSub(exitConditionValue, chunkStart);
+  auto isLastChunk = chunkHeaderBuilder.CreateICmpULE(iterationsLeft, chunkSpan);
+  auto fullChunkEnd = chunkHeaderBuilder.CreateAdd(chunkStart, chunkSpan);
+  auto chunkEnd = chunkHeaderBuilder.CreateSelect(isLastChunk,
+                                                  exitConditionValue,
+                                                  fullChunkEnd,
+                                                  "chunkEnd");
+
+  /*
+   * Check whether the current chunk has iterations to execute.
+   */
+  auto isChunkValid = cmpInst->clone();
+  isChunkValid->replaceUsesOfWith(loopGoverningPHI, chunkStart);
+  chunkHeaderBuilder.Insert(isChunkValid);
+  auto chunkBr = cast<BranchInst>(brInst->clone());
+  chunkBr->setCondition(isChunkValid);
+  chunkBr->setSuccessor(1 - exitSuccessorIndex, headerClone);
+  chunkHeaderBuilder.Insert(chunkBr);
+  chunkHeaderTerminator->eraseFromParent();
+
+  /*
+   * Move to the next chunk of the current task.
+   * Stop at the exit condition value when the next chunk would go past it.
+   */
+  chunkLatchBuilder.SetInsertPoint(chunkLatch->getTerminator());
+  auto iterationsLeftAfterChunk =
+      chunkLatchBuilder.CreateSub(exitConditionValue, chunkEnd);
+  auto isTaskDone =
+      chunkLatchBuilder.CreateICmpULE(iterationsLeftAfterChunk, otherCoresSpan);
+  auto nextChunkStart = chunkLatchBuilder.CreateAdd(chunkEnd, otherCoresSpan);
+  chunkStart->addIncoming(chunkLatchBuilder.CreateSelect(isTaskDone,
+                                                         exitConditionValue,
+                                                         nextChunkStart,
+                                                         "nextChunkStart"),
+                          chunkLatch);
+
+  /*
+   * The original loop now iterates over the iterations of a chunk with its
+   * original step.
+   */
+  for (auto &phi : headerClone->phis()) {
+    auto preheaderIndex = phi.getBasicBlockIndex(preheaderClone);
+    phi.setIncomingBlock(preheaderIndex, chunkHeader);
+    phi.setIncomingValue(preheaderIndex, chunkPHIs.at(&phi));
+  }
+  cmpInst->replaceUsesOfWith(exitConditionValue, chunkEnd);
+  brInst->setSuccessor(exitSuccessorIndex, chunkLatch);
+
+  /*
+   * The reduction variables leave the task from the loop over chunks.
+   */
+  auto sccManager = LDI->getSCCManager();
+  for (auto sccInfo : sccManager->getSCCsWithLoopCarriedDataDependencies()) {
+    auto reductionSCC = dyn_cast<ReductionSCC>(sccInfo);
+    if (reductionSCC == nullptr) {
+      continue;
+    }
+    auto headerPHI =
+        reductionSCC->getPhiThatAccumulatesValuesBetweenLoopIterations();
+    auto headerPHIClone =
+        cast<PHINode>(task->getCloneOfOriginalInstruction(headerPHI));
+    if (chunkPHIs.find(headerPHIClone) == chunkPHIs.end()) {
+      continue;
+    }
+    task->addInstruction(headerPHI, chunkPHIs.at(headerPHIClone));
+  }
+
+  /*
+   * Tell the loop vectorizer that the iterations of a chunk are independent.
+   */
+  this->addVectorizationHintsToChunkLoop(LDI);
+
+  return;
+}
+
+void DOALL::addVectorizationHintsToChunkLoop(LoopDependenceInfo *LDI) {
+
+  /*
+   * Fetch the task.
+   */
+  auto task = this->tasks[0];
+  auto &cxt = task->getTaskBody()->getContext();
+
+  /*
+   * Collect the memory instructions that do not access memory locations
+   * shared by different iterations of the loop.
+   * Instructions that access cloned memory objects are skipped because
+   * iterations of the same task share the private copy of those objects.
+   */
+  std::unordered_set<Instruction *> instructionsToSkip;
+  auto ltm = LDI->getLoopTransformationsManager();
+  if (ltm->isOptimizationEnabled(
+          LoopDependenceInfoOptimization::MEMORY_CLONING_ID)) {
+    auto memoryCloningAnalysis = LDI->getMemoryCloningAnalysis();
+    for (auto location : memoryCloningAnalysis->getClonableMemoryObjects()) {
+      for (auto I : location->getLoopInstructionsUsingLocation()) {
+        instructionsToSkip.insert(I);
+      }
+    }
+  }
+  auto loopStructure = LDI->getLoopStructure();
+  auto sccManager = LDI->getSCCManager();
+  auto sccdag = sccManager->getSCCDAG();
+  auto accessGroup = MDNode::getDistinct(cxt, {});
+  for (auto I : loopStructure->getInstructions()) {
+    if (!I->mayReadOrWriteMemory()) {
+      continue;
+    }
+    if (instructionsToSkip.find(I) != instructionsToSkip.end()) {
+      continue;
+    }
+    auto sccInfo = sccManager->getSCCAttrs(sccdag->sccOfValue(I));
+    if (!isa<LoopIterationSCC>(sccInfo)) {
+      continue;
+    }
+    auto cloneI = task->getCloneOfOriginalInstruction(I);
+    cloneI->setMetadata(LLVMContext::MD_access_group, accessGroup);
+  }
+
+  /*
+   * Attach the hints to the latches of the loop that iterates within a chunk.
+   * The existing hints of the loop are preserved.
+   */
+  for (auto latch : loopStructure->getLatches()) {
+    auto latchClone = task->getCloneOfOriginalBasicBlock(latch);
+    auto latchTerminator = latchClone->getTerminator();
+    SmallVector<Metadata *, 4> hints;
+    hints.push_back(nullptr);
+    if (auto loopID = latchTerminator->getMetadata(LLVMContext::MD_loop)) {
+      for (auto i = 1; i < loopID->getNumOperands(); i++) {
+        hints.push_back(loopID->getOperand(i));
+      }
+    }
+    hints.push_back(MDNode::get(
+        cxt,
+        { MDString::get(cxt, "llvm.loop.vectorize.enable"),
+          ConstantAsMetadata::get(ConstantInt::getTrue(cxt)) }));
+    hints.push_back(MDNode::get(
+        cxt,
+        { MDString::get(cxt, "llvm.loop.parallel_accesses"), accessGroup }));
+    auto newLoopID = MDNode::getDistinct(cxt, hints);
+    newLoopID->replaceOperandWith(0, newLoopID);
+    latchTerminator->setMetadata(LLVMContext::MD_loop, newLoopID);
+  }
+
+  return;
+}
+
+uint32_t DOALL::getNumberOfVectorLanes(LoopDependenceInfo *LDI) const {
+
+  /*
+   * Fetch the smallest element accessed by the loop.
+   */
+  auto loopStructure = LDI->getLoopStructure();
+  auto &DL = loopStructure->getFunction()->getParent()->getDataLayout();
+  uint64_t smallestElementBits = 0;
+  for (auto I : loopStructure->getInstructions()) {
+    Type *elementType = nullptr;
+    if (auto load = dyn_cast<LoadInst>(I)) {
+      elementType = load->getType();
+    } else if (auto store = dyn_cast<StoreInst>(I)) {
+      elementType = store->getValueOperand()->getType();
+    } else {
+      continue;
+    }
+    if (!elementType->isSized()) {
+      continue;
+    }
+    auto bits = DL.getTypeSizeInBits(elementType);
+    if ((bits == 0)
+        || ((smallestElementBits != 0) && (bits >= smallestElementBits))) {
+      continue;
+    }
+    smallestElementBits = bits;
+  }
+  if (smallestElementBits == 0) {
+    return 1;
+  }
+
+  /*
+   * Compute the number of elements that fit in a vector register of the target
+   * the loop is compiled for.
+   */
+  auto &TTI = this->n.getTargetTransformInfo(*loopStructure->getFunction());
+  auto lanes = TTI.getRegisterBitWidth(true) / smallestElementBits;
+  if (lanes == 0) {
+    return 1;
+  }
+
+  return lanes;
+}
+
+uint64_t DOALL::roundChunkSizeToVectorWidth(LoopDependenceInfo *LDI,
+                                            uint64_t chunkSize) const {
+
+  /*
+   * Round the chunk size up to a multiple of the vector width.
+   * This way, only the last chunk of the loop needs a scalar remainder.
+   */
+  uint64_t lanes = this->getNumberOfVectorLanes(LDI);
+  auto roundedChunkSize = ((chunkSize + lanes - 1) / lanes) * lanes;
+
+  return roundedChunkSize;
+}
+
+CmpInst::Predicate DOALL::getPredicateToContinue(
+    LoopDependenceInfo *LDI) const {
+
+  /*
+   * Fetch the comparison that decides whether to execute another iteration.
+   */
+  auto loopStructure = LDI->getLoopStructure();
+  auto loopGoverningIVAttr = LDI->getLoopGoverningIVAttribution();
+  auto cmpInst =
+      loopGoverningIVAttr->getHeaderCompareInstructionToComputeExitCondition();
+  auto brInst = loopGoverningIVAttr->getHeaderBrInst();
+  auto ivValue =
+      loopGoverningIVAttr->getValueToCompareAgainstExitConditionValue();
+
+  /*
+   * Normalize the comparison to have the IV on the left.
+   */
+  auto predicate = cmpInst->getPredicate();
+  if (cmpInst->getOperand(1) == ivValue) {
+    predicate = CmpInst::getSwappedPredicate(predicate);
+  }
+
+  /*
+   * Normalize the comparison to be true when the loop continues.
+   */
+  if (brInst->getCondition() != cmpInst) {
+    return CmpInst::BAD_ICMP_PREDICATE;
+  }
+  if (!loopStructure->isIncluded(brInst->getSuccessor(0))) {
+    predicate = CmpInst::getInversePredicate(predicate);
+  }
+
+  return predicate;
+}
+
+} // namespace llvm::noelle
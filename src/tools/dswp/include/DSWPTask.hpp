@@ -80,34 +80,30 @@ struct QueueInfo {
   int bitLength;
   bool isMemoryDependence;
 
-  Instruction *producer;
+  /*
+   * Whether the slots of the queue are records rather than scalars.
+   * A record packs several values, or a single value that does not fit in the
+   * scalar queues (e.g., vectors, aggregates).
+   */
+  bool isRecord;
+
+  /*
+   * Values sent through the queue, in the order they are packed in a slot.
+   * They are all produced by the same basic block, so one slot is pushed per
+   * execution of that block.
+   */
+  std::vector<Instruction *> producers;
   std::set<Instruction *> consumers;
   unordered_map<Instruction *, int> consumerToPushIndex;
 
-  QueueInfo(Instruction *p, Instruction *c, Type *type, bool isMemoryDependence)
-    : producer{ p },
-      dependentType{ type },
-      isMemoryDependence{ isMemoryDependence } {
-    consumers.insert(c);
-    if (isMemoryDependence) {
-      dependentType = IntegerType::get(c->getContext(), 1);
-      bitLength = 1;
-    } else if (dependentType->isPointerTy()) {
-      bitLength =
-          DataLayout(p->getModule()).getTypeAllocSize(dependentType) * 8;
-    } else {
-      bitLength = dependentType->getPrimitiveSizeInBits();
-      // NOTE(angelo): Round up to the nearest power of 2
-      bitLength = pow(2, ceil(log2(bitLength)));
-    }
-  }
-
-  raw_ostream &print(raw_ostream &stream, std::string prefixToUse = "") {
-    producer->print(stream << prefixToUse << "From stage: " << fromStage
-                           << " To stage: " << toStage << " Number of bits: "
-                           << bitLength << " Producer: ");
-    return stream << "\n";
-  }
+  QueueInfo(Instruction *p, Instruction *c, bool isMemoryDependence);
+
+  void addProducer(Instruction *p);
+
+  raw_ostream &print(raw_ostream &stream, std::string prefixToUse = "");
+
+private:
+  void computeTypeOfSlots(void);
 };
 
 struct QueueInstrs {
@@ -115,6 +111,6 @@ struct QueueInstrs {
   Value *queueCall;
   Value *alloca;
   Value *allocaCast;
-  Value *load;
+  std::vector<Value *> loads;
 };
 } // namespace llvm::noelle
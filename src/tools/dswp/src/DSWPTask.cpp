@@ -41,3 +41,88 @@ void DSWPTask::extractFuncArgs(void) {
 
   return;
 }
+
+QueueInfo::QueueInfo(Instruction *p, Instruction *c, bool isMemoryDependence)
+  : isMemoryDependence{ isMemoryDependence },
+    producers{ p } {
+  consumers.insert(c);
+  this->computeTypeOfSlots();
+
+  return;
+}
+
+void QueueInfo::addProducer(Instruction *p) {
+  if (std::find(this->producers.begin(), this->producers.end(), p)
+      != this->producers.end()) {
+    return;
+  }
+  this->producers.push_back(p);
+  this->computeTypeOfSlots();
+
+  return;
+}
+
+void QueueInfo::computeTypeOfSlots(void) {
+  auto producer = this->producers[0];
+  auto &cxt = producer->getContext();
+  DataLayout DL(producer->getModule());
+
+  /*
+   * Fetch the types of the values sent through the queue.
+   */
+  std::vector<Type *> types;
+  for (auto p : this->producers) {
+    if (this->isMemoryDependence) {
+      types.push_back(IntegerType::get(cxt, 1));
+    } else {
+      types.push_back(p->getType());
+    }
+  }
+
+  /*
+   * Check if a single value fits in the scalar queues.
+   */
+  if ((types.size() == 1) && (!types[0]->isAggregateType())) {
+    this->dependentType = types[0];
+    if (this->isMemoryDependence) {
+      this->bitLength = 1;
+    } else if (this->dependentType->isPointerTy()) {
+      this->bitLength = DL.getTypeAllocSize(this->dependentType) * 8;
+    } else {
+      this->bitLength = this->dependentType->getPrimitiveSizeInBits();
+      // NOTE(angelo): Round up to the nearest power of 2
+      this->bitLength = pow(2, ceil(log2(this->bitLength)));
+    }
+    if ((this->bitLength == 1)
+        || ((this->bitLength >= 8) && (this->bitLength <= 64))) {
+      this->isRecord = false;
+      return;
+    }
+  }
+
+  /*
+   * The slots are records.
+   */
+  if (types.size() == 1) {
+    this->dependentType = types[0];
+  } else {
+    this->dependentType = StructType::get(cxt, types);
+  }
+  this->isRecord = true;
+  uint64_t recordSize = DL.getTypeAllocSize(this->dependentType);
+  this->bitLength = std::max<uint64_t>(recordSize, 1) * 8;
+
+  return;
+}
+
+raw_ostream &QueueInfo::print(raw_ostream &stream, std::string prefixToUse) {
+  stream << prefixToUse << "From stage: " << fromStage
+         << " To stage: " << toStage << " Number of bits: " << bitLength
+         << (isRecord ? " (record)" : "") << "\n";
+  for (auto producer : producers) {
+    producer->print(stream << prefixToUse << "  Producer: ");
+    stream << "\n";
+  }
+
+  return stream;
+}
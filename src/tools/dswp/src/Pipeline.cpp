@@ -173,7 +173,7 @@ void DSWP::createPipelineFromStages(LoopDependenceInfo *LDI, Noelle &par) {
   /*
    * Allocate an array of integers.
    * Each integer represents the bitwidth of each queue that connects pipeline
-   * stages.
+   * stages (or the size of the records of a queue of records).
    */
   auto queueSizesPtr = createQueueSizesArrayFromStages(LDI, builder, par);
 
@@ -242,7 +242,16 @@ Value *DSWP::createQueueSizesArrayFromStages(LoopDependenceInfo *LDI,
         ArrayRef<Value *>({ this->zeroIndexForBaseArray, queueIndex }));
     auto queueCast =
         funcBuilder.CreateBitCast(queuePtr, PointerType::getUnqual(par.int64));
-    funcBuilder.CreateStore(ConstantInt::get(par.int64, queue->bitLength),
+
+    /*
+     * Queues of records are described by the negated number of bytes of a
+     * record.
+     */
+    int64_t queueSize = queue->bitLength;
+    if (queue->isRecord) {
+      queueSize = -(queue->bitLength / 8);
+    }
+    funcBuilder.CreateStore(ConstantInt::get(par.int64, queueSize, true),
                             queueCast);
   }
 
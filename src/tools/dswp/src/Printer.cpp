@@ -81,9 +81,15 @@ void DSWP::printStageQueues(LoopDependenceInfo *LDI) const {
    */
   int count = 0;
   for (auto &queue : this->queues) {
-    errs() << "DSWP:    Queue: " << count++ << "\n";
-    queue->producer->print(errs() << "DSWP:     Producer:\t");
+    errs() << "DSWP:    Queue: " << count++;
+    if (queue->isRecord) {
+      errs() << " (records of " << (queue->bitLength / 8) << " bytes)";
+    }
     errs() << "\n";
+    for (auto producer : queue->producers) {
+      producer->print(errs() << "DSWP:     Producer:\t");
+      errs() << "\n";
+    }
     for (auto consumer : queue->consumers) {
       consumer->print(errs() << "DSWP:     Consumer:\t");
       errs() << "\n";
@@ -223,10 +229,12 @@ void DSWP::writeStageQueuesAsDot(const LoopDependenceInfo &LDI) const {
   };
 
   for (auto &queue : this->queues) {
-    auto producerNode = addNode(queue->fromStage, queue->producer);
-    for (auto consumerI : queue->consumers) {
-      auto consumerNode = addNode(queue->toStage, consumerI);
-      queueGraph.addEdge(producerNode->getT(), consumerNode->getT());
+    for (auto producer : queue->producers) {
+      auto producerNode = addNode(queue->fromStage, producer);
+      for (auto consumerI : queue->consumers) {
+        auto consumerNode = addNode(queue->toStage, consumerI);
+        queueGraph.addEdge(producerNode->getT(), consumerNode->getT());
+      }
     }
   }
 
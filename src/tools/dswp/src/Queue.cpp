@@ -33,40 +33,36 @@ void DSWP::registerQueue(Noelle &par,
                          bool isMemoryDependence) {
 
   /*
-   * Find/create the push queue in the producer stage
+   * Find/create the push queue in the producer stage.
+   *
+   * Values produced by the same basic block and sent to the same stage share
+   * a queue: they are packed in a single record, so they are synchronized
+   * once per execution of that block rather than once per value.
    */
   int queueIndex = this->queues.size();
   QueueInfo *queueInfo = nullptr;
-  for (auto queueI : fromStage->producerToQueues[producer]) {
-    if (this->queues[queueI]->toStage != toStage->getID())
+  for (auto queueI : fromStage->pushValueQueues) {
+    auto candidate = this->queues[queueI].get();
+    if (candidate->toStage != toStage->getID())
+      continue;
+    if (candidate->isMemoryDependence != isMemoryDependence)
+      continue;
+    if (candidate->producers[0]->getParent() != producer->getParent())
       continue;
     queueIndex = queueI;
-    queueInfo = this->queues[queueIndex].get();
+    queueInfo = candidate;
     break;
   }
   if (queueIndex == this->queues.size()) {
     this->queues.push_back(
         std::move(std::make_unique<QueueInfo>(producer,
                                               consumer,
-                                              producer->getType(),
                                               isMemoryDependence)));
-    fromStage->producerToQueues[producer].insert(queueIndex);
     queueInfo = this->queues[queueIndex].get();
-
-    /*
-     * Confirm a new queue is of a size handled by the parallelizer
-     */
-    auto &queueTypes = par.queues.queueSizeToIndex;
-    bool byteSize = queueTypes.find(queueInfo->bitLength) != queueTypes.end();
-    if (!byteSize) {
-      errs() << "NOT SUPPORTED BYTE SIZE (" << queueInfo->bitLength << "): ";
-      producer->getType()->print(errs());
-      errs() << "\n";
-      producer->print(errs() << "Producer: ");
-      errs() << "\n";
-      abort();
-    }
+  } else {
+    queueInfo->addProducer(producer);
   }
+  fromStage->producerToQueues[producer].insert(queueIndex);
 
   /*
    * Track queue indices in stages
@@ -350,9 +346,16 @@ void DSWP::generateLoadsOfQueuePointers(Noelle &par, int taskIndex) {
     auto queuePtr = entryBuilder.CreateInBoundsGEP(
         queuesArray,
         ArrayRef<Value *>({ this->zeroIndexForBaseArray, queueIndexValue }));
-    auto parQueueIndex = par.queues.queueSizeToIndex[queueInfo->bitLength];
-    auto queueType = par.queues.queueTypes[parQueueIndex];
-    auto queueElemType = par.queues.queueElementTypes[parQueueIndex];
+    Type *queueType = nullptr;
+    Type *queueElemType = nullptr;
+    if (queueInfo->isRecord) {
+      queueType = par.queues.recordQueueType;
+      queueElemType = par.int8;
+    } else {
+      auto parQueueIndex = par.queues.queueSizeToIndex[queueInfo->bitLength];
+      queueType = par.queues.queueTypes[parQueueIndex];
+      queueElemType = par.queues.queueElementTypes[parQueueIndex];
+    }
     auto queueCast =
         entryBuilder.CreateBitCast(queuePtr, PointerType::getUnqual(queueType));
 
@@ -381,25 +384,45 @@ void DSWP::popValueQueues(LoopDependenceInfo *LDI, Noelle &par, int taskIndex) {
         ArrayRef<Value *>({ queueInstrs->queuePtr, queueInstrs->allocaCast });
 
     /*
-     * Determine the clone of the basic block of the original producer
+     * Determine the clone of the basic block of the original producers
      * Insert load right there
      */
-    auto originalB = queueInfo->producer->getParent();
+    auto originalB = queueInfo->producers[0]->getParent();
     assert(task->isAnOriginalBasicBlock(originalB));
     auto clonedB = task->getCloneOfOriginalBasicBlock(originalB);
     Instruction *insertionPoint = clonedB->getFirstNonPHIOrDbgOrLifetime();
     IRBuilder<> builder(insertionPoint);
-    auto queuePopFunction =
-        par.queues.queuePops[par.queues.queueSizeToIndex[queueInfo->bitLength]];
+    Function *queuePopFunction = nullptr;
+    if (queueInfo->isRecord) {
+      queuePopFunction = par.queues.recordQueuePop;
+    } else {
+      queuePopFunction =
+          par.queues
+              .queuePops[par.queues.queueSizeToIndex[queueInfo->bitLength]];
+    }
     queueInstrs->queueCall =
         builder.CreateCall(queuePopFunction, queueCallArgs);
-    queueInstrs->load = builder.CreateLoad(queueInstrs->alloca);
 
     /*
-     * Map from producer to queue load
+     * Unpack the values
+     */
+    auto isPackedInStruct = isa<StructType>(queueInfo->dependentType)
+                            && (queueInfo->producers.size() > 1);
+    for (auto i = 0; i < queueInfo->producers.size(); ++i) {
+      auto valuePtr = queueInstrs->alloca;
+      if (isPackedInStruct) {
+        valuePtr = builder.CreateStructGEP(queueInstrs->alloca, i);
+      }
+      queueInstrs->loads.push_back(builder.CreateLoad(valuePtr));
+    }
+
+    /*
+     * Map from producers to queue loads
      */
-    task->addInstruction(queueInfo->producer,
-                         cast<Instruction>(queueInstrs->load));
+    for (auto i = 0; i < queueInfo->producers.size(); ++i) {
+      task->addInstruction(queueInfo->producers[i],
+                           cast<Instruction>(queueInstrs->loads[i]));
+    }
   }
 }
 
@@ -413,24 +436,52 @@ void DSWP::pushValueQueues(LoopDependenceInfo *LDI,
     auto queueInfo = this->queues[queueIndex].get();
     auto queueCallArgs =
         ArrayRef<Value *>({ queueInstrs->queuePtr, queueInstrs->allocaCast });
-    auto queuePushFunction =
-        par.queues
-            .queuePushes[par.queues.queueSizeToIndex[queueInfo->bitLength]];
+    Function *queuePushFunction = nullptr;
+    if (queueInfo->isRecord) {
+      queuePushFunction = par.queues.recordQueuePush;
+    } else {
+      queuePushFunction =
+          par.queues
+              .queuePushes[par.queues.queueSizeToIndex[queueInfo->bitLength]];
+    }
 
     /*
-     * Store the produced value immediately
-     * Push the value immediately
+     * Identify the last producer of the basic block: all the values of the
+     * queue are available right after it.
      */
-    auto producerBlock = queueInfo->producer->getParent();
-    auto producerClone =
-        task->getCloneOfOriginalInstruction(queueInfo->producer);
-    auto producerCloneBlock = producerClone->getParent();
-    auto insertPoint = producerClone->getNextNode();
+    auto producerBlock = queueInfo->producers[0]->getParent();
+    std::set<Instruction *> producers(queueInfo->producers.begin(),
+                                      queueInfo->producers.end());
+    Instruction *lastProducer = nullptr;
+    for (auto &I : *producerBlock) {
+      if (producers.find(&I) != producers.end()) {
+        lastProducer = &I;
+      }
+    }
+    assert(lastProducer != nullptr);
+
+    /*
+     * Store the produced values right after the last one
+     * Push them immediately
+     */
+    auto lastProducerClone = task->getCloneOfOriginalInstruction(lastProducer);
+    auto producerCloneBlock = lastProducerClone->getParent();
+    auto insertPoint = lastProducerClone->getNextNode();
     if (isa<PHINode>(insertPoint)) {
       insertPoint = producerCloneBlock->getFirstNonPHIOrDbgOrLifetime();
     }
     IRBuilder<> builder(insertPoint);
-    builder.CreateStore(producerClone, queueInstrs->alloca);
+    auto isPackedInStruct = isa<StructType>(queueInfo->dependentType)
+                            && (queueInfo->producers.size() > 1);
+    for (auto i = 0; i < queueInfo->producers.size(); ++i) {
+      auto producerClone =
+          task->getCloneOfOriginalInstruction(queueInfo->producers[i]);
+      auto valuePtr = queueInstrs->alloca;
+      if (isPackedInStruct) {
+        valuePtr = builder.CreateStructGEP(queueInstrs->alloca, i);
+      }
+      builder.CreateStore(producerClone, valuePtr);
+    }
     queueInstrs->queueCall =
         builder.CreateCall(queuePushFunction, queueCallArgs);
   }
@@ -21,6 +21,9 @@
  */
 #include "EnablersManager.hpp"
 #include "noelle/core/LoopCarriedUnknownSCC.hpp"
+#include "noelle/core/LoopInterchange.hpp"
+#include "noelle/core/LoopTiling.hpp"
+#include "noelle/core/LoopCollapse.hpp"
 #include "noelle/tools/DOALL.hpp"
 
 namespace llvm::noelle {
@@ -32,6 +35,50 @@ bool EnablersManager::applyEnablers(
     LoopInvariantCodeMotion &loopInvariantCodeMotion,
     SCEVSimplification &scevSimplification) {
 
+  /*
+   * Apply loop fusion.
+   */
+  if (par.isTransformationEnabled(Transformation::LOOP_FUSION_ID)) {
+    errs() << "EnablersManager:     Try to fuse loops\n";
+    if (this->applyLoopFusion(LDI, par, LoopTransformer)) {
+      errs() << "EnablersManager:       Fused loops\n";
+      return true;
+    }
+  }
+
+  /*
+   * Reorder the loop nest.
+   */
+  if (par.isTransformationEnabled(Transformation::LOOP_INTERCHANGE_ID)) {
+    errs() << "EnablersManager:     Try to interchange loops\n";
+    if (this->applyLoopInterchange(LDI, par, LoopTransformer)) {
+      errs() << "EnablersManager:       Interchanged loops\n";
+      return true;
+    }
+  }
+
+  /*
+   * Collapse the loop nest.
+   */
+  if (par.isTransformationEnabled(Transformation::LOOP_COLLAPSE_ID)) {
+    errs() << "EnablersManager:     Try to collapse loops\n";
+    if (this->applyLoopCollapse(LDI, par, LoopTransformer)) {
+      errs() << "EnablersManager:       Collapsed loops\n";
+      return true;
+    }
+  }
+
+  /*
+   * Tile the loop nest.
+   */
+  if (par.isTransformationEnabled(Transformation::LOOP_TILING_ID)) {
+    errs() << "EnablersManager:     Try to tile loops\n";
+    if (this->applyLoopTiling(LDI, par, LoopTransformer)) {
+      errs() << "EnablersManager:       Tiled loops\n";
+      return true;
+    }
+  }
+
   /*
    * Apply loop distribution.
    */
@@ -213,6 +260,208 @@ bool EnablersManager::applyLoopDistribution(LoopDependenceInfo *LDI,
   return false;
 }
 
+bool EnablersManager::applyLoopFusion(LoopDependenceInfo *LDI,
+                                      Noelle &par,
+                                      LoopTransformer &loopTransformer) {
+
+  /*
+   * Fusion merges the loop with the one that starts right after it ends.
+   */
+  auto ls = LDI->getLoopStructure();
+  auto exitBBs = ls->getLoopExitBasicBlocks();
+  if (exitBBs.size() != 1) {
+    return false;
+  }
+  auto exitBB = exitBBs[0];
+
+  /*
+   * Find the loop that follows the current one.
+   */
+  auto f = ls->getFunction();
+  auto loopsOfFunction = par.getLoopStructures(f);
+  LoopStructure *nextLS = nullptr;
+  for (auto otherLS : *loopsOfFunction) {
+    if (otherLS->getPreHeader() == exitBB) {
+      nextLS = otherLS;
+      break;
+    }
+  }
+  LoopDependenceInfo *nextLDI = nullptr;
+  if (nextLS != nullptr) {
+    nextLDI = par.getLoop(nextLS);
+  }
+
+  /*
+   * Free the memory.
+   */
+  for (auto otherLS : *loopsOfFunction) {
+    delete otherLS;
+  }
+  delete loopsOfFunction;
+  if (nextLDI == nullptr) {
+    return false;
+  }
+
+  /*
+   * Fuse the two loops.
+   */
+  auto modified = loopTransformer.fuseLoops(LDI, nextLDI);
+
+  return modified;
+}
+
+bool EnablersManager::applyLoopInterchange(LoopDependenceInfo *LDI,
+                                           Noelle &par,
+                                           LoopTransformer &loopTransformer) {
+
+  /*
+   * Only loop nests with a single inner loop can be interchanged.
+   */
+  auto loopNode = LDI->getLoopHierarchyStructures();
+  auto children = loopNode->getChildren();
+  if (children.size() != 1) {
+    return false;
+  }
+  auto innerLS = (*children.begin())->getLoop();
+  LoopInterchange li;
+  if (!li.canInterchangeLoops(*LDI, innerLS)) {
+    return false;
+  }
+
+  /*
+   * We prefer the parallel loop to be the outermost one.
+   */
+  DOALL doall{ par };
+  auto innerLDI = par.getLoop(innerLS);
+  auto isOuterDOALL = doall.canBeAppliedToLoop(LDI, nullptr);
+  auto isInnerDOALL = doall.canBeAppliedToLoop(innerLDI, nullptr);
+  if (isOuterDOALL && (!isInnerDOALL)) {
+    return false;
+  }
+
+  /*
+   * Among the orders that keep the parallel loop outermost, we prefer the one
+   * where most memory accesses of the innermost loop are unit-stride.
+   */
+  if (isOuterDOALL == isInnerDOALL) {
+    auto unitStrideAccesses =
+        li.getNumberOfAccessesIndexedInTheInnermostDimension(*LDI, innerLS);
+    auto unitStrideAccessesAfterInterchange =
+        li.getNumberOfAccessesIndexedInTheInnermostDimension(
+            *LDI,
+            LDI->getLoopStructure());
+    if (unitStrideAccessesAfterInterchange <= unitStrideAccesses) {
+      return false;
+    }
+  }
+
+  /*
+   * Interchange the loops.
+   */
+  auto modified = loopTransformer.interchangeLoops(LDI, innerLS);
+
+  return modified;
+}
+
+bool EnablersManager::applyLoopCollapse(LoopDependenceInfo *LDI,
+                                        Noelle &par,
+                                        LoopTransformer &loopTransformer) {
+
+  /*
+   * Only loop nests with a single inner loop can be collapsed.
+   */
+  auto loopNode = LDI->getLoopHierarchyStructures();
+  auto children = loopNode->getChildren();
+  if (children.size() != 1) {
+    return false;
+  }
+  auto innerLS = (*children.begin())->getLoop();
+  LoopCollapse lc;
+  if (!lc.canCollapseLoops(*LDI, innerLS)) {
+    return false;
+  }
+
+  /*
+   * Collapsing is useful only if both loops can be parallelized by DOALL.
+   */
+  DOALL doall{ par };
+  if (!doall.canBeAppliedToLoop(LDI, nullptr)) {
+    return false;
+  }
+  auto innerLDI = par.getLoop(innerLS);
+  auto isInnerDOALL = doall.canBeAppliedToLoop(innerLDI, nullptr);
+  if (!isInnerDOALL) {
+    return false;
+  }
+
+  /*
+   * Collapsing is useful only if the outer loop does not have enough
+   * iterations to keep all cores busy.
+   */
+  auto ltm = LDI->getLoopTransformationsManager();
+  auto cores = ltm->getMaximumNumberOfCores();
+  auto outerLS = LDI->getLoopStructure();
+  if (LDI->doesHaveCompileTimeKnownTripCount()) {
+    if (LDI->getCompileTimeTripCount() >= cores) {
+      return false;
+    }
+
+  } else {
+    auto profiles = par.getProfiles();
+    if (!profiles->isAvailable()) {
+      return false;
+    }
+    if (profiles->getAverageLoopIterationsPerInvocation(outerLS) >= cores) {
+      return false;
+    }
+  }
+
+  /*
+   * Collapse the loops.
+   */
+  auto modified = loopTransformer.collapseLoops(LDI, innerLS);
+
+  return modified;
+}
+
+bool EnablersManager::applyLoopTiling(LoopDependenceInfo *LDI,
+                                      Noelle &par,
+                                      LoopTransformer &loopTransformer) {
+
+  /*
+   * Only loop nests with a single inner loop can be tiled.
+   */
+  auto loopNode = LDI->getLoopHierarchyStructures();
+  auto children = loopNode->getChildren();
+  if (children.size() != 1) {
+    return false;
+  }
+  auto innerLS = (*children.begin())->getLoop();
+
+  /*
+   * Tiling is useful only if the outer loop reads again the data read by the
+   * inner loop, and the inner loop reads more data than a tile.
+   */
+  LoopTiling lt;
+  if (!lt.isDataReusedAcrossOuterIterations(*LDI, innerLS)) {
+    return false;
+  }
+  auto innerLDI = par.getLoop(innerLS);
+  auto isInnerLoopSmall =
+      innerLDI->doesHaveCompileTimeKnownTripCount()
+      && (innerLDI->getCompileTimeTripCount() <= this->tileSize);
+  if (isInnerLoopSmall) {
+    return false;
+  }
+
+  /*
+   * Tile the inner loop.
+   */
+  auto modified = loopTransformer.tileLoop(LDI, innerLS, this->tileSize);
+
+  return modified;
+}
+
 bool EnablersManager::applyDevirtualizer(LoopDependenceInfo *LDI,
                                          Noelle &par,
                                          LoopTransformer &lt) {
@@ -149,6 +149,14 @@ bool EnablersManager::runOnModule(Module &M) {
                                                   scevSimplification);
       modified |= modifiedFunctions[f];
 
+      /*
+       * The LDIs of the loops of @f are not valid anymore if @f has been
+       * modified.
+       */
+      if (modifiedFunctions[f]) {
+        noelle.invalidateLoops(f);
+      }
+
       return false;
     };
     tree->visitPostOrder(f);
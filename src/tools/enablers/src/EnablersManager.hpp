@@ -47,6 +47,7 @@ private:
    * Fields
    */
   bool enableEnablers;
+  uint64_t tileSize;
 
   /*
    * Methods
@@ -68,6 +69,22 @@ private:
                              Noelle &par,
                              LoopTransformer &LoopTransformer);
 
+  bool applyLoopFusion(LoopDependenceInfo *LDI,
+                       Noelle &par,
+                       LoopTransformer &LoopTransformer);
+
+  bool applyLoopInterchange(LoopDependenceInfo *LDI,
+                            Noelle &par,
+                            LoopTransformer &LoopTransformer);
+
+  bool applyLoopCollapse(LoopDependenceInfo *LDI,
+                         Noelle &par,
+                         LoopTransformer &LoopTransformer);
+
+  bool applyLoopTiling(LoopDependenceInfo *LDI,
+                       Noelle &par,
+                       LoopTransformer &LoopTransformer);
+
   bool applyDevirtualizer(LoopDependenceInfo *LDI,
                           Noelle &par,
                           LoopTransformer &lt);
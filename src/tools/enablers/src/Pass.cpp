@@ -28,10 +28,19 @@ static cl::opt<bool> DisableEnablers("noelle-disable-enablers",
                                      cl::ZeroOrMore,
                                      cl::Hidden,
                                      cl::desc("Disable all enablers"));
+static cl::opt<int> TileSize(
+    "noelle-loop-tiling-size",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc("Number of iterations of the inner loop per tile (default: 32)"));
 
 bool EnablersManager::doInitialization(Module &M) {
   this->enableEnablers =
       (DisableEnablers.getNumOccurrences() == 0) ? true : false;
+  this->tileSize = 32;
+  if (TileSize.getNumOccurrences() > 0) {
+    this->tileSize = TileSize.getValue();
+  }
 
   return false;
 }
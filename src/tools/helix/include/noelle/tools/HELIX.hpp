@@ -136,7 +136,17 @@ protected:
 
   virtual void computeAndCachePointerOfFutureSequentialSegment(
       HELIXTask *helixTask,
-      uint32_t ssID);
+      uint32_t ssID,
+      uint32_t distance,
+      uint32_t numberOfSequentialSegments);
+
+  uint32_t computeSynchronizationDistance(LoopDependenceInfo *LDI,
+                                          SequentialSegment *ss);
+
+  void injectInitialSignalsOfDistantSequentialSegments(
+      HELIXTask *helixTask,
+      std::vector<SequentialSegment *> *sss,
+      std::vector<uint32_t> &ssDistances);
 
   virtual Value *getPointerOfSequentialSegment(HELIXTask *helixTask,
                                                Value *ssArray,
@@ -51,9 +51,12 @@ void HELIX::addChunkFunctionExecutionAsideOriginalLoop(
   /*
    * Fetch the number of cores
    */
+  IRBuilder<> helixBuilder(this->entryPointOfParallelizedLoop);
   auto ltm = LDI->getLoopTransformationsManager();
-  auto numCores =
-      ConstantInt::get(this->noelle.int64, ltm->getMaximumNumberOfCores());
+  auto numCores = this->getNumberOfCoresToUse(
+      helixBuilder,
+      LDI,
+      ConstantInt::get(this->noelle.int64, ltm->getMaximumNumberOfCores()));
 
   /*
    * Fetch the chunk size.
@@ -64,7 +67,6 @@ void HELIX::addChunkFunctionExecutionAsideOriginalLoop(
   /*
    * Call the function that incudes the parallelized loop.
    */
-  IRBuilder<> helixBuilder(this->entryPointOfParallelizedLoop);
   auto runtimeCall = helixBuilder.CreateCall(
       this->taskDispatcherSS,
       ArrayRef<Value *>({ (Value *)tasks[0]->getTaskBody(),
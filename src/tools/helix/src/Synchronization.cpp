@@ -20,6 +20,7 @@
  OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "noelle/core/Architecture.hpp"
+#include "noelle/core/LoopCarriedDependencies.hpp"
 #include "noelle/tools/HELIX.hpp"
 
 namespace llvm::noelle {
@@ -85,6 +86,23 @@ void HELIX::addSynchronizations(LoopDependenceInfo *LDI,
     }
   }
 
+  /*
+   * Compute the iteration distance each sequential segment synchronizes with.
+   * The preamble decides whether the next iteration runs, so it always
+   * synchronizes with the previous iteration.
+   */
+  std::vector<uint32_t> ssDistances{};
+  for (auto ss : *sss) {
+    auto distance = (ss == preambleSS)
+                        ? 1
+                        : this->computeSynchronizationDistance(LDI, ss);
+    ssDistances.push_back(distance);
+    if ((distance > 1) && (this->verbose != Verbosity::Disabled)) {
+      errs() << "HELIX:   Sequential segment " << ss->getID()
+             << " synchronizes with iteration i-" << distance << "\n";
+    }
+  }
+
   /*
    * Fetch sequential segments entry in the past and future array
    * Allocate space to track sequential segment entry state
@@ -92,8 +110,11 @@ void HELIX::addSynchronizations(LoopDependenceInfo *LDI,
   std::vector<Value *> ssStates{};
   for (auto ss : *sss) {
     this->computeAndCachePointerOfPastSequentialSegment(helixTask, ss->getID());
-    this->computeAndCachePointerOfFutureSequentialSegment(helixTask,
-                                                          ss->getID());
+    this->computeAndCachePointerOfFutureSequentialSegment(
+        helixTask,
+        ss->getID(),
+        ssDistances.at(ss->getID()),
+        sss->size());
 
     /*
      * We must execute exactly one wait instruction for each sequential segment,
@@ -379,6 +400,132 @@ void HELIX::addSynchronizations(LoopDependenceInfo *LDI,
     }
   }
 
+  /*
+   * Release the first iterations of the sequential segments that synchronize
+   * with iterations further than the previous one.
+   */
+  this->injectInitialSignalsOfDistantSequentialSegments(helixTask,
+                                                        sss,
+                                                        ssDistances);
+
+  return;
+}
+
+uint32_t HELIX::computeSynchronizationDistance(LoopDependenceInfo *LDI,
+                                               SequentialSegment *ss) {
+
+  /*
+   * Fetch the loop.
+   */
+  auto loopNode = LDI->getLoopHierarchyStructures();
+  auto loopStructure = LDI->getLoopStructure();
+  auto loopDG = LDI->getLoopDG();
+  auto ssInstructions = ss->getInstructions();
+
+  /*
+   * The sequential segment can overlap across iterations closer than the
+   * shortest distance of the loop-carried dependences it is involved in.
+   * Only memory dependences with a known distance between instructions of the
+   * sequential segment can relax the synchronization.
+   */
+  uint32_t distance = 0;
+  for (auto dep : LoopCarriedDependencies::getLoopCarriedDependenciesForLoop(
+           *loopStructure,
+           loopNode,
+           *loopDG)) {
+    auto fromInst = dyn_cast<Instruction>(dep->getOutgoingT());
+    auto toInst = dyn_cast<Instruction>(dep->getIncomingT());
+    auto isFromInSS =
+        (fromInst != nullptr) && (ssInstructions.count(fromInst) > 0);
+    auto isToInSS = (toInst != nullptr) && (ssInstructions.count(toInst) > 0);
+    if (!isFromInSS && !isToInSS) {
+      continue;
+    }
+    if (!isFromInSS || !isToInSS || dep->isControlDependence()
+        || !dep->isMemoryDependence() || (dep->getDependenceDistance() == 0)) {
+      return 1;
+    }
+    auto depDistance = dep->getDependenceDistance();
+    distance = (distance == 0) ? depDistance : std::min(distance, depDistance);
+  }
+  if (distance == 0) {
+    return 1;
+  }
+
+  /*
+   * Every core must always synchronize with the same other core, so the
+   * distance must divide the number of cores.
+   */
+  while ((this->numTaskInstances % distance) != 0) {
+    distance--;
+  }
+
+  return distance;
+}
+
+void HELIX::injectInitialSignalsOfDistantSequentialSegments(
+    HELIXTask *helixTask,
+    std::vector<SequentialSegment *> *sss,
+    std::vector<uint32_t> &ssDistances) {
+
+  /*
+   * Check if there is a sequential segment to release.
+   */
+  auto maxDistance = 1u;
+  for (auto distance : ssDistances) {
+    maxDistance = std::max(maxDistance, distance);
+  }
+  if (maxDistance == 1) {
+    return;
+  }
+
+  /*
+   * Fetch the types.
+   */
+  auto tm = this->noelle.getTypesManager();
+  auto int64 = tm->getIntegerType(64);
+
+  /*
+   * Only the runtime lock of core 0 starts released.
+   * Cores 1 to d-1 run iterations 1 to d-1, which have no iteration d earlier
+   * to wait for, so they release their own lock once at the beginning of the
+   * task.
+   */
+  auto entryTerminator = helixTask->getEntry()->getTerminator();
+  for (auto ss : *sss) {
+    auto distance = ssDistances.at(ss->getID());
+    if (distance == 1) {
+      continue;
+    }
+
+    /*
+     * Compute the distance used by the current invocation.
+     */
+    IRBuilder<> entryBuilder(entryTerminator);
+    auto distanceValue = ConstantInt::get(int64, distance);
+    auto isDistanceUsable = entryBuilder.CreateICmpEQ(
+        entryBuilder.CreateSRem(helixTask->numCoresArg, distanceValue),
+        ConstantInt::get(int64, 0));
+    auto effectiveDistance =
+        entryBuilder.CreateSelect(isDistanceUsable,
+                                  distanceValue,
+                                  ConstantInt::get(int64, 1));
+    auto isFirstIterationFree = entryBuilder.CreateAnd(
+        entryBuilder.CreateICmpSGT(helixTask->coreArg,
+                                   ConstantInt::get(int64, 0)),
+        entryBuilder.CreateICmpSLT(helixTask->coreArg, effectiveDistance));
+
+    /*
+     * Release the lock.
+     */
+    auto releaseTerminator =
+        SplitBlockAndInsertIfThen(isFirstIterationFree, entryTerminator, false);
+    IRBuilder<> releaseBuilder(releaseTerminator);
+    auto pastPtr = this->ssPastPtrs.at(ss->getID());
+    auto signal = releaseBuilder.CreateCall(this->signalSSCall, { pastPtr });
+    helixTask->signals.insert(signal);
+  }
+
   return;
 }
 
@@ -464,7 +611,9 @@ void HELIX::computeAndCachePointerOfPastSequentialSegment(HELIXTask *helixTask,
 
 void HELIX::computeAndCachePointerOfFutureSequentialSegment(
     HELIXTask *helixTask,
-    uint32_t ssID) {
+    uint32_t ssID,
+    uint32_t distance,
+    uint32_t numberOfSequentialSegments) {
 
   /*
    * Compute the pointer.
@@ -473,6 +622,42 @@ void HELIX::computeAndCachePointerOfFutureSequentialSegment(
                                                  helixTask->ssFutureArrayArg,
                                                  ssID);
 
+  /*
+   * Sequential segments that synchronize with iteration i-d signal the core
+   * that runs iteration i+d, which is d cores ahead.
+   * The runtime lays out the sequential segment arrays of the cores one after
+   * the other, so the entry of that core is at a constant stride from the
+   * entry of the current core.
+   * If the distance does not divide the number of cores of the current
+   * invocation, fall back to the next core.
+   */
+  if (distance > 1) {
+    IRBuilder<> entryBuilder{ helixTask->getEntry()->getTerminator() };
+    auto tm = this->noelle.getTypesManager();
+    auto int64 = tm->getIntegerType(64);
+    auto distanceValue = ConstantInt::get(int64, distance);
+    auto isDistanceUsable = entryBuilder.CreateICmpEQ(
+        entryBuilder.CreateSRem(helixTask->numCoresArg, distanceValue),
+        ConstantInt::get(int64, 0));
+    auto effectiveDistance =
+        entryBuilder.CreateSelect(isDistanceUsable,
+                                  distanceValue,
+                                  ConstantInt::get(int64, 1));
+    auto futureCore = entryBuilder.CreateSRem(
+        entryBuilder.CreateAdd(helixTask->coreArg, effectiveDistance),
+        helixTask->numCoresArg);
+    auto ssArraySize =
+        numberOfSequentialSegments * Architecture::getCacheLineBytes();
+    auto futureOffset = entryBuilder.CreateMul(
+        entryBuilder.CreateSub(futureCore, helixTask->coreArg),
+        ConstantInt::get(int64, ssArraySize));
+    auto pastPtr = this->ssPastPtrs.at(ssID);
+    auto futureEntryAsInt =
+        entryBuilder.CreateAdd(entryBuilder.CreatePtrToInt(pastPtr, int64),
+                               futureOffset);
+    ptr = entryBuilder.CreateIntToPtr(futureEntryAsInt, pastPtr->getType());
+  }
+
   /*
    * Cache the pointer.
    */
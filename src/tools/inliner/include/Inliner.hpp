@@ -48,8 +48,34 @@ public:
   void getAnalysisUsage(AnalysisUsage &AU) const override;
 
 private:
+  /*
+   * Call site that can be inlined, ranked by the benefit of inlining it per
+   * instruction added to the program.
+   */
+  struct InliningCandidate {
+    WeakVH call;
+    Function *caller;
+    double benefit;
+    uint64_t cost;
+
+    double getPriority(void) const;
+  };
+
+  struct InliningCandidateCompare {
+    bool operator()(const InliningCandidate &a,
+                    const InliningCandidate &b) const;
+  };
+
   uint32_t maxNumberOfFunctionCallsToInlinePerLoop;
-  uint32_t maxProgramInstructions;
+  uint64_t maxCallerInstructions;
+
+  /*
+   * Code growth allowed per invocation of the inliner (number of
+   * instructions).
+   */
+  uint32_t codeGrowthPercentage;
+  uint64_t minimumBudget;
+  uint64_t budget;
 
   /*
    * Inlining procedure
@@ -58,11 +84,14 @@ private:
   bool registerRemainingLoops(std::string filename);
   bool inlineCallsInvolvedInLoopCarriedDataDependences(Noelle &noelle,
                                                        noelle::CallGraph *pcg);
-  bool inlineCallsInvolvedInLoopCarriedDataDependencesWithinLoop(
+  void collectCallsInvolvedInLoopCarriedDataDependencesWithinLoop(
       Function *F,
       LoopDependenceInfo *LDI,
       noelle::CallGraph *pcg,
-      Noelle &noelle);
+      Noelle &noelle,
+      std::vector<InliningCandidate> &candidates);
+  bool inlineCandidatesWithinBudget(Hot *p,
+                                    std::vector<InliningCandidate> &candidates);
 
   void getFunctionsToInline(std::string filename);
 
@@ -82,7 +111,7 @@ private:
 
   int getNextPreorderLoopAfter(Function *F, CallInst *call);
   void adjustLoopOrdersAfterInline(Function *F, Function *childF, int nextLoop);
-  void adjustFnGraphAfterInline(Function *F, Function *childF, int callInd);
+  void adjustFnGraphAfterInline(Function *F);
 
   /*
    * Function and loop order tracking
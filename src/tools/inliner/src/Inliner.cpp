@@ -26,7 +26,10 @@ namespace llvm::noelle {
 Inliner::Inliner()
   : ModulePass{ ID },
     maxNumberOfFunctionCallsToInlinePerLoop{ 10 },
-    maxProgramInstructions{ 50000 },
+    maxCallerInstructions{ 1000 },
+    codeGrowthPercentage{ 10 },
+    minimumBudget{ 5000 },
+    budget{ 0 },
     fnsAffected{},
     parentFns{},
     childrenFns{},
@@ -68,17 +71,16 @@ bool Inliner::runOnModule(Module &M) {
   }
 
   /*
-   * Check if the program is already too big
+   * Compute the code growth allowed for this invocation.
    */
   auto programInstructions = noelle.numberOfProgramInstructions();
   errs()
       << "Inliner:   Number of program instructions = " << programInstructions
       << "\n";
-  if (programInstructions >= this->maxProgramInstructions) {
-    errs()
-        << "Inliner:     There are too many instructions. We'll not inline anything\n";
-    return false;
-  }
+  this->budget = std::max(
+      this->minimumBudget,
+      (programInstructions * this->codeGrowthPercentage) / 100);
+  errs() << "Inliner:   Budget = " << this->budget << " instructions\n";
 
   /*
    * Fetch the call graph.
@@ -415,23 +417,29 @@ bool Inliner::inlineFunctionCall(Hot *p,
   assert(p != nullptr);
 
   /*
-   * Prevent inlining a call within a function already altered by inlining
+   * Avoid inlininig recursive calls.
    */
-  if (fnsAffected.find(F) != fnsAffected.end()) {
+  if (!canInlineWithoutRecursiveLoop(F, childF)) {
     return false;
   }
 
   /*
-   * Avoid inlininig recursive calls.
+   * Avoid inlining into a function that is too big.
    */
-  if (!canInlineWithoutRecursiveLoop(F, childF)) {
+  if (p->getStaticInstructions(F) > this->maxCallerInstructions) {
     return false;
   }
 
   /*
-   * Avoid inlining into a function that is too big.
+   * Check the budget.
    */
-  if (p->getStaticInstructions(F) > 1000) {
+  auto cost = p->getStaticInstructions(childF);
+  if (cost > this->budget) {
+    if (this->verbose != Verbosity::Disabled) {
+      errs() << "Inliner:   Inlining " << childF->getName() << " into "
+             << F->getName() << " exceeds the remaining budget ("
+             << this->budget << " instructions)\n";
+    }
     return false;
   }
 
@@ -447,18 +455,18 @@ bool Inliner::inlineFunctionCall(Hot *p,
     errs() << "\n";
   }
   int loopIndAfterCall = getNextPreorderLoopAfter(F, call);
-  auto &parentCalls = orderedCalls[F];
-  auto callInd = std::find(parentCalls.begin(), parentCalls.end(), call)
-                 - parentCalls.begin();
 
   /*
    * Inline the call.
+   * The call graph is updated by the inliner.
    */
-  InlineFunctionInfo IFI;
+  auto &callGraph = getAnalysis<CallGraphWrapperPass>().getCallGraph();
+  InlineFunctionInfo IFI(&callGraph);
   if (InlineFunction(call, IFI)) {
     fnsAffected.insert(F);
+    this->budget -= cost;
     adjustLoopOrdersAfterInline(F, childF, loopIndAfterCall);
-    adjustFnGraphAfterInline(F, childF, callInd);
+    adjustFnGraphAfterInline(F);
     return true;
   }
   return false;
@@ -524,42 +532,24 @@ void Inliner::adjustLoopOrdersAfterInline(Function *parentF,
   }
 }
 
-// NOTE(joe) This function doesn't correctly adjust Function Graph, since the
-// function used to compute childrenFns and parentFns [collectFnGraph] and
-// therefore depthOrdered and fnOrder [in collectInDepthOrderFns] doesn't take
-// into account the defferent function that never got an order. This causes the
-// number to be out between successive iterations of this inliner.
-void Inliner::adjustFnGraphAfterInline(Function *parentF,
-                                       Function *childF,
-                                       int callInd) {
-  auto &parentCalled = orderedCalled[parentF];
-  auto &childCalled = orderedCalled[childF];
-
-  parentCalled.erase(parentCalled.begin() + callInd);
-  if (!childCalled.empty()) {
-    auto childCallCount = childCalled.size();
-    auto endInsertAt = callInd + childCallCount;
-
-    // Shift over calls after the inlined call to make room for called
-    // function's calls
-    parentCalled.resize(parentCalled.size() + childCallCount);
-    for (auto shiftIndex = parentCalled.size() - 1; shiftIndex >= endInsertAt;
-         --shiftIndex) {
-      parentCalled[shiftIndex] = parentCalled[shiftIndex - childCallCount];
-    }
+void Inliner::adjustFnGraphAfterInline(Function *parentF) {
 
-    // Insert the called function's calls starting from the position of the
-    // inlined call
-    for (auto childIndex = callInd; childIndex < endInsertAt; ++childIndex) {
-      parentCalled[childIndex] = childCalled[childIndex - callInd];
-    }
+  /*
+   * The call graph has been updated by the inliner.
+   * Refresh the calls of the function inlined within.
+   */
+  auto &callGraph = getAnalysis<CallGraphWrapperPass>().getCallGraph();
+  for (auto F : childrenFns[parentF]) {
+    parentFns[F].erase(parentF);
   }
+  collectFnCallsAndCalled(callGraph, parentF);
 
-  // Readjust function graph of the function inlined within
+  /*
+   * Readjust function graph of the function inlined within
+   */
   std::set<Function *> reached;
   childrenFns[parentF].clear();
-  parentFns[childF].erase(parentF);
-  for (auto F : parentCalled) {
+  for (auto F : orderedCalled[parentF]) {
     if (reached.find(F) != reached.end())
       continue;
     reached.insert(F);
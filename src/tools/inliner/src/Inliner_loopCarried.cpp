@@ -27,7 +27,6 @@ namespace llvm::noelle {
 bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependences(
     Noelle &noelle,
     noelle::CallGraph *pcg) {
-  auto anyInlined = false;
 
   /*
    * Order these functions to prevent duplicating loops yet to be checked
@@ -38,20 +37,12 @@ bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependences(
   }
   sortInDepthOrderFns(orderedFns);
 
-  std::set<Function *> fnsToAvoid;
+  /*
+   * Collect the candidates of all enabled loops of the program.
+   */
+  std::vector<InliningCandidate> candidates;
   for (auto F : orderedFns) {
 
-    /*
-     * If we avoid this function until next pass, we do the same with its
-     * parents
-     */
-    if (fnsToAvoid.find(F) != fnsToAvoid.end()) {
-      for (auto parentF : parentFns[F]) {
-        fnsToAvoid.insert(parentF);
-      }
-      continue;
-    }
-
     /*
      * Fetch all loops of the current function.
      */
@@ -69,11 +60,9 @@ bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependences(
     auto &toCheck = loopsToCheck[F];
 
     /*
-     * Inline calls that are involved in loop-carried data dependences for the
+     * Collect calls that are involved in loop-carried data dependences for the
      * enabled loops.
      */
-    auto inlined = false;
-    std::set<LoopStructure *> removeSummaries;
     for (auto LDI : *allLoops) {
 
       /*
@@ -131,58 +120,110 @@ bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependences(
       }
 
       /*
-       * Inline the call.
+       * Collect the calls of the current loop.
        */
-      auto inlinedCall =
-          this->inlineCallsInvolvedInLoopCarriedDataDependencesWithinLoop(
-              F,
-              LDI,
-              pcg,
-              noelle);
-      inlined |= inlinedCall;
-      if (inlined) {
-        break;
-      }
+      this->collectCallsInvolvedInLoopCarriedDataDependencesWithinLoop(
+          F,
+          LDI,
+          pcg,
+          noelle,
+          candidates);
     }
 
     /*
      * Free the memory.
      */
-    for (auto tempLDI : *allLoops) {
-      delete tempLDI;
-    }
     delete allLoops;
+  }
+  if (this->verbose != Verbosity::Disabled) {
+    errs() << "Inliner:   " << candidates.size()
+           << " calls are involved in loop-carried data dependences\n";
+  }
+
+  /*
+   * Inline the most profitable calls until the budget runs out.
+   */
+  auto anyInlined =
+      this->inlineCandidatesWithinBudget(noelle.getProfiles(), candidates);
+
+  /*
+   * Inlining modifies the callers and it can remove callees.
+   * Hence, the LDIs computed so far are not valid anymore.
+   */
+  if (anyInlined) {
+    noelle.invalidateLoops();
+  }
+
+  return anyInlined;
+}
+
+bool Inliner::inlineCandidatesWithinBudget(
+    Hot *p,
+    std::vector<InliningCandidate> &candidates) {
+  assert(p != nullptr);
+
+  /*
+   * Sort the candidates by benefit per instruction added to the program.
+   */
+  std::priority_queue<InliningCandidate,
+                      std::vector<InliningCandidate>,
+                      InliningCandidateCompare>
+      worklist(candidates.begin(), candidates.end());
+
+  /*
+   * Inline the candidates.
+   */
+  auto anyInlined = false;
+  while (!worklist.empty() && (this->budget > 0)) {
+    auto candidate = worklist.top();
+    worklist.pop();
 
     /*
-     * Keep track of the inlining.
+     * Check if the call still exists.
+     * A call may be removed by the inlining of a previous candidate.
      */
-    anyInlined |= inlined;
+    Value *callValue = candidate.call;
+    if (callValue == nullptr) {
+      continue;
+    }
+    auto call = cast<CallInst>(callValue);
+    auto callee = call->getCalledFunction();
+    if ((callee == nullptr) || (call->getFunction() != candidate.caller)) {
+      continue;
+    }
 
     /*
-     * Avoid parents of affected functions.
-     * This is because we are not finished with the affected functions.
+     * Inline the call.
+     * The callee might have grown because of previous inlinings; the cost is
+     * recomputed and checked against the remaining budget by the inliner.
      */
-    if (inlined) {
-      for (auto parentF : parentFns[F]) {
-        fnsToAvoid.insert(parentF);
-      }
-    }
+    anyInlined |= this->inlineFunctionCall(p, candidate.caller, callee, call);
   }
 
   return anyInlined;
 }
 
+double Inliner::InliningCandidate::getPriority(void) const {
+  return this->benefit / std::max<double>(this->cost, 1);
+}
+
+bool Inliner::InliningCandidateCompare::operator()(
+    const InliningCandidate &a,
+    const InliningCandidate &b) const {
+  return a.getPriority() < b.getPriority();
+}
+
 /*
  * GOAL: Go through loops in function
- * If there is only one non-clonable/reducable SCC,
- * try inlining the function call in that SCC with the
- * most memory edges to other internal/external values
+ * Collect the function calls of sequential SCCs that are involved in
+ * memory dependences as inlining candidates
  */
-bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependencesWithinLoop(
+void Inliner::collectCallsInvolvedInLoopCarriedDataDependencesWithinLoop(
     Function *F,
     LoopDependenceInfo *LDI,
     noelle::CallGraph *pcg,
-    Noelle &noelle) {
+    Noelle &noelle,
+    std::vector<InliningCandidate> &candidates) {
   assert(pcg != nullptr);
   assert(LDI != nullptr);
 
@@ -202,17 +243,26 @@ bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependencesWithinLoop(
   auto SCCDAG = sccManager->getSCCDAG();
 
   /*
-   *inlineFunctionCall Fetch the loop structure.
+   * Fetch the loop structure.
    */
   auto loopStructure = LDI->getLoopStructure();
   auto loopStructureNode = LDI->getLoopHierarchyStructures();
 
+  /*
+   * Weight the benefit of removing a dependence by how hot the loop is.
+   */
+  double loopWeight = 1;
+  if (hot->isAvailable()) {
+    loopWeight = std::max<double>(
+        1,
+        hot->getTotalInstructions(loopStructure));
+  }
+
   /*
    * Check every sequential SCC.
    */
-  int64_t maxMemEdges = 0;
   uint32_t numberOfFunctionCallsToInline = 0;
-  CallInst *inlineCall = nullptr;
+  std::vector<InliningCandidate> loopCandidates;
   auto nonDOALLSCCs = DOALL::getSCCsThatBlockDOALLToBeApplicable(LDI, noelle);
   for (auto scc : nonDOALLSCCs) {
 
@@ -319,31 +369,23 @@ bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependencesWithinLoop(
       }
 
       /*
-       * Consider only the call instruction with the maximum number of memory
-       * edges. Also, consider only calls to functions that are smaller than the
-       * current loop size.
+       * Consider only calls involved in memory dependences to functions that
+       * are smaller than the current loop size.
        */
       numberOfFunctionCallsToInline++;
-      if ((memEdgeCount > maxMemEdges)
+      if ((memEdgeCount > 0)
           && (hot->getStaticInstructions(callF)
               < hot->getStaticInstructions(loopStructure))) {
-        maxMemEdges = memEdgeCount;
-        inlineCall = call;
+        InliningCandidate candidate;
+        candidate.call = call;
+        candidate.caller = F;
+        candidate.benefit = memEdgeCount * loopWeight;
+        candidate.cost = hot->getStaticInstructions(callF);
+        loopCandidates.push_back(candidate);
       }
     }
   }
 
-  /*
-   * Check if there is a function to inline.
-   */
-  if (inlineCall == nullptr) {
-
-    /*
-     * No call needs to be inlined.
-     */
-    return false;
-  }
-
   /*
    * Check if there are too many loop-carried data dependences related to
    * function calls.
@@ -355,16 +397,17 @@ bool Inliner::inlineCallsInvolvedInLoopCarriedDataDependencesWithinLoop(
         << *loopStructure->getHeader()->getFirstNonPHI()
         << " has too many function calls involved in loop-carried data dependences (there are "
         << numberOfFunctionCallsToInline << ")\n";
-    return false;
+    return;
   }
 
   /*
-   * Inline the call instruction.
+   * Add the candidates of the loop.
    */
-  auto inlined =
-      inlineFunctionCall(hot, F, inlineCall->getCalledFunction(), inlineCall);
+  candidates.insert(candidates.end(),
+                    loopCandidates.begin(),
+                    loopCandidates.end());
 
-  return inlined;
+  return;
 }
 
 } // namespace llvm::noelle
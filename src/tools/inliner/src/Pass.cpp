@@ -32,9 +32,24 @@ static cl::opt<int> Verbose(
     cl::ZeroOrMore,
     cl::Hidden,
     cl::desc("Verbose output (0: disabled, 1: minimal, 2: maximal"));
+static cl::opt<int> CodeGrowthBudget(
+    "noelle-inliner-budget",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::init(10),
+    cl::desc("Maximum code growth per invocation of the inliner as percentage "
+             "of the program instructions"));
+static cl::opt<int> MaxCallerInstructions(
+    "noelle-inliner-max-caller-instructions",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::init(1000),
+    cl::desc("Do not inline into functions bigger than this"));
 
 bool Inliner::doInitialization(Module &M) {
   this->verbose = static_cast<Verbosity>(Verbose.getValue());
+  this->codeGrowthPercentage = CodeGrowthBudget.getValue();
+  this->maxCallerInstructions = MaxCallerInstructions.getValue();
 
   return false;
 }
@@ -29,14 +29,17 @@ void LoopStats::collectStatsOnLLVMSCCs(Hot *profiles,
                                        Stats *statsForLoop) {
 
   /*
-   * Construct loop internal SCCDAG (it uses LLVM's scc_iterator)
+   * Construct loop internal SCCDAG.
+   *
+   * A view of the loop dependence graph is enough as the SCCDAG copies the
+   * nodes and edges it needs.
    */
   std::vector<Value *> loopInternals;
   for (auto internalNode : loopDG->internalNodePairs()) {
     loopInternals.push_back(internalNode.first);
   }
-  auto loopInternalDG = loopDG->createSubgraphFromValues(loopInternals, false);
-  auto loopInternalSCCDAG = SCCDAG(loopInternalDG);
+  PDGSubgraphView loopInternalDG(loopDG, loopInternals, false);
+  auto loopInternalSCCDAG = SCCDAG(&loopInternalDG);
   collectStatsOnSCCDAG(profiles,
                        &loopInternalSCCDAG,
                        nullptr,
@@ -64,8 +67,8 @@ void LoopStats::collectStatsOnNoelleSCCs(Hot *profiles,
   for (auto internalNode : loopDG->internalNodePairs()) {
     loopInternals.push_back(internalNode.first);
   }
-  auto loopInternalDG = loopDG->createSubgraphFromValues(loopInternals, false);
-  auto loopInternalSCCDAG = SCCDAG(loopInternalDG);
+  PDGSubgraphView loopInternalDG(loopDG, loopInternals, false);
+  auto loopInternalSCCDAG = SCCDAG(&loopInternalDG);
 
   auto loopHierarchy = LDI.getLoopHierarchyStructures();
   auto loopFunction = loopStructure->getFunction();
@@ -95,6 +95,29 @@ void Planner::removeLoopsNotWorthParallelizing(Noelle &noelle,
         return true;
       }
 
+      /*
+       * Check the number of iterations of the typical invocation.
+       * The average can be high because of few long invocations while most
+       * invocations only execute few iterations.
+       */
+      auto iterationsHistogram =
+          profiles->getIterationsPerInvocationHistogram(ls);
+      if (iterationsHistogram != nullptr) {
+        auto medianIterations = iterationsHistogram->getPercentile(50);
+        if (medianIterations < averageIterationThreshold) {
+          errs() << "Planner:    Loop " << loopID << " has "
+                 << medianIterations
+                 << " number of iterations in its median invocation\n";
+          errs() << "Planner:      It is too low. The threshold is "
+                 << averageIterationThreshold << "\n";
+
+          /*
+           * Remove the loop.
+           */
+          return true;
+        }
+      }
+
       /*
        * Check the minimum hotness
        */
@@ -184,6 +207,20 @@ void Planner::removeLoopsNotWorthParallelizing(Noelle &noelle,
       errs() << prefix
              << "  Average iterations per invocation = " << averageIterations
              << " %\n";
+      auto iterationsHistogram =
+          profiles->getIterationsPerInvocationHistogram(loopStructure);
+      if (iterationsHistogram != nullptr) {
+        errs() << prefix << "  Iterations per invocation (median, 90th "
+               << "percentile) = " << iterationsHistogram->getPercentile(50)
+               << ", " << iterationsHistogram->getPercentile(90) << "\n";
+      }
+      auto instructionsHistogram =
+          profiles->getTotalInstructionsPerIterationHistogram(loopStructure);
+      if (instructionsHistogram != nullptr) {
+        errs() << prefix << "  Instructions per iteration (median, 90th "
+               << "percentile) = " << instructionsHistogram->getPercentile(50)
+               << ", " << instructionsHistogram->getPercentile(90) << "\n";
+      }
       errs() << prefix << "\n";
 
       return false;
@@ -46,6 +46,7 @@ bool Planner::doInitialization(Module &M) {
 
 bool Planner::runOnModule(Module &M) {
   errs() << "Planner: Start\n";
+  CompileTimePhase phase("Planner");
 
   /*
    * Fetch the outputs of the passes we rely on.
@@ -126,13 +127,6 @@ bool Planner::runOnModule(Module &M) {
                       ldiParallelizationOrderIndex);
       modified = true;
     }
-
-    /*
-     * Free the memory.
-     */
-    for (auto loop : loopsToParallelize) {
-      delete loop;
-    }
   }
 
   /*
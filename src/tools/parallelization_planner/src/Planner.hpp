@@ -28,6 +28,7 @@
 #include "noelle/core/SCCDAG.hpp"
 #include "noelle/core/Noelle.hpp"
 #include "noelle/core/MetadataManager.hpp"
+#include "noelle/core/CompileTimeProfiler.hpp"
 #include "noelle/tools/DOALL.hpp"
 
 namespace llvm::noelle {
@@ -45,6 +45,12 @@ public:
 
   uint32_t getIndexOfEnvironmentVariable(uint32_t id) const;
 
+  /*
+   * Return the offset of the environment variable @id within the environment
+   * array (see LoopEnvironmentBuilder::getOffsetOfEnvironmentVariable).
+   */
+  uint64_t getOffsetOfEnvironmentVariable(uint32_t id) const;
+
   BasicBlock *getParLoopEntryPoint(void) const;
 
   BasicBlock *getParLoopExitPoint(void) const;
@@ -65,6 +71,14 @@ public:
 
   virtual std::string getName(void) const = 0;
 
+  /*
+   * Let the runtime choose the number of cores and the chunk size of the
+   * parallelized loop (see NOELLE_getLoopCores and NOELLE_getLoopChunkSize).
+   * The values computed at compile time become the defaults and the upper
+   * bound of the number of cores.
+   */
+  void enableRuntimeConfiguration(void);
+
   /*
    * Destructor.
    */
@@ -193,12 +207,25 @@ protected:
   float computeSequentialFractionOfExecution(
       LoopDependenceInfo *LDI,
       std::function<bool(GenericSCC *scc)> doesItRunSequentially) const;
+
+  /*
+   * Runtime configuration of the parallelized loop.
+   */
+  Value *getNumberOfCoresToUse(IRBuilder<> &builder,
+                               LoopDependenceInfo *LDI,
+                               Value *maximumNumberOfCores);
+
+  Value *getChunkSizeToUse(IRBuilder<> &builder,
+                           LoopDependenceInfo *LDI,
+                           Value *chunkSize);
+
   /*
    * Fields
    */
   Noelle &noelle;
   Verbosity verbose;
   LoopEnvironmentBuilder *envBuilder;
+  bool isRuntimeConfigurable;
 
   /*
    * Parallel task related information.
@@ -206,6 +233,23 @@ protected:
   BasicBlock *entryPointOfParallelizedLoop, *exitPointOfParallelizedLoop;
   std::vector<Task *> tasks;
   uint32_t numTaskInstances;
+
+private:
+  void cloneHeapObjectLocally(LoopDependenceInfo *LDI,
+                              int taskIndex,
+                              ClonableMemoryObject *location,
+                              IRBuilder<> &entryBuilder);
+
+  void makeValueALiveInOfTask(LoopDependenceInfo *LDI,
+                              int taskIndex,
+                              Value *value,
+                              Instruction *consumer,
+                              IRBuilder<> &entryBuilder);
+
+  Value *fetchLoopParameterFromRuntime(IRBuilder<> &builder,
+                                       LoopDependenceInfo *LDI,
+                                       std::string runtimeAPI,
+                                       Value *defaultValue);
 };
 
 } // namespace llvm::noelle
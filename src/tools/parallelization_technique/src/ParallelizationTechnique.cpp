@@ -32,10 +32,79 @@ ParallelizationTechnique::ParallelizationTechnique(Noelle &n)
     envBuilder{ nullptr },
     entryPointOfParallelizedLoop{ nullptr },
     exitPointOfParallelizedLoop{ nullptr },
-    numTaskInstances{ 0 } {
+    numTaskInstances{ 0 },
+    isRuntimeConfigurable{ false } {
   this->verbose = n.getVerbosity();
 }
 
+void ParallelizationTechnique::enableRuntimeConfiguration(void) {
+  this->isRuntimeConfigurable = true;
+
+  return;
+}
+
+Value *ParallelizationTechnique::getNumberOfCoresToUse(
+    IRBuilder<> &builder,
+    LoopDependenceInfo *LDI,
+    Value *maximumNumberOfCores) {
+  return this->fetchLoopParameterFromRuntime(builder,
+                                             LDI,
+                                             "NOELLE_getLoopCores",
+                                             maximumNumberOfCores);
+}
+
+Value *ParallelizationTechnique::getChunkSizeToUse(IRBuilder<> &builder,
+                                                   LoopDependenceInfo *LDI,
+                                                   Value *chunkSize) {
+  return this->fetchLoopParameterFromRuntime(builder,
+                                             LDI,
+                                             "NOELLE_getLoopChunkSize",
+                                             chunkSize);
+}
+
+Value *ParallelizationTechnique::fetchLoopParameterFromRuntime(
+    IRBuilder<> &builder,
+    LoopDependenceInfo *LDI,
+    std::string runtimeAPI,
+    Value *defaultValue) {
+  assert(LDI != nullptr);
+  assert(defaultValue != nullptr);
+
+  /*
+   * Check if the parameter can be chosen at runtime.
+   */
+  if (!this->isRuntimeConfigurable) {
+    return defaultValue;
+  }
+  auto runtimeFunction = this->noelle.getProgram()->getFunction(runtimeAPI);
+  if (runtimeFunction == nullptr) {
+    return defaultValue;
+  }
+
+  /*
+   * Fetch the loop index, which is how the runtime configuration refers to the
+   * loop (see Noelle::getLoopIndex).
+   */
+  auto ls = LDI->getLoopStructure();
+  auto loopIndexOpt = this->noelle.getLoopIndex(ls);
+  if (!loopIndexOpt) {
+    return defaultValue;
+  }
+  auto loopID = ConstantInt::get(this->noelle.int64, loopIndexOpt.value());
+
+  /*
+   * Ask the runtime.
+   */
+  auto runtimeValue = builder.CreateCall(
+      runtimeFunction,
+      ArrayRef<Value *>({ loopID,
+                          builder.CreateZExtOrTrunc(defaultValue,
+                                                    this->noelle.int64) }));
+  auto value = builder.CreateZExtOrTrunc(runtimeValue, defaultValue->getType());
+
+  return value;
+}
+
 Value *ParallelizationTechnique::getEnvArray(void) const {
   assert(this->envBuilder != nullptr);
   return this->envBuilder->getEnvironmentArray();
@@ -50,6 +119,15 @@ uint32_t ParallelizationTechnique::getIndexOfEnvironmentVariable(
   return envVar;
 }
 
+uint64_t ParallelizationTechnique::getOffsetOfEnvironmentVariable(
+    uint32_t id) const {
+  assert(this->envBuilder != nullptr);
+
+  auto offset = this->envBuilder->getOffsetOfEnvironmentVariable(id);
+
+  return offset;
+}
+
 void ParallelizationTechnique::initializeEnvironmentBuilder(
     LoopDependenceInfo *LDI,
     std::set<uint32_t> nonReducableVars) {
@@ -190,9 +268,26 @@ void ParallelizationTechnique::populateLiveInEnvironment(
    */
   auto env = LDI->getEnvironment();
 
+  /*
+   * Fetch the code that computes the pointers to the environment variables.
+   * It is at the beginning of the entry block of the function that includes
+   * the loop, just like the environment array (see allocateEnvironmentArray).
+   */
+  auto loopFunction = LDI->getLoopStructure()->getFunction();
+  auto &entryBlock = loopFunction->getEntryBlock();
+
   /*
    * Store live-in values into the environment just before jumping to the
    * parallelized loop.
+   *
+   * The environment array is allocated once per invocation of the function
+   * that includes the loop, so a live-in that cannot change between
+   * invocations of the loop is stored only once.
+   * This is the case for arguments, globals, and constants (stored when the
+   * environment is created), and for instructions of the entry block (stored
+   * right after they are computed).
+   * Environments are always created at the beginning of the entry block, so
+   * the instructions of the entry block come after them.
    */
   IRBuilder<> builder(this->entryPointOfParallelizedLoop);
   for (auto envID : env->getEnvIDsOfLiveInVars()) {
@@ -215,10 +310,33 @@ void ParallelizationTechnique::populateLiveInEnvironment(
      */
     auto environmentVariable = this->envBuilder->getEnvironmentVariable(envID);
 
+    /*
+     * Choose where to store the value.
+     */
+    auto environmentVariableInst = cast<Instruction>(environmentVariable);
+    Instruction *insertPoint = nullptr;
+    if (isa<Argument>(producerOfLiveIn) || isa<Constant>(producerOfLiveIn)) {
+      insertPoint = environmentVariableInst->getNextNode();
+
+    } else if (auto producerInst = dyn_cast<Instruction>(producerOfLiveIn)) {
+      if (true && (producerInst->getParent() == &entryBlock)
+          && (!isa<PHINode>(producerInst))
+          && (!producerInst->isTerminator())) {
+        insertPoint = producerInst->getNextNode();
+      }
+    }
+
     /*
      * Store the value inside the environment.
      */
-    auto newStore = builder.CreateStore(producerOfLiveIn, environmentVariable);
+    StoreInst *newStore = nullptr;
+    if (insertPoint != nullptr) {
+      IRBuilder<> invariantBuilder(insertPoint);
+      newStore =
+          invariantBuilder.CreateStore(producerOfLiveIn, environmentVariable);
+    } else {
+      newStore = builder.CreateStore(producerOfLiveIn, environmentVariable);
+    }
 
     /*
      * Attach the metadata to the new store
@@ -512,9 +630,9 @@ void ParallelizationTechnique::cloneMemoryLocationsLocallyAndRewireLoop(
   for (auto location : memoryCloningAnalysis->getClonableMemoryObjects()) {
 
     /*
-     * Fetch the stack object.
+     * Fetch the memory object.
      */
-    auto alloca = location->getAllocation();
+    auto allocation = location->getAllocation();
 
     /*
      * Check if this is an allocation used by this task
@@ -545,7 +663,7 @@ void ParallelizationTechnique::cloneMemoryLocationsLocallyAndRewireLoop(
      * stack object doesn't need to be initialized.
      */
     if (!location->doPrivateCopiesNeedToBeInitialized()) {
-      task->removeLiveIn(alloca);
+      task->removeLiveIn(allocation);
     }
 
     /*
@@ -649,65 +767,32 @@ void ParallelizationTechnique::cloneMemoryLocationsLocallyAndRewireLoop(
            * Check if the current operand is the alloca instruction that will be
            * cloned.
            */
-          if (opJ == alloca) {
+          if (opJ == allocation) {
             continue;
           }
 
           /*
            * Check if the current operand requires to become a live-in.
            */
-          auto newLiveIn = true;
-          for (auto envID : envUser->getEnvIDsOfLiveInVars()) {
-            auto producer = environment->getProducer(envID);
-            if (producer == opJ) {
-              newLiveIn = false;
-              break;
-            }
-          }
-          if (!newLiveIn) {
-            continue;
-          }
-
-          /*
-           * The current operand must become a new live-in.
-           *
-           * Make space in the environment for the new live-in.
-           */
-          auto newLiveInEnvironmentID =
-              environment->addLiveInValue(opJ, { opI });
-          this->envBuilder->addVariableToEnvironment(newLiveInEnvironmentID,
-                                                     opJ->getType());
-
-          /*
-           * Declare the new live-in of the loop is also a new live-in for the
-           * user (i.e., task) of the environment specified bt the input (i.e.,
-           * taskIndex).
-           */
-          envUser->addLiveIn(newLiveInEnvironmentID);
-
-          /*
-           * Add the load inside the task to load from the environment the new
-           * live-in.
-           */
-          auto envVarPtr =
-              envUser->createEnvironmentVariablePointer(entryBuilder,
-                                                        newLiveInEnvironmentID,
-                                                        opJ->getType());
-          auto environmentLocationLoad =
-              entryBuilder.CreateLoad(envVarPtr,
-                                      "noelle.environment_variable.live_in");
-
-          /*
-           * Make the task aware that the new load represents the live-in value.
-           */
-          task->addLiveIn(opJ, environmentLocationLoad);
+          this->makeValueALiveInOfTask(LDI, taskIndex, opJ, opI, entryBuilder);
         }
       }
     }
 
+    /*
+     * Heap objects are allocated once per invocation of the task.
+     * The private copy is reused by all iterations (and chunks) executed by the
+     * current instance of the task and it is released when the task exits.
+     */
+    if (location->isHeapObject()) {
+      this->cloneHeapObjectLocally(LDI, taskIndex, location, entryBuilder);
+      continue;
+    }
+
     /*
      * Clone the stack object at the beginning of the task.
      */
+    auto alloca = cast<AllocaInst>(allocation);
     auto allocaClone = cast<AllocaInst>(alloca->clone());
     auto firstInst = &*entryBlock.begin();
     entryBuilder.SetInsertPoint(firstInst);
@@ -819,6 +904,126 @@ void ParallelizationTechnique::cloneMemoryLocationsLocallyAndRewireLoop(
   }
 }
 
+void ParallelizationTechnique::cloneHeapObjectLocally(
+    LoopDependenceInfo *LDI,
+    int taskIndex,
+    ClonableMemoryObject *location,
+    IRBuilder<> &entryBuilder) {
+
+  /*
+   * Fetch the task.
+   */
+  auto task = this->tasks[taskIndex];
+  auto allocation = cast<CallInst>(location->getAllocation());
+
+  /*
+   * The arguments of the allocation (e.g., the size) must be available within
+   * the task.
+   */
+  for (auto &arg : allocation->args()) {
+    if (isa<Constant>(arg.get())) {
+      continue;
+    }
+    this->makeValueALiveInOfTask(LDI,
+                                 taskIndex,
+                                 arg.get(),
+                                 allocation,
+                                 entryBuilder);
+  }
+
+  /*
+   * Clone the allocation.
+   *
+   * NOTE: the clone is inserted after the loads of its live-in arguments and
+   * before the casts and GEPs of the object that have been cloned already.
+   */
+  auto allocationClone = cast<CallInst>(allocation->clone());
+  entryBuilder.Insert(allocationClone);
+
+  /*
+   * Keep track of the original-clone mapping.
+   */
+  task->addInstruction(allocation, allocationClone);
+
+  /*
+   * Release the private copy when the task exits.
+   */
+  auto module = task->getTaskBody()->getParent();
+  auto &cxt = module->getContext();
+  auto voidPtrType = PointerType::getUnqual(IntegerType::get(cxt, 8));
+  auto deallocatorType = FunctionType::get(Type::getVoidTy(cxt),
+                                           ArrayRef<Type *>({ voidPtrType }),
+                                           false);
+  auto deallocator =
+      module->getOrInsertFunction(location->getDeallocatorName(),
+                                  deallocatorType);
+  IRBuilder<> exitBuilder(task->getExit());
+  auto ptrToFree = exitBuilder.CreateBitCast(allocationClone, voidPtrType);
+  exitBuilder.CreateCall(deallocator, ArrayRef<Value *>({ ptrToFree }));
+
+  return;
+}
+
+void ParallelizationTechnique::makeValueALiveInOfTask(
+    LoopDependenceInfo *LDI,
+    int taskIndex,
+    Value *value,
+    Instruction *consumer,
+    IRBuilder<> &entryBuilder) {
+
+  /*
+   * Fetch the task and the environment.
+   */
+  auto task = this->tasks[taskIndex];
+  auto environment = LDI->getEnvironment();
+  auto envUser = this->envBuilder->getUser(taskIndex);
+
+  /*
+   * Check if the value is already a live-in of the task.
+   */
+  for (auto envID : envUser->getEnvIDsOfLiveInVars()) {
+    auto producer = environment->getProducer(envID);
+    if (producer == value) {
+      return;
+    }
+  }
+
+  /*
+   * The value must become a new live-in.
+   *
+   * Make space in the environment for the new live-in.
+   */
+  auto newLiveInEnvironmentID =
+      environment->addLiveInValue(value, { consumer });
+  this->envBuilder->addVariableToEnvironment(newLiveInEnvironmentID,
+                                             value->getType());
+
+  /*
+   * Declare the new live-in of the loop is also a new live-in for the
+   * user (i.e., task) of the environment specified bt the input (i.e.,
+   * taskIndex).
+   */
+  envUser->addLiveIn(newLiveInEnvironmentID);
+
+  /*
+   * Add the load inside the task to load from the environment the new
+   * live-in.
+   */
+  auto envVarPtr =
+      envUser->createEnvironmentVariablePointer(entryBuilder,
+                                                newLiveInEnvironmentID,
+                                                value->getType());
+  auto environmentLocationLoad =
+      entryBuilder.CreateLoad(envVarPtr, "noelle.environment_variable.live_in");
+
+  /*
+   * Make the task aware that the new load represents the live-in value.
+   */
+  task->addLiveIn(value, environmentLocationLoad);
+
+  return;
+}
+
 void ParallelizationTechnique::generateCodeToLoadLiveInVariables(
     LoopDependenceInfo *LDI,
     int taskIndex) {
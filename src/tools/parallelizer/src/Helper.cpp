@@ -62,6 +62,20 @@ bool Parallelizer::collectThreadPoolHelperFunctionsAndTypes(Module &M,
   par.queues.queueElementTypes =
       std::vector<Type *>({ par.int8, par.int16, par.int32, par.int64 });
 
+  /*
+   * Fetch the queues of records.
+   */
+  par.queues.recordQueuePush = M.getFunction("queuePushRecord");
+  par.queues.recordQueuePop = M.getFunction("queuePopRecord");
+  if ((par.queues.recordQueuePush == nullptr)
+      || (par.queues.recordQueuePop == nullptr)) {
+    errs()
+        << "Parallelizer: ERROR = the functions of the queues of records could not be found\n";
+    abort();
+  }
+  par.queues.recordQueueType =
+      par.queues.recordQueuePush->arg_begin()->getType();
+
   return true;
 }
 } // namespace llvm::noelle
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights to
+ use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies
+ of the Software, and to permit persons to whom the Software is furnished to do
+ so, subject to the following conditions:
+
+ * The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+ * IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR
+ OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE
+ OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "Parallelizer.hpp"
+
+namespace llvm::noelle {
+
+bool Parallelizer::parallelizeLoopWithAllApplicableTechniques(
+    LoopDependenceInfo *LDI,
+    Noelle &par,
+    Heuristics *h) {
+  auto prefix = "Parallelizer: multiversioning: ";
+
+  /*
+   * Assertions.
+   */
+  assert(LDI != nullptr);
+  assert(h != nullptr);
+
+  /*
+   * Fetch the verbosity level.
+   */
+  auto verbose = par.getVerbosity();
+
+  /*
+   * Fetch the loop.
+   *
+   * The runtime configuration refers to loops by their index among the loops
+   * of the program, which is the one used by the autotuner to explore the
+   * design space. Loops without an index are parallelized as usual.
+   */
+  auto loopStructure = LDI->getLoopStructure();
+  auto loopPreHeader = loopStructure->getPreHeader();
+  auto loopIndexOpt = par.getLoopIndex(loopStructure);
+  if (!loopIndexOpt) {
+    return this->parallelizeLoop(LDI, par, h);
+  }
+  auto loopID = loopIndexOpt.value();
+  if (verbose != Verbosity::Disabled) {
+    errs() << prefix << "Start\n";
+    errs() << prefix << "  Loop " << loopID << " = \""
+           << *loopStructure->getHeader()->getFirstNonPHI() << "\"\n";
+  }
+
+  /*
+   * Allocate the parallelization techniques.
+   * They are listed in order of priority: the first one that can be applied
+   * generates the variant that runs by default.
+   */
+  DSWP dswp{ par, this->forceParallelization, !this->forceNoSCCPartition };
+  DOALL doall{ par };
+  HELIX helix{ par, this->forceParallelization };
+  std::vector<std::pair<ParallelizationTechnique *, Transformation>>
+      techniques{ { &doall, DOALL_ID }, { &helix, HELIX_ID }, { &dswp, DSWP_ID } };
+
+  /*
+   * Check which techniques can be applied before modifying the code.
+   */
+  auto ltm = LDI->getLoopTransformationsManager();
+  std::vector<std::pair<ParallelizationTechnique *, Transformation>>
+      applicableTechniques;
+  for (auto techniqueAndID : techniques) {
+    auto technique = techniqueAndID.first;
+    auto techniqueID = techniqueAndID.second;
+    if (true && par.isTransformationEnabled(techniqueID)
+        && ltm->isTransformationEnabled(techniqueID)
+        && technique->canBeAppliedToLoop(LDI, h)) {
+      applicableTechniques.push_back(techniqueAndID);
+    }
+  }
+
+  /*
+   * Generate one variant of the loop per technique.
+   */
+  std::vector<TransformedLoopVariant> variants;
+  for (auto techniqueAndID : applicableTechniques) {
+    auto technique = techniqueAndID.first;
+    auto techniqueID = techniqueAndID.second;
+
+    /*
+     * Apply the technique.
+     */
+    technique->enableRuntimeConfiguration();
+    auto codeModified = (techniqueID == HELIX_ID)
+                            ? this->applyHELIX(helix, LDI, par, h)
+                            : technique->apply(LDI, h);
+    if (!codeModified) {
+      continue;
+    }
+    if (verbose != Verbosity::Disabled) {
+      errs() << prefix << "  Generated the " << technique->getName()
+             << " variant\n";
+    }
+
+    /*
+     * Keep track of the new variant.
+     */
+    auto exitBlockID = LDI->getEnvironment()->getExitBlockID();
+    auto exitOffset = ConstantInt::get(
+        par.int64,
+        exitBlockID >= 0
+            ? technique->getOffsetOfEnvironmentVariable(exitBlockID)
+            : -1);
+    TransformedLoopVariant variant;
+    variant.variantID = 1 + techniqueID;
+    variant.startOfLoop = technique->getParLoopEntryPoint();
+    variant.endOfLoop = technique->getParLoopExitPoint();
+    variant.envArray = technique->getEnvArray();
+    variant.envOffsetForExitVariable = exitOffset;
+    variant.minIdleCores = technique->getMinimumNumberOfIdleCores();
+    assert(variant.startOfLoop != nullptr);
+    assert(variant.endOfLoop != nullptr);
+    assert(variant.envArray != nullptr);
+    variants.push_back(variant);
+  }
+
+  /*
+   * Check if the loop has been parallelized.
+   */
+  if (variants.size() == 0) {
+    if (verbose != Verbosity::Disabled) {
+      errs() << prefix << "  The loop has not been parallelized\n";
+      errs() << prefix << "Exit\n";
+    }
+    return false;
+  }
+
+  /*
+   * Link all variants within the original function that includes the
+   * sequential loop.
+   */
+  auto loopExitBlocks = loopStructure->getLoopExitBasicBlocks();
+  auto linker = par.getLinker();
+  linker->linkTransformedLoopVariantsToOriginalFunction(loopPreHeader,
+                                                        loopID,
+                                                        variants,
+                                                        loopExitBlocks);
+  assert(par.verifyCode());
+
+  if (verbose != Verbosity::Disabled) {
+    errs() << prefix << "  The loop has " << (variants.size() + 1)
+           << " versions\n";
+    errs() << prefix << "Exit\n";
+  }
+
+  return true;
+}
+
+} // namespace llvm::noelle
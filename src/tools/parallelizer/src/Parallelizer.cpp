@@ -125,6 +125,7 @@ bool Parallelizer::parallelizeLoop(LoopDependenceInfo *LDI,
     /*
      * Apply DOALL.
      */
+    CompileTimePhase phase("DOALL");
     codeModified = doall.apply(LDI, h);
     usedTechnique = &doall;
 
@@ -135,44 +136,8 @@ bool Parallelizer::parallelizeLoop(LoopDependenceInfo *LDI,
     /*
      * Apply HELIX
      */
-    codeModified = helix.apply(LDI, h);
-
-    auto function = helix.getTaskFunction();
-    auto &LI = getAnalysis<LoopInfoWrapperPass>(*function).getLoopInfo();
-    auto &PDT =
-        getAnalysis<PostDominatorTreeWrapperPass>(*function).getPostDomTree();
-    auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(*function).getSE();
-
-    if (par.getVerbosity() >= Verbosity::Maximal) {
-      errs() << "HELIX:  Constructing task dependence graph\n";
-    }
-
-    auto taskFunctionDG =
-        helix.constructTaskInternalDependenceGraphFromOriginalLoopDG(LDI, PDT);
-
-    if (par.getVerbosity() >= Verbosity::Maximal) {
-      errs() << "HELIX:  Constructing task loop dependence info\n";
-    }
-
-    auto DS = par.getDominators(function);
-    auto l = LI.getLoopsInPreorder()[0];
-    auto newLoops = par.getLoopStructures(function, 0);
-    auto newForest = par.organizeLoopsInTheirNestingForest(*newLoops);
-    auto newLoopNode = newForest->getInnermostLoopThatContains(l->getHeader());
-    assert(newLoopNode != nullptr);
-    auto lto = LDI->getLoopTransformationsManager();
-    auto newLDI = new LoopDependenceInfo(
-        taskFunctionDG,
-        newLoopNode,
-        l,
-        *DS,
-        SE,
-        par.getCompilationOptionsManager()->getMaximumNumberOfCores(),
-        par.canFloatsBeConsideredRealNumbers(),
-        lto->getOptimizationsEnabled(),
-        false,
-        lto->getChunkSize());
-    codeModified = helix.apply(newLDI, h);
+    CompileTimePhase phase("HELIX");
+    codeModified = this->applyHELIX(helix, LDI, par, h);
     usedTechnique = &helix;
 
   } else if (true && par.isTransformationEnabled(DSWP_ID)
@@ -182,6 +147,7 @@ bool Parallelizer::parallelizeLoop(LoopDependenceInfo *LDI,
     /*
      * Apply DSWP.
      */
+    CompileTimePhase phase("DSWP");
     codeModified = dswp.apply(LDI, h);
     usedTechnique = &dswp;
   }
@@ -219,10 +185,10 @@ bool Parallelizer::parallelizeLoop(LoopDependenceInfo *LDI,
     errs() << prefix << "  Link the parallelize loop\n";
   }
   auto exitBlockID = LDI->getEnvironment()->getExitBlockID();
-  auto exitIndex = ConstantInt::get(
+  auto exitOffset = ConstantInt::get(
       par.int64,
       exitBlockID >= 0
-          ? usedTechnique->getIndexOfEnvironmentVariable(exitBlockID)
+          ? usedTechnique->getOffsetOfEnvironmentVariable(exitBlockID)
           : -1);
   auto loopExitBlocks = loopStructure->getLoopExitBasicBlocks();
   auto linker = par.getLinker();
@@ -231,7 +197,7 @@ bool Parallelizer::parallelizeLoop(LoopDependenceInfo *LDI,
       entryPoint,
       exitPoint,
       envArray,
-      exitIndex,
+      exitOffset,
       loopExitBlocks,
       usedTechnique->getMinimumNumberOfIdleCores());
   assert(par.verifyCode());
@@ -247,4 +213,57 @@ bool Parallelizer::parallelizeLoop(LoopDependenceInfo *LDI,
 
   return true;
 }
+
+bool Parallelizer::applyHELIX(HELIX &helix,
+                              LoopDependenceInfo *LDI,
+                              Noelle &par,
+                              Heuristics *h) {
+
+  /*
+   * Generate the task of the loop.
+   */
+  auto codeModified = helix.apply(LDI, h);
+
+  /*
+   * Synchronize the task using the dependences of the task itself.
+   */
+  auto function = helix.getTaskFunction();
+  auto &LI = getAnalysis<LoopInfoWrapperPass>(*function).getLoopInfo();
+  auto &PDT =
+      getAnalysis<PostDominatorTreeWrapperPass>(*function).getPostDomTree();
+  auto &SE = getAnalysis<ScalarEvolutionWrapperPass>(*function).getSE();
+
+  if (par.getVerbosity() >= Verbosity::Maximal) {
+    errs() << "HELIX:  Constructing task dependence graph\n";
+  }
+
+  auto taskFunctionDG =
+      helix.constructTaskInternalDependenceGraphFromOriginalLoopDG(LDI, PDT);
+
+  if (par.getVerbosity() >= Verbosity::Maximal) {
+    errs() << "HELIX:  Constructing task loop dependence info\n";
+  }
+
+  auto DS = par.getDominators(function);
+  auto l = LI.getLoopsInPreorder()[0];
+  auto newLoops = par.getLoopStructures(function, 0);
+  auto newForest = par.organizeLoopsInTheirNestingForest(*newLoops);
+  auto newLoopNode = newForest->getInnermostLoopThatContains(l->getHeader());
+  assert(newLoopNode != nullptr);
+  auto lto = LDI->getLoopTransformationsManager();
+  auto newLDI = new LoopDependenceInfo(
+      taskFunctionDG,
+      newLoopNode,
+      l,
+      *DS,
+      SE,
+      par.getCompilationOptionsManager()->getMaximumNumberOfCores(),
+      par.canFloatsBeConsideredRealNumbers(),
+      lto->getOptimizationsEnabled(),
+      false,
+      lto->getChunkSize());
+  codeModified = helix.apply(newLDI, h);
+
+  return codeModified;
+}
 } // namespace llvm::noelle
@@ -28,6 +28,7 @@
 #include "noelle/core/SCCDAG.hpp"
 #include "noelle/core/Noelle.hpp"
 #include "noelle/core/MetadataManager.hpp"
+#include "noelle/core/CompileTimeProfiler.hpp"
 #include "noelle/tools/DOALL.hpp"
 #include "noelle/tools/HELIX.hpp"
 #include "HeuristicsPass.hpp"
@@ -56,12 +57,22 @@ private:
    */
   bool forceParallelization;
   bool forceNoSCCPartition;
+  bool multiversioning;
 
   /*
    * Methods
    */
   bool parallelizeLoop(LoopDependenceInfo *LDI, Noelle &par, Heuristics *h);
 
+  bool parallelizeLoopWithAllApplicableTechniques(LoopDependenceInfo *LDI,
+                                                  Noelle &par,
+                                                  Heuristics *h);
+
+  bool applyHELIX(HELIX &helix,
+                  LoopDependenceInfo *LDI,
+                  Noelle &par,
+                  Heuristics *h);
+
   std::vector<LoopDependenceInfo *> getLoopsToParallelize(Module &M,
                                                           Noelle &par);
 
@@ -36,11 +36,18 @@ static cl::opt<bool> ForceNoSCCPartition(
     cl::ZeroOrMore,
     cl::Hidden,
     cl::desc("Force no SCC merging when parallelizing"));
+static cl::opt<bool> Multiversioning(
+    "noelle-parallelizer-multiversioning",
+    cl::ZeroOrMore,
+    cl::Hidden,
+    cl::desc(
+        "Generate all applicable parallel versions of a loop and select the one to run (and its cores and chunk size) at runtime"));
 
 Parallelizer::Parallelizer()
   : ModulePass{ ID },
     forceParallelization{ false },
-    forceNoSCCPartition{ false } {
+    forceNoSCCPartition{ false },
+    multiversioning{ false } {
 
   return;
 }
@@ -48,12 +55,14 @@ Parallelizer::Parallelizer()
 bool Parallelizer::doInitialization(Module &M) {
   this->forceParallelization = (ForceParallelization.getNumOccurrences() > 0);
   this->forceNoSCCPartition = (ForceNoSCCPartition.getNumOccurrences() > 0);
+  this->multiversioning = (Multiversioning.getNumOccurrences() > 0);
 
   return false;
 }
 
 bool Parallelizer::runOnModule(Module &M) {
   errs() << "Parallelizer: Start\n";
+  CompileTimePhase phase("Parallelizer");
 
   /*
    * Fetch the outputs of the passes we rely on.
@@ -164,7 +173,12 @@ bool Parallelizer::runOnModule(Module &M) {
     /*
      * Parallelize the current loop.
      */
-    auto loopIsParallelized = this->parallelizeLoop(ldi, noelle, heuristics);
+    auto loopIsParallelized =
+        this->multiversioning
+            ? this->parallelizeLoopWithAllApplicableTechniques(ldi,
+                                                               noelle,
+                                                               heuristics)
+            : this->parallelizeLoop(ldi, noelle, heuristics);
 
     /*
      * Keep track of the parallelization.
@@ -177,16 +191,10 @@ bool Parallelizer::runOnModule(Module &M) {
         modifiedBBs[bb] = true;
       }
       modifiedFunctions.insert(ls->getFunction());
+      noelle.invalidateLoops(ls->getFunction());
     }
   }
 
-  /*
-   * Free the memory.
-   */
-  for (auto indexLoopPair : loopParallelizationOrder) {
-    delete indexLoopPair.second;
-  }
-
   /*
    * Erase calls to intrinsics in modified functions
    */
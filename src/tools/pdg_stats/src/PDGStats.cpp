@@ -21,6 +21,7 @@
  */
 #include "noelle/core/PDGPrinter.hpp"
 #include "noelle/core/SystemHeaders.hpp"
+#include "noelle/core/DependenceQueryCache.hpp"
 #include "PDGStats.hpp"
 
 using namespace llvm;
@@ -97,6 +98,15 @@ bool PDGStats::runOnModule(Module &M) {
     }
   }
 
+  /*
+   * Collect the statistics about the memory dependences of the loops that did
+   * not manifest when the program was profiled (see noelle-prof-deps).
+   */
+  this->hasDependenceProfile = DependenceProfile::isAvailable(M);
+  if (this->hasDependenceProfile) {
+    this->collectStatsForProfiledLoopDependences(noelle, M);
+  }
+
   /*
    * Print the statistics.
    */
@@ -267,6 +277,68 @@ void PDGStats::collectStatsForLoopEdges(
   return;
 }
 
+void PDGStats::collectStatsForProfiledLoopDependences(Noelle &noelle,
+                                                      Module &M) {
+  auto optimizations = {
+    LoopDependenceInfoOptimization::MEMORY_DEPENDENCE_PROFILE_ID
+  };
+
+  for (auto &F : M) {
+    if (F.empty()) {
+      continue;
+    }
+
+    /*
+     * Compute the loops of the function with the dependence profile enabled.
+     */
+    auto loopStructures = noelle.getLoopStructures(&F);
+    for (auto ls : *loopStructures) {
+      auto ldi = noelle.getLoop(ls, optimizations);
+
+      /*
+       * Check the memory dependences of the loop.
+       */
+      auto loopDG = ldi->getLoopDG();
+      for (auto edge : loopDG->getEdges()) {
+        if (!edge->isMemoryDependence()) {
+          continue;
+        }
+        this->numberOfProfiledLoopMemoryDependences++;
+
+        /*
+         * Check if the profile marked the dependence.
+         */
+        auto remedies = edge->getRemedies();
+        if (!remedies) {
+          continue;
+        }
+        for (auto &remedySet : *remedies) {
+          for (auto &remedy : *remedySet) {
+            auto profileRemedy =
+                std::dynamic_pointer_cast<DependenceProfileRemedy>(remedy);
+            if (profileRemedy == nullptr) {
+              continue;
+            }
+            if (profileRemedy->wasNeverObserved()) {
+              this->numberOfLoopMemoryDependencesNeverObserved++;
+            } else {
+              this->numberOfLoopMemoryDependencesObservedWithinIterations++;
+            }
+          }
+        }
+      }
+
+      /*
+       * Free the memory.
+       */
+      delete ls;
+    }
+    delete loopStructures;
+  }
+
+  return;
+}
+
 bool PDGStats::edgeIsDependenceOf(MDNode *edgeM,
                                   const EDGE_ATTRIBUTE edgeAttribute) {
   if (MDNode *m = dyn_cast<MDNode>(edgeM->getOperand(edgeAttribute))) {
@@ -299,6 +371,41 @@ void PDGStats::printStats() {
          << "\n";
   errs() << "     Number of potential memory dependences: "
          << this->numberOfPotentialMemoryDependences << "\n";
+  if (this->hasDependenceProfile) {
+    errs() << " Number of memory dependences of loops: "
+           << this->numberOfProfiledLoopMemoryDependences << "\n";
+    errs() << "   Never observed by the profiler: "
+           << this->numberOfLoopMemoryDependencesNeverObserved << "\n";
+    errs() << "   Observed only within single iterations: "
+           << this->numberOfLoopMemoryDependencesObservedWithinIterations
+           << "\n";
+  }
+
+  /*
+   * Print the statistics of the dependence queries.
+   */
+  auto &queryCache = DependenceQueryCache::getSessionCache();
+  this->printQueryStats("Alias queries",
+                        queryCache.getNumberOfAliasQueries(),
+                        queryCache.getNumberOfAliasHits());
+  this->printQueryStats("Loop-aware dependence queries",
+                        queryCache.getNumberOfLoopAwareQueries(),
+                        queryCache.getNumberOfLoopAwareHits());
+  errs() << " Invalidations of the query cache: "
+         << queryCache.getNumberOfInvalidations() << "\n";
+
+  return;
+}
+
+void PDGStats::printQueryStats(std::string title,
+                               uint64_t queries,
+                               uint64_t hits) {
+  errs() << " " << title << ": " << queries << " (cache hits: " << hits;
+  if (queries > 0) {
+    errs() << ", hit rate: " << format("%.1f", (hits * 100.0) / queries)
+           << "%";
+  }
+  errs() << ")\n";
 
   return;
 }
@@ -22,6 +22,7 @@
 #pragma once
 
 #include "noelle/core/Noelle.hpp"
+#include "noelle/core/DependenceProfile.hpp"
 
 namespace llvm::noelle {
 
@@ -52,6 +53,10 @@ private:
   int64_t numberOfMemoryMustDependence = 0;
   int64_t numberOfPotentialMemoryDependences = 0;
   int64_t numberOfControlDependence = 0;
+  bool hasDependenceProfile = false;
+  int64_t numberOfProfiledLoopMemoryDependences = 0;
+  int64_t numberOfLoopMemoryDependencesNeverObserved = 0;
+  int64_t numberOfLoopMemoryDependencesObservedWithinIterations = 0;
 
   void collectStatsForNodes(Function &F);
   void collectStatsForPotentialEdges(
@@ -70,10 +75,13 @@ private:
       std::unordered_map<LoopStructure *, LoopDependenceInfo *> &lsToLDI,
       Function &F);
 
+  void collectStatsForProfiledLoopDependences(Noelle &noelle, Module &M);
+
   void analyzeDependence(DGEdge<Value> *edge);
 
   bool edgeIsDependenceOf(MDNode *edgeM, EDGE_ATTRIBUTE edgeAttribute);
   void printStats();
+  void printQueryStats(std::string title, uint64_t queries, uint64_t hits);
   uint64_t computePotentialEdges(uint64_t totLoads,
                                  uint64_t totStores,
                                  uint64_t totCalls);
@@ -88,13 +88,6 @@ bool TimeSaved::runOnModule(Module &M) {
                                                  maxTimeSavedWithDOALLOnly);
     programMaxTimeSaved += maxTimeSaved;
     programMaxTimeSavedWithDOALLOnly += maxTimeSavedWithDOALLOnly;
-
-    /*
-     * Free the memory.
-     */
-    for (auto loop : loopsToParallelize) {
-      delete loop;
-    }
   }
 
   /*
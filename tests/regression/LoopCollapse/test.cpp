@@ -0,0 +1,69 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * The loops can be collapsed: the outer loop has only a few iterations, every
+ * iteration of the loop nest accesses a different element, and the induction
+ * variables are used only to compute the linearized index i*m+j.
+ */
+void collapsible (long long int *a, long long int *b, long long int n, long long int m){
+  for (long long int i=0; i < n; i++){
+    for (long long int j=0; j < m; j++){
+      a[i * m + j] = b[i * m + j] * 3 + 1;
+    }
+  }
+}
+
+/*
+ * The loops cannot be collapsed: every iteration of the inner loop reads the
+ * element written by the previous one.
+ */
+void notCollapsible (long long int *a, long long int n, long long int m){
+  for (long long int i=0; i < n; i++){
+    for (long long int j=1; j < m; j++){
+      a[i * m + j] = (a[i * m + j - 1] * 3 + 1) % 1000003;
+    }
+  }
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 3){
+    fprintf(stderr, "USAGE: %s OUTER_ITERATIONS INNER_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto n = atoll(argv[1]);
+  auto m = atoll(argv[2]);
+  if ((n <= 0) || (m <= 0)) return 0;
+
+  /*
+   * Allocate space.
+   */
+  long long int *a = (long long int *) calloc(n * m, sizeof(long long int));
+  long long int *b = (long long int *) calloc(n * m, sizeof(long long int));
+  for (long long int i=0; i < n * m; i++){
+    b[i] = i % 13;
+  }
+
+  /*
+   * Run the loop nests.
+   */
+  collapsible(a, b, n, m);
+  unsigned long long int s = 0;
+  for (long long int i=0; i < n * m; i++){
+    s = s * 31 + a[i];
+  }
+  printf("%llu\n", s);
+
+  notCollapsible(a, n, m);
+  s = 0;
+  for (long long int i=0; i < n * m; i++){
+    s = s * 31 + a[i];
+  }
+  printf("%llu\n", s);
+
+  return 0;
+}
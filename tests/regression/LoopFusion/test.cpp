@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * The two loops can be fused: the second one reads only the element written
+ * by the first one in the same iteration.
+ */
+void fusable (long long int *a, long long int *b, long long int iters){
+  for (long long int i=0; i < iters; i++){
+    a[i] = i * 3;
+  }
+  for (long long int i=0; i < iters; i++){
+    b[i] = a[i] + 1;
+  }
+}
+
+/*
+ * The two loops cannot be fused: the second one reads an element that the
+ * first one writes in a later iteration.
+ */
+void notFusable (long long int *a, long long int *b, long long int iters){
+  for (long long int i=0; i < iters; i++){
+    a[i] = i * 5;
+  }
+  for (long long int i=0; i < iters; i++){
+    b[i] = a[i + 1] + a[i];
+  }
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations <= 0) return 0;
+
+  /*
+   * Allocate space.
+   */
+  long long int *a = (long long int *) calloc(iterations + 2, sizeof(long long int));
+  long long int *b = (long long int *) calloc(iterations + 2, sizeof(long long int));
+
+  /*
+   * Run the loops.
+   */
+  fusable(a, b, iterations);
+  long long int s = 0;
+  for (long long int i=0; i < iterations; i++){
+    s += b[i];
+  }
+  printf("%lld\n", s);
+
+  notFusable(a, b, iterations);
+  s = 0;
+  for (long long int i=0; i < iterations; i++){
+    s += b[i] * (i + 1);
+  }
+  printf("%lld\n", s);
+
+  return 0;
+}
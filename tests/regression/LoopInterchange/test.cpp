@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIZE 128
+
+unsigned long long int A[SIZE][SIZE];
+unsigned long long int B[SIZE][SIZE];
+unsigned long long int C[SIZE][SIZE];
+unsigned long long int D[2 * SIZE];
+
+/*
+ * The loops can be interchanged: every element of A is accessed by a single
+ * iteration of the loop nest.
+ * The interchange makes the accesses unit-stride.
+ */
+void interchangeable (long long int n){
+  for (long long int i=0; i < n; i++){
+    for (long long int j=0; j < n; j++){
+      A[j][i] = A[j][i] * 2 + B[j][i];
+    }
+  }
+}
+
+/*
+ * The loops cannot be interchanged: the element D[i+j] is updated by the
+ * iterations (i, j) and (i+1, j-1), and the interchange would swap their order.
+ */
+void notInterchangeable (long long int n){
+  for (long long int i=0; i < n; i++){
+    for (long long int j=0; j < n; j++){
+      D[i + j] = D[i + j] * 2 + B[j][i] + C[j][i];
+    }
+  }
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations <= 0) return 0;
+  if (iterations > SIZE) iterations = SIZE;
+
+  /*
+   * Initialize the inputs.
+   */
+  for (long long int i=0; i < SIZE; i++){
+    for (long long int j=0; j < SIZE; j++){
+      A[i][j] = i;
+      B[i][j] = i * 3 + j;
+      C[i][j] = j % 7;
+    }
+  }
+
+  /*
+   * Run the loop nests.
+   */
+  interchangeable(iterations);
+  unsigned long long int s = 0;
+  for (long long int i=0; i < SIZE; i++){
+    for (long long int j=0; j < SIZE; j++){
+      s += A[i][j] * (i + j);
+    }
+  }
+  printf("%llu\n", s);
+
+  notInterchangeable(iterations);
+  s = 0;
+  for (long long int i=0; i < 2 * SIZE; i++){
+    s = s * 31 + D[i];
+  }
+  printf("%llu\n", s);
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SIZE 256
+
+unsigned long long int A[SIZE];
+unsigned long long int B[SIZE];
+unsigned long long int D[2 * SIZE];
+
+/*
+ * The inner loop can be tiled: every element of A is accessed by a single
+ * iteration of the outer loop, and every iteration of the outer loop reads
+ * the whole B again.
+ */
+void tileable (long long int n){
+  for (long long int i=0; i < n; i++){
+    for (long long int j=0; j < n; j++){
+      A[i] = A[i] * 3 + B[j];
+    }
+  }
+}
+
+/*
+ * The inner loop cannot be tiled: the element D[i+j] is updated by the
+ * iterations (i, j) and (i+1, j-1), which can end up in different tiles that
+ * run in the opposite order.
+ */
+void notTileable (long long int n){
+  for (long long int i=0; i < n; i++){
+    for (long long int j=0; j < n; j++){
+      D[i + j] = D[i + j] * 3 + B[j];
+    }
+  }
+}
+
+int main (int argc, char *argv[]){
+
+  /*
+   * Check the inputs.
+   */
+  if (argc < 2){
+    fprintf(stderr, "USAGE: %s LOOP_ITERATIONS\n", argv[0]);
+    return -1;
+  }
+  auto iterations = atoll(argv[1]);
+  if (iterations <= 0) return 0;
+  if (iterations > SIZE) iterations = SIZE;
+
+  /*
+   * Initialize the inputs.
+   */
+  for (long long int i=0; i < SIZE; i++){
+    A[i] = i;
+    B[i] = i % 11;
+  }
+
+  /*
+   * Run the loop nests.
+   */
+  tileable(iterations);
+  unsigned long long int s = 0;
+  for (long long int i=0; i < SIZE; i++){
+    s = s * 31 + A[i];
+  }
+  printf("%llu\n", s);
+
+  notTileable(iterations);
+  s = 0;
+  for (long long int i=0; i < 2 * SIZE; i++){
+    s = s * 31 + D[i];
+  }
+  printf("%llu\n", s);
+
+  return 0;
+}
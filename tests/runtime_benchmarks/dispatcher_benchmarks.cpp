@@ -0,0 +1,621 @@
+/*
+ * Copyright 2022  Simone Campanoni
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/*
+ * Microbenchmarks of the dispatchers of the NOELLE runtime.
+ *
+ * The dispatchers are invoked directly with synthetic task bodies that mimic
+ * the code generated by the DOALL, HELIX, and DSWP parallelization techniques.
+ * Every configuration is run several times and the median of each metric is
+ * reported.
+ *
+ * The output is a sequence of tab-separated tables, one per technique. Each
+ * table starts with a header line that begins with '#'.
+ */
+
+#define CACHE_LINE_SIZE 64
+
+/*
+ * APIs of the runtime (see NOELLE_APIs.c).
+ */
+extern "C" {
+typedef struct {
+  int32_t numberOfThreadsUsed;
+  int64_t unusedVariableToPreventOptIfStructHasOnlyOneVariable;
+} DispatcherInfo;
+
+DispatcherInfo NOELLE_DOALLDispatcher(
+    void (*parallelizedLoop)(void *, int64_t, int64_t, int64_t),
+    void *env,
+    int64_t maxNumberOfCores,
+    int64_t chunkSize,
+    int64_t loopID);
+
+DispatcherInfo NOELLE_HELIX_dispatcher_sequentialSegments(
+    void (*parallelizedLoop)(void *,
+                             void *,
+                             void *,
+                             void *,
+                             int64_t,
+                             int64_t,
+                             uint64_t *),
+    void *env,
+    void *loopCarriedArray,
+    int64_t numCores,
+    int64_t numOfsequentialSegments);
+
+void HELIX_wait(void *);
+void HELIX_signal(void *);
+
+DispatcherInfo NOELLE_DSWPDispatcher(void *env,
+                                     int64_t *queueSizes,
+                                     void *stages,
+                                     int64_t numberOfStages,
+                                     int64_t numberOfQueues);
+
+void queuePush8(void *, int8_t *);
+void queuePush16(void *, int16_t *);
+void queuePush32(void *, int32_t *);
+void queuePush64(void *, int64_t *);
+void queuePop8(void *, int8_t *);
+void queuePop16(void *, int16_t *);
+void queuePop32(void *, int32_t *);
+void queuePop64(void *, int64_t *);
+void queuePushRecord(void *, void *);
+void queuePopRecord(void *, void *);
+
+uint32_t NOELLE_getAvailableCores(void);
+}
+
+/*
+ * Timestamps (in nanoseconds) shared by the dispatcher and the tasks it runs.
+ */
+typedef struct {
+  std::atomic<int64_t> firstTaskStart;
+  std::atomic<int64_t> lastTaskEnd;
+} TaskTimes_t;
+
+typedef struct {
+  TaskTimes_t times;
+  int64_t iterations;
+  int64_t cost;
+  uint64_t sinks[64 * (CACHE_LINE_SIZE / sizeof(uint64_t))];
+} DOALLBenchmark_t;
+
+typedef struct {
+  TaskTimes_t times;
+  int64_t iterations;
+  int64_t cost;
+  int64_t sequentialSegments;
+  uint64_t sinks[64 * (CACHE_LINE_SIZE / sizeof(uint64_t))];
+} HELIXBenchmark_t;
+
+typedef struct {
+  TaskTimes_t times;
+  int64_t values;
+  int64_t numberOfStages;
+  std::atomic<int64_t> nextRelayStage;
+  uint64_t sink;
+} DSWPBenchmark_t;
+
+static int64_t now(void) {
+  auto t = std::chrono::steady_clock::now().time_since_epoch();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(t).count();
+}
+
+static void resetTaskTimes(TaskTimes_t *times) {
+  times->firstTaskStart.store(INT64_MAX);
+  times->lastTaskEnd.store(0);
+
+  return;
+}
+
+static void taskStarted(TaskTimes_t *times) {
+  auto t = now();
+  auto current = times->firstTaskStart.load(std::memory_order_relaxed);
+  while ((t < current)
+         && !times->firstTaskStart.compare_exchange_weak(current, t)) {
+  }
+
+  return;
+}
+
+static void taskEnded(TaskTimes_t *times) {
+  auto t = now();
+  auto current = times->lastTaskEnd.load(std::memory_order_relaxed);
+  while ((t > current)
+         && !times->lastTaskEnd.compare_exchange_weak(current, t)) {
+  }
+
+  return;
+}
+
+/*
+ * Run cost units of work that the compiler cannot remove.
+ */
+static uint64_t work(int64_t cost, uint64_t value) {
+  for (auto i = 0; i < cost; i++) {
+    value ^= value << 13;
+    value ^= value >> 7;
+    value ^= value << 17;
+    asm volatile("" : "+r"(value));
+  }
+
+  return value;
+}
+
+static uint64_t *sinkOfCore(uint64_t *sinks, int64_t coreID) {
+  return &sinks[(coreID % 64) * (CACHE_LINE_SIZE / sizeof(uint64_t))];
+}
+
+static int64_t median(std::vector<int64_t> &samples) {
+  std::sort(samples.begin(), samples.end());
+
+  return samples[samples.size() / 2];
+}
+
+/**********************************************************************
+ *                DOALL
+ **********************************************************************/
+static void DOALLTask(void *env,
+                      int64_t coreID,
+                      int64_t numCores,
+                      int64_t chunkSize) {
+  auto b = (DOALLBenchmark_t *)env;
+  taskStarted(&b->times);
+
+  /*
+   * Execute the chunks of iterations assigned to the current core.
+   */
+  uint64_t value = coreID + 1;
+  for (auto first = coreID * chunkSize; first < b->iterations;
+       first += numCores * chunkSize) {
+    auto last = std::min(first + chunkSize, b->iterations);
+    for (auto i = first; i < last; i++) {
+      value = work(b->cost, value + i);
+    }
+  }
+  *sinkOfCore(b->sinks, coreID) = value;
+
+  taskEnded(&b->times);
+  return;
+}
+
+static void benchmarkDOALL(int64_t repetitions, int64_t maxCores) {
+  printf("# technique\tcores\tthreads\tchunk_size\titeration_cost\titerations"
+         "\tfork_ns\tjoin_ns\ttotal_ns\tns_per_iteration\n");
+
+  auto b = new DOALLBenchmark_t();
+  b->iterations = 100000;
+  for (auto cores = 1; cores <= maxCores; cores *= 2) {
+    for (auto chunkSize : { 1, 8, 64 }) {
+      for (auto cost : { 0, 100, 1000 }) {
+        b->cost = cost;
+
+        /*
+         * Measure.
+         * The first run warms up the thread pool and it is discarded.
+         */
+        std::vector<int64_t> forks, joins, totals;
+        int32_t threads = 0;
+        for (auto r = 0; r <= repetitions; r++) {
+          resetTaskTimes(&b->times);
+          auto start = now();
+          auto info =
+              NOELLE_DOALLDispatcher(DOALLTask, b, cores, chunkSize, -1);
+          auto end = now();
+          threads = info.numberOfThreadsUsed;
+          if (r == 0) {
+            continue;
+          }
+          forks.push_back(b->times.firstTaskStart.load() - start);
+          joins.push_back(end - b->times.lastTaskEnd.load());
+          totals.push_back(end - start);
+        }
+
+        /*
+         * Report.
+         */
+        auto total = median(totals);
+        printf("doall\t%d\t%d\t%d\t%d\t%lld\t%lld\t%lld\t%lld\t%.2f\n",
+               cores,
+               threads,
+               chunkSize,
+               cost,
+               (long long)b->iterations,
+               (long long)median(forks),
+               (long long)median(joins),
+               (long long)total,
+               ((double)total) / b->iterations);
+        fflush(stdout);
+      }
+    }
+  }
+  delete b;
+
+  return;
+}
+
+/**********************************************************************
+ *                HELIX
+ **********************************************************************/
+static void HELIXTask(void *env,
+                      void *,
+                      void *ssArrayPast,
+                      void *ssArrayFuture,
+                      int64_t coreID,
+                      int64_t numCores,
+                      uint64_t *) {
+  auto b = (HELIXBenchmark_t *)env;
+  taskStarted(&b->times);
+
+  /*
+   * Execute the iterations assigned to the current core.
+   * Each iteration runs its parallel part first and then it goes through its
+   * sequential segments in order.
+   */
+  uint64_t value = coreID + 1;
+  for (auto i = coreID; i < b->iterations; i += numCores) {
+    value = work(b->cost, value + i);
+    for (auto ss = 0; ss < b->sequentialSegments; ss++) {
+      HELIX_wait((void *)(((uint64_t)ssArrayPast) + (ss * CACHE_LINE_SIZE)));
+      value++;
+      HELIX_signal(
+          (void *)(((uint64_t)ssArrayFuture) + (ss * CACHE_LINE_SIZE)));
+    }
+  }
+  *sinkOfCore(b->sinks, coreID) = value;
+
+  taskEnded(&b->times);
+  return;
+}
+
+static void benchmarkHELIX(int64_t repetitions, int64_t maxCores) {
+  printf("# technique\tcores\tthreads\tsequential_segments\titeration_cost"
+         "\titerations\tfork_ns\tjoin_ns\ttotal_ns\tns_per_iteration"
+         "\tns_per_signal\n");
+
+  /*
+   * The HELIX dispatcher requires at least two cores.
+   */
+  auto b = new HELIXBenchmark_t();
+  b->iterations = 10000;
+  for (auto cores = 2; cores <= std::max(maxCores, (int64_t)2); cores *= 2) {
+    for (auto sequentialSegments : { 1, 2, 4, 8 }) {
+      for (auto cost : { 0, 100, 1000 }) {
+        b->cost = cost;
+        b->sequentialSegments = sequentialSegments;
+
+        /*
+         * Measure.
+         */
+        std::vector<int64_t> forks, joins, totals;
+        int32_t threads = 0;
+        for (auto r = 0; r <= repetitions; r++) {
+          resetTaskTimes(&b->times);
+          auto start = now();
+          auto info =
+              NOELLE_HELIX_dispatcher_sequentialSegments(HELIXTask,
+                                                         b,
+                                                         NULL,
+                                                         cores,
+                                                         sequentialSegments);
+          auto end = now();
+          threads = info.numberOfThreadsUsed;
+          if (r == 0) {
+            continue;
+          }
+          forks.push_back(b->times.firstTaskStart.load() - start);
+          joins.push_back(end - b->times.lastTaskEnd.load());
+          totals.push_back(end - start);
+        }
+
+        /*
+         * Report.
+         */
+        auto total = median(totals);
+        auto perIteration = ((double)total) / b->iterations;
+        printf("helix\t%d\t%d\t%d\t%d\t%lld\t%lld\t%lld\t%lld\t%.2f\t%.2f\n",
+               cores,
+               threads,
+               sequentialSegments,
+               cost,
+               (long long)b->iterations,
+               (long long)median(forks),
+               (long long)median(joins),
+               (long long)total,
+               perIteration,
+               perIteration / sequentialSegments);
+        fflush(stdout);
+      }
+    }
+  }
+  delete b;
+
+  return;
+}
+
+/**********************************************************************
+ *                DSWP
+ **********************************************************************/
+template <typename T>
+struct QueueFunctions {};
+
+template <>
+struct QueueFunctions<int8_t> {
+  static constexpr void (*push)(void *, int8_t *) = queuePush8;
+  static constexpr void (*pop)(void *, int8_t *) = queuePop8;
+};
+
+template <>
+struct QueueFunctions<int16_t> {
+  static constexpr void (*push)(void *, int16_t *) = queuePush16;
+  static constexpr void (*pop)(void *, int16_t *) = queuePop16;
+};
+
+template <>
+struct QueueFunctions<int32_t> {
+  static constexpr void (*push)(void *, int32_t *) = queuePush32;
+  static constexpr void (*pop)(void *, int32_t *) = queuePop32;
+};
+
+template <>
+struct QueueFunctions<int64_t> {
+  static constexpr void (*push)(void *, int64_t *) = queuePush64;
+  static constexpr void (*pop)(void *, int64_t *) = queuePop64;
+};
+
+/*
+ * Record that packs four values, like the ones DSWP sends when several
+ * values flow between the same two stages.
+ */
+typedef struct {
+  int64_t values[4];
+} DSWPRecord_t;
+
+template <>
+struct QueueFunctions<DSWPRecord_t> {
+  static void push(void *queue, DSWPRecord_t *record) {
+    queuePushRecord(queue, record);
+  }
+  static void pop(void *queue, DSWPRecord_t *record) {
+    queuePopRecord(queue, record);
+  }
+};
+
+/*
+ * Values sent through the queues.
+ */
+template <typename T>
+static T DSWPValue(int64_t i) {
+  return (T)i;
+}
+
+template <>
+DSWPRecord_t DSWPValue<DSWPRecord_t>(int64_t i) {
+  return DSWPRecord_t{ { i, i + 1, i + 2, i + 3 } };
+}
+
+template <typename T>
+static uint64_t DSWPFold(T value) {
+  return value;
+}
+
+static uint64_t DSWPFold(DSWPRecord_t value) {
+  return value.values[0] + value.values[1] + value.values[2] + value.values[3];
+}
+
+/*
+ * Size of a queue as described to the dispatcher: the number of bits of a
+ * scalar queue, or the negated number of bytes of a queue of records.
+ */
+template <typename T>
+static int64_t DSWPQueueSize(void) {
+  return sizeof(T) * 8;
+}
+
+template <>
+int64_t DSWPQueueSize<DSWPRecord_t>(void) {
+  return -((int64_t)sizeof(DSWPRecord_t));
+}
+
+/*
+ * The first stage produces the values, the middle stages forward them to
+ * their next stage, and the last stage consumes them.
+ */
+template <typename T>
+static void DSWPFirstStage(void *env, void *queues) {
+  auto b = (DSWPBenchmark_t *)env;
+  auto allQueues = (void **)queues;
+  taskStarted(&b->times);
+
+  for (auto i = 0; i < b->values; i++) {
+    auto value = DSWPValue<T>(i);
+    QueueFunctions<T>::push(allQueues[0], &value);
+  }
+
+  taskEnded(&b->times);
+  return;
+}
+
+template <typename T>
+static void DSWPMiddleStage(void *env, void *queues) {
+  auto b = (DSWPBenchmark_t *)env;
+  auto allQueues = (void **)queues;
+  taskStarted(&b->times);
+
+  /*
+   * Middle stages are interchangeable, so each one picks the next free
+   * position of the pipeline.
+   */
+  auto stageID = b->nextRelayStage.fetch_add(1);
+  for (auto i = 0; i < b->values; i++) {
+    T value;
+    QueueFunctions<T>::pop(allQueues[stageID - 1], &value);
+    QueueFunctions<T>::push(allQueues[stageID], &value);
+  }
+
+  taskEnded(&b->times);
+  return;
+}
+
+template <typename T>
+static void DSWPLastStage(void *env, void *queues) {
+  auto b = (DSWPBenchmark_t *)env;
+  auto allQueues = (void **)queues;
+  taskStarted(&b->times);
+
+  uint64_t sum = 0;
+  for (auto i = 0; i < b->values; i++) {
+    T value;
+    QueueFunctions<T>::pop(allQueues[b->numberOfStages - 2], &value);
+    sum += DSWPFold(value);
+  }
+  b->sink = sum;
+
+  taskEnded(&b->times);
+  return;
+}
+
+template <typename T>
+static void benchmarkDSWPQueue(DSWPBenchmark_t *b,
+                               int64_t repetitions,
+                               int64_t numberOfStages) {
+
+  /*
+   * Build the pipeline.
+   */
+  auto numberOfQueues = numberOfStages - 1;
+  std::vector<void *> stages;
+  stages.push_back((void *)DSWPFirstStage<T>);
+  for (auto i = 1; i < (numberOfStages - 1); i++) {
+    stages.push_back((void *)DSWPMiddleStage<T>);
+  }
+  stages.push_back((void *)DSWPLastStage<T>);
+  std::vector<int64_t> queueSizes(numberOfQueues, DSWPQueueSize<T>());
+  b->numberOfStages = numberOfStages;
+
+  /*
+   * Measure.
+   */
+  std::vector<int64_t> forks, joins, totals;
+  for (auto r = 0; r <= repetitions; r++) {
+    resetTaskTimes(&b->times);
+    b->nextRelayStage.store(1);
+    auto start = now();
+    NOELLE_DSWPDispatcher(b,
+                          queueSizes.data(),
+                          stages.data(),
+                          numberOfStages,
+                          numberOfQueues);
+    auto end = now();
+    if (r == 0) {
+      continue;
+    }
+    forks.push_back(b->times.firstTaskStart.load() - start);
+    joins.push_back(end - b->times.lastTaskEnd.load());
+    totals.push_back(end - start);
+  }
+
+  /*
+   * Report.
+   * The throughput is the number of values that go through the whole pipeline
+   * per second.
+   */
+  auto total = median(totals);
+  auto valuesPerSecond = ((double)b->values) * 1e9 / total;
+  printf("dswp\t%lld\t%d\t%lld\t%lld\t%lld\t%lld\t%.0f\t%.2f\n",
+         (long long)numberOfStages,
+         (int)(sizeof(T) * 8),
+         (long long)b->values,
+         (long long)median(forks),
+         (long long)median(joins),
+         (long long)total,
+         valuesPerSecond,
+         valuesPerSecond * sizeof(T) / (1024 * 1024));
+  fflush(stdout);
+
+  return;
+}
+
+static void benchmarkDSWP(int64_t repetitions, int64_t maxCores) {
+  printf("# technique\tstages\tqueue_width_bits\tvalues\tfork_ns\tjoin_ns"
+         "\ttotal_ns\tvalues_per_second\tmb_per_second\n");
+
+  auto b = new DSWPBenchmark_t();
+  b->values = 1000000;
+  for (auto stages = 2; stages <= std::max(maxCores, (int64_t)2); stages++) {
+    benchmarkDSWPQueue<int8_t>(b, repetitions, stages);
+    benchmarkDSWPQueue<int16_t>(b, repetitions, stages);
+    benchmarkDSWPQueue<int32_t>(b, repetitions, stages);
+    benchmarkDSWPQueue<int64_t>(b, repetitions, stages);
+    benchmarkDSWPQueue<DSWPRecord_t>(b, repetitions, stages);
+  }
+  delete b;
+
+  return;
+}
+
+int main(int argc, char *argv[]) {
+
+  /*
+   * Fetch the inputs.
+   */
+  if ((argc > 1) && (strcmp(argv[1], "-h") == 0)) {
+    fprintf(stderr,
+            "USAGE: %s [all|doall|helix|dswp] [REPETITIONS] [MAX_CORES]\n",
+            argv[0]);
+    return 1;
+  }
+  auto technique = (argc > 1) ? argv[1] : "all";
+  int64_t repetitions = (argc > 2) ? atoll(argv[2]) : 10;
+  int64_t maxCores =
+      (argc > 3) ? atoll(argv[3]) : (int64_t)NOELLE_getAvailableCores();
+  if ((repetitions < 1) || (maxCores < 1)) {
+    fprintf(stderr, "ERROR: repetitions and cores must be positive\n");
+    return 1;
+  }
+
+  /*
+   * Run the benchmarks.
+   */
+  auto all = (strcmp(technique, "all") == 0);
+  if (all || (strcmp(technique, "doall") == 0)) {
+    benchmarkDOALL(repetitions, maxCores);
+  }
+  if (all || (strcmp(technique, "helix") == 0)) {
+    benchmarkHELIX(repetitions, maxCores);
+  }
+  if (all || (strcmp(technique, "dswp") == 0)) {
+    benchmarkDSWP(repetitions, maxCores);
+  }
+
+  return 0;
+}
@@ -12,6 +12,9 @@ function linkParUtils {
     if ! test -f Parallelizer_utils.cpp ; then
       ln -s ${rootDir}/src/core/runtime/Parallelizer_utils.cpp ;
       ln -s ${rootDir}/src/core/runtime/NOELLE_APIs.c ;
+      ln -s ${rootDir}/src/core/runtime/NOELLE_ThreadPool.h ;
+      ln -s ${rootDir}/src/core/runtime/NOELLE_ThreadPool.hpp ;
+      ln -s ${rootDir}/src/core/runtime/NOELLE_Queue.hpp ;
     fi
     if ! test -f Makefile ; then
       ln -s ../../scripts/Makefile ;
@@ -12,7 +12,7 @@ function cleanTests {
 
     cd $i ;
     make clean ;
-    rm -f NOELLE_APIs.* *_utils.cpp Makefile *.log *.dot ;
+    rm -f NOELLE_APIs.* NOELLE_ThreadPool.* NOELLE_Queue.hpp *_utils.cpp Makefile *.log *.dot ;
     cd ../ ;
   done
 
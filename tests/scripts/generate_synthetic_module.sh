@@ -0,0 +1,71 @@
+#!/bin/bash -e
+
+# Generate a C program whose size grows linearly with SCALE.
+# Each unit of scale adds one function with a DOALL loop, a reduction, a loop
+# with a loop-carried memory dependence, and a triply nested loop.
+if test $# -lt 2 ; then
+  echo "USAGE: `basename $0` SCALE FILE_TO_GENERATE" ;
+  exit 1;
+fi
+scale="$1" ;
+outFile="$2" ;
+
+cat > $outFile <<EOF
+#include <stdio.h>
+#include <stdlib.h>
+
+EOF
+
+for i in `seq 0 $(( scale - 1 ))` ; do
+  cat >> $outFile <<EOF
+long long kernel_${i} (long long *a, long long *b, long long *c, long long n){
+  long long sum = 0;
+
+  for (long long j = 0; j < n; j++){
+    a[j] = b[j] * ${i} + c[j];
+  }
+
+  for (long long j = 0; j < n; j++){
+    sum += a[j] ^ (b[j] >> 2);
+  }
+
+  for (long long j = 1; j < n; j++){
+    b[j] = b[j - 1] + a[j] % 7;
+  }
+
+  for (long long x = 0; x < 8; x++){
+    for (long long y = 0; y < 8; y++){
+      for (long long z = 0; z < n / 64; z++){
+        c[(x * 8 + y) * (n / 64) + z] += a[z] * x - y;
+      }
+    }
+  }
+
+  return sum + b[n - 1];
+}
+
+EOF
+done
+
+cat >> $outFile <<EOF
+int main (int argc, char *argv[]){
+  long long n = (argc > 1) ? atoll(argv[1]) * 64 : 1024;
+  long long *a = (long long *)calloc(n, sizeof(long long));
+  long long *b = (long long *)calloc(n, sizeof(long long));
+  long long *c = (long long *)calloc(n, sizeof(long long));
+  long long result = 0;
+
+EOF
+for i in `seq 0 $(( scale - 1 ))` ; do
+  echo "  result += kernel_${i}(a, b, c, n);" >> $outFile ;
+done
+cat >> $outFile <<EOF
+
+  printf("%lld\n", result);
+  free(a);
+  free(b);
+  free(c);
+
+  return 0;
+}
+EOF
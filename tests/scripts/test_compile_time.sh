@@ -0,0 +1,275 @@
+#!/bin/bash
+
+# Measure how long NOELLE takes (wall time and peak resident set size) to run
+# each of its phases on the regression and performance tests and on synthetic
+# modules of increasing size.
+#
+# Results are written to compile_time/results.txt, one line per benchmark and
+# phase:
+#   BENCHMARK <tab> PHASE <tab> SECONDS <tab> PEAK_RSS_KB <tab> STATUS
+#
+# USAGE: test_compile_time.sh [--save-baseline] [--synthetic-only]
+#
+# Environment variables:
+#   SYNTHETIC_SCALES        sizes of the synthetic modules (default: "1 4 16")
+#   COMPILE_TIME_TOLERANCE  slowdown (percent) tolerated against the baseline
+#                           before a phase is reported (default: 10)
+#   COMPILE_TIME_MIN_DELTA  slowdowns shorter than these seconds are noise
+#                           (default: 0.5)
+
+function compileBitcode {
+  local sourceFile="$1" ;
+  local outputFile="$2" ;
+
+  # Use the front-end flags of the regression and performance tests
+  local compiler="clang" ;
+  if [[ "$sourceFile" == *.cpp ]] ; then
+    compiler="clang++" ;
+  fi
+  $compiler -emit-llvm -O1 -Xclang -disable-llvm-passes -c $sourceFile -o $outputFile &> /dev/null ;
+  if test $? -ne 0 ; then
+    return 1 ;
+  fi
+  opt -O0 $outputFile -o $outputFile &> /dev/null ;
+  noelle-norm $outputFile -o $outputFile &> /dev/null ;
+
+  return $? ;
+}
+
+function measurePhase {
+  local benchmark="$1" ;
+  local phase="$2" ;
+  shift 2 ;
+
+  # Run the phase
+  local timeFile=`mktemp` ;
+  ${timeCommand} -f "%e %M" -o $timeFile "$@" &> ${phase}.log ;
+  local exitCode=$? ;
+
+  # Dump the measurements
+  local seconds=`awk 'END { print $1 }' $timeFile` ;
+  local peakRSS=`awk 'END { print $2 }' $timeFile` ;
+  local phaseStatus="ok" ;
+  if test $exitCode -ne 0 ; then
+    phaseStatus="failed" ;
+  fi
+  echo -e "${benchmark}\t${phase}\t${seconds}\t${peakRSS}\t${phaseStatus}" >> $resultsFile ;
+
+  # Clean
+  rm $timeFile ;
+
+  return $exitCode ;
+}
+
+function measureBenchmark {
+  local benchmark="$1" ;
+  local bitcode="$2" ;
+  local noelleOptions="-noelle-min-hot=0" ;
+
+  echo "  $benchmark" ;
+
+  # Prepare the directory of the benchmark
+  local benchmarkDir="${workDir}/${benchmark}" ;
+  rm -rf $benchmarkDir ;
+  mkdir -p $benchmarkDir ;
+  pushd $benchmarkDir > /dev/null ;
+  ln -s ${rootDir}/src/core/runtime/NOELLE_APIs.c ;
+
+  # Add the loop IDs (not measured)
+  noelle-meta-loop-embed $bitcode -o loops.bc &> loop_embed.log ;
+  if test $? -ne 0 ; then
+    echo "    ERROR: the loop IDs could not be embedded" ;
+    popd > /dev/null ;
+    return ;
+  fi
+
+  # PDG construction, with and without the reachability analysis
+  measurePhase $benchmark pdg noelle-meta-pdg-embed loops.bc -o pdg.bc ;
+  measurePhase $benchmark pdg_no_reachability noelle-meta-pdg-embed loops.bc -o pdg_no_reachability.bc -noelle-disable-pdg-reaching-analysis ;
+
+  # Loop abstractions (loop structures, SCCDAG attributes, induction variables, ...), with and without the loop-aware dependence analyses
+  measurePhase $benchmark loops noelle-loop-stats loops.bc $noelleOptions ;
+  measurePhase $benchmark loops_no_loop_aware noelle-loop-stats loops.bc $noelleOptions -noelle-disable-loop-aware-dependence-analyses ;
+
+  # Parallelization planner
+  measurePhase $benchmark planner noelle-parallelization-planner loops.bc -o plan.bc $noelleOptions ;
+  if test $? -ne 0 ; then
+    popd > /dev/null ;
+    return ;
+  fi
+
+  # Add the prototypes of the runtime (not measured)
+  clang -c -emit-llvm NOELLE_APIs.c -o NOELLE_APIs.bc &> /dev/null ;
+  llvm-link NOELLE_APIs.bc plan.bc -o code_with_prototypes.bc &> /dev/null ;
+  noelle-rm-function -function-name=SIMONE_CAMPANONI_IS_GOING_TO_REMOVE_THIS_FUNCTION code_with_prototypes.bc -o code_to_parallelize.bc &> /dev/null ;
+
+  # Parallelization techniques, one at a time
+  measurePhase $benchmark doall noelle-parallelizer-loop code_to_parallelize.bc -o doall.bc $noelleOptions -noelle-parallelizer-force -noelle-disable-helix -noelle-disable-dswp ;
+  measurePhase $benchmark helix noelle-parallelizer-loop code_to_parallelize.bc -o helix.bc $noelleOptions -noelle-parallelizer-force -noelle-disable-doall -noelle-disable-dswp ;
+  measurePhase $benchmark dswp noelle-parallelizer-loop code_to_parallelize.bc -o dswp.bc $noelleOptions -noelle-parallelizer-force -noelle-disable-doall -noelle-disable-helix ;
+
+  popd > /dev/null ;
+
+  return ;
+}
+
+function measureTests {
+  local suite="$1" ;
+
+  echo "Measuring the $suite tests" ;
+  for i in `ls $suite`; do
+    if ! test -d ${suite}/$i ; then
+      continue ;
+    fi
+
+    # Fetch the source code
+    local sourceFile="${suite}/${i}/test.c" ;
+    if ! test -f $sourceFile ; then
+      sourceFile="${suite}/${i}/test.cpp" ;
+    fi
+    if ! test -f $sourceFile ; then
+      continue ;
+    fi
+
+    # Generate the bitcode
+    local bitcode="${workDir}/bitcode/${suite}_${i}.bc" ;
+    compileBitcode $sourceFile $bitcode ;
+    if test $? -ne 0 ; then
+      echo "  ERROR: $sourceFile could not be compiled" ;
+      continue ;
+    fi
+
+    measureBenchmark ${suite}_${i} $bitcode ;
+  done
+
+  return ;
+}
+
+function measureSyntheticModules {
+  echo "Measuring the synthetic modules" ;
+  for scale in $SYNTHETIC_SCALES ; do
+    local sourceFile="${workDir}/bitcode/synthetic_${scale}.c" ;
+    local bitcode="${workDir}/bitcode/synthetic_${scale}.bc" ;
+    ./scripts/generate_synthetic_module.sh $scale $sourceFile ;
+    compileBitcode $sourceFile $bitcode ;
+    if test $? -ne 0 ; then
+      echo "  ERROR: $sourceFile could not be compiled" ;
+      continue ;
+    fi
+
+    measureBenchmark synthetic_${scale} $bitcode ;
+  done
+
+  return ;
+}
+
+function printSummary {
+  echo "Time and peak memory per phase (all benchmarks)" ;
+  awk -F'\t' '
+    {
+      seconds[$2] += $3;
+      if ($4 > rss[$2]){
+        rss[$2] = $4;
+      }
+      if ($5 != "ok"){
+        failures[$2]++;
+      }
+    }
+    END {
+      for (phase in seconds){
+        printf("  %-22s %10.2f s %10d KB %4d failures\n", phase, seconds[phase], rss[phase], failures[phase]);
+      }
+    }' $resultsFile | sort ;
+
+  return ;
+}
+
+function compareAgainstBaseline {
+  if ! test -f $baselineFile ; then
+    echo "No baseline to compare against: run \"make compile_time_baseline\" to record one" ;
+    return 0 ;
+  fi
+
+  echo "Comparing against the baseline (tolerance ${COMPILE_TIME_TOLERANCE}%)" ;
+  awk -F'\t' -v tolerance=$COMPILE_TIME_TOLERANCE -v minDelta=$COMPILE_TIME_MIN_DELTA '
+    NR == FNR {
+      baseSeconds[$1 "\t" $2] = $3;
+      baseRSS[$1 "\t" $2] = $4;
+      next;
+    }
+    {
+      key = $1 "\t" $2;
+      if (!(key in baseSeconds)){
+        next;
+      }
+      limit = 1 + (tolerance / 100);
+      if (($3 > baseSeconds[key] * limit) && ($3 - baseSeconds[key] > minDelta)){
+        printf("  SLOWER: %s %s: %.2f s -> %.2f s\n", $1, $2, baseSeconds[key], $3);
+        regressions++;
+      }
+      if ($4 > baseRSS[key] * limit){
+        printf("  MORE MEMORY: %s %s: %d KB -> %d KB\n", $1, $2, baseRSS[key], $4);
+        regressions++;
+      }
+    }
+    END {
+      printf("  %d regressions\n", regressions);
+      exit (regressions > 0);
+    }' $baselineFile $resultsFile ;
+
+  return $? ;
+}
+
+# Parse the options
+saveBaseline="0" ;
+synthetic_only="0" ;
+for option in "$@" ; do
+  if test "$option" == "--save-baseline" ; then
+    saveBaseline="1" ;
+  elif test "$option" == "--synthetic-only" ; then
+    synthetic_only="1" ;
+  fi
+done
+if test "$SYNTHETIC_SCALES" == "" ; then
+  SYNTHETIC_SCALES="1 4 16" ;
+fi
+if test "$COMPILE_TIME_TOLERANCE" == "" ; then
+  COMPILE_TIME_TOLERANCE="10" ;
+fi
+if test "$COMPILE_TIME_MIN_DELTA" == "" ; then
+  COMPILE_TIME_MIN_DELTA="0.5" ;
+fi
+
+# Check the dependences
+timeCommand="/usr/bin/time" ;
+if ! test -x $timeCommand ; then
+  echo "ERROR: GNU time is required to measure the peak memory" ;
+  exit 1 ;
+fi
+
+# Set the paths
+rootDir="`git rev-parse --show-toplevel`" ;
+export PATH=${rootDir}/install/bin:$PATH ;
+workDir="`pwd`/compile_time" ;
+resultsFile="${workDir}/results.txt" ;
+baselineFile="${workDir}/baseline.txt" ;
+mkdir -p ${workDir}/bitcode ;
+> $resultsFile ;
+
+# Measure
+if test "$synthetic_only" == "0" ; then
+  measureTests regression ;
+  measureTests performance ;
+fi
+measureSyntheticModules ;
+
+# Report
+printSummary ;
+if test "$saveBaseline" == "1" ; then
+  cp $resultsFile $baselineFile ;
+  echo "Baseline saved in $baselineFile" ;
+  exit 0 ;
+fi
+compareAgainstBaseline ;
+
+exit $? ;